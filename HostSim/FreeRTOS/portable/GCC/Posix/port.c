@@ -0,0 +1,787 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*-----------------------------------------------------------
+* Implementation of functions defined in portable.h for the Posix port.
+*
+* Each task is a pthread that is parked on its own condition variable while
+* it is not the running task.  Switching context means waking the thread of
+* the task selected by vTaskSwitchContext() and parking the current one, so
+* exactly one task thread executes at any time.
+*
+* Interrupts are POSIX signals.  SIGALRM drives the tick from an interval
+* timer and SIGUSR1 delivers simulated peripheral interrupts.  Both are
+* blocked in every thread except the running task, so the running task is
+* always the one that is "interrupted", and blocking them in that thread is
+* how interrupts are masked.
+*----------------------------------------------------------*/
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define portSIG_TICK           SIGALRM
+#define portSIG_INTERRUPT      SIGUSR1
+#define portPENDING_WORDS      ( ( portMAX_SIMULATED_INTERRUPTS + 31UL ) / 32UL )
+#define portNS_PER_SECOND      ( 1000000000ULL )
+
+/* Called around the outermost critical section, as on the target port */
+#ifndef traceCRITICAL_ENTERED
+    #define traceCRITICAL_ENTERED()
+#endif
+#ifndef traceCRITICAL_EXITING
+    #define traceCRITICAL_EXITING()
+#endif
+/* Called around a tickless sleep, as on the target port */
+#ifndef traceSLEEP_ENTERED
+    #define traceSLEEP_ENTERED()
+#endif
+#ifndef traceSLEEP_ENDED
+    #define traceSLEEP_ENDED( ulCycles )
+#endif
+
+typedef struct THREAD
+{
+    pthread_t xPthread;
+    TaskFunction_t pxCode;
+    void * pvParams;
+    BaseType_t xResumeSignalled;
+    pthread_mutex_t xMutex;
+    pthread_cond_t xCond;
+} Thread_t;
+
+/*-----------------------------------------------------------*/
+
+static pthread_once_t xPortInitOnce = PTHREAD_ONCE_INIT;
+static sigset_t xInterruptSignals;
+
+static volatile UBaseType_t uxCriticalNesting = 0;
+static volatile BaseType_t xInsideInterrupt = pdFALSE;
+static volatile BaseType_t xSwitchPending = pdFALSE;
+static volatile BaseType_t xSchedulerRunning = pdFALSE;
+static volatile BaseType_t xSchedulerEnded = pdFALSE;
+
+static pthread_mutex_t xSchedulerEndMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xSchedulerEndCond = PTHREAD_COND_INITIALIZER;
+
+static PortInterruptHandler_t pvInterruptHandlers[ portMAX_SIMULATED_INTERRUPTS ];
+static volatile uint32_t ulPendingInterrupts[ portPENDING_WORDS ];
+static volatile uint64_t ullRaiseTimeNs[ portMAX_SIMULATED_INTERRUPTS ];
+
+/* Raise time of the interrupt being serviced and of the earliest one that
+ * asked for a context switch during the current handler invocation. */
+static uint64_t ullServicedRaiseNs = 0;
+static uint64_t ullYieldRaiseNs = 0;
+
+static PortSimulationStats_t xStats;
+static uint64_t ullSchedulerStartNs = 0;
+static uint64_t ullLastSwitchNs = 0;
+
+#if ( configUSE_TICKLESS_IDLE == 2 )
+    static PortTicklessStats_t xTicklessStats;
+    static volatile BaseType_t xTicklessSlept = pdFALSE;
+#endif
+
+/*-----------------------------------------------------------*/
+
+static void prvPortInit( void );
+static void * prvWaitForStart( void * pvParams );
+static void prvSuspendSelf( Thread_t * pxThread );
+static void prvResumeThread( Thread_t * pxThread );
+static void prvSwitchContext( void );
+static void prvEnterInterrupt( void );
+static void prvExitInterrupt( void );
+static void prvTickSignalHandler( int iSignal );
+static void prvInterruptSignalHandler( int iSignal );
+static void prvSetupTimerInterrupt( void );
+static uint64_t prvNowNs( void );
+
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNowNs( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * portNS_PER_SECOND ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static Thread_t * prvGetThreadFromTask( TaskHandle_t xTask )
+{
+    /* The first member of the TCB is pxTopOfStack, which this port never
+     * moves, and the top of stack holds the thread descriptor. */
+    StackType_t * pxTopOfStack = *( StackType_t ** ) xTask;
+
+    return ( Thread_t * ) ( *pxTopOfStack );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPortInit( void )
+{
+    struct sigaction xSigTick;
+    struct sigaction xSigInterrupt;
+    int iRet;
+
+    sigemptyset( &xInterruptSignals );
+    sigaddset( &xInterruptSignals, portSIG_TICK );
+    sigaddset( &xInterruptSignals, portSIG_INTERRUPT );
+
+    memset( &xSigTick, 0, sizeof( xSigTick ) );
+    xSigTick.sa_handler = prvTickSignalHandler;
+    xSigTick.sa_mask = xInterruptSignals;
+    xSigTick.sa_flags = SA_RESTART;
+    iRet = sigaction( portSIG_TICK, &xSigTick, NULL );
+    configASSERT( iRet == 0 );
+
+    memset( &xSigInterrupt, 0, sizeof( xSigInterrupt ) );
+    xSigInterrupt.sa_handler = prvInterruptSignalHandler;
+    xSigInterrupt.sa_mask = xInterruptSignals;
+    xSigInterrupt.sa_flags = SA_RESTART;
+    iRet = sigaction( portSIG_INTERRUPT, &xSigInterrupt, NULL );
+    configASSERT( iRet == 0 );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    Thread_t * pxThread;
+    sigset_t xSavedMask;
+    int iRet;
+
+    pthread_once( &xPortInitOnce, prvPortInit );
+
+    pxThread = calloc( 1, sizeof( Thread_t ) );
+    configASSERT( pxThread != NULL );
+
+    pxThread->pxCode = pxCode;
+    pxThread->pvParams = pvParameters;
+    pxThread->xResumeSignalled = pdFALSE;
+    pthread_mutex_init( &pxThread->xMutex, NULL );
+    pthread_cond_init( &pxThread->xCond, NULL );
+
+    /* The task never executes on the FreeRTOS stack, so the top word is only
+     * used to find the thread again from the task handle. */
+    *pxTopOfStack = ( StackType_t ) ( portPOINTER_SIZE_TYPE ) pxThread;
+
+    /* The new thread inherits the signal mask, so create it with interrupts
+     * masked; it unmasks them the first time it is scheduled. */
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignals, &xSavedMask );
+    iRet = pthread_create( &pxThread->xPthread, NULL, prvWaitForStart, pxThread );
+    pthread_sigmask( SIG_SETMASK, &xSavedMask, NULL );
+    configASSERT( iRet == 0 );
+
+    return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvWaitForStart( void * pvParams )
+{
+    Thread_t * pxThread = ( Thread_t * ) pvParams;
+
+    prvSuspendSelf( pxThread );
+
+    /* Scheduled for the first time. */
+    uxCriticalNesting = 0;
+    vPortEnableInterrupts();
+
+    pxThread->pxCode( pxThread->pvParams );
+
+    /* A function that implements a task must not exit or attempt to return
+     * to its caller as there is nothing to return to. */
+    configASSERT( pdFALSE );
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSuspendSelf( Thread_t * pxThread )
+{
+    pthread_mutex_lock( &pxThread->xMutex );
+
+    while( pxThread->xResumeSignalled == pdFALSE )
+    {
+        pthread_cond_wait( &pxThread->xCond, &pxThread->xMutex );
+    }
+
+    pxThread->xResumeSignalled = pdFALSE;
+    pthread_mutex_unlock( &pxThread->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvResumeThread( Thread_t * pxThread )
+{
+    pthread_mutex_lock( &pxThread->xMutex );
+    pxThread->xResumeSignalled = pdTRUE;
+    pthread_cond_signal( &pxThread->xCond );
+    pthread_mutex_unlock( &pxThread->xMutex );
+}
+/*-----------------------------------------------------------*/
+
+/* Must be called with interrupts masked. */
+static void prvSwitchContext( void )
+{
+    TaskHandle_t xFromTask = xTaskGetCurrentTaskHandle();
+    TaskHandle_t xToTask;
+    Thread_t * pxFrom;
+    Thread_t * pxTo;
+    UBaseType_t uxSavedCriticalNesting;
+    uint64_t ullNow;
+
+    vTaskSwitchContext();
+    xToTask = xTaskGetCurrentTaskHandle();
+
+    if( xFromTask != xToTask )
+    {
+        pxFrom = prvGetThreadFromTask( xFromTask );
+        pxTo = prvGetThreadFromTask( xToTask );
+
+        ullNow = prvNowNs();
+        #if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
+            if( xFromTask == xTaskGetIdleTaskHandle() )
+            {
+                xStats.ullIdleNs += ullNow - ullLastSwitchNs;
+            }
+        #endif
+        ullLastSwitchNs = ullNow;
+        xStats.ullContextSwitches++;
+
+        uxSavedCriticalNesting = uxCriticalNesting;
+        prvResumeThread( pxTo );
+        prvSuspendSelf( pxFrom );
+        uxCriticalNesting = uxSavedCriticalNesting;
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+    uint32_t ulWord;
+
+    pthread_once( &xPortInitOnce, prvPortInit );
+
+    /* The thread that started the scheduler only waits for it to end. */
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignals, NULL );
+
+    ullSchedulerStartNs = prvNowNs();
+    ullLastSwitchNs = ullSchedulerStartNs;
+    xSchedulerRunning = pdTRUE;
+
+    prvSetupTimerInterrupt();
+
+    /* Start the first task. */
+    prvResumeThread( prvGetThreadFromTask( xTaskGetCurrentTaskHandle() ) );
+
+    /* Deliver anything that was raised before the scheduler ran. */
+    for( ulWord = 0; ulWord < portPENDING_WORDS; ulWord++ )
+    {
+        if( ulPendingInterrupts[ ulWord ] != 0UL )
+        {
+            kill( getpid(), portSIG_INTERRUPT );
+            break;
+        }
+    }
+
+    pthread_mutex_lock( &xSchedulerEndMutex );
+
+    while( xSchedulerEnded == pdFALSE )
+    {
+        pthread_cond_wait( &xSchedulerEndCond, &xSchedulerEndMutex );
+    }
+
+    pthread_mutex_unlock( &xSchedulerEndMutex );
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+    struct itimerval xTimer;
+
+    memset( &xTimer, 0, sizeof( xTimer ) );
+    setitimer( ITIMER_REAL, &xTimer, NULL );
+    xSchedulerRunning = pdFALSE;
+
+    pthread_mutex_lock( &xSchedulerEndMutex );
+    xSchedulerEnded = pdTRUE;
+    pthread_cond_signal( &xSchedulerEndCond );
+    pthread_mutex_unlock( &xSchedulerEndMutex );
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+    pthread_sigmask( SIG_BLOCK, &xInterruptSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+    pthread_sigmask( SIG_UNBLOCK, &xInterruptSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+    if( uxCriticalNesting == 0 )
+    {
+        vPortDisableInterrupts();
+        traceCRITICAL_ENTERED();
+    }
+
+    uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+    configASSERT( uxCriticalNesting );
+    uxCriticalNesting--;
+
+    if( uxCriticalNesting == 0 )
+    {
+        traceCRITICAL_EXITING();
+        vPortEnableInterrupts();
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortSetInterruptMask( void )
+{
+    /* Interrupts are always masked while a signal handler runs. */
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t uxMask )
+{
+    ( void ) uxMask;
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+    /* Masked as by vPortEnterCritical(), but the switch is not timed as a
+     * critical section: on the target it runs in PendSV once the section
+     * has ended. A yield inside a section therefore ends its timing here and
+     * starts it again when this thread runs on. */
+    if( uxCriticalNesting == 0 )
+    {
+        vPortDisableInterrupts();
+    }
+    else
+    {
+        traceCRITICAL_EXITING();
+    }
+
+    uxCriticalNesting++;
+    prvSwitchContext();
+    uxCriticalNesting--;
+
+    if( uxCriticalNesting == 0 )
+    {
+        vPortEnableInterrupts();
+    }
+    else
+    {
+        traceCRITICAL_ENTERED();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldFromISR( void )
+{
+    if( xInsideInterrupt != pdFALSE )
+    {
+        /* Deferred to the end of the handler, as PendSV is on the target. */
+        if( ( xSwitchPending == pdFALSE ) || ( ullServicedRaiseNs < ullYieldRaiseNs ) )
+        {
+            ullYieldRaiseNs = ullServicedRaiseNs;
+        }
+
+        xSwitchPending = pdTRUE;
+    }
+    else
+    {
+        vPortYield();
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortIsInsideInterrupt( void )
+{
+    return xInsideInterrupt;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEnterInterrupt( void )
+{
+    uxCriticalNesting++;
+    xInsideInterrupt = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvExitInterrupt( void )
+{
+    uint64_t ullLatency;
+
+    xInsideInterrupt = pdFALSE;
+
+    if( xSwitchPending != pdFALSE )
+    {
+        xSwitchPending = pdFALSE;
+
+        if( ullYieldRaiseNs != 0ULL )
+        {
+            ullLatency = prvNowNs() - ullYieldRaiseNs;
+            xStats.ullWakeups++;
+            xStats.ullWakeupLatencyTotalNs += ullLatency;
+
+            if( ullLatency > xStats.ullWakeupLatencyMaxNs )
+            {
+                xStats.ullWakeupLatencyMaxNs = ullLatency;
+            }
+
+            ullYieldRaiseNs = 0ULL;
+        }
+
+        prvSwitchContext();
+    }
+
+    uxCriticalNesting--;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickSignalHandler( int iSignal )
+{
+    ( void ) iSignal;
+
+    prvEnterInterrupt();
+    xStats.ullTicks++;
+
+    if( xTaskIncrementTick() != pdFALSE )
+    {
+        xSwitchPending = pdTRUE;
+    }
+
+    prvExitInterrupt();
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptSignalHandler( int iSignal )
+{
+    uint32_t ulWord;
+    uint32_t ulPending;
+    uint32_t ulInterruptNumber;
+    uint64_t ullLatency;
+
+    ( void ) iSignal;
+
+    prvEnterInterrupt();
+
+    for( ulWord = 0; ulWord < portPENDING_WORDS; ulWord++ )
+    {
+        ulPending = __atomic_exchange_n( &ulPendingInterrupts[ ulWord ], 0UL, __ATOMIC_SEQ_CST );
+
+        while( ulPending != 0UL )
+        {
+            /* Lowest number first, as the NVIC does for equal priorities. */
+            ulInterruptNumber = ( ulWord * 32UL ) + ( uint32_t ) __builtin_ctz( ulPending );
+            ulPending &= ulPending - 1UL;
+
+            ullServicedRaiseNs = ullRaiseTimeNs[ ulInterruptNumber ];
+            ullLatency = prvNowNs() - ullServicedRaiseNs;
+            xStats.ullInterrupts++;
+            xStats.ullInterruptLatencyTotalNs += ullLatency;
+
+            if( ullLatency > xStats.ullInterruptLatencyMaxNs )
+            {
+                xStats.ullInterruptLatencyMaxNs = ullLatency;
+            }
+
+            if( pvInterruptHandlers[ ulInterruptNumber ] != NULL )
+            {
+                pvInterruptHandlers[ ulInterruptNumber ]( ulInterruptNumber );
+            }
+        }
+    }
+
+    prvExitInterrupt();
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber,
+                               PortInterruptHandler_t pvHandler )
+{
+    configASSERT( ulInterruptNumber < portMAX_SIMULATED_INTERRUPTS );
+    pvInterruptHandlers[ ulInterruptNumber ] = pvHandler;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+    uint32_t ulWord = ulInterruptNumber / 32UL;
+    uint32_t ulBit = 1UL << ( ulInterruptNumber % 32UL );
+    uint32_t ulPrevious;
+
+    configASSERT( ulInterruptNumber < portMAX_SIMULATED_INTERRUPTS );
+
+    if( ( ulPendingInterrupts[ ulWord ] & ulBit ) == 0UL )
+    {
+        ullRaiseTimeNs[ ulInterruptNumber ] = prvNowNs();
+    }
+
+    ulPrevious = __atomic_fetch_or( &ulPendingInterrupts[ ulWord ], ulBit, __ATOMIC_SEQ_CST );
+
+    /* Interrupts raised before the scheduler starts stay pending until it
+     * does, as they would on the target with the kernel's early masking. */
+    if( ( xSchedulerRunning != pdFALSE ) && ( ( ulPrevious & ulBit ) == 0UL ) )
+    {
+        kill( getpid(), portSIG_INTERRUPT );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetSimulationStats( PortSimulationStats_t * pxStats )
+{
+    uint64_t ullNow = prvNowNs();
+
+    *pxStats = xStats;
+
+    if( ullSchedulerStartNs != 0ULL )
+    {
+        pxStats->ullRunNs = ullNow - ullSchedulerStartNs;
+
+        #if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
+            if( xTaskGetCurrentTaskHandle() == xTaskGetIdleTaskHandle() )
+            {
+                pxStats->ullIdleNs += ullNow - ullLastSwitchNs;
+            }
+        #endif
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TICKLESS_IDLE == 2 )
+
+/* Host nanoseconds to target system clock counts */
+    static uint32_t prvNsToCounts( uint64_t ullNs )
+    {
+        return ( uint32_t ) ( ( ullNs * ( configCPU_CLOCK_HZ / 1000000ULL ) ) / 1000ULL );
+    }
+/*-----------------------------------------------------------*/
+
+    static uint64_t prvTimevalToNs( const struct timeval * pxTime )
+    {
+        return ( ( uint64_t ) pxTime->tv_sec * portNS_PER_SECOND ) + ( ( uint64_t ) pxTime->tv_usec * 1000ULL );
+    }
+/*-----------------------------------------------------------*/
+
+/* Follows the target vPortSuppressTicksAndSleep(): the interval timer stands
+ * in for the SysTick, the monotonic clock for Wide Timer 1A and a wait for the
+ * simulated interrupt signal for WFI.  The wait only ends the sleep; the
+ * signal is raised again once the sleep has been reported, so the handler
+ * runs in the window the target opens after WFI. */
+    void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+    {
+        const uint64_t ullTickNs = portNS_PER_SECOND / configTICK_RATE_HZ;
+        struct itimerval xTimer;
+        struct itimerval xStopped;
+        struct timespec xTimeout;
+        struct timespec xNoWait = { 0, 0 };
+        sigset_t xTick;
+        sigset_t xPending;
+        sigset_t xWake;
+        uint64_t ullTickLeftNs, ullWakeNs, ullStartNs, ullElapsedNs, ullRestartedNs, ullNextTickNs;
+        uint32_t ulCarriedTicks, ulCompleteTickPeriods, ulBin;
+        int32_t lError;
+        int iRet;
+
+        vPortDisableInterrupts();
+        xTicklessSlept = pdTRUE;
+
+        if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+        {
+            xTicklessStats.ulAborted++;
+            vPortEnableInterrupts();
+            return;
+        }
+
+        /* Stop the tick and see how far into the current tick it got. */
+        memset( &xStopped, 0, sizeof( xStopped ) );
+        setitimer( ITIMER_REAL, &xStopped, &xTimer );
+        ullStartNs = prvNowNs();
+        traceSLEEP_ENTERED();
+        ullTickLeftNs = prvTimevalToNs( &xTimer.it_value );
+
+        if( ( ullTickLeftNs == 0ULL ) || ( ullTickLeftNs > ullTickNs ) )
+        {
+            ullTickLeftNs = ullTickNs;
+        }
+
+        ulCarriedTicks = 0;
+        sigemptyset( &xTick );
+        sigaddset( &xTick, portSIG_TICK );
+        sigpending( &xPending );
+
+        if( sigismember( &xPending, portSIG_TICK ) == 1 )
+        {
+            ( void ) sigtimedwait( &xTick, NULL, &xNoWait );
+            ulCarriedTicks = 1;
+        }
+
+        ullWakeNs = ullTickLeftNs + ( ullTickNs * ( xExpectedIdleTime - 1UL - ulCarriedTicks ) );
+
+        configPRE_SLEEP_PROCESSING( xExpectedIdleTime );
+
+        sigemptyset( &xWake );
+        sigaddset( &xWake, portSIG_INTERRUPT );
+        xTimeout.tv_sec = ( time_t ) ( ullWakeNs / portNS_PER_SECOND );
+        xTimeout.tv_nsec = ( long ) ( ullWakeNs % portNS_PER_SECOND );
+        iRet = sigtimedwait( &xWake, NULL, &xTimeout );
+
+        configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+        traceSLEEP_ENDED( prvNsToCounts( prvNowNs() - ullStartNs ) );
+
+        if( iRet == portSIG_INTERRUPT )
+        {
+            xTicklessStats.ulEarlyWakeups++;
+
+            /* The wait took the signal; raised again for this thread, it is
+             * handled as soon as interrupts are unmasked. */
+            pthread_kill( pthread_self(), portSIG_INTERRUPT );
+            vPortEnableInterrupts();
+            vPortDisableInterrupts();
+        }
+        else
+        {
+            xTicklessStats.ulTimerWakeups++;
+        }
+
+        ullElapsedNs = prvNowNs() - ullStartNs;
+
+        if( ullElapsedNs >= ullTickLeftNs )
+        {
+            ulCompleteTickPeriods = ulCarriedTicks + 1UL + ( uint32_t ) ( ( ullElapsedNs - ullTickLeftNs ) / ullTickNs );
+            ullNextTickNs = ullTickNs - ( ( ullElapsedNs - ullTickLeftNs ) % ullTickNs );
+        }
+        else
+        {
+            ulCompleteTickPeriods = ulCarriedTicks;
+            ullNextTickNs = ullTickLeftNs - ullElapsedNs;
+        }
+
+        if( ulCompleteTickPeriods > xExpectedIdleTime )
+        {
+            ulCompleteTickPeriods = xExpectedIdleTime;
+            ullNextTickNs = 1000ULL;
+        }
+
+        /* setitimer() takes microseconds and treats zero as stop. */
+        if( ullNextTickNs < 1000ULL )
+        {
+            ullNextTickNs = 1000ULL;
+        }
+
+        xTimer.it_value.tv_sec = ( time_t ) ( ullNextTickNs / portNS_PER_SECOND );
+        xTimer.it_value.tv_usec = ( suseconds_t ) ( ( ullNextTickNs % portNS_PER_SECOND ) / 1000ULL );
+        xTimer.it_interval.tv_sec = 0;
+        xTimer.it_interval.tv_usec = ( suseconds_t ) ( 1000000UL / configTICK_RATE_HZ );
+        setitimer( ITIMER_REAL, &xTimer, NULL );
+        ullRestartedNs = prvNowNs() - ullStartNs;
+
+        lError = ( int32_t ) prvNsToCounts( ullElapsedNs ) - ( int32_t ) prvNsToCounts( ullRestartedNs );
+        xTicklessStats.lCompensationError += lError;
+
+        if( ( uint32_t ) ( ( lError < 0 ) ? -lError : lError ) > xTicklessStats.ulMaxCompensationError )
+        {
+            xTicklessStats.ulMaxCompensationError = ( uint32_t ) ( ( lError < 0 ) ? -lError : lError );
+        }
+
+        for( ulBin = 0; ( ulBin < ( portTICKLESS_RESIDENCY_BINS - 1UL ) ) && ( ( ulCompleteTickPeriods >> ulBin ) != 0UL ); ulBin++ )
+        {
+        }
+
+        xTicklessStats.aulResidency[ ulBin ]++;
+        xTicklessStats.ulSleeps++;
+        xTicklessStats.ulTicksSuppressed += ulCompleteTickPeriods;
+        xTicklessStats.ullSleepCounts += prvNsToCounts( ullElapsedNs );
+
+        vTaskStepTick( ulCompleteTickPeriods );
+
+        vPortEnableInterrupts();
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortGetTicklessStats( PortTicklessStats_t * pxStats )
+    {
+        *pxStats = xTicklessStats;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xPortTicklessSleptSinceLastCall( void )
+    {
+        BaseType_t xSlept = xTicklessSlept;
+
+        xTicklessSlept = pdFALSE;
+
+        return xSlept;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+static void prvSetupTimerInterrupt( void )
+{
+    struct itimerval xTimer;
+    int iRet;
+
+    xTimer.it_interval.tv_sec = 0;
+    xTimer.it_interval.tv_usec = ( suseconds_t ) ( 1000000UL / configTICK_RATE_HZ );
+    xTimer.it_value = xTimer.it_interval;
+
+    iRet = setitimer( ITIMER_REAL, &xTimer, NULL );
+    configASSERT( iRet == 0 );
+}
+/*-----------------------------------------------------------*/
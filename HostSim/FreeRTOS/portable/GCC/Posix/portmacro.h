@@ -0,0 +1,193 @@
+/*
+ * FreeRTOS Kernel V10.5.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+#ifndef PORTMACRO_H
+    #define PORTMACRO_H
+
+    #ifdef __cplusplus
+        extern "C" {
+    #endif
+
+/*-----------------------------------------------------------
+ * Port specific definitions.
+ *
+ * The settings in this file configure FreeRTOS correctly for a Linux host.
+ * Every task runs in its own pthread, only one of which is allowed to run at
+ * any time.  The tick and all simulated peripheral interrupts are delivered
+ * as signals to the thread of the task that is currently running, so masking
+ * those signals is the equivalent of masking interrupts on the target.
+ *
+ * These settings should not be altered.
+ *-----------------------------------------------------------
+ */
+
+/* Type definitions. */
+    #define portCHAR                 char
+    #define portFLOAT                float
+    #define portDOUBLE               double
+    #define portLONG                 long
+    #define portSHORT                short
+    #define portSTACK_TYPE           unsigned long
+    #define portBASE_TYPE            long
+    #define portPOINTER_SIZE_TYPE    size_t
+
+    typedef portSTACK_TYPE   StackType_t;
+    typedef long             BaseType_t;
+    typedef unsigned long    UBaseType_t;
+
+    #if ( configUSE_16_BIT_TICKS == 1 )
+        typedef uint16_t     TickType_t;
+        #define portMAX_DELAY              ( TickType_t ) 0xffff
+    #else
+        typedef uint32_t     TickType_t;
+        #define portMAX_DELAY              ( TickType_t ) 0xffffffffUL
+
+/* 32-bit tick type on a 64-bit architecture, so reads of the tick count do
+ * not need to be guarded with a critical section. */
+        #define portTICK_TYPE_IS_ATOMIC    1
+    #endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specifics. */
+    #define portSTACK_GROWTH      ( -1 )
+    #define portTICK_PERIOD_MS    ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+    #define portBYTE_ALIGNMENT    8
+/*-----------------------------------------------------------*/
+
+/* Scheduler utilities. */
+    extern void vPortYield( void );
+    extern void vPortYieldFromISR( void );
+
+    #define portYIELD()                                 vPortYield()
+    #define portEND_SWITCHING_ISR( xSwitchRequired )    do { if( xSwitchRequired != pdFALSE ) vPortYieldFromISR(); } while( 0 )
+    #define portYIELD_FROM_ISR( x )                     portEND_SWITCHING_ISR( x )
+/*-----------------------------------------------------------*/
+
+/* Critical section management. */
+    extern void vPortDisableInterrupts( void );
+    extern void vPortEnableInterrupts( void );
+    extern void vPortEnterCritical( void );
+    extern void vPortExitCritical( void );
+    extern UBaseType_t uxPortSetInterruptMask( void );
+    extern void vPortClearInterruptMask( UBaseType_t uxMask );
+
+    #define portDISABLE_INTERRUPTS()                  vPortDisableInterrupts()
+    #define portENABLE_INTERRUPTS()                   vPortEnableInterrupts()
+    #define portENTER_CRITICAL()                      vPortEnterCritical()
+    #define portEXIT_CRITICAL()                       vPortExitCritical()
+    #define portSET_INTERRUPT_MASK_FROM_ISR()         uxPortSetInterruptMask()
+    #define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )    vPortClearInterruptMask( x )
+/*-----------------------------------------------------------*/
+
+/* Simulated interrupt controller.  ulInterruptNumber is the NVIC interrupt
+ * number of the simulated peripheral (the vector table index minus 16) and is
+ * passed back to the handler.  The handler runs on the thread of the
+ * interrupted task with all simulated interrupts masked; a context switch
+ * requested through portYIELD_FROM_ISR() is deferred until every pending
+ * handler has run, as PendSV is on the target. */
+    #define portMAX_SIMULATED_INTERRUPTS    ( 160UL )
+
+    typedef void ( * PortInterruptHandler_t )( uint32_t ulInterruptNumber );
+
+    extern void vPortSetInterruptHandler( uint32_t ulInterruptNumber,
+                                          PortInterruptHandler_t pvHandler );
+    extern void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber );
+    extern BaseType_t xPortIsInsideInterrupt( void );
+
+/* Scheduler behaviour counters maintained by the port so the simulation can
+ * report them.  Times are host nanoseconds. */
+    typedef struct xPORT_SIMULATION_STATS
+    {
+        uint64_t ullTicks;                   /* Tick interrupts serviced. */
+        uint64_t ullContextSwitches;         /* Thread hand-overs between tasks. */
+        uint64_t ullInterrupts;              /* Simulated peripheral interrupts serviced. */
+        uint64_t ullInterruptLatencyMaxNs;   /* Worst raise-to-handler latency. */
+        uint64_t ullInterruptLatencyTotalNs; /* Sum of raise-to-handler latencies. */
+        uint64_t ullWakeups;                 /* Switches requested from an ISR. */
+        uint64_t ullWakeupLatencyMaxNs;      /* Worst raise-to-task latency. */
+        uint64_t ullWakeupLatencyTotalNs;    /* Sum of raise-to-task latencies. */
+        uint64_t ullIdleNs;                  /* Time the idle task held the CPU. */
+        uint64_t ullRunNs;                   /* Time since the scheduler started. */
+    } PortSimulationStats_t;
+
+    extern void vPortGetSimulationStats( PortSimulationStats_t * pxStats );
+/*-----------------------------------------------------------*/
+
+/* Tickless idle.  The interval timer is stopped while the idle task sleeps
+ * and the host wait ends on the tick the kernel expects to need next or on a
+ * simulated interrupt, as Wide Timer 1A and WFI do on the target.  The
+ * statistics match the target port; times are converted to system clock
+ * counts, configCPU_CLOCK_HZ per second. */
+    extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+    #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vPortSuppressTicksAndSleep( xExpectedIdleTime )
+
+    #define portTICKLESS_RESIDENCY_BINS    ( 8UL )
+
+    typedef struct xPORT_TICKLESS_STATS
+    {
+        uint32_t ulSleeps;                                      /* Sleeps entered. */
+        uint32_t ulAborted;                                     /* Sleeps abandoned, a task was ready. */
+        uint32_t ulTimerWakeups;                                /* Woken by the wake timer. */
+        uint32_t ulEarlyWakeups;                                /* Woken by another interrupt. */
+        uint32_t ulTicksSuppressed;                             /* Tick interrupts that did not happen. */
+        uint64_t ullSleepCounts;                                /* Time asleep. */
+        int32_t lCompensationError;                             /* Sum of kernel time minus wake timer time. */
+        uint32_t ulMaxCompensationError;                        /* Largest error of one sleep, either sign. */
+        uint32_t aulResidency[ portTICKLESS_RESIDENCY_BINS ];   /* Sleeps of 0, 1, 2-3, 4-7 ... tick periods. */
+    } PortTicklessStats_t;
+
+    extern void vPortGetTicklessStats( PortTicklessStats_t * pxStats );
+
+/* pdTRUE if the idle task entered portSUPPRESS_TICKS_AND_SLEEP() since the
+ * last call.  The idle hook only parks the thread when it did not, as the
+ * tick is then running and will end the wait. */
+    extern BaseType_t xPortTicklessSleptSinceLastCall( void );
+/*-----------------------------------------------------------*/
+
+/* Task function macros as described on the FreeRTOS.org WEB site.  These are
+ * not necessary for to use this port.  They are defined so the common demo files
+ * (which build with all the ports) will build. */
+    #define portTASK_FUNCTION_PROTO( vFunction, pvParameters )    void vFunction( void * pvParameters )
+    #define portTASK_FUNCTION( vFunction, pvParameters )          void vFunction( void * pvParameters )
+/*-----------------------------------------------------------*/
+
+/* portNOP() is not required by this port. */
+    #define portNOP()
+
+/* No MPU here and every task runs on its own host thread stack, so the
+ * target's stack guard (configUSE_MPU_STACK_GUARD) has nothing to move. */
+    #define portSTACK_GUARD_SWITCHED_IN( pxStack )
+
+/*-----------------------------------------------------------*/
+
+    #ifdef __cplusplus
+        }
+    #endif
+
+#endif /* PORTMACRO_H */
@@ -0,0 +1,499 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - ADC
+ *
+ * File Name: sim_adc.c
+ *
+ * Description: Simulated ADC0/ADC1 sample sequencers. A processor trigger
+ *              on PSSI samples the steps programmed in SSMUXn/SSCTLn up to
+ *              the END step, one microsecond per sample times the hardware
+ *              averaging factor of SAC. Results land in the sequencer FIFO
+ *              (8/4/4/1 entries), RIS is raised when a step has IE set and the
+ *              sequencer interrupt line of the simulated NVIC follows RIS & IM.
+ *              A GPTM time-out with TnOTE set starts the sequencers whose
+ *              EMUX selects the timer. With ACTSS.ADEN set, an IE step also
+ *              requests a uDMA burst on the sequencer's channel, and the
+ *              completed transfer raises the DMA bit of RIS.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "sim_adc.h"
+#include "sim_nvic.h"
+#include "sim_registers.h"
+#include "sim_udma.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_ADC_BLOCK_SIZE       0x1000u
+#define SIM_ADC_NUM_SEQUENCERS   4u
+#define SIM_ADC_MAX_STEPS        8u
+#define SIM_ADC_SAMPLE_NS        1000u      /* 1 Msps */
+#define SIM_ADC_FULL_SCALE       4095u
+
+#define SIM_ADC_ACTSS_OFFSET     0x000u
+#define SIM_ADC_RIS_OFFSET       0x004u
+#define SIM_ADC_IM_OFFSET        0x008u
+#define SIM_ADC_ISC_OFFSET       0x00Cu
+#define SIM_ADC_OSTAT_OFFSET     0x010u
+#define SIM_ADC_EMUX_OFFSET      0x014u
+#define SIM_ADC_USTAT_OFFSET     0x018u
+#define SIM_ADC_PSSI_OFFSET      0x028u
+#define SIM_ADC_SAC_OFFSET       0x030u
+
+/* Per sequencer registers, 0x20 apart starting at SS0 */
+#define SIM_ADC_SS_OFFSET(ss)    (0x040u + ((ss) * 0x20u))
+#define SIM_ADC_SSMUX_OFFSET     0x00u
+#define SIM_ADC_SSCTL_OFFSET     0x04u
+#define SIM_ADC_SSFIFO_OFFSET    0x08u
+#define SIM_ADC_SSFSTAT_OFFSET   0x0Cu
+#define SIM_ADC_SSEMUX_OFFSET    0x18u
+
+#define SIM_ADC_ACTSS_ADEN(ss)   (0x100u << (ss))
+#define SIM_ADC_ACTSS_BUSY       0x00010000u
+#define SIM_ADC_INT_DMA(ss)      (0x100u << (ss))
+#define SIM_ADC_SSCTL_END        0x2u
+#define SIM_ADC_SSCTL_IE         0x4u
+#define SIM_ADC_SSCTL_TS         0x8u
+#define SIM_ADC_SSFSTAT_EMPTY    0x00000100u
+#define SIM_ADC_SSFSTAT_FULL     0x00001000u
+#define SIM_ADC_EMUX_PROCESSOR   0x0u
+#define SIM_ADC_EMUX_TIMER       0x5u
+
+/* ISC, OSTAT and USTAT are write-1-to-clear. The model keeps this otherwise
+ * unused bit set in them, so a firmware write shows up as it being cleared.
+ * A read-modify-write (ADCIntClearEx, ADCSequenceOverflowClear) keeps the
+ * marker, which is why ISC reads back as zero here rather than as MIS: any
+ * bit in it can then only have been written by the firmware. */
+#define SIM_ADC_W1C_MARKER       0x80000000u
+
+/* Internal temperature sensor code for 25 C (TEMP = 147.5 - 75 * VTS / VREF) */
+#define SIM_ADC_TEMP_SENSOR_CODE 2028u
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 aulFifo[SIM_ADC_MAX_STEPS];
+    uint32 ulHead;
+    uint32 ulCount;
+    uint32 aulResults[SIM_ADC_MAX_STEPS];   /* Samples of the running sequence */
+    uint32 ulResultCount;
+    boolean bInterrupt;                     /* Running sequence has an IE step */
+    uint64 ullDoneNs;                       /* 0 while the sequencer is idle */
+} SimAdc_SequencerType;
+
+typedef struct
+{
+    uint32 ulBase;
+    uint32 aulIrq[SIM_ADC_NUM_SEQUENCERS];
+    uint32 ulDmaChannel;                    /* uDMA channel of SS0, SS1-3 follow */
+    uint32 ulRawStatus;                     /* RIS bits */
+    uint32 ulDmaRequests;                   /* Sequencers waiting for the uDMA */
+    uint32 ulOverflow;                      /* OSTAT bits */
+    uint32 ulUnderflow;                     /* USTAT bits */
+    SimAdc_SequencerType axSequencers[SIM_ADC_NUM_SEQUENCERS];
+} SimAdc_ModuleType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const uint32 aulFifoDepth[SIM_ADC_NUM_SEQUENCERS] = { 8u, 4u, 4u, 1u };
+
+static SimAdc_ModuleType axModules[SIM_ADC_NUM_MODULES] =
+{
+    { 0x40038000u, { 14u, 15u, 16u, 17u }, 14u },   /* ADC0 */
+    { 0x40039000u, { 48u, 49u, 50u, 51u }, 24u },   /* ADC1 */
+};
+
+static uint32 aulInputCodes[SIM_ADC_NUM_CHANNELS];
+static SimAdc_StatsType xStats;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+#define ADC_REG(module, offset)      SIM_REG((module)->ulBase + (offset))
+#define SS_REG(module, ss, offset)   ADC_REG(module, SIM_ADC_SS_OFFSET(ss) + (offset))
+
+static void prvStartSequence(SimAdc_ModuleType *pxModule, uint32 ulSeq, uint64 ullNowNs)
+{
+    SimAdc_SequencerType *pxSeq = &pxModule->axSequencers[ulSeq];
+    uint32 ulMux = SS_REG(pxModule, ulSeq, SIM_ADC_SSMUX_OFFSET);
+    uint32 ulCtl = SS_REG(pxModule, ulSeq, SIM_ADC_SSCTL_OFFSET);
+    uint32 ulExtMux = SS_REG(pxModule, ulSeq, SIM_ADC_SSEMUX_OFFSET);
+    uint32 ulAverage = 1u << (ADC_REG(pxModule, SIM_ADC_SAC_OFFSET) & 0x7u);
+    uint32 ulStep;
+    uint32 ulNibble;
+    uint32 ulChannel;
+
+    if ((pxSeq->ullDoneNs != 0u) ||
+        ((ADC_REG(pxModule, SIM_ADC_ACTSS_OFFSET) & (1u << ulSeq)) == 0u))
+    {
+        return;
+    }
+
+    pxSeq->ulResultCount = 0u;
+    pxSeq->bInterrupt = FALSE;
+    for (ulStep = 0; ulStep < aulFifoDepth[ulSeq]; ulStep++)
+    {
+        ulNibble = (ulCtl >> (ulStep * 4u)) & 0xFu;
+        ulChannel = ((ulMux >> (ulStep * 4u)) & 0xFu) | (((ulExtMux >> (ulStep * 4u)) & 0x1u) << 4);
+
+        if (ulNibble & SIM_ADC_SSCTL_TS)
+        {
+            pxSeq->aulResults[pxSeq->ulResultCount++] = SIM_ADC_TEMP_SENSOR_CODE;
+        }
+        else
+        {
+            pxSeq->aulResults[pxSeq->ulResultCount++] =
+                (ulChannel < SIM_ADC_NUM_CHANNELS) ? aulInputCodes[ulChannel] : 0u;
+        }
+        if (ulNibble & SIM_ADC_SSCTL_IE)
+        {
+            pxSeq->bInterrupt = TRUE;
+        }
+        if (ulNibble & SIM_ADC_SSCTL_END)
+        {
+            break;
+        }
+    }
+
+    xStats.ullConversions += (uint64)pxSeq->ulResultCount * ulAverage;
+    pxSeq->ullDoneNs = ullNowNs + ((uint64)pxSeq->ulResultCount * ulAverage * SIM_ADC_SAMPLE_NS);
+}
+
+static void prvCompleteSequence(SimAdc_ModuleType *pxModule, uint32 ulSeq)
+{
+    SimAdc_SequencerType *pxSeq = &pxModule->axSequencers[ulSeq];
+    uint32 ulResult;
+
+    for (ulResult = 0; ulResult < pxSeq->ulResultCount; ulResult++)
+    {
+        if (pxSeq->ulCount == aulFifoDepth[ulSeq])
+        {
+            pxModule->ulOverflow |= (1u << ulSeq);
+            xStats.ullOverflows++;
+            continue;
+        }
+        pxSeq->aulFifo[(pxSeq->ulHead + pxSeq->ulCount) % aulFifoDepth[ulSeq]] =
+            pxSeq->aulResults[ulResult];
+        pxSeq->ulCount++;
+    }
+    if (pxSeq->bInterrupt)
+    {
+        pxModule->ulRawStatus |= (1u << ulSeq);
+        if (ADC_REG(pxModule, SIM_ADC_ACTSS_OFFSET) & SIM_ADC_ACTSS_ADEN(ulSeq))
+        {
+            pxModule->ulDmaRequests |= (1u << ulSeq);
+        }
+    }
+    pxSeq->ullDoneNs = 0u;
+    xStats.ullSequences++;
+}
+
+/* ISC, OSTAT and USTAT: consume a firmware write-1-to-clear, then publish the
+ * current status with the marker set again */
+static void prvSyncClearRegister(SimAdc_ModuleType *pxModule, uint32 ulOffset,
+                                 uint32 *pulStatus, uint32 ulMask)
+{
+    uint32 ulValue;
+
+    do
+    {
+        ulValue = ADC_REG(pxModule, ulOffset);
+        if ((ulValue & SIM_ADC_W1C_MARKER) == 0u)
+        {
+            *pulStatus &= ~ulValue;
+        }
+        else
+        {
+            /* Bits the model did not publish */
+            *pulStatus &= ~(ulValue & ~(ulMask | SIM_ADC_W1C_MARKER));
+        }
+    } while (!SimReg_Publish(pxModule->ulBase + ulOffset, ulValue,
+                             (*pulStatus & ulMask) | SIM_ADC_W1C_MARKER));
+}
+
+/* Hand the completed sequences to the uDMA. Its reads of SSFIFOn come back
+ * through the access hook, so this runs once the registers are up to date. */
+static void prvRequestDma(SimAdc_ModuleType *pxModule)
+{
+    uint32 ulSeq;
+
+    while (pxModule->ulDmaRequests != 0u)
+    {
+        ulSeq = (uint32)__builtin_ctz(pxModule->ulDmaRequests);
+        pxModule->ulDmaRequests &= ~(1u << ulSeq);
+        SimUdma_Request(pxModule->ulDmaChannel + ulSeq, 0u);
+    }
+}
+
+static void prvDmaDone(uint32 ulChannel, uint32 ulEncoding)
+{
+    uint32 ulModule;
+    uint32 ulSeq;
+
+    (void)ulEncoding;
+    for (ulModule = 0; ulModule < SIM_ADC_NUM_MODULES; ulModule++)
+    {
+        ulSeq = ulChannel - axModules[ulModule].ulDmaChannel;
+        if (ulSeq < SIM_ADC_NUM_SEQUENCERS)
+        {
+            axModules[ulModule].ulRawStatus |= SIM_ADC_INT_DMA(ulSeq);
+        }
+    }
+}
+
+static void prvConsumeWrites(SimAdc_ModuleType *pxModule, uint64 ullNowNs)
+{
+    uint32 ulValue;
+    uint32 ulSeq;
+
+    /* PSSI is write-only and reads back as zero */
+    ulValue = SimReg_Take(pxModule->ulBase + SIM_ADC_PSSI_OFFSET);
+    for (ulSeq = 0; ulSeq < SIM_ADC_NUM_SEQUENCERS; ulSeq++)
+    {
+        if ((ulValue & (1u << ulSeq)) &&
+            (((ADC_REG(pxModule, SIM_ADC_EMUX_OFFSET) >> (ulSeq * 4u)) & 0xFu) == SIM_ADC_EMUX_PROCESSOR))
+        {
+            prvStartSequence(pxModule, ulSeq, ullNowNs);
+        }
+    }
+}
+
+static void prvUpdateModule(SimAdc_ModuleType *pxModule, uint64 ullNowNs)
+{
+    SimAdc_SequencerType *pxSeq;
+    uint32 ulSeq;
+    uint32 ulBusy = 0u;
+    uint32 ulStatus;
+
+    prvConsumeWrites(pxModule, ullNowNs);
+    prvSyncClearRegister(pxModule, SIM_ADC_ISC_OFFSET, &pxModule->ulRawStatus, 0u);
+
+    for (ulSeq = 0; ulSeq < SIM_ADC_NUM_SEQUENCERS; ulSeq++)
+    {
+        pxSeq = &pxModule->axSequencers[ulSeq];
+        if ((pxSeq->ullDoneNs != 0u) && (ullNowNs >= pxSeq->ullDoneNs))
+        {
+            prvCompleteSequence(pxModule, ulSeq);
+        }
+        if (pxSeq->ullDoneNs != 0u)
+        {
+            ulBusy = SIM_ADC_ACTSS_BUSY;
+        }
+
+        ulStatus = (pxSeq->ulCount == 0u) ? SIM_ADC_SSFSTAT_EMPTY : 0u;
+        if (pxSeq->ulCount == aulFifoDepth[ulSeq])
+        {
+            ulStatus |= SIM_ADC_SSFSTAT_FULL;
+        }
+        ulStatus |= ((pxSeq->ulHead + pxSeq->ulCount) % aulFifoDepth[ulSeq]) << 4;   /* HPTR */
+        ulStatus |= pxSeq->ulHead;                                                   /* TPTR */
+        SS_REG(pxModule, ulSeq, SIM_ADC_SSFSTAT_OFFSET) = ulStatus;
+    }
+
+    if (ulBusy)
+    {
+        __atomic_fetch_or(&ADC_REG(pxModule, SIM_ADC_ACTSS_OFFSET), SIM_ADC_ACTSS_BUSY, __ATOMIC_SEQ_CST);
+    }
+    else
+    {
+        __atomic_fetch_and(&ADC_REG(pxModule, SIM_ADC_ACTSS_OFFSET), ~SIM_ADC_ACTSS_BUSY, __ATOMIC_SEQ_CST);
+    }
+    prvRequestDma(pxModule);
+    prvSyncClearRegister(pxModule, SIM_ADC_ISC_OFFSET, &pxModule->ulRawStatus, 0u);
+    prvSyncClearRegister(pxModule, SIM_ADC_OSTAT_OFFSET, &pxModule->ulOverflow, 0xFu);
+    prvSyncClearRegister(pxModule, SIM_ADC_USTAT_OFFSET, &pxModule->ulUnderflow, 0xFu);
+    ADC_REG(pxModule, SIM_ADC_RIS_OFFSET) = pxModule->ulRawStatus;
+}
+
+static void prvUpdateInterrupts(SimAdc_ModuleType *pxModule)
+{
+    uint32 ulSeq;
+
+    for (ulSeq = 0; ulSeq < SIM_ADC_NUM_SEQUENCERS; ulSeq++)
+    {
+        SimNvic_Update(pxModule->aulIrq[ulSeq]);
+    }
+}
+
+static void prvPopFifo(SimAdc_ModuleType *pxModule, uint32 ulSeq)
+{
+    SimAdc_SequencerType *pxSeq = &pxModule->axSequencers[ulSeq];
+
+    if (pxSeq->ulCount == 0u)
+    {
+        /* Reading an empty FIFO is an underflow; the data is undefined */
+        pxModule->ulUnderflow |= (1u << ulSeq);
+        return;
+    }
+    SS_REG(pxModule, ulSeq, SIM_ADC_SSFIFO_OFFSET) = pxSeq->aulFifo[pxSeq->ulHead];
+    pxSeq->ulHead = (pxSeq->ulHead + 1u) % aulFifoDepth[ulSeq];
+    pxSeq->ulCount--;
+}
+
+static SimAdc_ModuleType *prvModuleFromAddress(uint32 ulAddress)
+{
+    uint32 ulModule;
+
+    for (ulModule = 0; ulModule < SIM_ADC_NUM_MODULES; ulModule++)
+    {
+        if ((ulAddress - axModules[ulModule].ulBase) < SIM_ADC_BLOCK_SIZE)
+        {
+            return &axModules[ulModule];
+        }
+    }
+    return NULL_PTR;
+}
+
+static void prvAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    SimAdc_ModuleType *pxModule = prvModuleFromAddress(ulAddress);
+    uint32 ulOffset = ulAddress - pxModule->ulBase;
+    uint32 ulSeq;
+
+    prvUpdateModule(pxModule, ullNowNs);
+
+    /* A read of SSFIFOn pops the oldest result */
+    for (ulSeq = 0; ulSeq < SIM_ADC_NUM_SEQUENCERS; ulSeq++)
+    {
+        if (ulOffset == (SIM_ADC_SS_OFFSET(ulSeq) + SIM_ADC_SSFIFO_OFFSET))
+        {
+            prvPopFifo(pxModule, ulSeq);
+            prvUpdateModule(pxModule, ullNowNs);
+        }
+    }
+    prvUpdateInterrupts(pxModule);
+}
+
+static boolean prvInterruptLevel(uint32 ulIrq)
+{
+    uint32 ulModule;
+    uint32 ulSeq;
+    SimAdc_ModuleType *pxModule;
+
+    for (ulModule = 0; ulModule < SIM_ADC_NUM_MODULES; ulModule++)
+    {
+        pxModule = &axModules[ulModule];
+        for (ulSeq = 0; ulSeq < SIM_ADC_NUM_SEQUENCERS; ulSeq++)
+        {
+            if (pxModule->aulIrq[ulSeq] == ulIrq)
+            {
+                prvUpdateModule(pxModule, SimReg_NowNs());
+                return ((pxModule->ulRawStatus & ADC_REG(pxModule, SIM_ADC_IM_OFFSET)
+                         & ((1u << ulSeq) | SIM_ADC_INT_DMA(ulSeq))) != 0u);
+            }
+        }
+    }
+    return FALSE;
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimAdc_Init(void)
+{
+    uint32 ulModule;
+    uint32 ulSeq;
+
+    for (ulModule = 0; ulModule < SIM_ADC_NUM_MODULES; ulModule++)
+    {
+        for (ulSeq = 0; ulSeq < SIM_ADC_NUM_SEQUENCERS; ulSeq++)
+        {
+            SimNvic_SetSource(axModules[ulModule].aulIrq[ulSeq], prvInterruptLevel);
+            SimUdma_SetPeripheral(axModules[ulModule].ulDmaChannel + ulSeq, 0u, prvDmaDone);
+        }
+        prvUpdateModule(&axModules[ulModule], SimReg_NowNs());
+        SimReg_RegisterHook(axModules[ulModule].ulBase, SIM_ADC_BLOCK_SIZE, prvAccessHook);
+    }
+}
+
+void SimAdc_SetInput(uint32 ulChannel, uint32 ulMillivolts)
+{
+    SimAdc_SetInputMicrovolts(ulChannel, ulMillivolts * 1000u);
+}
+
+void SimAdc_SetInputMicrovolts(uint32 ulChannel, uint32 ulMicrovolts)
+{
+    uint64 ullCode;
+
+    if (ulChannel >= SIM_ADC_NUM_CHANNELS)
+    {
+        return;
+    }
+    ullCode = ((uint64)ulMicrovolts * (SIM_ADC_FULL_SCALE + 1u)) / (SIM_ADC_VREF_MV * 1000ull);
+    SimReg_Lock();
+    aulInputCodes[ulChannel] = (ullCode > SIM_ADC_FULL_SCALE) ? SIM_ADC_FULL_SCALE : (uint32)ullCode;
+    SimReg_Unlock();
+}
+
+void SimAdc_TimerTrigger(uint64 ullNowNs)
+{
+    uint32 ulModule;
+    uint32 ulSeq;
+    SimAdc_ModuleType *pxModule;
+
+    for (ulModule = 0; ulModule < SIM_ADC_NUM_MODULES; ulModule++)
+    {
+        pxModule = &axModules[ulModule];
+        prvUpdateModule(pxModule, ullNowNs);
+        for (ulSeq = 0; ulSeq < SIM_ADC_NUM_SEQUENCERS; ulSeq++)
+        {
+            if (((ADC_REG(pxModule, SIM_ADC_EMUX_OFFSET) >> (ulSeq * 4u)) & 0xFu) == SIM_ADC_EMUX_TIMER)
+            {
+                /* A trigger while the sequencer still runs is lost */
+                prvStartSequence(pxModule, ulSeq, ullNowNs);
+            }
+        }
+        prvUpdateInterrupts(pxModule);
+    }
+}
+
+void SimAdc_Service(uint64 ullNowNs)
+{
+    uint32 ulModule;
+
+    for (ulModule = 0; ulModule < SIM_ADC_NUM_MODULES; ulModule++)
+    {
+        prvUpdateModule(&axModules[ulModule], ullNowNs);
+        prvUpdateInterrupts(&axModules[ulModule]);
+    }
+}
+
+uint64 SimAdc_NextDeadline(uint64 ullNowNs)
+{
+    uint64 ullNext = 0xFFFFFFFFFFFFFFFFull;
+    uint32 ulModule;
+    uint32 ulSeq;
+    uint64 ullDone;
+
+    (void)ullNowNs;
+    for (ulModule = 0; ulModule < SIM_ADC_NUM_MODULES; ulModule++)
+    {
+        for (ulSeq = 0; ulSeq < SIM_ADC_NUM_SEQUENCERS; ulSeq++)
+        {
+            ullDone = axModules[ulModule].axSequencers[ulSeq].ullDoneNs;
+            if ((ullDone != 0u) && (ullDone < ullNext))
+            {
+                ullNext = ullDone;
+            }
+        }
+    }
+    return ullNext;
+}
+
+void SimAdc_GetStats(SimAdc_StatsType *pxStats)
+{
+    SimReg_Lock();
+    *pxStats = xStats;
+    SimReg_Unlock();
+}
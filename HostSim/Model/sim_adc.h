@@ -0,0 +1,60 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - ADC
+ *
+ * File Name: sim_adc.h
+ *
+ * Description: Header for the simulated ADC0/ADC1 modules of the Linux host
+ *              build
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_ADC_H_
+#define SIM_ADC_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_ADC_NUM_MODULES     2u
+#define SIM_ADC_NUM_CHANNELS    12u     /* AIN0 - AIN11 */
+#define SIM_ADC_VREF_MV         3300u
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint64 ullConversions;      /* Samples taken, before hardware averaging */
+    uint64 ullSequences;        /* Completed sample sequences */
+    uint64 ullOverflows;        /* Results lost to a full sequencer FIFO */
+} SimAdc_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void SimAdc_Init(void);
+
+/* Set the voltage on an analog input pin */
+extern void SimAdc_SetInput(uint32 ulChannel, uint32 ulMillivolts);
+
+/* The same in microvolts, for inputs driven by a model rather than a setting */
+extern void SimAdc_SetInputMicrovolts(uint32 ulChannel, uint32 ulMicrovolts);
+
+extern void SimAdc_Service(uint64 ullNowNs);
+
+/* A GPTM time-out with its ADC trigger output enabled (model locked) */
+extern void SimAdc_TimerTrigger(uint64 ullNowNs);
+
+/* Host time at which the next running sequence completes */
+extern uint64 SimAdc_NextDeadline(uint64 ullNowNs);
+
+extern void SimAdc_GetStats(SimAdc_StatsType *pxStats);
+
+#endif /* SIM_ADC_H_ */
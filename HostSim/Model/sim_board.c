@@ -0,0 +1,655 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Board
+ *
+ * File Name: sim_board.c
+ *
+ * Description: Puts the simulated TM4C123 on a virtual seat heater board.
+ *              Brings up the peripheral models before main() runs, drives the
+ *              LM35 inputs and the two push buttons, advances the models
+ *              from a service thread and prints a measurement report when
+ *              the run ends. The run is configured from the environment:
+ *
+ *                SIM_DURATION_MS      run time, 0 runs until killed (10000)
+ *                SIM_AIN0_MV          driver LM35 output on PE3 (20)
+ *                SIM_AIN1_MV          passenger LM35 output on PE2 (25)
+ *                SIM_SW1_PERIOD_MS    SW1 (PF4) press period, 0 = never (1500)
+ *                SIM_SW2_PERIOD_MS    SW2 (PF0) press period, 0 = never (2300)
+ *                SIM_SW1_HOLD_MS      how long SW1 is held per click (100)
+ *                SIM_SW2_HOLD_MS      how long SW2 is held per click (100)
+ *                SIM_SW1_CLICKS       clicks per SW1 press, 150 ms apart (1)
+ *                SIM_SW2_CLICKS       clicks per SW2 press, 150 ms apart (1)
+ *                SIM_SW_BOUNCES       contact bounces on every button edge (4)
+ *                SIM_EEPROM_FILE      EEPROM image loaded at start, saved at end
+ *                SIM_HEATER_RISE_C    seat temperature rise at full heater power (20)
+ *                SIM_SEAT_TAU_MS      seat thermal time constant (5000)
+ *                SIM_SEAT_BAND_C      distance from the desired temperature that
+ *                                     counts as reached, in tenths (15)
+ *
+ *              The default sensor inputs land inside the 5..40 window the
+ *              firmware accepts for its raw ADC readings, so the normal
+ *              control path runs rather than the sensor error path. Each
+ *              button edge is followed by SIM_SW_BOUNCES short returns to
+ *              the old level, 250 us apart, like a worn tactile switch.
+ *              The SIM_AINx_MV inputs are the ambient temperature of the
+ *              seats, which heat up from there with their heater duty.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "TypeDef.h"
+#include "gpio_debounce.h"
+#include "heater.h"
+#include "runtime_stats.h"
+#include "trace.h"
+#include "log.h"
+#include "pool.h"
+#include "sim_adc.h"
+#include "sim_dwt.h"
+#include "sim_eeprom.h"
+#include "sim_gpio.h"
+#include "sim_gptm.h"
+#include "sim_nvic.h"
+#include "sim_pwm.h"
+#include "sim_registers.h"
+#include "sim_seat.h"
+#include "sim_sysctl.h"
+#include "sim_uart.h"
+#include "sim_udma.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_SERVICE_PERIOD_NS    1000000ull     /* Model update without deadlines */
+#define SIM_BUTTON_BOUNCE_NS     250000ull      /* Between contact bounces */
+#define SIM_BUTTON_CLICK_GAP_NS  150000000ull   /* Between clicks of one press */
+#define SIM_NS_PER_MS            1000000ull
+
+#define SIM_SW1_PIN              4u
+#define SIM_SW2_PIN              0u
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulPin;
+    uint64 ullPeriodNs;
+    uint64 ullHoldNs;
+    uint32 ulClicks;
+    uint64 ullNextPressNs;      /* Start of the next press */
+    uint64 ullNextClickNs;      /* Next click of this press, 0 if none is left */
+    uint64 ullReleaseNs;        /* 0 while released */
+    uint32 ulClicksLeft;
+    boolean bPressed;
+    uint32 ulBouncesLeft;       /* Level toggles still to come */
+    uint64 ullBounceNs;
+    uint64 ullPresses;
+    uint64 ullClicks;
+} SimBoard_ButtonType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint64 ullStartNs;
+static uint64 ullDurationNs;
+static const char *pcEepromFile = NULL_PTR;
+static SimBoard_ButtonType axButtons[2];
+static uint32 ulBounces;
+
+/* Desired temperatures of the firmware, a lock-free copy from main.c */
+extern void vSeatTableSnapshot(SeatTableType *pxSnapshot);
+
+#if NUM_SEATS != SIM_SEAT_NUM_SEATS
+#error "The seat model needs one seat per firmware seat"
+#endif
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint64 prvEnvOrDefault(const char *pcName, uint64 ullDefault)
+{
+    const char *pcValue = getenv(pcName);
+
+    return (pcValue != NULL_PTR) ? strtoull(pcValue, NULL_PTR, 0) : ullDefault;
+}
+
+static void prvLoadEeprom(void)
+{
+    FILE *pxFile;
+    uint32 ulWord;
+    uint32 ulValue;
+
+    pxFile = (pcEepromFile != NULL_PTR) ? fopen(pcEepromFile, "rb") : NULL_PTR;
+    if (pxFile == NULL_PTR)
+    {
+        return;
+    }
+    for (ulWord = 0; ulWord < SIM_EEPROM_NUM_WORDS; ulWord++)
+    {
+        if (fread(&ulValue, sizeof(ulValue), 1, pxFile) != 1u)
+        {
+            break;
+        }
+        SimEeprom_WriteWord(ulWord, ulValue);
+    }
+    fclose(pxFile);
+}
+
+static void prvSaveEeprom(void)
+{
+    FILE *pxFile;
+    uint32 ulWord;
+    uint32 ulValue;
+
+    pxFile = (pcEepromFile != NULL_PTR) ? fopen(pcEepromFile, "wb") : NULL_PTR;
+    if (pxFile == NULL_PTR)
+    {
+        return;
+    }
+    for (ulWord = 0; ulWord < SIM_EEPROM_NUM_WORDS; ulWord++)
+    {
+        ulValue = SimEeprom_ReadWord(ulWord);
+        (void)fwrite(&ulValue, sizeof(ulValue), 1, pxFile);
+    }
+    fclose(pxFile);
+}
+
+/* The LaunchPad buttons pull the pin low while pressed */
+static void prvSetButton(SimBoard_ButtonType *pxButton, boolean bPressed, uint64 ullNowNs)
+{
+    pxButton->bPressed = bPressed;
+    SimGpio_SetInput(SIM_GPIO_PORTF, pxButton->ulPin, bPressed ? LOGIC_LOW : LOGIC_HIGH);
+    pxButton->ulBouncesLeft = 2u * ulBounces;
+    pxButton->ullBounceNs = ullNowNs + SIM_BUTTON_BOUNCE_NS;
+}
+
+static void prvServiceButtons(uint64 ullNowNs)
+{
+    uint32 ulButton;
+    SimBoard_ButtonType *pxButton;
+    boolean bLevel;
+
+    for (ulButton = 0; ulButton < 2u; ulButton++)
+    {
+        pxButton = &axButtons[ulButton];
+        if (pxButton->ullPeriodNs == 0u)
+        {
+            continue;
+        }
+
+        /* Odd toggles go back to the old level, the last one settles */
+        if ((pxButton->ulBouncesLeft != 0u) && (ullNowNs >= pxButton->ullBounceNs))
+        {
+            bLevel = ((pxButton->ulBouncesLeft & 1u) == 0u) ? !pxButton->bPressed : pxButton->bPressed;
+            SimGpio_SetInput(SIM_GPIO_PORTF, pxButton->ulPin, bLevel ? LOGIC_LOW : LOGIC_HIGH);
+            pxButton->ulBouncesLeft--;
+            pxButton->ullBounceNs += SIM_BUTTON_BOUNCE_NS;
+        }
+
+        if ((pxButton->ullReleaseNs != 0u) && (ullNowNs >= pxButton->ullReleaseNs))
+        {
+            prvSetButton(pxButton, FALSE, ullNowNs);
+            pxButton->ullReleaseNs = 0u;
+            pxButton->ullNextClickNs = (pxButton->ulClicksLeft != 0u) ? (ullNowNs + SIM_BUTTON_CLICK_GAP_NS) : 0u;
+        }
+        if ((pxButton->ullNextPressNs != 0u) && (ullNowNs >= pxButton->ullNextPressNs))
+        {
+            pxButton->ulClicksLeft = pxButton->ulClicks;
+            pxButton->ullNextClickNs = ullNowNs;
+            pxButton->ullNextPressNs += pxButton->ullPeriodNs;
+            pxButton->ullPresses++;
+        }
+        if ((pxButton->ullNextClickNs != 0u) && (ullNowNs >= pxButton->ullNextClickNs) &&
+            (pxButton->ullReleaseNs == 0u))
+        {
+            prvSetButton(pxButton, TRUE, ullNowNs);
+            pxButton->ullReleaseNs = ullNowNs + pxButton->ullHoldNs;
+            pxButton->ullNextClickNs = 0u;
+            pxButton->ulClicksLeft--;
+            pxButton->ullClicks++;
+        }
+    }
+}
+
+static uint64 prvButtonsNextDeadline(void)
+{
+    uint32 ulButton;
+    uint64 ullNext = ~0ull;
+
+    for (ulButton = 0; ulButton < 2u; ulButton++)
+    {
+        if ((axButtons[ulButton].ulBouncesLeft != 0u) && (axButtons[ulButton].ullBounceNs < ullNext))
+        {
+            ullNext = axButtons[ulButton].ullBounceNs;
+        }
+    }
+    return ullNext;
+}
+
+static uint64 prvNextWakeNs(uint64 ullNowNs)
+{
+    uint64 ullNext = ullNowNs + SIM_SERVICE_PERIOD_NS;
+    uint64 ullDeadline;
+
+    ullDeadline = prvButtonsNextDeadline();
+    if (ullDeadline < ullNext)
+    {
+        ullNext = ullDeadline;
+    }
+
+    SimReg_Lock();
+    ullDeadline = SimGptm_NextDeadline(ullNowNs);
+    if (ullDeadline < ullNext)
+    {
+        ullNext = ullDeadline;
+    }
+    ullDeadline = SimAdc_NextDeadline(ullNowNs);
+    if (ullDeadline < ullNext)
+    {
+        ullNext = ullDeadline;
+    }
+    ullDeadline = SimUart_NextDeadline(ullNowNs);
+    if (ullDeadline < ullNext)
+    {
+        ullNext = ullDeadline;
+    }
+    ullDeadline = SimEeprom_NextDeadline(ullNowNs);
+    if (ullDeadline < ullNext)
+    {
+        ullNext = ullDeadline;
+    }
+    ullDeadline = SimPwm_NextDeadline(ullNowNs);
+    if (ullDeadline < ullNext)
+    {
+        ullNext = ullDeadline;
+    }
+    SimReg_Unlock();
+
+    return ullNext;
+}
+
+static void *prvServiceThread(void *pvParameters)
+{
+    struct timespec xWake;
+    uint64 ullNow;
+    uint64 ullNext;
+    uint32 ulSeat;
+    SeatTableType xSeats;
+
+    (void)pvParameters;
+    for (;;)
+    {
+        ullNow = SimReg_NowNs();
+        if ((ullDurationNs != 0u) && ((ullNow - ullStartNs) >= ullDurationNs))
+        {
+            exit(EXIT_SUCCESS);
+        }
+
+        prvServiceButtons(ullNow);
+
+        SimReg_Lock();
+        SimGptm_Service(ullNow);
+        SimAdc_Service(ullNow);
+        SimUart_Service(ullNow);
+        SimEeprom_Service(ullNow);
+        SimPwm_Service(ullNow);
+        vSeatTableSnapshot(&xSeats);
+        for (ulSeat = 0; ulSeat < NUM_SEATS; ulSeat++)
+        {
+            SimSeat_SetTarget(ulSeat, (uint32)xSeats.DesiredTemperature[ulSeat], ullNow);
+        }
+        SimSeat_Service(ullNow);
+        SimGpio_Service(ullNow);
+        SimNvic_Service(ullNow);
+        SimReg_Unlock();
+
+        ullNext = prvNextWakeNs(ullNow);
+        xWake.tv_sec = (time_t)(ullNext / 1000000000ull);
+        xWake.tv_nsec = (long)(ullNext % 1000000000ull);
+        (void)clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &xWake, NULL_PTR);
+    }
+
+    return NULL_PTR;
+}
+
+static double prvMeanUs(uint64 ullTotalNs, uint64 ullCount)
+{
+    return (ullCount != 0u) ? ((double)ullTotalNs / (double)ullCount) / 1000.0 : 0.0;
+}
+
+static double prvPerClick(uint64 ullCount, uint64 ullClicks)
+{
+    return (ullClicks != 0u) ? ((double)ullCount / (double)ullClicks) : 0.0;
+}
+
+static double prvCyclesUs(uint64 ullCycles)
+{
+    return (double)ullCycles / (double)(configCPU_CLOCK_HZ / 1000000u);
+}
+
+/* The firmware's own view from the DWT cycle counter, tag 0 is the idle task.
+ * The load is the tasks' run time over the whole run: the firmware's window
+ * would miss the idle stretch still in progress when the run ends. */
+static void prvReportTasks(double dRunS)
+{
+    RunTimeStats_TaskType xTask;
+    uint32 ulTag;
+    uint32 ulBucket;
+    uint64 ullBusy = 0u;
+
+    for (ulTag = 1; ulTag <= NUMBER_OF_TASKS; ulTag++)
+    {
+        RunTimeStats_GetTask(ulTag, &xTask);
+        ullBusy += xTask.RunTime;
+    }
+    fprintf(stderr, "CPU load (DWT)      : %.2f %%\n",
+            (dRunS > 0.0) ? ((100.0 * prvCyclesUs(ullBusy)) / (dRunS * 1e6)) : 0.0);
+    fprintf(stderr, "interrupts masked   : %.1f us at most by a critical section\n",
+            prvCyclesUs(RunTimeStats_GetMaskedMax()));
+    for (ulTag = 0; ulTag <= NUMBER_OF_TASKS; ulTag++)
+    {
+        RunTimeStats_GetTask(ulTag, &xTask);
+        if (ulTag == 0u)
+        {
+            fprintf(stderr, "task 0 (idle)       : ran %.1f ms\n", prvCyclesUs(xTask.RunTime) / 1000.0);
+            continue;
+        }
+        fprintf(stderr, "task %u              : ran %.1f ms, %u activations, execution min %.1f mean %.1f "
+                "max %.1f us, response min %.1f max %.1f us, histogram",
+                ulTag, prvCyclesUs(xTask.RunTime) / 1000.0, xTask.Activations,
+                prvCyclesUs(xTask.ExecutionMin),
+                (xTask.Activations != 0u) ? prvCyclesUs(xTask.ExecutionTotal) / (double)xTask.Activations : 0.0,
+                prvCyclesUs(xTask.ExecutionMax), prvCyclesUs(xTask.ResponseMin), prvCyclesUs(xTask.ResponseMax));
+        for (ulBucket = 0; ulBucket < RUNTIME_STATS_BUCKETS; ulBucket++)
+        {
+            if (xTask.ResponseHistogram[ulBucket] != 0u)
+            {
+                /* Labelled with the bucket's lower bound, bucket 0 starts at zero */
+                fprintf(stderr, " %.0fus:%u",
+                        (ulBucket == 0u) ? 0.0 : prvCyclesUs(1ull << (RUNTIME_STATS_HISTOGRAM_SHIFT + ulBucket)),
+                        xTask.ResponseHistogram[ulBucket]);
+            }
+        }
+        fprintf(stderr, "\n");
+        if (xTask.DeadlineMs != 0u)
+        {
+            /* Headroom of the worst job seen against the declared deadline */
+            fprintf(stderr, "  deadline          : %u ms, period %u ms, %u misses, WCET %.1f us, %.1f %% of the deadline\n",
+                    xTask.DeadlineMs, xTask.PeriodMs, xTask.DeadlineMisses, prvCyclesUs(xTask.ExecutionMax),
+                    prvCyclesUs(xTask.ExecutionMax) / (10.0 * (double)xTask.DeadlineMs));
+        }
+    }
+}
+
+/* Kernel objects that were taken at least once, by queue number */
+static void prvReportObjects(void)
+{
+    RunTimeStats_ObjectType xObject;
+    uint32 ulObject;
+
+    for (ulObject = 1; ulObject < RUNTIME_STATS_MAX_OBJECTS; ulObject++)
+    {
+        RunTimeStats_GetObject(ulObject, &xObject);
+        if ((xObject.Takes == 0u) && (xObject.Failed == 0u))
+        {
+            continue;
+        }
+        fprintf(stderr, "object %u %-11s: %u takes, %u contended, %u failed, wait mean %.1f max %.1f us, "
+                "hold max %.1f us, %u priority inheritances\n",
+                ulObject, (xObject.Name != NULL_PTR) ? xObject.Name : "", xObject.Takes, xObject.Contended,
+                xObject.Failed,
+                (xObject.Contended != 0u) ? prvCyclesUs(xObject.WaitTotal) / (double)xObject.Contended : 0.0,
+                prvCyclesUs(xObject.WaitMax), prvCyclesUs(xObject.HoldMax), xObject.Inheritances);
+    }
+}
+
+static void prvReportPools(void)
+{
+    static const char *const apcClassNames[POOL_NUM_CLASSES] = { "messages", "frames" };
+    Pool_StatsType xPool;
+    uint32 ulClass;
+
+    for (ulClass = 0; ulClass < POOL_NUM_CLASSES; ulClass++)
+    {
+        Pool_GetStats((Pool_ClassType)ulClass, &xPool);
+        fprintf(stderr, "pool %-15s: %u allocations, %u failed, high water %u of %u blocks of %u bytes\n",
+                apcClassNames[ulClass], xPool.Allocated, xPool.Failed, xPool.MaxUsed, xPool.Blocks,
+                xPool.BlockSize);
+    }
+}
+
+static void prvReport(void)
+{
+    PortSimulationStats_t xPort;
+    PortTicklessStats_t xTickless;
+    SimUart_StatsType xUart;
+    SimAdc_StatsType xAdc;
+    SimUdma_StatsType xUdma;
+    SimEeprom_StatsType xEeprom;
+    double dRunS;
+    double dUartS;
+    GPIO_DebounceStatsType xDebounce;
+    SimPwm_StatsType xPwm;
+    SimSeat_StatsType xSeat;
+    Heater_StatsType xHeater;
+    Trace_StatsType xTrace;
+    Log_StatsType xLog;
+    uint32 ulSeat;
+    static const char *const apcSeatNames[SIM_SEAT_NUM_SEATS] = { "driver   ", "passenger" };
+    uint32 ulWord;
+    uint32 ulMaxWear = 0u;
+    uint64 ullClicks;
+    uint64 ullTimerIsrs;
+    uint64 ullButtonIsrs;
+    uint64 ullGestures;
+
+    SimReg_Lock();
+    SimUart_Service(SimReg_NowNs());
+    SimUart_Flush();
+    SimReg_Unlock();
+
+    vPortGetSimulationStats(&xPort);
+    vPortGetTicklessStats(&xTickless);
+    SimUart_GetStats(&xUart);
+    SimAdc_GetStats(&xAdc);
+    SimUdma_GetStats(&xUdma);
+    SimEeprom_GetStats(&xEeprom);
+    GPIO_DebounceGetStats(&xDebounce);
+    SimPwm_GetStats(&xPwm);
+    Heater_GetStats(&xHeater);
+    Trace_GetStats(&xTrace);
+    Log_GetStats(&xLog);
+    for (ulWord = 0; ulWord < SIM_EEPROM_NUM_WORDS; ulWord++)
+    {
+        if (xEeprom.aulWritesPerWord[ulWord] > ulMaxWear)
+        {
+            ulMaxWear = xEeprom.aulWritesPerWord[ulWord];
+        }
+    }
+
+    /* Every gesture is one notification of the input dispatcher */
+    ullClicks = axButtons[0].ullClicks + axButtons[1].ullClicks;
+    ullTimerIsrs = SimNvic_GetDispatchCount(21u) + SimNvic_GetDispatchCount(23u);
+    ullButtonIsrs = SimNvic_GetDispatchCount(30u) + ullTimerIsrs;
+    ullGestures = (uint64)xDebounce.Gestures[GPIO_GESTURE_SHORT_PRESS] +
+                  xDebounce.Gestures[GPIO_GESTURE_LONG_PRESS] + xDebounce.Gestures[GPIO_GESTURE_DOUBLE_CLICK];
+
+    dRunS = (double)xPort.ullRunNs / 1e9;
+    dUartS = (double)(xUart.ullLastTxNs - xUart.ullFirstTxNs) / 1e9;
+
+    fprintf(stderr, "\n===== HostSim report =====\n");
+    fprintf(stderr, "run time            : %.3f s\n", dRunS);
+    fprintf(stderr, "ticks               : %llu\n", (uint64)xPort.ullTicks);
+    fprintf(stderr, "context switches    : %llu\n", (uint64)xPort.ullContextSwitches);
+    fprintf(stderr, "tickless sleeps     : %u (%u timer, %u early wakeups), %u aborted, "
+            "%u ticks suppressed, asleep %.1f %% of the run\n",
+            xTickless.ulSleeps, xTickless.ulTimerWakeups, xTickless.ulEarlyWakeups, xTickless.ulAborted,
+            xTickless.ulTicksSuppressed,
+            (xPort.ullRunNs != 0u) ? ((100.0 * (double)xTickless.ullSleepCounts * 1e9 / configCPU_CLOCK_HZ) /
+                                      (double)xPort.ullRunNs) : 0.0);
+    fprintf(stderr, "tickless residency  : 0:%u 1:%u 2-3:%u 4-7:%u 8-15:%u 16-31:%u 32-63:%u 64+:%u ticks, "
+            "compensation error %d counts total, %u max\n",
+            xTickless.aulResidency[0], xTickless.aulResidency[1], xTickless.aulResidency[2],
+            xTickless.aulResidency[3], xTickless.aulResidency[4], xTickless.aulResidency[5],
+            xTickless.aulResidency[6], xTickless.aulResidency[7],
+            xTickless.lCompensationError, xTickless.ulMaxCompensationError);
+    fprintf(stderr, "CPU load            : %.2f %%\n",
+            (xPort.ullRunNs != 0u) ? (100.0 * (1.0 - ((double)xPort.ullIdleNs / (double)xPort.ullRunNs))) : 0.0);
+    prvReportTasks(dRunS);
+    prvReportObjects();
+    prvReportPools();
+    fprintf(stderr, "kernel trace        : %u events recorded, %u dropped, ring high water %u of %u records\n",
+            xTrace.Recorded, xTrace.Dropped, xTrace.MaxUsed, TRACE_BUFFER_RECORDS);
+    fprintf(stderr, "deferred log        : %u messages written, %u dropped, ring high water %u of %u records\n",
+            xLog.Written, xLog.Dropped, xLog.MaxUsed, LOG_RING_RECORDS);
+    fprintf(stderr, "interrupts          : %llu, latency mean %.1f us max %.1f us\n",
+            (uint64)xPort.ullInterrupts,
+            prvMeanUs(xPort.ullInterruptLatencyTotalNs, xPort.ullInterrupts),
+            (double)xPort.ullInterruptLatencyMaxNs / 1000.0);
+    fprintf(stderr, "ISR to task wakeups : %llu, latency mean %.1f us max %.1f us\n",
+            (uint64)xPort.ullWakeups,
+            prvMeanUs(xPort.ullWakeupLatencyTotalNs, xPort.ullWakeups),
+            (double)xPort.ullWakeupLatencyMaxNs / 1000.0);
+    fprintf(stderr, "button clicks       : %llu (SW1 %llu, SW2 %llu), %u bounces per edge\n",
+            ullClicks, axButtons[0].ullClicks, axButtons[1].ullClicks, ulBounces);
+    fprintf(stderr, "button ISRs         : %llu port F, %llu debounce timer, %.2f per click\n",
+            ullButtonIsrs - ullTimerIsrs, ullTimerIsrs, prvPerClick(ullButtonIsrs, ullClicks));
+    fprintf(stderr, "button gestures     : %u short, %u long, %u double, %u glitches, "
+            "%.2f dispatcher wakeups per click\n",
+            xDebounce.Gestures[GPIO_GESTURE_SHORT_PRESS], xDebounce.Gestures[GPIO_GESTURE_LONG_PRESS],
+            xDebounce.Gestures[GPIO_GESTURE_DOUBLE_CLICK], xDebounce.Glitches,
+            prvPerClick(ullGestures, ullClicks));
+    fprintf(stderr, "UART0 TX            : %llu bytes at %u baud, %llu dropped\n",
+            xUart.ullTxBytes, xUart.ulBaudRate, xUart.ullTxDropped);
+    if ((dUartS > 0.0) && (xUart.ulBaudRate != 0u))
+    {
+        fprintf(stderr, "UART0 throughput    : %.0f B/s, line busy %.1f %% of the run\n",
+                (double)xUart.ullTxBytes / dUartS,
+                (100.0 * (double)xUart.ullTxBytes * 10.0 / (double)xUart.ulBaudRate) / dRunS);
+    }
+    fprintf(stderr, "ADC                 : %llu sequences, %llu conversions, %llu overflows\n",
+            xAdc.ullSequences, xAdc.ullConversions, xAdc.ullOverflows);
+    fprintf(stderr, "uDMA                : %llu requests, %llu items, %llu transfers done, %llu missed\n",
+            xUdma.ullRequests, xUdma.ullItems, xUdma.ullCompletions, xUdma.ullMissed);
+    fprintf(stderr, "EEPROM              : %llu words written, %llu read, busy %.3f ms, "
+            "max wear %u, %llu bad block selects, %llu program-done ISRs\n",
+            xEeprom.ullWordWrites, xEeprom.ullWordReads, (double)xEeprom.ullBusyNs / 1e6,
+            ulMaxWear, xEeprom.ullBadBlocks, SimNvic_GetDispatchCount(29u));
+    fprintf(stderr, "PWM0                : %llu periods, %llu updates, %llu mid-period glitches\n",
+            xPwm.ullPeriods, xPwm.ullUpdates, xPwm.ullGlitches);
+    fprintf(stderr, "heaters             : %u duty requests, %u compare writes, %llu ramp ISRs\n",
+            xHeater.DutyRequests, xHeater.CompareUpdates,
+            SimNvic_GetDispatchCount(10u) + SimNvic_GetDispatchCount(11u));
+    for (ulSeat = 0; ulSeat < SIM_SEAT_NUM_SEATS; ulSeat++)
+    {
+        SimSeat_GetStats(ulSeat, &xSeat);
+        fprintf(stderr, "seat %s      : %.1f C, mean duty %.1f %%, %llu/%llu targets reached, "
+                "time to target mean %.2f s max %.2f s, settling mean %.2f s max %.2f s (%llu settled), "
+                "overshoot %.2f C, max error %.2f C\n",
+                apcSeatNames[ulSeat], xSeat.dTemperatureC, xSeat.dMeanDuty / 10.0,
+                xSeat.ullReached, xSeat.ullTargets,
+                (xSeat.ullReached != 0u) ? ((double)xSeat.ullTimeToTargetTotalNs / (double)xSeat.ullReached) / 1e9
+                                         : 0.0,
+                (double)xSeat.ullTimeToTargetMaxNs / 1e9,
+                (xSeat.ullSettled != 0u) ? ((double)xSeat.ullSettlingTotalNs / (double)xSeat.ullSettled) / 1e9 : 0.0,
+                (double)xSeat.ullSettlingMaxNs / 1e9, xSeat.ullSettled, xSeat.dMaxOvershootC, xSeat.dMaxErrorC);
+    }
+
+    prvSaveEeprom();
+}
+
+/* Runs before main(): the firmware finds the peripherals already powered */
+__attribute__((constructor)) static void prvBoardInit(void)
+{
+    pthread_t xThread;
+    sigset_t xAll;
+    sigset_t xSaved;
+    SimSeat_ConfigType xSeatConfig;
+    uint32 aulAmbientMv[SIM_SEAT_NUM_SEATS];
+
+    SimSysCtl_Init();
+    SimNvic_Init();
+    SimGpio_Init();
+    SimGptm_Init();
+    SimUart_Init();
+    SimUdma_Init();
+    SimAdc_Init();
+    SimEeprom_Init();
+    SimPwm_Init();
+    SimDwt_Init();
+
+    ullStartNs = SimReg_NowNs();
+    ullDurationNs = prvEnvOrDefault("SIM_DURATION_MS", 10000u) * SIM_NS_PER_MS;
+    pcEepromFile = getenv("SIM_EEPROM_FILE");
+    prvLoadEeprom();
+
+    aulAmbientMv[0] = (uint32)prvEnvOrDefault("SIM_AIN0_MV", 20u);
+    aulAmbientMv[1] = (uint32)prvEnvOrDefault("SIM_AIN1_MV", 25u);
+    xSeatConfig.dRiseC = (double)prvEnvOrDefault("SIM_HEATER_RISE_C", 20u);
+    xSeatConfig.dTauS = (double)prvEnvOrDefault("SIM_SEAT_TAU_MS", 5000u) / 1000.0;
+    xSeatConfig.dBandC = (double)prvEnvOrDefault("SIM_SEAT_BAND_C", 15u) / 10.0;
+    SimSeat_Init(&xSeatConfig, aulAmbientMv);
+
+    /* Buttons released (pulled up) */
+    SimGpio_SetInput(SIM_GPIO_PORTF, SIM_SW1_PIN, LOGIC_HIGH);
+    SimGpio_SetInput(SIM_GPIO_PORTF, SIM_SW2_PIN, LOGIC_HIGH);
+    ulBounces = (uint32)prvEnvOrDefault("SIM_SW_BOUNCES", 4u);
+    axButtons[0].ulPin = SIM_SW1_PIN;
+    axButtons[0].ullPeriodNs = prvEnvOrDefault("SIM_SW1_PERIOD_MS", 1500u) * SIM_NS_PER_MS;
+    axButtons[0].ullHoldNs = prvEnvOrDefault("SIM_SW1_HOLD_MS", 100u) * SIM_NS_PER_MS;
+    axButtons[0].ulClicks = (uint32)prvEnvOrDefault("SIM_SW1_CLICKS", 1u);
+    axButtons[0].ullNextPressNs = ullStartNs + axButtons[0].ullPeriodNs;
+    axButtons[1].ulPin = SIM_SW2_PIN;
+    axButtons[1].ullPeriodNs = prvEnvOrDefault("SIM_SW2_PERIOD_MS", 2300u) * SIM_NS_PER_MS;
+    axButtons[1].ullHoldNs = prvEnvOrDefault("SIM_SW2_HOLD_MS", 100u) * SIM_NS_PER_MS;
+    axButtons[1].ulClicks = (uint32)prvEnvOrDefault("SIM_SW2_CLICKS", 1u);
+    axButtons[1].ullNextPressNs = ullStartNs + axButtons[1].ullPeriodNs;
+
+    atexit(prvReport);
+
+    /* Simulated interrupts must only ever reach the thread of the running task */
+    sigfillset(&xAll);
+    pthread_sigmask(SIG_BLOCK, &xAll, &xSaved);
+    if (pthread_create(&xThread, NULL_PTR, prvServiceThread, NULL_PTR) != 0)
+    {
+        fprintf(stderr, "HostSim: cannot start the service thread\n");
+        abort();
+    }
+    pthread_sigmask(SIG_SETMASK, &xSaved, NULL_PTR);
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+/* Park the host thread until the next tick or interrupt instead of spinning.
+ * After a tickless sleep the idle task goes straight back to the next one. */
+void vApplicationIdleHook(void)
+{
+    if (xPortTicklessSleptSinceLastCall() == pdFALSE)
+    {
+        pause();
+    }
+}
+
+void vAssertCalled(const char *pcFile, unsigned long ulLine)
+{
+    fprintf(stderr, "HostSim: assertion failed at %s:%lu\n", pcFile, ulLine);
+    abort();
+}
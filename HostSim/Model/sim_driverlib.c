@@ -0,0 +1,243 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Driverlib
+ *
+ * File Name: sim_driverlib.c
+ *
+ * Description: Host versions of the driverlib functions that cannot run on
+ *              the register file as they are: sysctl.c goes through the
+ *              bit-band alias region and has no SysCtlDelay() outside an ARM
+ *              toolchain, and interrupt.c programs PRIMASK and relocates the
+ *              vector table. Peripheral drivers such as adc.c, eeprom.c and
+ *              gpio.c are compiled unchanged and only call into these.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "sim_nvic.h"
+#include "sim_registers.h"
+#include "sim_sysctl.h"
+
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* SYSCTL_PERIPH_xxx: register offset in bits 15:8, bit number in bits 7:0 */
+#define SIM_PERIPH_REG_OFFSET(periph)   (((periph) & 0xFF00u) >> 8)
+#define SIM_PERIPH_BIT(periph)          (1u << ((periph) & 0xFFu))
+
+#define SIM_NVIC_PRI0_ADDRESS           0xE000E400u
+
+/* Run-mode clock configuration, USEPWMDIV and PWMDIV */
+#define SIM_SYSCTL_RCC_OFFSET           0x060u
+#define SIM_SYSCTL_RCC_PWM_MASK         0x001E0000u
+
+/* SysCtlDelay() spends three cycles per loop */
+#define SIM_DELAY_CYCLES_PER_LOOP       3u
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static boolean prvIsPeripheralIrq(uint32_t ui32Interrupt)
+{
+    return (ui32Interrupt >= SIM_NVIC_FIRST_IRQ_VECTOR) &&
+           (ui32Interrupt < (SIM_NVIC_FIRST_IRQ_VECTOR + SIM_NVIC_NUM_IRQS));
+}
+
+static void prvSetNvicBit(uint32_t ui32Bank, uint32_t ui32Interrupt)
+{
+    uint32_t ui32Irq = ui32Interrupt - SIM_NVIC_FIRST_IRQ_VECTOR;
+
+    /* The NVIC set/clear registers ignore zero bits, so a plain store works.
+     * The access after it lets the NVIC model act on the store right away. */
+    *SimReg_Map(ui32Bank + ((ui32Irq / 32u) * 4u)) = 1u << (ui32Irq % 32u);
+    (void)*SimReg_Map(ui32Bank);
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+/*
+ * sysctl.c
+ */
+
+bool SysCtlPeripheralPresent(uint32_t ui32Peripheral)
+{
+    (void)ui32Peripheral;
+    return true;
+}
+
+bool SysCtlPeripheralReady(uint32_t ui32Peripheral)
+{
+    return (*SimReg_Map(SIM_SYSCTL_PR_BASE + SIM_PERIPH_REG_OFFSET(ui32Peripheral))
+            & SIM_PERIPH_BIT(ui32Peripheral)) != 0u;
+}
+
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral)
+{
+    *SimReg_Map(SIM_SYSCTL_RCGC_BASE + SIM_PERIPH_REG_OFFSET(ui32Peripheral))
+        |= SIM_PERIPH_BIT(ui32Peripheral);
+}
+
+void SysCtlPeripheralDisable(uint32_t ui32Peripheral)
+{
+    *SimReg_Map(SIM_SYSCTL_RCGC_BASE + SIM_PERIPH_REG_OFFSET(ui32Peripheral))
+        &= ~SIM_PERIPH_BIT(ui32Peripheral);
+}
+
+void SysCtlPeripheralReset(uint32_t ui32Peripheral)
+{
+    /* The models keep their state over a reset pulse */
+    (void)ui32Peripheral;
+}
+
+void SysCtlDelay(uint32_t ui32Count)
+{
+    uint64 ullEndNs = SimReg_NowNs()
+                    + (((uint64)ui32Count * SIM_DELAY_CYCLES_PER_LOOP * 1000000000ull)
+                       / SIM_SYSCTL_CLOCK_HZ);
+
+    while (SimReg_NowNs() < ullEndNs)
+    {
+    }
+}
+
+void SysCtlClockSet(uint32_t ui32Config)
+{
+    /* The simulation always runs from the 16 MHz PIOSC */
+    (void)ui32Config;
+}
+
+uint32_t SysCtlClockGet(void)
+{
+    return SIM_SYSCTL_CLOCK_HZ;
+}
+
+void SysCtlPWMClockSet(uint32_t ui32Config)
+{
+    /* USEPWMDIV and PWMDIV of RCC, read back by the PWM model */
+    volatile uint32_t *pui32Rcc = SimReg_Map(SIM_SYSCTL_BASE + SIM_SYSCTL_RCC_OFFSET);
+
+    *pui32Rcc = (*pui32Rcc & ~SIM_SYSCTL_RCC_PWM_MASK) | (ui32Config & SIM_SYSCTL_RCC_PWM_MASK);
+}
+
+uint32_t SysCtlPWMClockGet(void)
+{
+    return *SimReg_Map(SIM_SYSCTL_BASE + SIM_SYSCTL_RCC_OFFSET) & SIM_SYSCTL_RCC_PWM_MASK;
+}
+
+/*
+ * interrupt.c
+ */
+
+bool IntMasterEnable(void)
+{
+    sigset_t xMask;
+
+    pthread_sigmask(SIG_SETMASK, NULL, &xMask);
+    portENABLE_INTERRUPTS();
+    return sigismember(&xMask, SIGALRM) ? true : false;
+}
+
+bool IntMasterDisable(void)
+{
+    sigset_t xMask;
+
+    pthread_sigmask(SIG_SETMASK, NULL, &xMask);
+    portDISABLE_INTERRUPTS();
+    return sigismember(&xMask, SIGALRM) ? true : false;
+}
+
+void IntRegister(uint32_t ui32Interrupt, void (*pfnHandler)(void))
+{
+    SimNvic_SetVector(ui32Interrupt, pfnHandler);
+}
+
+void IntUnregister(uint32_t ui32Interrupt)
+{
+    SimNvic_SetVector(ui32Interrupt, NULL_PTR);
+}
+
+void IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority)
+{
+    uint32_t ui32Irq = ui32Interrupt - SIM_NVIC_FIRST_IRQ_VECTOR;
+    uint32_t ui32Shift = (ui32Irq % 4u) * 8u;
+    volatile uint32 *pulPri;
+
+    if (prvIsPeripheralIrq(ui32Interrupt))
+    {
+        pulPri = SimReg_Map(SIM_NVIC_PRI0_ADDRESS + ((ui32Irq / 4u) * 4u));
+        *pulPri = (*pulPri & ~(0xFFu << ui32Shift)) | ((uint32_t)ui8Priority << ui32Shift);
+    }
+}
+
+int32_t IntPriorityGet(uint32_t ui32Interrupt)
+{
+    uint32_t ui32Irq = ui32Interrupt - SIM_NVIC_FIRST_IRQ_VECTOR;
+
+    if (!prvIsPeripheralIrq(ui32Interrupt))
+    {
+        return -1;
+    }
+    return (int32_t)((*SimReg_Map(SIM_NVIC_PRI0_ADDRESS + ((ui32Irq / 4u) * 4u))
+                      >> ((ui32Irq % 4u) * 8u)) & 0xFFu);
+}
+
+void IntEnable(uint32_t ui32Interrupt)
+{
+    if (prvIsPeripheralIrq(ui32Interrupt))
+    {
+        prvSetNvicBit(SIM_NVIC_EN0_ADDRESS, ui32Interrupt);
+    }
+}
+
+void IntDisable(uint32_t ui32Interrupt)
+{
+    if (prvIsPeripheralIrq(ui32Interrupt))
+    {
+        prvSetNvicBit(SIM_NVIC_DIS0_ADDRESS, ui32Interrupt);
+    }
+}
+
+uint32_t IntIsEnabled(uint32_t ui32Interrupt)
+{
+    uint32_t ui32Irq = ui32Interrupt - SIM_NVIC_FIRST_IRQ_VECTOR;
+
+    if (!prvIsPeripheralIrq(ui32Interrupt))
+    {
+        return 0u;
+    }
+    return *SimReg_Map(SIM_NVIC_EN0_ADDRESS + ((ui32Irq / 32u) * 4u)) & (1u << (ui32Irq % 32u));
+}
+
+void IntPendSet(uint32_t ui32Interrupt)
+{
+    if (prvIsPeripheralIrq(ui32Interrupt))
+    {
+        prvSetNvicBit(SIM_NVIC_PEND0_ADDRESS, ui32Interrupt);
+    }
+}
+
+void IntPendClear(uint32_t ui32Interrupt)
+{
+    if (prvIsPeripheralIrq(ui32Interrupt))
+    {
+        prvSetNvicBit(SIM_NVIC_UNPEND0_ADDRESS, ui32Interrupt);
+    }
+}
+
+void IntTrigger(uint32_t ui32Interrupt)
+{
+    IntPendSet(ui32Interrupt);
+}
@@ -0,0 +1,96 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - DWT
+ *
+ * File Name: sim_dwt.c
+ *
+ * Description: Simulated DWT cycle counter. CYCCNT counts the 16 MHz system
+ *              clock while DEMCR.TRCENA and DWT_CTRL.CYCCNTENA are both set
+ *              and the core is not asleep: Sleep mode stops the core clock.
+ *              Like the GPTM count it is derived from host time whenever the
+ *              firmware looks at it, and a value the firmware writes is
+ *              counted on from.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "sim_dwt.h"
+#include "sim_registers.h"
+#include "sim_sysctl.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_DWT_BASE             0xE0001000u
+#define SIM_DWT_SIZE             0x1000u
+#define SIM_DWT_CTRL             (SIM_DWT_BASE + 0x000u)
+#define SIM_DWT_CYCCNT           (SIM_DWT_BASE + 0x004u)
+#define SIM_DWT_DEMCR            0xE000EDFCu
+
+#define SIM_DWT_CTRL_CYCCNTENA   0x00000001u
+#define SIM_DWT_DEMCR_TRCENA     0x01000000u
+
+/* NUMCOMP = 4 comparators, as on the Cortex-M4 */
+#define SIM_DWT_CTRL_RESET       0x40000000u
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 ulBaseCount = 0;          /* CYCCNT at ullBaseNs */
+static uint64 ullBaseNs = 0;
+static uint32 ulPublished = 0;          /* Last count the model stored */
+static boolean bSleeping = FALSE;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    uint32 ulSeen = SIM_REG(SIM_DWT_CYCCNT);
+    uint32 ulCount = ulSeen;
+    boolean bCounting = ((SIM_REG(SIM_DWT_DEMCR) & SIM_DWT_DEMCR_TRCENA) != 0u) &&
+                        ((SIM_REG(SIM_DWT_CTRL) & SIM_DWT_CTRL_CYCCNTENA) != 0u) && !bSleeping;
+
+    (void)ulAddress;
+    if ((ulCount != ulPublished) || !bCounting)
+    {
+        /* Written by the firmware, or stopped: count on from here */
+        ulBaseCount = ulCount;
+        ullBaseNs = ullNowNs;
+    }
+    else
+    {
+        ulCount = ulBaseCount + (uint32)(((ullNowNs - ullBaseNs) * (SIM_SYSCTL_CLOCK_HZ / 1000000u)) / 1000u);
+    }
+
+    /* A firmware store racing this one wins and is picked up next time */
+    if (SimReg_Publish(SIM_DWT_CYCCNT, ulSeen, ulCount))
+    {
+        ulPublished = ulCount;
+    }
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimDwt_Init(void)
+{
+    SIM_REG(SIM_DWT_CTRL) = SIM_DWT_CTRL_RESET;
+    SimReg_RegisterHook(SIM_DWT_BASE, SIM_DWT_SIZE, prvAccessHook);
+    /* Writes to DEMCR start or stop the count too */
+    SimReg_RegisterHook(SIM_DWT_DEMCR, 4u, prvAccessHook);
+}
+
+void SimDwt_SetSleeping(boolean bSleep)
+{
+    SimReg_Lock();
+    /* The count is brought up to now before it stops or starts again */
+    prvAccessHook(SIM_DWT_CYCCNT, SimReg_NowNs());
+    bSleeping = bSleep;
+    SimReg_Unlock();
+}
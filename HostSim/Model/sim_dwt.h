@@ -0,0 +1,28 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - DWT
+ *
+ * File Name: sim_dwt.h
+ *
+ * Description: Header for the simulated DWT cycle counter of the Linux host
+ *              build
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_DWT_H_
+#define SIM_DWT_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void SimDwt_Init(void);
+
+/* The core enters or leaves Sleep mode, CYCCNT stops in between */
+extern void SimDwt_SetSleeping(boolean bSleep);
+
+#endif /* SIM_DWT_H_ */
@@ -0,0 +1,255 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - EEPROM
+ *
+ * File Name: sim_eeprom.c
+ *
+ * Description: Simulated 2 KB EEPROM (32 blocks of 16 words). Models the
+ *              EEBLOCK/EEOFFSET pointer, the EERDWR/EERDWRINC data windows
+ *              and the EEDONE.WORKING busy time of a word program, so the
+ *              unmodified driverlib eeprom.c runs against it and its
+ *              blocking behaviour can be measured. With EEINT.INT set, the
+ *              end of a program raises the EEPROM bit of the flash
+ *              controller interrupt (FCRIS/FCIM/FCMISC, vector FLASH).
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "sim_eeprom.h"
+#include "sim_nvic.h"
+#include "sim_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_EEPROM_BASE          0x400AF000u
+#define SIM_EEPROM_BLOCK_SIZE    0x1000u
+
+#define SIM_EEPROM_EESIZE        (SIM_EEPROM_BASE + 0x000u)
+#define SIM_EEPROM_EEBLOCK       (SIM_EEPROM_BASE + 0x004u)
+#define SIM_EEPROM_EEOFFSET      (SIM_EEPROM_BASE + 0x008u)
+#define SIM_EEPROM_EERDWR        (SIM_EEPROM_BASE + 0x010u)
+#define SIM_EEPROM_EERDWRINC     (SIM_EEPROM_BASE + 0x014u)
+#define SIM_EEPROM_EEDONE        (SIM_EEPROM_BASE + 0x018u)
+#define SIM_EEPROM_EEINT         (SIM_EEPROM_BASE + 0x040u)
+
+#define SIM_EEPROM_EEDONE_WORKING   0x1u
+#define SIM_EEPROM_EEINT_INT        0x1u
+
+/* The program-done interrupt is signalled through the flash controller */
+#define SIM_FLASH_BASE           0x400FD000u
+#define SIM_FLASH_BLOCK_SIZE     0x1000u
+#define SIM_FLASH_FCRIS          (SIM_FLASH_BASE + 0x00Cu)
+#define SIM_FLASH_FCIM           (SIM_FLASH_BASE + 0x010u)
+#define SIM_FLASH_FCMISC         (SIM_FLASH_BASE + 0x014u)
+#define SIM_FLASH_INT_EEPROM     0x4u
+#define SIM_FLASH_IRQ            29u
+
+/* FCMISC is published with this bit set, so a value without it can only be
+ * a write-1-to-clear stored by the firmware (see sim_adc.c) */
+#define SIM_FLASH_W1C_MARKER     0x80000000u
+
+/* Time EEDONE.WORKING stays set after a word is written */
+#define SIM_EEPROM_PROGRAM_NS    110000u
+
+#define SIM_EEPROM_ERASED_WORD   0xFFFFFFFFu
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 aulData[SIM_EEPROM_NUM_WORDS];
+
+static uint32 ulBlock = 0;
+static uint32 ulOffset = 0;
+
+/* Data window access that has not been settled yet. The hook runs before the
+ * access, so the window is loaded with the addressed word and the next hook
+ * tells a read from a write by whether the firmware replaced that value. */
+static uint32 ulPendingWindow = 0;      /* 0 when nothing is pending */
+static uint32 ulPlacedValue = 0;
+
+static uint64 ullBusyUntilNs = 0;
+static boolean bWorking = FALSE;        /* Program whose end is not signalled yet */
+static uint32 ulFlashRawStatus = 0;     /* FCRIS */
+static SimEeprom_StatsType xStats;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvProgram(uint32 ulValue, uint64 ullNowNs)
+{
+    uint32 ulWord = (ulBlock * SIM_EEPROM_WORDS_PER_BLOCK) + ulOffset;
+
+    if (ullNowNs < ullBusyUntilNs)
+    {
+        /* Writes while a program is in progress are lost */
+        return;
+    }
+    aulData[ulWord] = ulValue;
+    xStats.ullWordWrites++;
+    xStats.aulWritesPerWord[ulWord]++;
+    xStats.ullBusyNs += SIM_EEPROM_PROGRAM_NS;
+    ullBusyUntilNs = ullNowNs + SIM_EEPROM_PROGRAM_NS;
+    bWorking = TRUE;
+}
+
+static void prvSettle(uint64 ullNowNs)
+{
+    uint32 ulValue;
+
+    /* EEBLOCK only accepts existing blocks, EEOFFSET is four bits wide */
+    ulValue = SIM_REG(SIM_EEPROM_EEBLOCK);
+    if (ulValue != ulBlock)
+    {
+        if (ulValue < SIM_EEPROM_NUM_BLOCKS)
+        {
+            ulBlock = ulValue;
+        }
+        else
+        {
+            xStats.ullBadBlocks++;
+            SIM_REG(SIM_EEPROM_EEBLOCK) = ulBlock;
+        }
+    }
+    ulOffset = SIM_REG(SIM_EEPROM_EEOFFSET) & (SIM_EEPROM_WORDS_PER_BLOCK - 1u);
+
+    if (ulPendingWindow != 0u)
+    {
+        ulValue = SIM_REG(ulPendingWindow);
+        if (ulValue != ulPlacedValue)
+        {
+            prvProgram(ulValue, ullNowNs);
+        }
+        else
+        {
+            /* Also taken for a write of the value already stored, which the
+             * model treats as a read: the array contents end up the same */
+            xStats.ullWordReads++;
+        }
+        if (ulPendingWindow == SIM_EEPROM_EERDWRINC)
+        {
+            ulOffset = (ulOffset + 1u) & (SIM_EEPROM_WORDS_PER_BLOCK - 1u);
+        }
+        ulPendingWindow = 0u;
+    }
+    SIM_REG(SIM_EEPROM_EEOFFSET) = ulOffset;
+
+    SIM_REG(SIM_EEPROM_EEDONE) = (ullNowNs < ullBusyUntilNs) ? SIM_EEPROM_EEDONE_WORKING : 0u;
+}
+
+static void prvAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    prvSettle(ullNowNs);
+
+    if ((ulAddress == SIM_EEPROM_EERDWR) || (ulAddress == SIM_EEPROM_EERDWRINC))
+    {
+        ulPlacedValue = aulData[(ulBlock * SIM_EEPROM_WORDS_PER_BLOCK) + ulOffset];
+        SIM_REG(ulAddress) = ulPlacedValue;
+        ulPendingWindow = ulAddress;
+    }
+}
+
+static void prvUpdateInterrupt(uint64 ullNowNs)
+{
+    uint32 ulValue;
+
+    do
+    {
+        ulValue = SIM_REG(SIM_FLASH_FCMISC);
+        if ((ulValue & SIM_FLASH_W1C_MARKER) == 0u)
+        {
+            ulFlashRawStatus &= ~ulValue;
+        }
+    } while (!SimReg_Publish(SIM_FLASH_FCMISC, ulValue,
+                             (ulFlashRawStatus & SIM_REG(SIM_FLASH_FCIM)) | SIM_FLASH_W1C_MARKER));
+
+    /* The interrupt fires on the falling edge of EEDONE.WORKING */
+    if (bWorking && (ullNowNs >= ullBusyUntilNs))
+    {
+        bWorking = FALSE;
+        if (SIM_REG(SIM_EEPROM_EEINT) & SIM_EEPROM_EEINT_INT)
+        {
+            ulFlashRawStatus |= SIM_FLASH_INT_EEPROM;
+            (void)SimReg_Publish(SIM_FLASH_FCMISC, SIM_REG(SIM_FLASH_FCMISC),
+                                 (ulFlashRawStatus & SIM_REG(SIM_FLASH_FCIM)) | SIM_FLASH_W1C_MARKER);
+        }
+    }
+    SIM_REG(SIM_FLASH_FCRIS) = ulFlashRawStatus;
+}
+
+static void prvFlashAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    (void)ulAddress;
+    SimEeprom_Service(ullNowNs);
+    SimNvic_Update(SIM_FLASH_IRQ);
+}
+
+static boolean prvInterruptLevel(uint32 ulIrq)
+{
+    (void)ulIrq;
+    SimEeprom_Service(SimReg_NowNs());
+    return ((SIM_REG(SIM_FLASH_FCMISC) & ~SIM_FLASH_W1C_MARKER) != 0u);
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimEeprom_Init(void)
+{
+    uint32 ulWord;
+
+    for (ulWord = 0; ulWord < SIM_EEPROM_NUM_WORDS; ulWord++)
+    {
+        aulData[ulWord] = SIM_EEPROM_ERASED_WORD;
+    }
+    /* EESIZE: BLKCNT in bits 26:16, WORDCNT in bits 15:0 */
+    SIM_REG(SIM_EEPROM_EESIZE) = (SIM_EEPROM_NUM_BLOCKS << 16) | SIM_EEPROM_NUM_WORDS;
+    SIM_REG(SIM_FLASH_FCMISC) = SIM_FLASH_W1C_MARKER;
+    SimReg_RegisterHook(SIM_EEPROM_BASE, SIM_EEPROM_BLOCK_SIZE, prvAccessHook);
+    SimReg_RegisterHook(SIM_FLASH_BASE, SIM_FLASH_BLOCK_SIZE, prvFlashAccessHook);
+    SimNvic_SetSource(SIM_FLASH_IRQ, prvInterruptLevel);
+}
+
+void SimEeprom_Service(uint64 ullNowNs)
+{
+    prvSettle(ullNowNs);
+    prvUpdateInterrupt(ullNowNs);
+}
+
+uint64 SimEeprom_NextDeadline(uint64 ullNowNs)
+{
+    (void)ullNowNs;
+    return bWorking ? ullBusyUntilNs : SIM_EEPROM_NO_DEADLINE;
+}
+
+void SimEeprom_GetStats(SimEeprom_StatsType *pxStats)
+{
+    SimReg_Lock();
+    *pxStats = xStats;
+    SimReg_Unlock();
+}
+
+uint32 SimEeprom_ReadWord(uint32 ulWord)
+{
+    uint32 ulValue;
+
+    SimReg_Lock();
+    ulValue = (ulWord < SIM_EEPROM_NUM_WORDS) ? aulData[ulWord] : SIM_EEPROM_ERASED_WORD;
+    SimReg_Unlock();
+    return ulValue;
+}
+
+void SimEeprom_WriteWord(uint32 ulWord, uint32 ulValue)
+{
+    SimReg_Lock();
+    if (ulWord < SIM_EEPROM_NUM_WORDS)
+    {
+        aulData[ulWord] = ulValue;
+    }
+    SimReg_Unlock();
+}
@@ -0,0 +1,56 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - EEPROM
+ *
+ * File Name: sim_eeprom.h
+ *
+ * Description: Header for the simulated 2 KB EEPROM of the Linux host build
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_EEPROM_H_
+#define SIM_EEPROM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_EEPROM_NUM_BLOCKS       32u
+#define SIM_EEPROM_WORDS_PER_BLOCK  16u
+#define SIM_EEPROM_NUM_WORDS        (SIM_EEPROM_NUM_BLOCKS * SIM_EEPROM_WORDS_PER_BLOCK)
+
+#define SIM_EEPROM_NO_DEADLINE      0xFFFFFFFFFFFFFFFFull
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint64 ullWordReads;        /* Words read through EERDWR/EERDWRINC */
+    uint64 ullWordWrites;       /* Words programmed */
+    uint64 ullBusyNs;           /* Time spent with EEDONE.WORKING set */
+    uint64 ullBadBlocks;        /* EEBLOCK writes past the last block, ignored */
+    uint32 aulWritesPerWord[SIM_EEPROM_NUM_WORDS];   /* Wear per word */
+} SimEeprom_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void SimEeprom_Init(void);
+extern void SimEeprom_Service(uint64 ullNowNs);
+
+/* Host time the running word program ends, SIM_EEPROM_NO_DEADLINE if idle */
+extern uint64 SimEeprom_NextDeadline(uint64 ullNowNs);
+extern void SimEeprom_GetStats(SimEeprom_StatsType *pxStats);
+
+/* Direct access to the array contents, e.g. to preload or dump them */
+extern uint32 SimEeprom_ReadWord(uint32 ulWord);
+extern void SimEeprom_WriteWord(uint32 ulWord, uint32 ulValue);
+
+#endif /* SIM_EEPROM_H_ */
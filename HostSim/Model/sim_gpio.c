@@ -0,0 +1,226 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - GPIO
+ *
+ * File Name: sim_gpio.c
+ *
+ * Description: Simulated GPIO ports A-F. Models pin direction, the DATA
+ *              register, edge detection into RIS and the write-1-to-clear ICR,
+ *              and drives the port interrupt line of the simulated NVIC.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "sim_gpio.h"
+#include "sim_nvic.h"
+#include "sim_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_GPIO_BLOCK_SIZE      0x1000u
+
+#define SIM_GPIO_DATA_OFFSET     0x3FCu
+#define SIM_GPIO_DIR_OFFSET      0x400u
+#define SIM_GPIO_IS_OFFSET       0x404u
+#define SIM_GPIO_IBE_OFFSET      0x408u
+#define SIM_GPIO_IEV_OFFSET      0x40Cu
+#define SIM_GPIO_IM_OFFSET       0x410u
+#define SIM_GPIO_RIS_OFFSET      0x414u
+#define SIM_GPIO_MIS_OFFSET      0x418u
+#define SIM_GPIO_ICR_OFFSET      0x41Cu
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulBase;
+    uint32 ulIrq;
+    uint32 ulInputLevels;       /* Levels driven onto the pins from outside */
+    uint32 ulLastOutputs;       /* Output levels seen at the last update */
+    uint64 aullToggles[8];
+} SimGpio_PortType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static SimGpio_PortType axPorts[SIM_GPIO_NUM_PORTS] =
+{
+    { 0x40004000u,  0u, 0xFFu, 0u, { 0u } },   /* PORTA */
+    { 0x40005000u,  1u, 0xFFu, 0u, { 0u } },   /* PORTB */
+    { 0x40006000u,  2u, 0xFFu, 0u, { 0u } },   /* PORTC */
+    { 0x40007000u,  3u, 0xFFu, 0u, { 0u } },   /* PORTD */
+    { 0x40024000u,  4u, 0xFFu, 0u, { 0u } },   /* PORTE */
+    { 0x40025000u, 30u, 0xFFu, 0u, { 0u } },   /* PORTF */
+};
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+#define PORT_REG(port, offset)   SIM_REG((port)->ulBase + (offset))
+
+static void prvUpdatePort(SimGpio_PortType *pxPort)
+{
+    uint32 ulDir;
+    uint32 ulData;
+    uint32 ulOutputs;
+    uint32 ulChanged;
+    uint32 ulPin;
+
+    /* ICR is write-1-to-clear and always reads back as zero */
+    PORT_REG(pxPort, SIM_GPIO_RIS_OFFSET) &= ~SimReg_Take(pxPort->ulBase + SIM_GPIO_ICR_OFFSET);
+    PORT_REG(pxPort, SIM_GPIO_MIS_OFFSET) = PORT_REG(pxPort, SIM_GPIO_RIS_OFFSET)
+                                          & PORT_REG(pxPort, SIM_GPIO_IM_OFFSET);
+
+    /* Inputs read the external level, outputs keep what the firmware wrote.
+     * A store racing with this update is picked up by the next one. */
+    ulDir = PORT_REG(pxPort, SIM_GPIO_DIR_OFFSET) & 0xFFu;
+    ulData = PORT_REG(pxPort, SIM_GPIO_DATA_OFFSET);
+    ulOutputs = ulData & ulDir;
+    (void)SimReg_Publish(pxPort->ulBase + SIM_GPIO_DATA_OFFSET, ulData,
+                         ulOutputs | (pxPort->ulInputLevels & ~ulDir & 0xFFu));
+
+    ulChanged = (ulOutputs ^ pxPort->ulLastOutputs) & ulDir;
+    for (ulPin = 0; ulPin < 8u; ulPin++)
+    {
+        if (ulChanged & (1u << ulPin))
+        {
+            pxPort->aullToggles[ulPin]++;
+        }
+    }
+    pxPort->ulLastOutputs = ulOutputs;
+}
+
+static SimGpio_PortType *prvPortFromAddress(uint32 ulAddress)
+{
+    uint32 ulPort;
+
+    for (ulPort = 0; ulPort < SIM_GPIO_NUM_PORTS; ulPort++)
+    {
+        if ((ulAddress - axPorts[ulPort].ulBase) < SIM_GPIO_BLOCK_SIZE)
+        {
+            return &axPorts[ulPort];
+        }
+    }
+    return NULL_PTR;
+}
+
+static void prvAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    SimGpio_PortType *pxPort = prvPortFromAddress(ulAddress);
+
+    (void)ullNowNs;
+    prvUpdatePort(pxPort);
+    SimNvic_Update(pxPort->ulIrq);
+}
+
+static boolean prvInterruptLevel(uint32 ulIrq)
+{
+    uint32 ulPort;
+
+    for (ulPort = 0; ulPort < SIM_GPIO_NUM_PORTS; ulPort++)
+    {
+        if (axPorts[ulPort].ulIrq == ulIrq)
+        {
+            prvUpdatePort(&axPorts[ulPort]);
+            return (PORT_REG(&axPorts[ulPort], SIM_GPIO_MIS_OFFSET) != 0u);
+        }
+    }
+    return FALSE;
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimGpio_Init(void)
+{
+    uint32 ulPort;
+
+    for (ulPort = 0; ulPort < SIM_GPIO_NUM_PORTS; ulPort++)
+    {
+        SimReg_RegisterHook(axPorts[ulPort].ulBase, SIM_GPIO_BLOCK_SIZE, prvAccessHook);
+        SimNvic_SetSource(axPorts[ulPort].ulIrq, prvInterruptLevel);
+    }
+}
+
+void SimGpio_SetInput(uint32 ulPort, uint32 ulPin, uint8 ucLevel)
+{
+    SimGpio_PortType *pxPort = &axPorts[ulPort];
+    uint32 ulBit = 1u << ulPin;
+    uint32 ulOld;
+    uint32 ulNew;
+    boolean bDetected;
+
+    SimReg_Lock();
+    prvUpdatePort(pxPort);
+
+    ulOld = pxPort->ulInputLevels & ulBit;
+    ulNew = ucLevel ? ulBit : 0u;
+    pxPort->ulInputLevels = (pxPort->ulInputLevels & ~ulBit) | ulNew;
+
+    if ((PORT_REG(pxPort, SIM_GPIO_DIR_OFFSET) & ulBit) == 0u)
+    {
+        if (PORT_REG(pxPort, SIM_GPIO_IS_OFFSET) & ulBit)
+        {
+            /* Level sensitive */
+            bDetected = ((ulNew != 0u) == ((PORT_REG(pxPort, SIM_GPIO_IEV_OFFSET) & ulBit) != 0u));
+        }
+        else if (ulOld == ulNew)
+        {
+            bDetected = FALSE;
+        }
+        else if (PORT_REG(pxPort, SIM_GPIO_IBE_OFFSET) & ulBit)
+        {
+            bDetected = TRUE;       /* Both edges */
+        }
+        else
+        {
+            /* IEV = 1 rising edge, IEV = 0 falling edge */
+            bDetected = ((ulNew != 0u) == ((PORT_REG(pxPort, SIM_GPIO_IEV_OFFSET) & ulBit) != 0u));
+        }
+
+        if (bDetected)
+        {
+            PORT_REG(pxPort, SIM_GPIO_RIS_OFFSET) |= ulBit;
+        }
+    }
+
+    prvUpdatePort(pxPort);
+    SimNvic_Update(pxPort->ulIrq);
+    SimReg_Unlock();
+}
+
+uint8 SimGpio_GetOutput(uint32 ulPort, uint32 ulPin)
+{
+    uint8 ucLevel;
+
+    SimReg_Lock();
+    prvUpdatePort(&axPorts[ulPort]);
+    ucLevel = (uint8)((axPorts[ulPort].ulLastOutputs >> ulPin) & 1u);
+    SimReg_Unlock();
+
+    return ucLevel;
+}
+
+uint64 SimGpio_GetToggleCount(uint32 ulPort, uint32 ulPin)
+{
+    return axPorts[ulPort].aullToggles[ulPin];
+}
+
+void SimGpio_Service(uint64 ullNowNs)
+{
+    uint32 ulPort;
+
+    (void)ullNowNs;
+    for (ulPort = 0; ulPort < SIM_GPIO_NUM_PORTS; ulPort++)
+    {
+        prvUpdatePort(&axPorts[ulPort]);
+    }
+}
@@ -0,0 +1,47 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - GPIO
+ *
+ * File Name: sim_gpio.h
+ *
+ * Description: Header for the simulated GPIO ports A-F of the Linux host build
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_GPIO_H_
+#define SIM_GPIO_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_GPIO_PORTA          0u
+#define SIM_GPIO_PORTB          1u
+#define SIM_GPIO_PORTC          2u
+#define SIM_GPIO_PORTD          3u
+#define SIM_GPIO_PORTE          4u
+#define SIM_GPIO_PORTF          5u
+#define SIM_GPIO_NUM_PORTS      6u
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void SimGpio_Init(void);
+
+/* Drive an input pin from outside the chip (button, sensor, ...) */
+extern void SimGpio_SetInput(uint32 ulPort, uint32 ulPin, uint8 ucLevel);
+
+/* Output pin level as last written by the firmware */
+extern uint8 SimGpio_GetOutput(uint32 ulPort, uint32 ulPin);
+
+/* Number of output level changes seen on a pin */
+extern uint64 SimGpio_GetToggleCount(uint32 ulPort, uint32 ulPin);
+
+extern void SimGpio_Service(uint64 ullNowNs);
+
+#endif /* SIM_GPIO_H_ */
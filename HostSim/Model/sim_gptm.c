@@ -0,0 +1,307 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - GPTM
+ *
+ * File Name: sim_gptm.c
+ *
+ * Description: Simulated general purpose timers. Timer A of every block is
+ *              modelled in one-shot and periodic mode, counting up or down
+ *              from the 16 MHz system clock through the prescaler, with the
+ *              time-out flag in RIS and the interrupt line to the NVIC. The
+ *              count is derived from host time whenever it is looked at.
+ *              Periodic time-outs with TAOTE set trigger the ADC.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "sim_adc.h"
+#include "sim_gptm.h"
+#include "sim_nvic.h"
+#include "sim_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_GPTM_BLOCK_SIZE      0x1000u
+#define SIM_GPTM_CLOCK_MHZ       16u
+
+#define SIM_GPTM_CFG_OFFSET      0x000u
+#define SIM_GPTM_TAMR_OFFSET     0x004u
+#define SIM_GPTM_CTL_OFFSET      0x00Cu
+#define SIM_GPTM_IMR_OFFSET      0x018u
+#define SIM_GPTM_RIS_OFFSET      0x01Cu
+#define SIM_GPTM_MIS_OFFSET      0x020u
+#define SIM_GPTM_ICR_OFFSET      0x024u
+#define SIM_GPTM_TAILR_OFFSET    0x028u
+#define SIM_GPTM_TBILR_OFFSET    0x02Cu
+#define SIM_GPTM_TAPR_OFFSET     0x038u
+#define SIM_GPTM_TAR_OFFSET      0x048u
+#define SIM_GPTM_TBR_OFFSET      0x04Cu
+#define SIM_GPTM_TAV_OFFSET      0x050u
+#define SIM_GPTM_TBV_OFFSET      0x054u
+
+#define SIM_GPTM_CTL_TAEN        0x01u
+#define SIM_GPTM_CTL_TAOTE       0x20u
+#define SIM_GPTM_TAMR_MODE_MASK  0x03u
+#define SIM_GPTM_TAMR_ONE_SHOT   0x01u
+#define SIM_GPTM_TAMR_PERIODIC   0x02u
+#define SIM_GPTM_TAMR_TACDIR     0x10u
+#define SIM_GPTM_RIS_TATORIS     0x01u
+#define SIM_GPTM_CFG_SPLIT       0x04u
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulBase;
+    uint32 ulIrqA;
+    boolean bWide;
+    boolean bRunning;
+    uint64 ullStartNs;
+    uint64 ullLoad;
+    uint32 ulPrescale;
+    uint64 ullTimeouts;         /* Periodic time-outs already flagged */
+} SimGptm_TimerType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static SimGptm_TimerType axTimers[SIM_GPTM_NUM_TIMERS] =
+{
+    { 0x40030000u,  19u, FALSE },   /* TIMER0 */
+    { 0x40031000u,  21u, FALSE },   /* TIMER1 */
+    { 0x40032000u,  23u, FALSE },   /* TIMER2 */
+    { 0x40033000u,  35u, FALSE },   /* TIMER3 */
+    { 0x40034000u,  70u, FALSE },   /* TIMER4 */
+    { 0x40035000u,  92u, FALSE },   /* TIMER5 */
+    { 0x40036000u,  94u, TRUE  },   /* WTIMER0 */
+    { 0x40037000u,  96u, TRUE  },   /* WTIMER1 */
+    { 0x4004C000u,  98u, TRUE  },   /* WTIMER2 */
+    { 0x4004D000u, 100u, TRUE  },   /* WTIMER3 */
+    { 0x4004E000u, 102u, TRUE  },   /* WTIMER4 */
+    { 0x4004F000u, 104u, TRUE  },   /* WTIMER5 */
+};
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+#define TIMER_REG(timer, offset)   SIM_REG((timer)->ulBase + (offset))
+
+static void prvStart(SimGptm_TimerType *pxTimer, uint64 ullNowNs)
+{
+    boolean bSplit = ((TIMER_REG(pxTimer, SIM_GPTM_CFG_OFFSET) & 0x7u) == SIM_GPTM_CFG_SPLIT);
+
+    if (bSplit)
+    {
+        /* Individual timer A: 16-bit with 8-bit prescaler, or 32-bit with
+         * 16-bit prescaler for the wide blocks */
+        pxTimer->ullLoad = pxTimer->bWide ? TIMER_REG(pxTimer, SIM_GPTM_TAILR_OFFSET)
+                                          : (TIMER_REG(pxTimer, SIM_GPTM_TAILR_OFFSET) & 0xFFFFu);
+        pxTimer->ulPrescale = pxTimer->bWide ? (TIMER_REG(pxTimer, SIM_GPTM_TAPR_OFFSET) & 0xFFFFu)
+                                             : (TIMER_REG(pxTimer, SIM_GPTM_TAPR_OFFSET) & 0xFFu);
+    }
+    else
+    {
+        /* Concatenated: 32-bit, or 64-bit for the wide blocks, no prescaler */
+        pxTimer->ullLoad = TIMER_REG(pxTimer, SIM_GPTM_TAILR_OFFSET);
+        if (pxTimer->bWide)
+        {
+            pxTimer->ullLoad |= (uint64)TIMER_REG(pxTimer, SIM_GPTM_TBILR_OFFSET) << 32;
+        }
+        pxTimer->ulPrescale = 0u;
+    }
+    pxTimer->ullStartNs = ullNowNs;
+    pxTimer->ullTimeouts = 0u;
+    pxTimer->bRunning = TRUE;
+}
+
+static uint64 prvTicksSinceStart(const SimGptm_TimerType *pxTimer, uint64 ullNowNs)
+{
+    return ((ullNowNs - pxTimer->ullStartNs) * SIM_GPTM_CLOCK_MHZ / 1000u) / (pxTimer->ulPrescale + 1u);
+}
+
+static void prvWriteValue(SimGptm_TimerType *pxTimer, uint64 ullValue)
+{
+    TIMER_REG(pxTimer, SIM_GPTM_TAR_OFFSET) = (uint32)ullValue;
+    TIMER_REG(pxTimer, SIM_GPTM_TAV_OFFSET) = (uint32)ullValue;
+    if (pxTimer->bWide && ((TIMER_REG(pxTimer, SIM_GPTM_CFG_OFFSET) & 0x7u) != SIM_GPTM_CFG_SPLIT))
+    {
+        TIMER_REG(pxTimer, SIM_GPTM_TBR_OFFSET) = (uint32)(ullValue >> 32);
+        TIMER_REG(pxTimer, SIM_GPTM_TBV_OFFSET) = (uint32)(ullValue >> 32);
+    }
+}
+
+static void prvUpdateTimer(SimGptm_TimerType *pxTimer, uint64 ullNowNs)
+{
+    uint32 ulMode;
+    boolean bUp;
+    uint64 ullTicks;
+    uint64 ullPeriod;
+    uint64 ullCount;
+
+    /* ICR is write-1-to-clear and always reads back as zero */
+    TIMER_REG(pxTimer, SIM_GPTM_RIS_OFFSET) &= ~SimReg_Take(pxTimer->ulBase + SIM_GPTM_ICR_OFFSET);
+
+    if ((TIMER_REG(pxTimer, SIM_GPTM_CTL_OFFSET) & SIM_GPTM_CTL_TAEN) && !pxTimer->bRunning)
+    {
+        prvStart(pxTimer, ullNowNs);
+    }
+    else if (!(TIMER_REG(pxTimer, SIM_GPTM_CTL_OFFSET) & SIM_GPTM_CTL_TAEN) && pxTimer->bRunning)
+    {
+        pxTimer->bRunning = FALSE;      /* The count freezes where it is */
+    }
+
+    if (pxTimer->bRunning)
+    {
+        ulMode = TIMER_REG(pxTimer, SIM_GPTM_TAMR_OFFSET) & SIM_GPTM_TAMR_MODE_MASK;
+        bUp = (TIMER_REG(pxTimer, SIM_GPTM_TAMR_OFFSET) & SIM_GPTM_TAMR_TACDIR) != 0u;
+        ullTicks = prvTicksSinceStart(pxTimer, ullNowNs);
+        ullPeriod = pxTimer->ullLoad + 1u;
+
+        if (ulMode == SIM_GPTM_TAMR_PERIODIC)
+        {
+            if ((ullTicks / ullPeriod) > pxTimer->ullTimeouts)
+            {
+                pxTimer->ullTimeouts = ullTicks / ullPeriod;
+                TIMER_REG(pxTimer, SIM_GPTM_RIS_OFFSET) |= SIM_GPTM_RIS_TATORIS;
+                if (TIMER_REG(pxTimer, SIM_GPTM_CTL_OFFSET) & SIM_GPTM_CTL_TAOTE)
+                {
+                    SimAdc_TimerTrigger(ullNowNs);
+                }
+            }
+            ullCount = ullTicks % ullPeriod;
+            prvWriteValue(pxTimer, bUp ? ullCount : (pxTimer->ullLoad - ullCount));
+        }
+        else if (ullTicks >= pxTimer->ullLoad)
+        {
+            /* One-shot time-out: the timer stops and clears its enable bit */
+            TIMER_REG(pxTimer, SIM_GPTM_RIS_OFFSET) |= SIM_GPTM_RIS_TATORIS;
+            __atomic_fetch_and(&TIMER_REG(pxTimer, SIM_GPTM_CTL_OFFSET), ~SIM_GPTM_CTL_TAEN,
+                               __ATOMIC_SEQ_CST);
+            pxTimer->bRunning = FALSE;
+            prvWriteValue(pxTimer, bUp ? pxTimer->ullLoad : 0u);
+        }
+        else
+        {
+            prvWriteValue(pxTimer, bUp ? ullTicks : (pxTimer->ullLoad - ullTicks));
+        }
+    }
+
+    TIMER_REG(pxTimer, SIM_GPTM_MIS_OFFSET) = TIMER_REG(pxTimer, SIM_GPTM_RIS_OFFSET)
+                                            & TIMER_REG(pxTimer, SIM_GPTM_IMR_OFFSET);
+}
+
+static SimGptm_TimerType *prvTimerFromAddress(uint32 ulAddress)
+{
+    uint32 ulTimer;
+
+    for (ulTimer = 0; ulTimer < SIM_GPTM_NUM_TIMERS; ulTimer++)
+    {
+        if ((ulAddress - axTimers[ulTimer].ulBase) < SIM_GPTM_BLOCK_SIZE)
+        {
+            return &axTimers[ulTimer];
+        }
+    }
+    return NULL_PTR;
+}
+
+static void prvAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    SimGptm_TimerType *pxTimer = prvTimerFromAddress(ulAddress);
+
+    prvUpdateTimer(pxTimer, ullNowNs);
+    SimNvic_Update(pxTimer->ulIrqA);
+}
+
+static boolean prvInterruptLevel(uint32 ulIrq)
+{
+    uint32 ulTimer;
+
+    for (ulTimer = 0; ulTimer < SIM_GPTM_NUM_TIMERS; ulTimer++)
+    {
+        if (axTimers[ulTimer].ulIrqA == ulIrq)
+        {
+            prvUpdateTimer(&axTimers[ulTimer], SimReg_NowNs());
+            return ((TIMER_REG(&axTimers[ulTimer], SIM_GPTM_MIS_OFFSET) & SIM_GPTM_RIS_TATORIS) != 0u);
+        }
+    }
+    return FALSE;
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimGptm_Init(void)
+{
+    uint32 ulTimer;
+
+    for (ulTimer = 0; ulTimer < SIM_GPTM_NUM_TIMERS; ulTimer++)
+    {
+        /* Reset values of the load and count registers */
+        TIMER_REG(&axTimers[ulTimer], SIM_GPTM_TAILR_OFFSET) = 0xFFFFFFFFu;
+        TIMER_REG(&axTimers[ulTimer], SIM_GPTM_TBILR_OFFSET) = 0xFFFFFFFFu;
+        TIMER_REG(&axTimers[ulTimer], SIM_GPTM_TAR_OFFSET) = 0xFFFFFFFFu;
+        TIMER_REG(&axTimers[ulTimer], SIM_GPTM_TAV_OFFSET) = 0xFFFFFFFFu;
+
+        SimReg_RegisterHook(axTimers[ulTimer].ulBase, SIM_GPTM_BLOCK_SIZE, prvAccessHook);
+        SimNvic_SetSource(axTimers[ulTimer].ulIrqA, prvInterruptLevel);
+    }
+}
+
+void SimGptm_Service(uint64 ullNowNs)
+{
+    uint32 ulTimer;
+
+    for (ulTimer = 0; ulTimer < SIM_GPTM_NUM_TIMERS; ulTimer++)
+    {
+        prvUpdateTimer(&axTimers[ulTimer], ullNowNs);
+    }
+}
+
+uint64 SimGptm_NextDeadline(uint64 ullNowNs)
+{
+    uint32 ulTimer;
+    uint64 ullNext = SIM_GPTM_NO_DEADLINE;
+    uint64 ullTicksToNext;
+    uint64 ullTicks;
+    uint64 ullPeriod;
+    uint64 ullDeadline;
+    SimGptm_TimerType *pxTimer;
+
+    for (ulTimer = 0; ulTimer < SIM_GPTM_NUM_TIMERS; ulTimer++)
+    {
+        pxTimer = &axTimers[ulTimer];
+        /* Only time-outs somebody sees: an interrupt or an ADC trigger */
+        if (!pxTimer->bRunning ||
+            !((TIMER_REG(pxTimer, SIM_GPTM_IMR_OFFSET) & SIM_GPTM_RIS_TATORIS) ||
+              (TIMER_REG(pxTimer, SIM_GPTM_CTL_OFFSET) & SIM_GPTM_CTL_TAOTE)))
+        {
+            continue;
+        }
+
+        ullTicks = prvTicksSinceStart(pxTimer, ullNowNs);
+        ullPeriod = pxTimer->ullLoad + 1u;
+        if ((TIMER_REG(pxTimer, SIM_GPTM_TAMR_OFFSET) & SIM_GPTM_TAMR_MODE_MASK) == SIM_GPTM_TAMR_PERIODIC)
+        {
+            ullTicksToNext = ((ullTicks / ullPeriod) + 1u) * ullPeriod;
+        }
+        else
+        {
+            ullTicksToNext = pxTimer->ullLoad;
+        }
+        ullDeadline = pxTimer->ullStartNs
+                    + ((ullTicksToNext * (pxTimer->ulPrescale + 1u) * 1000u) / SIM_GPTM_CLOCK_MHZ) + 1u;
+        if (ullDeadline < ullNext)
+        {
+            ullNext = ullDeadline;
+        }
+    }
+    return ullNext;
+}
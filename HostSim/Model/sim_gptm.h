@@ -0,0 +1,36 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - GPTM
+ *
+ * File Name: sim_gptm.h
+ *
+ * Description: Header for the simulated 16/32-bit and 32/64-bit wide general
+ *              purpose timers of the Linux host build
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_GPTM_H_
+#define SIM_GPTM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_GPTM_NUM_TIMERS     12u     /* TIMER0-5 then WTIMER0-5 */
+#define SIM_GPTM_NO_DEADLINE    0xFFFFFFFFFFFFFFFFull
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void SimGptm_Init(void);
+extern void SimGptm_Service(uint64 ullNowNs);
+
+/* Host time of the next timeout that would raise an interrupt */
+extern uint64 SimGptm_NextDeadline(uint64 ullNowNs);
+
+#endif /* SIM_GPTM_H_ */
@@ -0,0 +1,184 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - NVIC
+ *
+ * File Name: sim_nvic.c
+ *
+ * Description: Simulated NVIC for the Linux host build. Tracks the enable and
+ *              pending registers, and dispatches the firmware's interrupt
+ *              handlers through the FreeRTOS Posix port. Lines are level
+ *              sensitive: a source that is still asserted when its handler
+ *              returns is taken again, as on the target.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "sim_nvic.h"
+#include "sim_registers.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static SimNvic_LevelType apfnSources[SIM_NVIC_NUM_IRQS];
+static uint32 aulEnabled[SIM_NVIC_NUM_WORDS];
+static uint32 aulPending[SIM_NVIC_NUM_WORDS];
+static uint32 aulEnabledPublished[SIM_NVIC_NUM_WORDS];
+static uint32 aulPendingPublished[SIM_NVIC_NUM_WORDS];
+static boolean abActive[SIM_NVIC_NUM_IRQS];
+static uint64 aullDispatched[SIM_NVIC_NUM_IRQS];
+
+/* Handlers installed at run time with IntRegister(), which on the target
+ * copies the vector table to SRAM and patches it */
+static void (*apfnRamVectors[SIM_NVIC_FIRST_IRQ_VECTOR + SIM_NVIC_NUM_IRQS])(void);
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvApplyWrites(void)
+{
+    uint32 ulWord;
+
+    for (ulWord = 0; ulWord < SIM_NVIC_NUM_WORDS; ulWord++)
+    {
+        SimReg_SyncSetRegister(SIM_NVIC_EN0_ADDRESS + (ulWord * 4u),
+                               &aulEnabled[ulWord], &aulEnabledPublished[ulWord]);
+        aulEnabled[ulWord] &= ~SimReg_Take(SIM_NVIC_DIS0_ADDRESS + (ulWord * 4u));
+        SimReg_SyncSetRegister(SIM_NVIC_EN0_ADDRESS + (ulWord * 4u),
+                               &aulEnabled[ulWord], &aulEnabledPublished[ulWord]);
+
+        SimReg_SyncSetRegister(SIM_NVIC_PEND0_ADDRESS + (ulWord * 4u),
+                               &aulPending[ulWord], &aulPendingPublished[ulWord]);
+        aulPending[ulWord] &= ~SimReg_Take(SIM_NVIC_UNPEND0_ADDRESS + (ulWord * 4u));
+        SimReg_SyncSetRegister(SIM_NVIC_PEND0_ADDRESS + (ulWord * 4u),
+                               &aulPending[ulWord], &aulPendingPublished[ulWord]);
+    }
+}
+
+static void prvEvaluate(uint32 ulIrq)
+{
+    uint32 ulWord = ulIrq / 32u;
+    uint32 ulBit = 1u << (ulIrq % 32u);
+
+    /* A line that stays asserted while its handler runs is taken again when
+     * the handler returns, so only latch it while the line is not active */
+    if (!abActive[ulIrq] && (apfnSources[ulIrq] != NULL_PTR) && apfnSources[ulIrq](ulIrq))
+    {
+        aulPending[ulWord] |= ulBit;
+    }
+
+    if ((aulPending[ulWord] & ulBit) && (aulEnabled[ulWord] & ulBit) && !abActive[ulIrq])
+    {
+        aulPending[ulWord] &= ~ulBit;
+        SimReg_SyncSetRegister(SIM_NVIC_PEND0_ADDRESS + (ulWord * 4u),
+                               &aulPending[ulWord], &aulPendingPublished[ulWord]);
+        abActive[ulIrq] = TRUE;
+        vPortGenerateSimulatedInterrupt(ulIrq);
+    }
+}
+
+static void prvDispatch(uint32 ulIrq)
+{
+    uint32 ulVector = ulIrq + SIM_NVIC_FIRST_IRQ_VECTOR;
+
+    SimReg_Lock();
+    aullDispatched[ulIrq]++;
+    SIM_REG(SIM_NVIC_ACTIVE0_ADDRESS + ((ulIrq / 32u) * 4u)) |= (1u << (ulIrq % 32u));
+    SimReg_Unlock();
+
+    if (apfnRamVectors[ulVector] != NULL_PTR)
+    {
+        apfnRamVectors[ulVector]();
+    }
+    else if ((ulVector < g_ulSimVectorCount) && (g_pfnSimVectors[ulVector] != NULL_PTR))
+    {
+        g_pfnSimVectors[ulVector]();
+    }
+    else
+    {
+        /* IntDefaultHandler on the target spins here forever */
+        fprintf(stderr, "HostSim: unhandled interrupt %u (vector %u)\n", ulIrq, ulVector);
+        abort();
+    }
+
+    SimReg_Lock();
+    SIM_REG(SIM_NVIC_ACTIVE0_ADDRESS + ((ulIrq / 32u) * 4u)) &= ~(1u << (ulIrq % 32u));
+    abActive[ulIrq] = FALSE;
+    prvApplyWrites();
+    prvEvaluate(ulIrq);
+    SimReg_Unlock();
+}
+
+static void prvAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    (void)ulAddress;
+    SimNvic_Service(ullNowNs);
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimNvic_Init(void)
+{
+    uint32 ulIrq;
+
+    for (ulIrq = 0; ulIrq < SIM_NVIC_NUM_IRQS; ulIrq++)
+    {
+        vPortSetInterruptHandler(ulIrq, prvDispatch);
+    }
+    SimReg_RegisterHook(SIM_NVIC_EN0_ADDRESS, 0x300u, prvAccessHook);
+}
+
+void SimNvic_SetSource(uint32 ulIrq, SimNvic_LevelType pfnLevel)
+{
+    apfnSources[ulIrq] = pfnLevel;
+}
+
+void SimNvic_Update(uint32 ulIrq)
+{
+    prvApplyWrites();
+    prvEvaluate(ulIrq);
+}
+
+void SimNvic_SetPending(uint32 ulIrq)
+{
+    aulPending[ulIrq / 32u] |= (1u << (ulIrq % 32u));
+    SimReg_SyncSetRegister(SIM_NVIC_PEND0_ADDRESS + ((ulIrq / 32u) * 4u),
+                           &aulPending[ulIrq / 32u], &aulPendingPublished[ulIrq / 32u]);
+    prvEvaluate(ulIrq);
+}
+
+void SimNvic_Service(uint64 ullNowNs)
+{
+    uint32 ulIrq;
+
+    (void)ullNowNs;
+    prvApplyWrites();
+    for (ulIrq = 0; ulIrq < SIM_NVIC_NUM_IRQS; ulIrq++)
+    {
+        prvEvaluate(ulIrq);
+    }
+}
+
+void SimNvic_SetVector(uint32 ulVector, void (*pfnHandler)(void))
+{
+    if ((ulVector >= SIM_NVIC_FIRST_IRQ_VECTOR) &&
+        (ulVector < (SIM_NVIC_FIRST_IRQ_VECTOR + SIM_NVIC_NUM_IRQS)))
+    {
+        SimReg_Lock();
+        apfnRamVectors[ulVector] = pfnHandler;
+        SimReg_Unlock();
+    }
+}
+
+uint64 SimNvic_GetDispatchCount(uint32 ulIrq)
+{
+    return aullDispatched[ulIrq];
+}
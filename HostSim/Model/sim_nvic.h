@@ -0,0 +1,68 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - NVIC
+ *
+ * File Name: sim_nvic.h
+ *
+ * Description: Header for the simulated NVIC. Peripheral models describe
+ *              their interrupt lines as levels; the NVIC raises the matching
+ *              vector of the firmware's startup table on the FreeRTOS port.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_NVIC_H_
+#define SIM_NVIC_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_NVIC_FIRST_IRQ_VECTOR   16u     /* Vector number of IRQ 0 */
+#define SIM_NVIC_NUM_IRQS           139u    /* TM4C123GH6PM interrupt lines */
+
+#define SIM_NVIC_EN0_ADDRESS        0xE000E100u
+#define SIM_NVIC_DIS0_ADDRESS       0xE000E180u
+#define SIM_NVIC_PEND0_ADDRESS      0xE000E200u
+#define SIM_NVIC_UNPEND0_ADDRESS    0xE000E280u
+#define SIM_NVIC_ACTIVE0_ADDRESS    0xE000E300u
+#define SIM_NVIC_NUM_WORDS          5u
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Returns TRUE while the peripheral asserts the interrupt line. Called with
+ * the model locked. */
+typedef boolean (*SimNvic_LevelType)(uint32 ulIrq);
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void SimNvic_Init(void);
+extern void SimNvic_SetSource(uint32 ulIrq, SimNvic_LevelType pfnLevel);
+
+/* Re-evaluate one line after its peripheral changed state (model locked) */
+extern void SimNvic_Update(uint32 ulIrq);
+
+/* Pend a line for an event without a status bit behind it, such as the uDMA
+ * done signal on a peripheral vector (model locked) */
+extern void SimNvic_SetPending(uint32 ulIrq);
+
+/* Re-evaluate every line, picking up enable register writes (model locked) */
+extern void SimNvic_Service(uint64 ullNowNs);
+
+/* Install (or with NULL_PTR remove) a run time handler for an IRQ vector */
+extern void SimNvic_SetVector(uint32 ulVector, void (*pfnHandler)(void));
+
+extern uint64 SimNvic_GetDispatchCount(uint32 ulIrq);
+
+/* Generated from the vector table of tm4c123gh6pm_startup_ccs.c */
+extern void (* const g_pfnSimVectors[])(void);
+extern const uint32 g_ulSimVectorCount;
+
+#endif /* SIM_NVIC_H_ */
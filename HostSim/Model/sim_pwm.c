@@ -0,0 +1,335 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - PWM
+ *
+ * File Name: sim_pwm.c
+ *
+ * Description: Simulated PWM0 module. The four generators count down from
+ *              the PWM clock (system clock through the RCC PWM divider) and
+ *              their outputs are modelled as driverlib's PWMGenConfigure()
+ *              sets them up for down count mode: high from the load value to
+ *              the compare value. Compare values, the load value and the
+ *              output enables take effect at once or, in the synchronized
+ *              update modes, at the next reload of the generator. Every
+ *              reload raises the counter load and zero interrupt status.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "sim_nvic.h"
+#include "sim_pwm.h"
+#include "sim_registers.h"
+#include "sim_sysctl.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_PWM_BASE             0x40028000u
+#define SIM_PWM_BLOCK_SIZE       0x1000u
+
+#define SIM_PWM_ENABLE           (SIM_PWM_BASE + 0x008u)
+#define SIM_PWM_INTEN            (SIM_PWM_BASE + 0x014u)
+#define SIM_PWM_RIS              (SIM_PWM_BASE + 0x018u)
+#define SIM_PWM_ISC              (SIM_PWM_BASE + 0x01Cu)
+#define SIM_PWM_ENUPD            (SIM_PWM_BASE + 0x028u)
+
+/* Generator n registers start at 0x40 + 0x40 * n */
+#define SIM_PWM_GEN_BASE(gen)    (SIM_PWM_BASE + 0x040u + ((gen) * 0x040u))
+#define SIM_PWM_X_CTL_OFFSET     0x000u
+#define SIM_PWM_X_INTEN_OFFSET   0x004u
+#define SIM_PWM_X_RIS_OFFSET     0x008u
+#define SIM_PWM_X_ISC_OFFSET     0x00Cu
+#define SIM_PWM_X_LOAD_OFFSET    0x010u
+#define SIM_PWM_X_COUNT_OFFSET   0x014u
+#define SIM_PWM_X_CMPA_OFFSET    0x018u
+#define SIM_PWM_X_CMPB_OFFSET    0x01Cu
+
+#define SIM_PWM_X_CTL_ENABLE     0x01u
+#define SIM_PWM_X_CTL_LOADUPD    0x08u
+#define SIM_PWM_X_CTL_CMPAUPD    0x10u
+#define SIM_PWM_X_CTL_CMPBUPD    0x20u
+#define SIM_PWM_X_INT_CNTZERO    0x01u
+#define SIM_PWM_X_INT_CNTLOAD    0x02u
+#define SIM_PWM_ENUPD_SYNC       0x02u  /* Local and global synchronization */
+
+/* X_ISC is published with this bit set, so a value without it can only be a
+ * write-1-to-clear stored by the firmware (see sim_adc.c) */
+#define SIM_PWM_W1C_MARKER       0x80000000u
+
+/* RCC: USEPWMDIV selects PWMDIV, a divider of 2 to 64 */
+#define SIM_SYSCTL_RCC           (SIM_SYSCTL_BASE + 0x060u)
+#define SIM_SYSCTL_RCC_USEPWMDIV 0x00100000u
+#define SIM_SYSCTL_RCC_PWMDIV(rcc) (((rcc) >> 17) & 0x7u)
+
+#define SIM_PWM_COUNTER_MASK     0xFFFFu
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulIrq;
+    boolean bRunning;
+    uint64 ullStartNs;          /* Time of the first load since the last restart */
+    uint64 ullReloads;          /* Reloads already seen */
+    uint32 ulLoad;              /* Values in effect */
+    uint32 ulCmpA;
+    uint32 ulCmpB;
+    uint32 ulEnabled;           /* Output enables of the A and B pins, bits 0 and 1 */
+    uint32 ulRawStatus;         /* X_RIS */
+} SimPwm_GeneratorType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static SimPwm_GeneratorType axGenerators[SIM_PWM_NUM_GENERATORS] =
+{
+    { 10u }, { 11u }, { 12u }, { 45u }
+};
+
+static SimPwm_StatsType xStats;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+#define GEN_REG(gen, offset)     SIM_REG(SIM_PWM_GEN_BASE(gen) + (offset))
+
+static uint64 prvClockHz(void)
+{
+    uint32 ulRcc = SIM_REG(SIM_SYSCTL_RCC);
+    uint32 ulDivider;
+
+    if ((ulRcc & SIM_SYSCTL_RCC_USEPWMDIV) == 0u)
+    {
+        return SIM_SYSCTL_CLOCK_HZ;
+    }
+    ulDivider = SIM_SYSCTL_RCC_PWMDIV(ulRcc);
+    return SIM_SYSCTL_CLOCK_HZ / (2u << ((ulDivider > 5u) ? 5u : ulDivider));
+}
+
+/* Takes a new register value into effect; bAtReload tells the synchronized
+ * update modes that the generator has just reloaded */
+static void prvLatch(uint32 *pulActive, uint32 ulValue, boolean bSync, boolean bAtReload, boolean bRunning)
+{
+    if ((ulValue == *pulActive) || (bSync && !bAtReload))
+    {
+        return;
+    }
+    *pulActive = ulValue;
+    xStats.ullUpdates++;
+    if (bRunning && !bAtReload)
+    {
+        xStats.ullGlitches++;
+    }
+}
+
+static void prvLatchGenerator(uint32 ulGen, boolean bAtReload)
+{
+    SimPwm_GeneratorType *pxGen = &axGenerators[ulGen];
+    uint32 ulCtl = GEN_REG(ulGen, SIM_PWM_X_CTL_OFFSET);
+    uint32 ulEnupd = SIM_REG(SIM_PWM_ENUPD) >> (ulGen * 4u);
+    uint32 ulEnable = (SIM_REG(SIM_PWM_ENABLE) >> (ulGen * 2u)) & 0x3u;
+    uint32 ulLoad = GEN_REG(ulGen, SIM_PWM_X_LOAD_OFFSET) & SIM_PWM_COUNTER_MASK;
+    uint32 ulActive;
+
+    if ((ulLoad != pxGen->ulLoad) && (!(ulCtl & SIM_PWM_X_CTL_LOADUPD) || bAtReload))
+    {
+        /* A new period starts counting from here */
+        pxGen->ulLoad = ulLoad;
+        pxGen->ullStartNs = SimReg_NowNs();
+        pxGen->ullReloads = 0u;
+    }
+    prvLatch(&pxGen->ulCmpA, GEN_REG(ulGen, SIM_PWM_X_CMPA_OFFSET) & SIM_PWM_COUNTER_MASK,
+             (ulCtl & SIM_PWM_X_CTL_CMPAUPD) != 0u, bAtReload, pxGen->bRunning);
+    prvLatch(&pxGen->ulCmpB, GEN_REG(ulGen, SIM_PWM_X_CMPB_OFFSET) & SIM_PWM_COUNTER_MASK,
+             (ulCtl & SIM_PWM_X_CTL_CMPBUPD) != 0u, bAtReload, pxGen->bRunning);
+
+    /* Each output has its own two-bit ENUPD field */
+    ulActive = pxGen->ulEnabled & 0x1u;
+    prvLatch(&ulActive, ulEnable & 0x1u, (ulEnupd & SIM_PWM_ENUPD_SYNC) != 0u, bAtReload, pxGen->bRunning);
+    pxGen->ulEnabled = (pxGen->ulEnabled & ~0x1u) | ulActive;
+    ulActive = (pxGen->ulEnabled >> 1) & 0x1u;
+    prvLatch(&ulActive, (ulEnable >> 1) & 0x1u, ((ulEnupd >> 2) & SIM_PWM_ENUPD_SYNC) != 0u, bAtReload,
+             pxGen->bRunning);
+    pxGen->ulEnabled = (pxGen->ulEnabled & ~0x2u) | (ulActive << 1);
+}
+
+static void prvUpdateGenerator(uint32 ulGen, uint64 ullNowNs)
+{
+    SimPwm_GeneratorType *pxGen = &axGenerators[ulGen];
+    uint32 ulCtl = GEN_REG(ulGen, SIM_PWM_X_CTL_OFFSET);
+    uint32 ulValue;
+    uint64 ullPeriod;
+    uint64 ullTicks;
+    uint64 ullReloads;
+
+    if ((ulCtl & SIM_PWM_X_CTL_ENABLE) && !pxGen->bRunning)
+    {
+        /* Enabling loads the counter with everything written so far */
+        pxGen->bRunning = TRUE;
+        pxGen->ullStartNs = ullNowNs;
+        pxGen->ullReloads = 0u;
+        pxGen->ulLoad = GEN_REG(ulGen, SIM_PWM_X_LOAD_OFFSET) & SIM_PWM_COUNTER_MASK;
+        prvLatchGenerator(ulGen, TRUE);
+    }
+    else if (!(ulCtl & SIM_PWM_X_CTL_ENABLE) && pxGen->bRunning)
+    {
+        pxGen->bRunning = FALSE;
+    }
+
+    if (pxGen->bRunning)
+    {
+        ullPeriod = (uint64)pxGen->ulLoad + 1u;
+        ullTicks = ((ullNowNs - pxGen->ullStartNs) * prvClockHz()) / 1000000000ull;
+        ullReloads = ullTicks / ullPeriod;
+        if (ullReloads > pxGen->ullReloads)
+        {
+            xStats.ullPeriods += ullReloads - pxGen->ullReloads;
+            pxGen->ullReloads = ullReloads;
+            pxGen->ulRawStatus |= SIM_PWM_X_INT_CNTZERO | SIM_PWM_X_INT_CNTLOAD;
+            prvLatchGenerator(ulGen, TRUE);
+        }
+        GEN_REG(ulGen, SIM_PWM_X_COUNT_OFFSET) = pxGen->ulLoad - (uint32)(ullTicks % ullPeriod);
+    }
+    prvLatchGenerator(ulGen, FALSE);
+
+    do
+    {
+        ulValue = GEN_REG(ulGen, SIM_PWM_X_ISC_OFFSET);
+        if ((ulValue & SIM_PWM_W1C_MARKER) == 0u)
+        {
+            pxGen->ulRawStatus &= ~ulValue;
+        }
+    } while (!SimReg_Publish(SIM_PWM_GEN_BASE(ulGen) + SIM_PWM_X_ISC_OFFSET, ulValue,
+                             (pxGen->ulRawStatus & GEN_REG(ulGen, SIM_PWM_X_INTEN_OFFSET)) |
+                             SIM_PWM_W1C_MARKER));
+    GEN_REG(ulGen, SIM_PWM_X_RIS_OFFSET) = pxGen->ulRawStatus;
+}
+
+static boolean prvGeneratorAsserts(uint32 ulGen)
+{
+    return ((GEN_REG(ulGen, SIM_PWM_X_ISC_OFFSET) & ~SIM_PWM_W1C_MARKER) != 0u) &&
+           ((SIM_REG(SIM_PWM_INTEN) & (1u << ulGen)) != 0u);
+}
+
+static void prvUpdateModule(uint64 ullNowNs)
+{
+    uint32 ulGen;
+    uint32 ulRaw = 0u;
+
+    for (ulGen = 0; ulGen < SIM_PWM_NUM_GENERATORS; ulGen++)
+    {
+        prvUpdateGenerator(ulGen, ullNowNs);
+        if ((GEN_REG(ulGen, SIM_PWM_X_ISC_OFFSET) & ~SIM_PWM_W1C_MARKER) != 0u)
+        {
+            ulRaw |= 1u << ulGen;
+        }
+    }
+    SIM_REG(SIM_PWM_RIS) = ulRaw;
+    SIM_REG(SIM_PWM_ISC) = ulRaw & SIM_REG(SIM_PWM_INTEN);
+}
+
+static void prvAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    uint32 ulGen;
+
+    (void)ulAddress;
+    prvUpdateModule(ullNowNs);
+    for (ulGen = 0; ulGen < SIM_PWM_NUM_GENERATORS; ulGen++)
+    {
+        SimNvic_Update(axGenerators[ulGen].ulIrq);
+    }
+}
+
+static boolean prvInterruptLevel(uint32 ulIrq)
+{
+    uint32 ulGen;
+
+    prvUpdateModule(SimReg_NowNs());
+    for (ulGen = 0; ulGen < SIM_PWM_NUM_GENERATORS; ulGen++)
+    {
+        if (axGenerators[ulGen].ulIrq == ulIrq)
+        {
+            return prvGeneratorAsserts(ulGen);
+        }
+    }
+    return FALSE;
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimPwm_Init(void)
+{
+    uint32 ulGen;
+
+    for (ulGen = 0; ulGen < SIM_PWM_NUM_GENERATORS; ulGen++)
+    {
+        GEN_REG(ulGen, SIM_PWM_X_ISC_OFFSET) = SIM_PWM_W1C_MARKER;
+        SimNvic_SetSource(axGenerators[ulGen].ulIrq, prvInterruptLevel);
+    }
+    SimReg_RegisterHook(SIM_PWM_BASE, SIM_PWM_BLOCK_SIZE, prvAccessHook);
+}
+
+void SimPwm_Service(uint64 ullNowNs)
+{
+    prvUpdateModule(ullNowNs);
+}
+
+uint64 SimPwm_NextDeadline(uint64 ullNowNs)
+{
+    SimPwm_GeneratorType *pxGen;
+    uint32 ulGen;
+    uint64 ullNext = SIM_PWM_NO_DEADLINE;
+    uint64 ullDeadline;
+
+    (void)ullNowNs;
+    for (ulGen = 0; ulGen < SIM_PWM_NUM_GENERATORS; ulGen++)
+    {
+        pxGen = &axGenerators[ulGen];
+        /* Only reloads somebody sees */
+        if (!pxGen->bRunning || ((SIM_REG(SIM_PWM_INTEN) & (1u << ulGen)) == 0u) ||
+            ((GEN_REG(ulGen, SIM_PWM_X_INTEN_OFFSET) & (SIM_PWM_X_INT_CNTZERO | SIM_PWM_X_INT_CNTLOAD)) == 0u))
+        {
+            continue;
+        }
+        ullDeadline = pxGen->ullStartNs
+                    + ((((pxGen->ullReloads + 1u) * ((uint64)pxGen->ulLoad + 1u)) * 1000000000ull)
+                       / prvClockHz()) + 1u;
+        if (ullDeadline < ullNext)
+        {
+            ullNext = ullDeadline;
+        }
+    }
+    return ullNext;
+}
+
+uint32 SimPwm_GetDuty(uint32 ulOutput)
+{
+    SimPwm_GeneratorType *pxGen = &axGenerators[(ulOutput / 2u) % SIM_PWM_NUM_GENERATORS];
+    uint32 ulCompare = ((ulOutput & 1u) == 0u) ? pxGen->ulCmpA : pxGen->ulCmpB;
+
+    if (!pxGen->bRunning || ((pxGen->ulEnabled & (1u << (ulOutput & 1u))) == 0u))
+    {
+        return 0u;
+    }
+    /* A compare value at or above the load value never pulls the pin low */
+    if (ulCompare >= pxGen->ulLoad)
+    {
+        return SIM_PWM_DUTY_MAX;
+    }
+    return (uint32)((((uint64)pxGen->ulLoad - ulCompare) * SIM_PWM_DUTY_MAX) / ((uint64)pxGen->ulLoad + 1u));
+}
+
+void SimPwm_GetStats(SimPwm_StatsType *pxStats)
+{
+    SimReg_Lock();
+    *pxStats = xStats;
+    SimReg_Unlock();
+}
@@ -0,0 +1,54 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - PWM
+ *
+ * File Name: sim_pwm.h
+ *
+ * Description: Header for the simulated PWM0 module of the Linux host build
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_PWM_H_
+#define SIM_PWM_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_PWM_NUM_GENERATORS  4u
+#define SIM_PWM_NUM_OUTPUTS     8u      /* M0PWM0 - M0PWM7, two per generator */
+#define SIM_PWM_DUTY_MAX        1000u   /* Per mille */
+#define SIM_PWM_NO_DEADLINE     0xFFFFFFFFFFFFFFFFull
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint64 ullPeriods;          /* Generator periods completed, all generators */
+    uint64 ullUpdates;          /* Compare or output enable changes taking effect */
+    uint64 ullGlitches;         /* Of those, the ones in the middle of a period */
+} SimPwm_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void SimPwm_Init(void);
+extern void SimPwm_Service(uint64 ullNowNs);
+
+/* Host time of the next generator reload that would raise an interrupt */
+extern uint64 SimPwm_NextDeadline(uint64 ullNowNs);
+
+/* Duty cycle an output pin runs at, 0 while its generator or the output is
+ * disabled (model locked) */
+extern uint32 SimPwm_GetDuty(uint32 ulOutput);
+
+extern void SimPwm_GetStats(SimPwm_StatsType *pxStats);
+
+#endif /* SIM_PWM_H_ */
@@ -0,0 +1,167 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Register File
+ *
+ * File Name: sim_registers.c
+ *
+ * Description: In-memory register file for the Linux host build. Every
+ *              register macro of tm4c123gh6pm_registers.h is rewritten at
+ *              build time to go through SimReg_Map(), which gives the
+ *              peripheral models a chance to update the register before the
+ *              firmware reads or writes it.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sim_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_MAX_HOOKS            32u
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulBase;
+    uint32 ulSize;
+    SimReg_HookType pfnHook;
+} SimReg_HookEntryType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 aulPeripheralSpace[SIM_PERIPHERAL_SIZE / 4u];
+static uint32 aulSystemSpace[SIM_SYSTEM_SIZE / 4u];
+
+static SimReg_HookEntryType axHooks[SIM_MAX_HOOKS];
+static uint32 ulHookCount = 0;
+
+static pthread_mutex_t xModelMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+/* The model lock also masks the simulated interrupts, so the running task can
+ * never be switched out while it holds it. */
+static __thread uint32 ulLockNesting = 0;
+static __thread sigset_t xSavedMask;
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+uint64 SimReg_NowNs(void)
+{
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return ((uint64)xNow.tv_sec * 1000000000ull) + (uint64)xNow.tv_nsec;
+}
+
+void SimReg_Lock(void)
+{
+    sigset_t xInterrupts;
+
+    if (ulLockNesting == 0)
+    {
+        sigemptyset(&xInterrupts);
+        sigaddset(&xInterrupts, SIGALRM);
+        sigaddset(&xInterrupts, SIGUSR1);
+        pthread_sigmask(SIG_BLOCK, &xInterrupts, &xSavedMask);
+    }
+    ulLockNesting++;
+    pthread_mutex_lock(&xModelMutex);
+}
+
+void SimReg_Unlock(void)
+{
+    pthread_mutex_unlock(&xModelMutex);
+    ulLockNesting--;
+    if (ulLockNesting == 0)
+    {
+        pthread_sigmask(SIG_SETMASK, &xSavedMask, NULL);
+    }
+}
+
+volatile uint32 *SimReg_Slot(uint32 ulAddress)
+{
+    if ((ulAddress - SIM_PERIPHERAL_BASE) < SIM_PERIPHERAL_SIZE)
+    {
+        return &aulPeripheralSpace[(ulAddress - SIM_PERIPHERAL_BASE) / 4u];
+    }
+    else if ((ulAddress - SIM_SYSTEM_BASE) < SIM_SYSTEM_SIZE)
+    {
+        return &aulSystemSpace[(ulAddress - SIM_SYSTEM_BASE) / 4u];
+    }
+    else
+    {
+        /* The target would take a bus fault here */
+        fprintf(stderr, "HostSim: access to unmapped register 0x%08X\n", ulAddress);
+        abort();
+    }
+}
+
+uint32 SimReg_Take(uint32 ulAddress)
+{
+    return __atomic_exchange_n(SimReg_Slot(ulAddress), 0u, __ATOMIC_SEQ_CST);
+}
+
+boolean SimReg_Publish(uint32 ulAddress, uint32 ulExpected, uint32 ulValue)
+{
+    return __atomic_compare_exchange_n(SimReg_Slot(ulAddress), &ulExpected, ulValue, FALSE,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+}
+
+void SimReg_SyncSetRegister(uint32 ulAddress, uint32 *pulState, uint32 *pulPublished)
+{
+    uint32 ulValue;
+
+    do
+    {
+        ulValue = SIM_REG(ulAddress);
+        *pulState |= ulValue & ~(*pulPublished);
+    } while (!SimReg_Publish(ulAddress, ulValue, *pulState));
+    *pulPublished = *pulState;
+}
+
+void SimReg_RegisterHook(uint32 ulBase, uint32 ulSize, SimReg_HookType pfnHook)
+{
+    if (ulHookCount >= SIM_MAX_HOOKS)
+    {
+        fprintf(stderr, "HostSim: too many register hooks\n");
+        abort();
+    }
+    axHooks[ulHookCount].ulBase = ulBase;
+    axHooks[ulHookCount].ulSize = ulSize;
+    axHooks[ulHookCount].pfnHook = pfnHook;
+    ulHookCount++;
+}
+
+volatile uint32 *SimReg_Map(uint32 ulAddress)
+{
+    uint32 ulIndex;
+    uint64 ullNow;
+
+    SimReg_Lock();
+    ullNow = SimReg_NowNs();
+    for (ulIndex = 0; ulIndex < ulHookCount; ulIndex++)
+    {
+        if ((ulAddress - axHooks[ulIndex].ulBase) < axHooks[ulIndex].ulSize)
+        {
+            axHooks[ulIndex].pfnHook(ulAddress, ullNow);
+        }
+    }
+    SimReg_Unlock();
+
+    return SimReg_Slot(ulAddress);
+}
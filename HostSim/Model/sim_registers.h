@@ -0,0 +1,68 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Register File
+ *
+ * File Name: sim_registers.h
+ *
+ * Description: Header for the in-memory register file that backs the
+ *              tm4c123gh6pm_registers.h macros in the Linux host build
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_REGISTERS_H_
+#define SIM_REGISTERS_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Address windows backed by the register file */
+#define SIM_PERIPHERAL_BASE      0x40000000u   /* APB/AHB peripherals */
+#define SIM_PERIPHERAL_SIZE      0x00100000u
+#define SIM_SYSTEM_BASE          0xE0000000u   /* Private peripheral bus: DWT, NVIC, SysTick, SCB */
+#define SIM_SYSTEM_SIZE          0x0000F000u
+
+/* Register access from inside the model: no hooks, caller holds the lock */
+#define SIM_REG(address)         (*SimReg_Slot(address))
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Called with the model locked before every firmware access to the range it
+ * was registered for, so a peripheral can bring its registers up to date
+ * (drain a FIFO, advance a timer, consume a write) before they are used. */
+typedef void (*SimReg_HookType)(uint32 ulAddress, uint64 ullNowNs);
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Firmware side: every XXX_REG macro expands to *SimReg_Map(address) */
+extern volatile uint32 *SimReg_Map(uint32 ulAddress);
+
+/* Model side */
+extern volatile uint32 *SimReg_Slot(uint32 ulAddress);
+
+/* The firmware stores to a register after its hook has returned, so a model
+ * updating a register the firmware also writes must not lose such a store:
+ * Take reads and clears a write-only register in one step, Publish replaces
+ * a value only if the firmware has not changed it since it was read. */
+extern uint32 SimReg_Take(uint32 ulAddress);
+extern boolean SimReg_Publish(uint32 ulAddress, uint32 ulExpected, uint32 ulValue);
+
+/* Fold firmware writes of a write-1-to-set register into *pulState and
+ * publish the result. A bit only counts as written when it was not already
+ * published, so the model may clear bits of *pulState on its own. */
+extern void SimReg_SyncSetRegister(uint32 ulAddress, uint32 *pulState, uint32 *pulPublished);
+
+extern void SimReg_RegisterHook(uint32 ulBase, uint32 ulSize, SimReg_HookType pfnHook);
+extern void SimReg_Lock(void);
+extern void SimReg_Unlock(void);
+extern uint64 SimReg_NowNs(void);
+
+#endif /* SIM_REGISTERS_H_ */
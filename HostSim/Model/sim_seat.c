@@ -0,0 +1,225 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Seat
+ *
+ * File Name: sim_seat.c
+ *
+ * Description: First-order thermal model of the two heated seats. Each seat
+ *              heats towards ambient + rise * duty with the time constant tau,
+ *              where the duty is what the heater's PWM output actually runs
+ *              at, and its temperature drives the seat's LM35 input. The
+ *              firmware reads the raw ADC code as degrees, so the model works
+ *              in those units as well.
+ *
+ *              Every heating target the firmware sets starts a measurement:
+ *              the time until the seat first comes within the band of the
+ *              target, the settling time until it enters the band for the
+ *              last time before the next target, and the largest error after
+ *              the band was first reached.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "sim_adc.h"
+#include "sim_pwm.h"
+#include "sim_registers.h"
+#include "sim_seat.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_SEAT_ADC_CODES      4096.0  /* Codes over SIM_ADC_VREF_MV */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulPwmOutput;         /* M0PWMx of the heater */
+    uint32 ulAdcChannel;        /* AINx of the LM35 */
+    double dAmbientC;
+    uint32 ulTargetC;
+    uint64 ullTargetNs;         /* Time the target was set */
+    boolean bReached;
+    boolean bInBand;
+    uint64 ullEnteredNs;        /* Time the seat last entered the band */
+    uint64 ullLastNs;
+    double dDutyIntegral;       /* Per mille * s */
+    double dRunS;
+    SimSeat_StatsType xStats;
+} SimSeat_SeatType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static SimSeat_SeatType axSeats[SIM_SEAT_NUM_SEATS] =
+{
+    { 0u, 0u },                 /* Driver: M0PWM0 (PB6), AIN0 (PE3) */
+    { 2u, 1u },                 /* Passenger: M0PWM2 (PB4), AIN1 (PE2) */
+};
+
+static SimSeat_ConfigType xConfig;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvDriveInput(SimSeat_SeatType *pxSeat)
+{
+    double dMicrovolts = (pxSeat->xStats.dTemperatureC * SIM_ADC_VREF_MV * 1000.0) / SIM_SEAT_ADC_CODES;
+
+    /* Rounded up so the code does not fall a whole degree short */
+    SimAdc_SetInputMicrovolts(pxSeat->ulAdcChannel, (dMicrovolts > 0.0) ? (uint32)(dMicrovolts + 1.0) : 0u);
+}
+
+/* Ends the settling measurement of the current target */
+static void prvSettle(const SimSeat_SeatType *pxSeat, SimSeat_StatsType *pxStats)
+{
+    uint64 ullTimeNs;
+
+    if ((pxSeat->ulTargetC == 0u) || !pxSeat->bInBand)
+    {
+        return;
+    }
+    ullTimeNs = pxSeat->ullEnteredNs - pxSeat->ullTargetNs;
+    pxStats->ullSettled++;
+    pxStats->ullSettlingTotalNs += ullTimeNs;
+    if (ullTimeNs > pxStats->ullSettlingMaxNs)
+    {
+        pxStats->ullSettlingMaxNs = ullTimeNs;
+    }
+}
+
+static void prvMeasure(SimSeat_SeatType *pxSeat, uint64 ullNowNs)
+{
+    double dError = pxSeat->xStats.dTemperatureC - (double)pxSeat->ulTargetC;
+    boolean bInBand = (dError >= -xConfig.dBandC) && (dError <= xConfig.dBandC);
+    uint64 ullTimeNs;
+
+    if (pxSeat->ulTargetC == 0u)
+    {
+        return;
+    }
+    if (bInBand && !pxSeat->bInBand)
+    {
+        pxSeat->ullEnteredNs = ullNowNs;
+    }
+    pxSeat->bInBand = bInBand;
+    if (!pxSeat->bReached)
+    {
+        if (!bInBand)
+        {
+            return;
+        }
+        pxSeat->bReached = TRUE;
+        ullTimeNs = ullNowNs - pxSeat->ullTargetNs;
+        pxSeat->xStats.ullReached++;
+        pxSeat->xStats.ullTimeToTargetTotalNs += ullTimeNs;
+        if (ullTimeNs > pxSeat->xStats.ullTimeToTargetMaxNs)
+        {
+            pxSeat->xStats.ullTimeToTargetMaxNs = ullTimeNs;
+        }
+    }
+    if (dError > pxSeat->xStats.dMaxOvershootC)
+    {
+        pxSeat->xStats.dMaxOvershootC = dError;
+    }
+    if (dError < 0.0)
+    {
+        dError = -dError;
+    }
+    if (dError > pxSeat->xStats.dMaxErrorC)
+    {
+        pxSeat->xStats.dMaxErrorC = dError;
+    }
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimSeat_Init(const SimSeat_ConfigType *pxConfig, const uint32 *pulAmbientMillivolts)
+{
+    uint32 ulSeat;
+    SimSeat_SeatType *pxSeat;
+
+    xConfig = *pxConfig;
+    for (ulSeat = 0; ulSeat < SIM_SEAT_NUM_SEATS; ulSeat++)
+    {
+        pxSeat = &axSeats[ulSeat];
+        pxSeat->dAmbientC = ((double)pulAmbientMillivolts[ulSeat] * SIM_SEAT_ADC_CODES) / SIM_ADC_VREF_MV;
+        pxSeat->xStats.dTemperatureC = pxSeat->dAmbientC;
+        pxSeat->ullLastNs = SimReg_NowNs();
+        prvDriveInput(pxSeat);
+    }
+}
+
+void SimSeat_Service(uint64 ullNowNs)
+{
+    uint32 ulSeat;
+    SimSeat_SeatType *pxSeat;
+    double dDuty;
+    double dStepS;
+
+    for (ulSeat = 0; ulSeat < SIM_SEAT_NUM_SEATS; ulSeat++)
+    {
+        pxSeat = &axSeats[ulSeat];
+        if (ullNowNs <= pxSeat->ullLastNs)
+        {
+            continue;
+        }
+        dStepS = (double)(ullNowNs - pxSeat->ullLastNs) / 1e9;
+        pxSeat->ullLastNs = ullNowNs;
+
+        /* The service thread runs at least every millisecond, far below tau,
+         * so a forward Euler step is accurate enough */
+        if (dStepS > xConfig.dTauS)
+        {
+            dStepS = xConfig.dTauS;
+        }
+        dDuty = (double)SimPwm_GetDuty(pxSeat->ulPwmOutput);
+        pxSeat->xStats.dTemperatureC +=
+            ((pxSeat->dAmbientC + ((xConfig.dRiseC * dDuty) / SIM_PWM_DUTY_MAX) - pxSeat->xStats.dTemperatureC)
+             * dStepS) / xConfig.dTauS;
+        pxSeat->dDutyIntegral += dDuty * dStepS;
+        pxSeat->dRunS += dStepS;
+        pxSeat->xStats.dMeanDuty = pxSeat->dDutyIntegral / pxSeat->dRunS;
+
+        prvDriveInput(pxSeat);
+        prvMeasure(pxSeat, ullNowNs);
+    }
+}
+
+void SimSeat_SetTarget(uint32 ulSeat, uint32 ulTargetC, uint64 ullNowNs)
+{
+    SimSeat_SeatType *pxSeat = &axSeats[ulSeat % SIM_SEAT_NUM_SEATS];
+
+    if (ulTargetC == pxSeat->ulTargetC)
+    {
+        return;
+    }
+    prvSettle(pxSeat, &pxSeat->xStats);
+    pxSeat->ulTargetC = ulTargetC;
+    pxSeat->ullTargetNs = ullNowNs;
+    pxSeat->bReached = FALSE;
+    pxSeat->bInBand = FALSE;
+    if (ulTargetC != 0u)
+    {
+        pxSeat->xStats.ullTargets++;
+    }
+}
+
+void SimSeat_GetStats(uint32 ulSeat, SimSeat_StatsType *pxStats)
+{
+    const SimSeat_SeatType *pxSeat = &axSeats[ulSeat % SIM_SEAT_NUM_SEATS];
+
+    SimReg_Lock();
+    /* A target still held at the end of the run counts if it settled */
+    *pxStats = pxSeat->xStats;
+    prvSettle(pxSeat, pxStats);
+    SimReg_Unlock();
+}
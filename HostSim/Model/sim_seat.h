@@ -0,0 +1,67 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Seat
+ *
+ * File Name: sim_seat.h
+ *
+ * Description: Header for the thermal model of the two heated seats
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_SEAT_H_
+#define SIM_SEAT_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_SEAT_NUM_SEATS      2u      /* Driver, passenger */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    double dRiseC;              /* Temperature rise above ambient at full power */
+    double dTauS;               /* Thermal time constant */
+    double dBandC;              /* Distance from the target that counts as reached */
+} SimSeat_ConfigType;
+
+/* Temperatures are in the firmware's degrees, one per ADC code */
+typedef struct
+{
+    double dTemperatureC;
+    double dMeanDuty;           /* Per mille, over the whole run */
+    uint64 ullTargets;          /* Heating targets set */
+    uint64 ullReached;          /* Of those, reached within the band */
+    uint64 ullTimeToTargetTotalNs;
+    uint64 ullTimeToTargetMaxNs;
+    uint64 ullSettled;          /* Targets the seat stayed within the band of */
+    uint64 ullSettlingTotalNs;  /* Until the seat entered the band for the last time */
+    uint64 ullSettlingMaxNs;
+    double dMaxOvershootC;      /* Above the target, after reaching it */
+    double dMaxErrorC;          /* Either side of the target, after reaching it */
+} SimSeat_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Both seats start at the ambient temperature of their LM35 input */
+extern void SimSeat_Init(const SimSeat_ConfigType *pxConfig, const uint32 *pulAmbientMillivolts);
+
+/* Advances the seats with the heater duty of their PWM outputs and drives
+ * the LM35 inputs (model locked) */
+extern void SimSeat_Service(uint64 ullNowNs);
+
+/* Desired temperature the firmware regulates a seat to, 0 when off */
+extern void SimSeat_SetTarget(uint32 ulSeat, uint32 ulTargetC, uint64 ullNowNs);
+
+extern void SimSeat_GetStats(uint32 ulSeat, SimSeat_StatsType *pxStats);
+
+#endif /* SIM_SEAT_H_ */
@@ -0,0 +1,58 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - System Control
+ *
+ * File Name: sim_sysctl.c
+ *
+ * Description: Simulated system control block. Identifies the part as a
+ *              TM4C123 in DID0 and makes every peripheral whose clock is
+ *              enabled in an RCGCx register report ready in the matching
+ *              PRx register, which is what the MCAL drivers poll for.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "sim_registers.h"
+#include "sim_sysctl.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_SYSCTL_BLOCK_SIZE    0x1000u
+#define SIM_SYSCTL_DID0          (SIM_SYSCTL_BASE + 0x000u)
+#define SIM_SYSCTL_DID1          (SIM_SYSCTL_BASE + 0x004u)
+
+/* DID0: version 1, TM4C123 class, revision B1. DID1: TM4C123GH6PM */
+#define SIM_SYSCTL_DID0_VALUE    0x18050101u
+#define SIM_SYSCTL_DID1_VALUE    0x10A1606Eu
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    uint32 ulOffset;
+
+    (void)ulAddress;
+    (void)ullNowNs;
+
+    /* Peripherals come out of reset as soon as their clock is enabled */
+    for (ulOffset = 0; ulOffset < SIM_SYSCTL_BANK_SIZE; ulOffset += 4u)
+    {
+        SIM_REG(SIM_SYSCTL_PR_BASE + ulOffset) = SIM_REG(SIM_SYSCTL_RCGC_BASE + ulOffset);
+    }
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimSysCtl_Init(void)
+{
+    SIM_REG(SIM_SYSCTL_DID0) = SIM_SYSCTL_DID0_VALUE;
+    SIM_REG(SIM_SYSCTL_DID1) = SIM_SYSCTL_DID1_VALUE;
+    SimReg_RegisterHook(SIM_SYSCTL_BASE, SIM_SYSCTL_BLOCK_SIZE, prvAccessHook);
+}
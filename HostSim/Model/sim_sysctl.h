@@ -0,0 +1,37 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - System Control
+ *
+ * File Name: sim_sysctl.h
+ *
+ * Description: Header for the simulated system control block of the Linux
+ *              host build
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_SYSCTL_H_
+#define SIM_SYSCTL_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_SYSCTL_BASE             0x400FE000u
+#define SIM_SYSCTL_CLOCK_HZ         16000000u       /* PIOSC, no PLL */
+
+/* Run mode clock gating control and peripheral ready register banks */
+#define SIM_SYSCTL_RCGC_BASE        (SIM_SYSCTL_BASE + 0x600u)
+#define SIM_SYSCTL_PR_BASE          (SIM_SYSCTL_BASE + 0xA00u)
+#define SIM_SYSCTL_BANK_SIZE        0x80u
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void SimSysCtl_Init(void);
+
+#endif /* SIM_SYSCTL_H_ */
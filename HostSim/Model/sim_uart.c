@@ -0,0 +1,308 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - UART0
+ *
+ * File Name: sim_uart.c
+ *
+ * Description: Simulated UART0 transmitter. A byte written to DR enters the
+ *              transmit FIFO (one entry deep while FEN = 0) and takes one
+ *              frame time at the programmed baud rate to shift out, so FR
+ *              reports TXFE/TXFF/BUSY the way the firmware would see them on
+ *              the target. The transmit interrupt is raised when the FIFO
+ *              drains through the IFLS trigger level (the holding register
+ *              empties while FEN = 0). With TXDMAE set, the FIFO draining to
+ *              that level makes a burst request on uDMA channel 9, and the
+ *              finished transfer pends the UART0 vector. Transmitted bytes
+ *              are written to stdout as they are, so the binary telemetry
+ *              can be piped into Tools/Telemetry/telemetry_dump.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <unistd.h>
+
+#include "sim_nvic.h"
+#include "sim_registers.h"
+#include "sim_uart.h"
+#include "sim_udma.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_UART0_BASE           0x4000C000u
+#define SIM_UART0_IRQ            5u
+#define SIM_UART0_TX_DMA_CHANNEL 9u
+#define SIM_UART_BLOCK_SIZE      0x1000u
+#define SIM_UART_CLOCK_HZ        16000000u
+
+#define SIM_UART_DR_OFFSET       0x000u
+#define SIM_UART_FR_OFFSET       0x018u
+#define SIM_UART_IBRD_OFFSET     0x024u
+#define SIM_UART_FBRD_OFFSET     0x028u
+#define SIM_UART_LCRH_OFFSET     0x02Cu
+#define SIM_UART_CTL_OFFSET      0x030u
+#define SIM_UART_IFLS_OFFSET     0x034u
+#define SIM_UART_IM_OFFSET       0x038u
+#define SIM_UART_RIS_OFFSET      0x03Cu
+#define SIM_UART_MIS_OFFSET      0x040u
+#define SIM_UART_ICR_OFFSET      0x044u
+#define SIM_UART_DMACTL_OFFSET   0x048u
+
+#define SIM_UART_FR_BUSY         0x08u
+#define SIM_UART_FR_RXFE         0x10u
+#define SIM_UART_FR_TXFF         0x20u
+#define SIM_UART_FR_TXFE         0x80u
+#define SIM_UART_LCRH_FEN        0x10u
+#define SIM_UART_CTL_UARTEN      0x001u
+#define SIM_UART_CTL_TXE         0x100u
+#define SIM_UART_INT_TX          0x20u
+#define SIM_UART_DMACTL_TXDMAE   0x02u
+
+#define SIM_UART_FIFO_DEPTH      16u
+#define SIM_UART_BITS_PER_FRAME  10u    /* start + 8 data + stop */
+
+/* DR holds this between firmware writes so a new write can be told apart */
+#define SIM_UART_DR_EMPTY        0xFFFFFFFFu
+
+#define SIM_UART_LINE_SIZE       256u
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 ulTxCount = 0;            /* Bytes in the FIFO plus the shifter */
+static uint64 ullTxDoneNs = 0;          /* When the byte in the shifter is out */
+static boolean bTxAboveLevel = FALSE;   /* FIFO filled past the TX trigger level */
+static boolean bDmaRequesting = FALSE;  /* A burst is being moved into DR */
+static SimUart_StatsType xStats;
+
+static char acLine[SIM_UART_LINE_SIZE];
+static uint32 ulLineLength = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+#define UART_REG(offset)   SIM_REG(SIM_UART0_BASE + (offset))
+
+static uint64 prvFrameTimeNs(void)
+{
+    /* BRD = IBRD + FBRD / 64 and baud = UARTSysClk / (16 * BRD) */
+    uint64 ullDivisor64 = ((uint64)UART_REG(SIM_UART_IBRD_OFFSET) * 64u)
+                        + (UART_REG(SIM_UART_FBRD_OFFSET) & 0x3Fu);
+
+    if (ullDivisor64 == 0u)
+    {
+        ullDivisor64 = 64u;
+    }
+    xStats.ulBaudRate = (uint32)(((uint64)SIM_UART_CLOCK_HZ * 64u) / (16u * ullDivisor64));
+
+    return (SIM_UART_BITS_PER_FRAME * 16u * ullDivisor64 * 1000000000ull)
+           / ((uint64)SIM_UART_CLOCK_HZ * 64u);
+}
+
+static void prvEmit(uint8 ucByte)
+{
+    acLine[ulLineLength++] = (char)ucByte;
+
+    /* A zero byte ends a binary telemetry frame the way '\n' ends a line */
+    if ((ucByte == '\n') || (ucByte == 0u) || (ulLineLength == SIM_UART_LINE_SIZE))
+    {
+        SimUart_Flush();
+    }
+}
+
+static void prvDrain(uint64 ullNowNs)
+{
+    uint64 ullFrame;
+
+    if (ulTxCount == 0u)
+    {
+        return;
+    }
+    ullFrame = prvFrameTimeNs();
+    while ((ulTxCount > 0u) && (ullNowNs >= ullTxDoneNs))
+    {
+        ulTxCount--;
+        xStats.ullTxBytes++;
+        xStats.ullLastTxNs = ullTxDoneNs;
+        if (ulTxCount > 0u)
+        {
+            ullTxDoneNs += ullFrame;
+        }
+    }
+}
+
+static void prvConsumeWrite(uint64 ullNowNs)
+{
+    uint32 ulDepth;
+    uint32 ulData = __atomic_exchange_n(&UART_REG(SIM_UART_DR_OFFSET), SIM_UART_DR_EMPTY,
+                                        __ATOMIC_SEQ_CST);
+
+    if (ulData == SIM_UART_DR_EMPTY)
+    {
+        return;
+    }
+    if ((UART_REG(SIM_UART_CTL_OFFSET) & (SIM_UART_CTL_UARTEN | SIM_UART_CTL_TXE))
+            != (SIM_UART_CTL_UARTEN | SIM_UART_CTL_TXE))
+    {
+        return;
+    }
+
+    ulDepth = (UART_REG(SIM_UART_LCRH_OFFSET) & SIM_UART_LCRH_FEN) ? SIM_UART_FIFO_DEPTH : 1u;
+    if ((ulTxCount > 0u) && ((ulTxCount - 1u) >= ulDepth))
+    {
+        xStats.ullTxDropped++;
+        return;
+    }
+
+    if (ulTxCount == 0u)
+    {
+        ullTxDoneNs = ullNowNs + prvFrameTimeNs();
+    }
+    if (xStats.ullFirstTxNs == 0u)
+    {
+        xStats.ullFirstTxNs = ullNowNs;
+    }
+    ulTxCount++;
+    prvEmit((uint8)ulData);
+}
+
+/* FIFO entries at or below which the transmit interrupt is raised */
+static uint32 prvTxTriggerLevel(void)
+{
+    static const uint8 aucLevels[8] = { 2u, 4u, 8u, 12u, 14u, 8u, 8u, 8u };
+
+    if (!(UART_REG(SIM_UART_LCRH_OFFSET) & SIM_UART_LCRH_FEN))
+    {
+        return 0u;
+    }
+    return aucLevels[UART_REG(SIM_UART_IFLS_OFFSET) & 0x7u];
+}
+
+static void prvUpdateInterrupt(uint32 ulQueued)
+{
+    /* Level crossings only: a FIFO that never filled past the level, or
+     * stays below it, raises nothing */
+    if (ulQueued > prvTxTriggerLevel())
+    {
+        bTxAboveLevel = TRUE;
+    }
+    else if (bTxAboveLevel)
+    {
+        bTxAboveLevel = FALSE;
+        UART_REG(SIM_UART_RIS_OFFSET) |= SIM_UART_INT_TX;
+    }
+    UART_REG(SIM_UART_MIS_OFFSET) = UART_REG(SIM_UART_RIS_OFFSET) & UART_REG(SIM_UART_IM_OFFSET);
+}
+
+static void prvUpdateFlags(void)
+{
+    uint32 ulDepth = (UART_REG(SIM_UART_LCRH_OFFSET) & SIM_UART_LCRH_FEN) ? SIM_UART_FIFO_DEPTH : 1u;
+    uint32 ulQueued = (ulTxCount > 0u) ? (ulTxCount - 1u) : 0u;
+    uint32 ulFlags = SIM_UART_FR_RXFE;
+
+    if (ulQueued == 0u)
+    {
+        ulFlags |= SIM_UART_FR_TXFE;
+    }
+    if (ulQueued >= ulDepth)
+    {
+        ulFlags |= SIM_UART_FR_TXFF;
+    }
+    if (ulTxCount > 0u)
+    {
+        ulFlags |= SIM_UART_FR_BUSY;
+    }
+    UART_REG(SIM_UART_FR_OFFSET) = ulFlags;
+    prvUpdateInterrupt(ulQueued);
+}
+
+static void prvAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    (void)ulAddress;
+    SimUart_Service(ullNowNs);
+    SimNvic_Update(SIM_UART0_IRQ);
+}
+
+/* The uDMA writes DR through the register file, and each write runs the
+ * access hook that consumes the previous one */
+static void prvRequestDma(void)
+{
+    uint32 ulQueued = (ulTxCount > 0u) ? (ulTxCount - 1u) : 0u;
+
+    if (bDmaRequesting || !(UART_REG(SIM_UART_DMACTL_OFFSET) & SIM_UART_DMACTL_TXDMAE) ||
+        (ulQueued > prvTxTriggerLevel()))
+    {
+        return;
+    }
+    bDmaRequesting = TRUE;
+    SimUdma_Request(SIM_UART0_TX_DMA_CHANNEL, 0u);
+    prvConsumeWrite(SimReg_NowNs());
+    prvUpdateFlags();
+    bDmaRequesting = FALSE;
+}
+
+static void prvDmaDone(uint32 ulChannel, uint32 ulEncoding)
+{
+    (void)ulChannel;
+    (void)ulEncoding;
+    SimNvic_SetPending(SIM_UART0_IRQ);
+}
+
+static boolean prvInterruptLevel(uint32 ulIrq)
+{
+    (void)ulIrq;
+    SimUart_Service(SimReg_NowNs());
+    return (UART_REG(SIM_UART_MIS_OFFSET) != 0u);
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimUart_Init(void)
+{
+    UART_REG(SIM_UART_DR_OFFSET) = SIM_UART_DR_EMPTY;
+    UART_REG(SIM_UART_CTL_OFFSET) = 0x300u;      /* Reset value: RXE | TXE */
+    UART_REG(SIM_UART_IFLS_OFFSET) = 0x12u;     /* Reset value: 1/2 for RX and TX */
+    prvUpdateFlags();
+    SimReg_RegisterHook(SIM_UART0_BASE, SIM_UART_BLOCK_SIZE, prvAccessHook);
+    SimNvic_SetSource(SIM_UART0_IRQ, prvInterruptLevel);
+    SimUdma_SetPeripheral(SIM_UART0_TX_DMA_CHANNEL, 0u, prvDmaDone);
+}
+
+void SimUart_Service(uint64 ullNowNs)
+{
+    /* ICR is write-1-to-clear and always reads back as zero */
+    UART_REG(SIM_UART_RIS_OFFSET) &= ~SimReg_Take(SIM_UART0_BASE + SIM_UART_ICR_OFFSET);
+
+    prvDrain(ullNowNs);
+    prvConsumeWrite(ullNowNs);
+    prvUpdateFlags();
+    prvRequestDma();
+}
+
+uint64 SimUart_NextDeadline(uint64 ullNowNs)
+{
+    (void)ullNowNs;
+    return (ulTxCount > 0u) ? ullTxDoneNs : SIM_UART_NO_DEADLINE;
+}
+
+void SimUart_GetStats(SimUart_StatsType *pxStats)
+{
+    SimReg_Lock();
+    *pxStats = xStats;
+    SimReg_Unlock();
+}
+
+void SimUart_Flush(void)
+{
+    if (ulLineLength > 0u)
+    {
+        (void)write(STDOUT_FILENO, acLine, ulLineLength);
+        ulLineLength = 0u;
+    }
+}
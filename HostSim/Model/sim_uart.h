@@ -0,0 +1,51 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - UART0
+ *
+ * File Name: sim_uart.h
+ *
+ * Description: Header for the simulated UART0 of the Linux host build
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_UART_H_
+#define SIM_UART_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_UART_NO_DEADLINE    0xFFFFFFFFFFFFFFFFull
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint64 ullTxBytes;          /* Bytes that left the transmit shift register */
+    uint64 ullTxDropped;        /* Writes to DR while the transmit FIFO was full */
+    uint64 ullFirstTxNs;        /* Host time the first byte was written */
+    uint64 ullLastTxNs;         /* Host time the last byte finished */
+    uint32 ulBaudRate;
+} SimUart_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void SimUart_Init(void);
+extern void SimUart_Service(uint64 ullNowNs);
+
+/* Host time the byte in the shift register is out, SIM_UART_NO_DEADLINE if idle */
+extern uint64 SimUart_NextDeadline(uint64 ullNowNs);
+extern void SimUart_GetStats(SimUart_StatsType *pxStats);
+
+/* Flush the line buffered terminal output */
+extern void SimUart_Flush(void);
+
+#endif /* SIM_UART_H_ */
@@ -0,0 +1,338 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - uDMA
+ *
+ * File Name: sim_udma.c
+ *
+ * Description: Simulated micro DMA controller. Works from the firmware's own
+ *              channel control table, which the host link keeps below 4 GB
+ *              so the 32-bit CTLBASE and end pointers of driverlib's udma.c
+ *              stay valid. Basic, auto and ping-pong transfers are modelled:
+ *              a peripheral request moves one arbitration burst, a software
+ *              request a whole auto transfer. Register source or destination
+ *              addresses go through the register file, so the peripheral
+ *              sees the access (a FIFO pops, a data register is written)
+ *              exactly as for a CPU access. Scatter-gather is not modelled,
+ *              and neither is CHIS: this firmware takes peripheral transfer
+ *              completions through the peripheral's interrupt only.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_registers.h"
+#include "sim_udma.h"
+
+#include "inc/hw_udma.h"
+#include "driverlib/udma.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_UDMA_BASE            0x400FF000u
+#define SIM_UDMA_BLOCK_SIZE      0x1000u
+
+#define SIM_UDMA_STAT            (SIM_UDMA_BASE + 0x000u)
+#define SIM_UDMA_CFG             (SIM_UDMA_BASE + 0x004u)
+#define SIM_UDMA_CTLBASE         (SIM_UDMA_BASE + 0x008u)
+#define SIM_UDMA_ALTBASE         (SIM_UDMA_BASE + 0x00Cu)
+#define SIM_UDMA_SWREQ           (SIM_UDMA_BASE + 0x014u)
+#define SIM_UDMA_USEBURSTSET     (SIM_UDMA_BASE + 0x018u)
+#define SIM_UDMA_USEBURSTCLR     (SIM_UDMA_BASE + 0x01Cu)
+#define SIM_UDMA_REQMASKSET      (SIM_UDMA_BASE + 0x020u)
+#define SIM_UDMA_REQMASKCLR      (SIM_UDMA_BASE + 0x024u)
+#define SIM_UDMA_ENASET          (SIM_UDMA_BASE + 0x028u)
+#define SIM_UDMA_ENACLR          (SIM_UDMA_BASE + 0x02Cu)
+#define SIM_UDMA_ALTSET          (SIM_UDMA_BASE + 0x030u)
+#define SIM_UDMA_ALTCLR          (SIM_UDMA_BASE + 0x034u)
+#define SIM_UDMA_PRIOSET         (SIM_UDMA_BASE + 0x038u)
+#define SIM_UDMA_PRIOCLR         (SIM_UDMA_BASE + 0x03Cu)
+#define SIM_UDMA_CHMAP0          (SIM_UDMA_BASE + 0x510u)
+
+/* The alternate structures start 32 entries (0x200 bytes on the target)
+ * into the control table */
+#define SIM_UDMA_ALT_OFFSET      0x200u
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* A write-1-to-set / write-1-to-clear register pair */
+typedef struct
+{
+    uint32 ulSetAddress;
+    uint32 ulClearAddress;
+    uint32 ulState;
+    uint32 ulPublished;
+} SimUdma_BitsType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static SimUdma_BitsType xEnable    = { SIM_UDMA_ENASET,      SIM_UDMA_ENACLR };
+static SimUdma_BitsType xAlternate = { SIM_UDMA_ALTSET,      SIM_UDMA_ALTCLR };
+static SimUdma_BitsType xReqMask   = { SIM_UDMA_REQMASKSET,  SIM_UDMA_REQMASKCLR };
+static SimUdma_BitsType xUseBurst  = { SIM_UDMA_USEBURSTSET, SIM_UDMA_USEBURSTCLR };
+static SimUdma_BitsType xPriority  = { SIM_UDMA_PRIOSET,     SIM_UDMA_PRIOCLR };
+
+static SimUdma_DoneType apfnDone[SIM_UDMA_NUM_CHANNELS][SIM_UDMA_NUM_ENCODINGS];
+
+/* Channels with a request waiting to be serviced */
+static uint32 ulRequests = 0;
+static boolean bRunning = FALSE;
+
+static SimUdma_StatsType xStats;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvSyncBits(SimUdma_BitsType *pxBits)
+{
+    SimReg_SyncSetRegister(pxBits->ulSetAddress, &pxBits->ulState, &pxBits->ulPublished);
+    pxBits->ulState &= ~SimReg_Take(pxBits->ulClearAddress);
+    SimReg_SyncSetRegister(pxBits->ulSetAddress, &pxBits->ulState, &pxBits->ulPublished);
+}
+
+static void prvApplyWrites(void)
+{
+    prvSyncBits(&xEnable);
+    prvSyncBits(&xAlternate);
+    prvSyncBits(&xReqMask);
+    prvSyncBits(&xUseBurst);
+    prvSyncBits(&xPriority);
+
+    SIM_REG(SIM_UDMA_STAT) = ((SIM_UDMA_NUM_CHANNELS - 1u) << UDMA_STAT_DMACHANS_S)
+                           | (SIM_REG(SIM_UDMA_CFG) & UDMA_CFG_MASTEN);
+    SIM_REG(SIM_UDMA_ALTBASE) = SIM_REG(SIM_UDMA_CTLBASE) + SIM_UDMA_ALT_OFFSET;
+
+    /* SWREQ is write-only */
+    ulRequests |= SimReg_Take(SIM_UDMA_SWREQ);
+}
+
+static boolean prvIsRegister(uint32 ulAddress)
+{
+    return ((ulAddress - SIM_PERIPHERAL_BASE) < SIM_PERIPHERAL_SIZE) ||
+           ((ulAddress - SIM_SYSTEM_BASE) < SIM_SYSTEM_SIZE);
+}
+
+static void *prvMemory(uint32 ulAddress)
+{
+    if (ulAddress < 0x1000u)
+    {
+        fprintf(stderr, "HostSim: uDMA access to address 0x%08X\n", ulAddress);
+        abort();
+    }
+    return (void *)(uintptr_t)ulAddress;
+}
+
+static uint32 prvRead(uint32 ulAddress, uint32 ulBytes)
+{
+    uint32 ulValue = 0u;
+
+    if (prvIsRegister(ulAddress))
+    {
+        /* Through the register file so the peripheral sees the read */
+        ulValue = *SimReg_Map(ulAddress & ~3u) >> ((ulAddress & 3u) * 8u);
+        return (ulBytes == 4u) ? ulValue : (ulValue & ((1u << (ulBytes * 8u)) - 1u));
+    }
+    memcpy(&ulValue, prvMemory(ulAddress), ulBytes);
+    return ulValue;
+}
+
+static void prvWrite(uint32 ulAddress, uint32 ulBytes, uint32 ulValue)
+{
+    if (prvIsRegister(ulAddress))
+    {
+        *SimReg_Map(ulAddress & ~3u) = ulValue << ((ulAddress & 3u) * 8u);
+        return;
+    }
+    memcpy(prvMemory(ulAddress), &ulValue, ulBytes);
+}
+
+/* End pointers address the last byte of the last item; an increment of 3
+ * means the address stays fixed */
+static uint32 prvItemAddress(uint32 ulEnd, uint32 ulIncrement, uint32 ulRemaining)
+{
+    return (ulIncrement == 3u) ? ulEnd : (ulEnd + 1u - (ulRemaining << ulIncrement));
+}
+
+static void prvRunChannel(uint32 ulChannel)
+{
+    uint32 ulBit = 1u << ulChannel;
+    uint32 ulTable = SIM_REG(SIM_UDMA_CTLBASE);
+    tDMAControlTable *pxEntry;
+    uint32 ulControl;
+    uint32 ulMode;
+    uint32 ulRemaining;
+    uint32 ulBurst;
+    uint32 ulSrcInc;
+    uint32 ulDstInc;
+    uint32 ulBytes;
+    uint32 ulSrcEnd;
+    uint32 ulDstEnd;
+    uint32 ulEncoding;
+
+    pxEntry = &((tDMAControlTable *)prvMemory(ulTable))
+                  [ulChannel | ((xAlternate.ulState & ulBit) ? UDMA_ALT_SELECT : 0u)];
+    ulControl = pxEntry->ui32Control;
+    ulMode = ulControl & UDMA_CHCTL_XFERMODE_M;
+
+    if ((ulMode != UDMA_MODE_BASIC) && (ulMode != UDMA_MODE_AUTO) && (ulMode != UDMA_MODE_PINGPONG))
+    {
+        if (ulMode != UDMA_MODE_STOP)
+        {
+            fprintf(stderr, "HostSim: uDMA mode %u of channel %u is not modelled\n", ulMode, ulChannel);
+            abort();
+        }
+        /* A request that finds a stopped structure ends the channel */
+        xEnable.ulState &= ~ulBit;
+        xStats.ullMissed++;
+        return;
+    }
+
+    ulRemaining = ((ulControl & UDMA_CHCTL_XFERSIZE_M) >> 4) + 1u;
+    ulBurst = (ulMode == UDMA_MODE_AUTO) ? ulRemaining
+                                         : (1u << ((ulControl & UDMA_CHCTL_ARBSIZE_M) >> 14));
+    ulSrcInc = (ulControl & UDMA_CHCTL_SRCINC_M) >> 26;
+    ulDstInc = (ulControl & UDMA_CHCTL_DSTINC_M) >> 30;
+    ulBytes = 1u << ((ulControl & UDMA_CHCTL_SRCSIZE_M) >> 24);
+    ulSrcEnd = (uint32)(uintptr_t)pxEntry->pvSrcEndAddr;
+    ulDstEnd = (uint32)(uintptr_t)pxEntry->pvDstEndAddr;
+
+    xStats.ullRequests++;
+    while ((ulBurst > 0u) && (ulRemaining > 0u))
+    {
+        prvWrite(prvItemAddress(ulDstEnd, ulDstInc, ulRemaining), ulBytes,
+                 prvRead(prvItemAddress(ulSrcEnd, ulSrcInc, ulRemaining), ulBytes));
+        ulBurst--;
+        ulRemaining--;
+        xStats.ullItems++;
+    }
+
+    if (ulRemaining > 0u)
+    {
+        pxEntry->ui32Control = (ulControl & ~UDMA_CHCTL_XFERSIZE_M) | ((ulRemaining - 1u) << 4);
+        return;
+    }
+
+    /* Done: the structure reads back as stopped with a size of one */
+    pxEntry->ui32Control = ulControl & ~(UDMA_CHCTL_XFERSIZE_M | UDMA_CHCTL_XFERMODE_M);
+    xStats.ullCompletions++;
+    if (ulMode == UDMA_MODE_PINGPONG)
+    {
+        xAlternate.ulState ^= ulBit;
+    }
+    else
+    {
+        xEnable.ulState &= ~ulBit;
+    }
+
+    ulEncoding = (SIM_REG(SIM_UDMA_CHMAP0 + ((ulChannel / 8u) * 4u)) >> ((ulChannel % 8u) * 4u)) & 0xFu;
+    if ((ulEncoding < SIM_UDMA_NUM_ENCODINGS) && (apfnDone[ulChannel][ulEncoding] != NULL_PTR))
+    {
+        apfnDone[ulChannel][ulEncoding](ulChannel, ulEncoding);
+    }
+}
+
+/* Service the waiting requests, high priority channels first and then by
+ * channel number, as the controller arbitrates */
+static void prvRun(void)
+{
+    uint32 ulReady;
+    uint32 ulChannel;
+
+    if (bRunning)
+    {
+        /* A register access of the running transfer raised a new request;
+         * the loop below picks it up */
+        return;
+    }
+    bRunning = TRUE;
+
+    for (;;)
+    {
+        prvApplyWrites();
+        if ((SIM_REG(SIM_UDMA_CFG) & UDMA_CFG_MASTEN) == 0u)
+        {
+            ulRequests = 0u;
+            break;
+        }
+
+        /* Requests of disabled channels are lost */
+        xStats.ullMissed += (uint64)__builtin_popcount(ulRequests & ~xEnable.ulState);
+        ulRequests &= xEnable.ulState;
+        if (ulRequests == 0u)
+        {
+            break;
+        }
+
+        ulReady = ((ulRequests & xPriority.ulState) != 0u) ? (ulRequests & xPriority.ulState)
+                                                             : ulRequests;
+        ulChannel = (uint32)__builtin_ctz(ulReady);
+        ulRequests &= ~(1u << ulChannel);
+        prvRunChannel(ulChannel);
+    }
+
+    prvApplyWrites();
+    bRunning = FALSE;
+}
+
+static void prvAccessHook(uint32 ulAddress, uint64 ullNowNs)
+{
+    (void)ulAddress;
+    (void)ullNowNs;
+    prvApplyWrites();
+    if (ulRequests != 0u)
+    {
+        prvRun();
+    }
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void SimUdma_Init(void)
+{
+    prvApplyWrites();
+    SimReg_RegisterHook(SIM_UDMA_BASE, SIM_UDMA_BLOCK_SIZE, prvAccessHook);
+}
+
+void SimUdma_SetPeripheral(uint32 ulChannel, uint32 ulEncoding, SimUdma_DoneType pfnDone)
+{
+    apfnDone[ulChannel][ulEncoding] = pfnDone;
+}
+
+void SimUdma_Request(uint32 ulChannel, uint32 ulEncoding)
+{
+    uint32 ulBit = 1u << ulChannel;
+    uint32 ulMapped;
+
+    prvApplyWrites();
+    ulMapped = (SIM_REG(SIM_UDMA_CHMAP0 + ((ulChannel / 8u) * 4u)) >> ((ulChannel % 8u) * 4u)) & 0xFu;
+
+    /* Another peripheral owns the channel, or the firmware masked the request
+     * and serves the peripheral by interrupt instead */
+    if ((ulMapped != ulEncoding) || (xReqMask.ulState & ulBit))
+    {
+        return;
+    }
+    ulRequests |= ulBit;
+    prvRun();
+}
+
+void SimUdma_GetStats(SimUdma_StatsType *pxStats)
+{
+    SimReg_Lock();
+    *pxStats = xStats;
+    SimReg_Unlock();
+}
@@ -0,0 +1,56 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - uDMA
+ *
+ * File Name: sim_udma.h
+ *
+ * Description: Header for the simulated micro DMA controller of the Linux
+ *              host build
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef SIM_UDMA_H_
+#define SIM_UDMA_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define SIM_UDMA_NUM_CHANNELS   32u
+#define SIM_UDMA_NUM_ENCODINGS  5u      /* Peripheral assignments per channel */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Tells a peripheral that the transfer of its channel has completed, which
+ * on the target raises the peripheral's own interrupt. Called model locked. */
+typedef void (*SimUdma_DoneType)(uint32 ulChannel, uint32 ulEncoding);
+
+typedef struct
+{
+    uint64 ullRequests;         /* Burst or single requests serviced */
+    uint64 ullItems;            /* Items moved */
+    uint64 ullCompletions;      /* Control structures run to completion */
+    uint64 ullMissed;           /* Requests of a disabled or stopped channel */
+} SimUdma_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void SimUdma_Init(void);
+
+/* Connect a peripheral to a channel for one CHMAP encoding */
+extern void SimUdma_SetPeripheral(uint32 ulChannel, uint32 ulEncoding, SimUdma_DoneType pfnDone);
+
+/* A peripheral asks for one arbitration burst (model locked) */
+extern void SimUdma_Request(uint32 ulChannel, uint32 ulEncoding);
+
+extern void SimUdma_GetStats(SimUdma_StatsType *pxStats);
+
+#endif /* SIM_UDMA_H_ */
@@ -0,0 +1,252 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Control benchmark
+ *
+ * File Name: pi_benchmark.c
+ *
+ * Description: Step responses of the seat temperature loop, run faster than
+ *              real time. The firmware's PI controller module is compiled
+ *              unchanged and closed around the same first-order seat model
+ *              as Model/sim_seat.c, sampled the way the firmware samples it:
+ *              the sensor task reads a whole-degree ADC code every 500 ms,
+ *              the set-heater task runs the controller every 150 ms, and a
+ *              rise in duty is ramped over the heater's soft-start time.
+ *
+ *              Every controller is stepped from ambient to each desired
+ *              level and the settling time, overshoot and remaining error
+ *              are printed. The P controller it replaced and a PI without
+ *              anti-windup run for comparison.
+ *
+ *                ./build/pi_benchmark [kp ki [rise_c tau_ms]]
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pi_controller.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define BENCH_STEP_MS           1u
+#define BENCH_RUN_MS            60000u
+#define BENCH_STEADY_MS         10000u      /* End of the run the remaining error is taken over */
+#define BENCH_SENSOR_PERIOD_MS  500u        /* GET_TEMP_TASK_PERIODICITY */
+#define BENCH_CONTROL_PERIOD_MS 150u        /* SET_TEMP_TASK_PERIOD_MS */
+#define BENCH_SOFT_START_MS     500u        /* HEATER_DEFAULT_SOFT_START_MS */
+#define BENCH_DUTY_MAX          1000
+#define BENCH_BAND_C            1.5         /* SIM_SEAT_BAND_C default */
+
+/* Seat gains of main.c */
+#define BENCH_SEAT_KP           150.0
+#define BENCH_SEAT_KI           30.0
+
+/* The old loop: full power from 5 degrees below the target */
+#define BENCH_P_BAND_KP         200.0
+
+/* 20 mV on the LM35 input, the firmware's reading of it in degrees */
+#define BENCH_AMBIENT_C         (20.0 * 4096.0 / 3300.0)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum
+{
+    BENCH_PI, BENCH_PI_NO_ANTI_WINDUP
+} Bench_KindType;
+
+typedef struct
+{
+    const char *pcName;
+    Bench_KindType eKind;
+    double dKp;
+    double dKi;
+} Bench_ControllerType;
+
+typedef struct
+{
+    double dRiseC;
+    double dTauS;
+} Bench_PlantType;
+
+typedef struct
+{
+    double dTimeToBandS;        /* < 0 if never reached */
+    double dSettlingS;          /* < 0 if not inside the band at the end */
+    double dOvershootC;
+    double dSteadyErrorC;       /* Mean of |error| at the end of the run */
+    double dMeanDuty;           /* Per mille */
+} Bench_ResultType;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Textbook PI that integrates every error, limited only at its output */
+static sint32 prvNaivePi(double dKp, double dKi, double *pdIntegral, sint32 sError)
+{
+    double dOutput;
+
+    *pdIntegral += dKi * ((double)BENCH_CONTROL_PERIOD_MS / 1000.0) * (double)sError;
+    dOutput = (dKp * (double)sError) + *pdIntegral;
+    if (dOutput > BENCH_DUTY_MAX)
+    {
+        dOutput = BENCH_DUTY_MAX;
+    }
+    if (dOutput < 0.0)
+    {
+        dOutput = 0.0;
+    }
+    return (sint32)(dOutput + 0.5);
+}
+
+static void prvRun(const Bench_ControllerType *pxController, const Bench_PlantType *pxPlant,
+                   sint32 sTargetC, Bench_ResultType *pxResult)
+{
+    PI_ControllerType xPi;
+    PI_ConfigType xConfig;
+    double dTemperature = BENCH_AMBIENT_C;
+    double dIntegral = 0.0;
+    double dDuty = 0.0;
+    double dError;
+    double dSteadySum = 0.0;
+    double dDutySum = 0.0;
+    double dStepS = (double)BENCH_STEP_MS / 1000.0;
+    double dRampStep = ((double)BENCH_DUTY_MAX * BENCH_STEP_MS) / BENCH_SOFT_START_MS;
+    sint32 sReading = (sint32)dTemperature;
+    sint32 sTargetDuty = 0;
+    boolean bInBand = FALSE;
+    uint32 ulEnteredMs = 0u;
+    uint32 ulSteadySamples = 0u;
+    uint32 ulMs;
+
+    xConfig.Kp = PI_GAIN(pxController->dKp);
+    xConfig.Ki = PI_GAIN(pxController->dKi);
+    xConfig.SamplePeriodMs = BENCH_CONTROL_PERIOD_MS;
+    xConfig.OutputMin = 0;
+    xConfig.OutputMax = BENCH_DUTY_MAX;
+    PI_Init(&xPi, &xConfig);
+
+    pxResult->dTimeToBandS = -1.0;
+    pxResult->dOvershootC = 0.0;
+    for (ulMs = 0u; ulMs < BENCH_RUN_MS; ulMs += BENCH_STEP_MS)
+    {
+        if ((ulMs % BENCH_SENSOR_PERIOD_MS) == 0u)
+        {
+            sReading = (sint32)dTemperature;
+        }
+        if ((ulMs % BENCH_CONTROL_PERIOD_MS) == 0u)
+        {
+            sTargetDuty = (pxController->eKind == BENCH_PI)
+                        ? PI_Update(&xPi, sTargetC - sReading)
+                        : prvNaivePi(pxController->dKp, pxController->dKi, &dIntegral, sTargetC - sReading);
+        }
+
+        /* Soft start: rises ramp, falls apply at once */
+        if ((double)sTargetDuty <= dDuty)
+        {
+            dDuty = (double)sTargetDuty;
+        }
+        else
+        {
+            dDuty = ((dDuty + dRampStep) > (double)sTargetDuty) ? (double)sTargetDuty : (dDuty + dRampStep);
+        }
+        dTemperature += ((BENCH_AMBIENT_C + ((pxPlant->dRiseC * dDuty) / BENCH_DUTY_MAX) - dTemperature) * dStepS)
+                      / pxPlant->dTauS;
+        dDutySum += dDuty;
+
+        dError = dTemperature - (double)sTargetC;
+        if (dError > pxResult->dOvershootC)
+        {
+            pxResult->dOvershootC = dError;
+        }
+        if ((dError >= -BENCH_BAND_C) && (dError <= BENCH_BAND_C))
+        {
+            if (!bInBand)
+            {
+                ulEnteredMs = ulMs;
+                bInBand = TRUE;
+            }
+            if (pxResult->dTimeToBandS < 0.0)
+            {
+                pxResult->dTimeToBandS = (double)ulMs / 1000.0;
+            }
+        }
+        else
+        {
+            bInBand = FALSE;
+        }
+        if (ulMs >= (BENCH_RUN_MS - BENCH_STEADY_MS))
+        {
+            dSteadySum += (dError < 0.0) ? -dError : dError;
+            ulSteadySamples++;
+        }
+    }
+    pxResult->dSettlingS = bInBand ? ((double)ulEnteredMs / 1000.0) : -1.0;
+    pxResult->dSteadyErrorC = dSteadySum / (double)ulSteadySamples;
+    pxResult->dMeanDuty = dDutySum / ((double)BENCH_RUN_MS / BENCH_STEP_MS);
+}
+
+static void prvPrintTime(double dSeconds)
+{
+    if (dSeconds < 0.0)
+    {
+        printf(" %8s", "-");
+    }
+    else
+    {
+        printf(" %7.2fs", dSeconds);
+    }
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    static const sint32 asTargets[] = { 25, 30, 35 };   /* Desired_LOW, MED, HIGH */
+    Bench_ControllerType axControllers[] =
+    {
+        { "P, 5 C band", BENCH_PI, BENCH_P_BAND_KP, 0.0 },
+        { "PI, no anti-windup", BENCH_PI_NO_ANTI_WINDUP, BENCH_SEAT_KP, BENCH_SEAT_KI },
+        { "PI", BENCH_PI, BENCH_SEAT_KP, BENCH_SEAT_KI },
+    };
+    Bench_PlantType xPlant = { 20.0, 5.0 };    /* SIM_HEATER_RISE_C, SIM_SEAT_TAU_MS defaults */
+    Bench_ResultType xResult;
+    uint32 ulController;
+    uint32 ulTarget;
+
+    if (argc >= 3)
+    {
+        axControllers[1].dKp = axControllers[2].dKp = atof(argv[1]);
+        axControllers[1].dKi = axControllers[2].dKi = atof(argv[2]);
+    }
+    if (argc >= 5)
+    {
+        xPlant.dRiseC = atof(argv[3]);
+        xPlant.dTauS = atof(argv[4]) / 1000.0;
+    }
+
+    printf("seat plant: ambient %.1f C, rise %.1f C at full power, tau %.2f s; band +-%.1f C; PI Kp %.1f Ki %.1f /s\n",
+           BENCH_AMBIENT_C, xPlant.dRiseC, xPlant.dTauS, BENCH_BAND_C, axControllers[2].dKp, axControllers[2].dKi);
+    printf("%-20s %6s %9s %9s %10s %10s %9s\n",
+           "controller", "target", "in band", "settled", "overshoot", "end error", "duty");
+    for (ulController = 0u; ulController < (sizeof(axControllers) / sizeof(axControllers[0])); ulController++)
+    {
+        for (ulTarget = 0u; ulTarget < (sizeof(asTargets) / sizeof(asTargets[0])); ulTarget++)
+        {
+            prvRun(&axControllers[ulController], &xPlant, asTargets[ulTarget], &xResult);
+            printf("%-20s %4d C", axControllers[ulController].pcName, asTargets[ulTarget]);
+            prvPrintTime(xResult.dTimeToBandS);
+            prvPrintTime(xResult.dSettlingS);
+            printf(" %8.2f C %8.2f C %8.1f%%\n", xResult.dOvershootC, xResult.dSteadyErrorC, xResult.dMeanDuty / 10.0);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,22 @@
+/*
+ * -------------------------------------------------------------------------
+ * FreeRTOS Kernel Configuration File - pool benchmark heaps
+ * -------------------------------------------------------------------------
+ * The host configuration with dynamic allocation turned back on, for the
+ * FreeRTOS heap the pool benchmark is built with. Nothing else of the
+ * kernel is compiled into the benchmark.
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef POOL_BENCHMARK_FREERTOS_CONFIG_H
+#define POOL_BENCHMARK_FREERTOS_CONFIG_H
+
+#include "../../../include/FreeRTOSConfig.h"
+
+#undef  configSUPPORT_DYNAMIC_ALLOCATION
+#define configSUPPORT_DYNAMIC_ALLOCATION      1
+
+/* Room for the fragments and the churn together */
+#define configTOTAL_HEAP_SIZE                 ( ( size_t ) ( 16 * 1024 ) )
+
+#endif /* POOL_BENCHMARK_FREERTOS_CONFIG_H */
@@ -0,0 +1,355 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Pool benchmark
+ *
+ * File Name: pool_benchmark.c
+ *
+ * Description: Time of every allocation and release made by the firmware's
+ *              pool allocator, compiled unchanged, against general-purpose
+ *              heaps serving the same requests. Three workloads run:
+ *
+ *                steady      one telemetry frame taken and given back
+ *                churn       message and frame sized blocks taken and given
+ *                            back in random order, at most as many at once
+ *                            as the pool classes hold
+ *                fragmented  churn after the heap was cut into 128 small
+ *                            holes that no frame fits in
+ *
+ *              The C library's malloc() always runs for comparison. Built as
+ *              pool_benchmark_heap_4 or pool_benchmark_heap_5, with the
+ *              FreeRTOS heap source of that name, the FreeRTOS heap runs as
+ *              well (HOSTSIM_FREERTOS_MEMMANG_DIR in CMakeLists.txt).
+ *
+ *              Times are host nanoseconds with the cost of reading the clock
+ *              taken off; only the spread between the allocators and between
+ *              the mean and the worst case carries over to the target.
+ *
+ *                ./build/pool_benchmark [operations]
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "pool.h"
+#include "Services/Telemetry/telemetry.h"
+
+#ifdef BENCH_FREERTOS_HEAP
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define BENCH_OPERATIONS        1000000u
+#define BENCH_MESSAGE_MIN       8u
+#define BENCH_FRAME_MIN         64u
+#define BENCH_SLOTS             (POOL_MESSAGE_BLOCKS + POOL_FRAME_BLOCKS)
+#define BENCH_FRAGMENTS         256u        /* Half of them are freed again */
+#define BENCH_FRAGMENT_SIZE     16u
+
+#ifdef BENCH_FREERTOS_HEAP
+#define BENCH_HEAP_5_REGION     (configTOTAL_HEAP_SIZE / 2)
+#endif
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    const char *pcName;
+    void *(*pfAlloc)(uint32 ulSize);
+    void (*pfFree)(void *pvBlock);
+    boolean bFragments;         /* Shares free space between sizes, so it can be fragmented */
+} Bench_AllocatorType;
+
+typedef enum
+{
+    BENCH_STEADY, BENCH_CHURN, BENCH_FRAGMENTED, BENCH_NUM_WORKLOADS
+} Bench_WorkloadType;
+
+typedef struct
+{
+    uint32 ulOperations;
+    uint32 ulFailed;
+    double dMeanNs;
+    uint32 ulP99Ns;
+    uint32 ulMaxNs;
+} Bench_ResultType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint32 *pulSamples;
+static uint32 ulSampleCount;
+static uint32 ulClockNs;        /* Cost of one timed empty operation */
+static uint32 ulRandom = 0x2545F491u;
+
+#if (BENCH_FREERTOS_HEAP == 5)
+/* Regions in ascending address order, as vPortDefineHeapRegions() wants them */
+static uint8 ucHeapRegions[2][BENCH_HEAP_5_REGION];
+#endif
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void *prvPoolAlloc(uint32 ulSize)
+{
+    return Pool_Alloc(ulSize);
+}
+
+static void prvPoolFree(void *pvBlock)
+{
+    (void)Pool_Free(pvBlock);
+}
+
+static void *prvLibcAlloc(uint32 ulSize)
+{
+    return malloc(ulSize);
+}
+
+static void prvLibcFree(void *pvBlock)
+{
+    free(pvBlock);
+}
+
+#ifdef BENCH_FREERTOS_HEAP
+static void *prvHeapAlloc(uint32 ulSize)
+{
+    return pvPortMalloc(ulSize);
+}
+
+static void prvHeapFree(void *pvBlock)
+{
+    vPortFree(pvBlock);
+}
+#endif
+
+static uint32 prvRandom(void)
+{
+    ulRandom ^= ulRandom << 13;
+    ulRandom ^= ulRandom >> 17;
+    ulRandom ^= ulRandom << 5;
+    return ulRandom;
+}
+
+static uint64 prvNowNs(void)
+{
+    struct timespec xNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &xNow);
+    return ((uint64)xNow.tv_sec * 1000000000u) + (uint64)xNow.tv_nsec;
+}
+
+static void prvSample(uint64 ullStartNs, uint64 ullEndNs)
+{
+    uint64 ullNs = ullEndNs - ullStartNs;
+
+    ullNs = (ullNs > ulClockNs) ? (ullNs - ulClockNs) : 0u;
+    pulSamples[ulSampleCount++] = (ullNs > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32)ullNs;
+}
+
+static int prvCompare(const void *pvLeft, const void *pvRight)
+{
+    uint32 ulLeft = *(const uint32 *)pvLeft;
+    uint32 ulRight = *(const uint32 *)pvRight;
+
+    return (ulLeft > ulRight) - (ulLeft < ulRight);
+}
+
+/* Frames go to the slots past the pool's message blocks */
+static uint32 prvSlotSize(uint32 ulSlot)
+{
+    if (ulSlot < POOL_MESSAGE_BLOCKS)
+    {
+        return BENCH_MESSAGE_MIN + (prvRandom() % (POOL_MESSAGE_BLOCK_SIZE - BENCH_MESSAGE_MIN + 1u));
+    }
+    return BENCH_FRAME_MIN + (prvRandom() % (TELEMETRY_MAX_FRAME_SIZE - BENCH_FRAME_MIN + 1u));
+}
+
+static void prvRun(const Bench_AllocatorType *pxAllocator, Bench_WorkloadType eWorkload, uint32 ulOperations,
+                   Bench_ResultType *pxResult)
+{
+    void *apvSlots[BENCH_SLOTS] = { NULL_PTR };
+    void *apvFragments[BENCH_FRAGMENTS];
+    uint64 ullTotalNs = 0u;
+    uint64 ullStartNs;
+    uint32 ulOperation;
+    uint32 ulSlot;
+    uint32 ulSample;
+    uint32 ulSize;
+
+    /* Every second fragment stays allocated, so the freed ones cannot merge */
+    if ((eWorkload == BENCH_FRAGMENTED) && pxAllocator->bFragments)
+    {
+        for (ulSlot = 0u; ulSlot < BENCH_FRAGMENTS; ulSlot++)
+        {
+            apvFragments[ulSlot] = pxAllocator->pfAlloc(BENCH_FRAGMENT_SIZE);
+        }
+        for (ulSlot = 0u; ulSlot < BENCH_FRAGMENTS; ulSlot += 2u)
+        {
+            pxAllocator->pfFree(apvFragments[ulSlot]);
+        }
+    }
+
+    ulSampleCount = 0u;
+    pxResult->ulFailed = 0u;
+    for (ulOperation = 0u; ulOperation < ulOperations; ulOperation++)
+    {
+        ulSlot = (eWorkload == BENCH_STEADY) ? (BENCH_SLOTS - 1u) : (prvRandom() % BENCH_SLOTS);
+        if (apvSlots[ulSlot] != NULL_PTR)
+        {
+            ullStartNs = prvNowNs();
+            pxAllocator->pfFree(apvSlots[ulSlot]);
+            prvSample(ullStartNs, prvNowNs());
+            apvSlots[ulSlot] = NULL_PTR;
+        }
+        else
+        {
+            ulSize = (eWorkload == BENCH_STEADY) ? TELEMETRY_MAX_FRAME_SIZE : prvSlotSize(ulSlot);
+            ullStartNs = prvNowNs();
+            apvSlots[ulSlot] = pxAllocator->pfAlloc(ulSize);
+            prvSample(ullStartNs, prvNowNs());
+            if (apvSlots[ulSlot] == NULL_PTR)
+            {
+                pxResult->ulFailed++;
+            }
+        }
+    }
+
+    for (ulSlot = 0u; ulSlot < BENCH_SLOTS; ulSlot++)
+    {
+        if (apvSlots[ulSlot] != NULL_PTR)
+        {
+            pxAllocator->pfFree(apvSlots[ulSlot]);
+        }
+    }
+    if ((eWorkload == BENCH_FRAGMENTED) && pxAllocator->bFragments)
+    {
+        for (ulSlot = 1u; ulSlot < BENCH_FRAGMENTS; ulSlot += 2u)
+        {
+            pxAllocator->pfFree(apvFragments[ulSlot]);
+        }
+    }
+
+    for (ulSample = 0u; ulSample < ulSampleCount; ulSample++)
+    {
+        ullTotalNs += pulSamples[ulSample];
+    }
+    qsort(pulSamples, ulSampleCount, sizeof(pulSamples[0]), prvCompare);
+    pxResult->ulOperations = ulSampleCount;
+    pxResult->dMeanNs = (double)ullTotalNs / (double)ulSampleCount;
+    pxResult->ulP99Ns = pulSamples[(ulSampleCount * 99u) / 100u];
+    pxResult->ulMaxNs = pulSamples[ulSampleCount - 1u];
+}
+
+/* The clock is read twice around an operation that does nothing */
+static void prvCalibrate(void)
+{
+    uint64 ullTotalNs = 0u;
+    uint64 ullStartNs;
+    uint32 ulRound;
+
+    for (ulRound = 0u; ulRound < 100000u; ulRound++)
+    {
+        ullStartNs = prvNowNs();
+        ullTotalNs += prvNowNs() - ullStartNs;
+    }
+    ulClockNs = (uint32)(ullTotalNs / 100000u);
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+#ifdef BENCH_FREERTOS_HEAP
+/* The heaps suspend the scheduler around their lists; there is none here */
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    return pdFALSE;
+}
+
+void vAssertCalled(const char *pcFile, unsigned long ulLine)
+{
+    fprintf(stderr, "assertion failed at %s:%lu\n", pcFile, ulLine);
+    abort();
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    static const char *const apcWorkloads[BENCH_NUM_WORKLOADS] = { "steady", "churn", "fragmented" };
+    const Bench_AllocatorType axAllocators[] =
+    {
+        { "pool", prvPoolAlloc, prvPoolFree, FALSE },
+#ifdef BENCH_FREERTOS_HEAP
+#if (BENCH_FREERTOS_HEAP == 4)
+        { "heap_4", prvHeapAlloc, prvHeapFree, TRUE },
+#else
+        { "heap_5", prvHeapAlloc, prvHeapFree, TRUE },
+#endif
+#endif
+        { "malloc", prvLibcAlloc, prvLibcFree, TRUE },
+    };
+    Bench_ResultType xResult;
+    uint32 ulOperations = BENCH_OPERATIONS;
+    uint32 ulAllocator;
+    uint32 ulWorkload;
+
+#if (BENCH_FREERTOS_HEAP == 5)
+    HeapRegion_t axRegions[3] =
+    {
+        { ucHeapRegions[0], BENCH_HEAP_5_REGION }, { ucHeapRegions[1], BENCH_HEAP_5_REGION }, { NULL, 0 }
+    };
+
+    vPortDefineHeapRegions(axRegions);
+#endif
+
+    if (argc >= 2)
+    {
+        ulOperations = (uint32)strtoul(argv[1], NULL, 10);
+    }
+    if (ulOperations == 0u)
+    {
+        fprintf(stderr, "usage: %s [operations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    pulSamples = malloc(ulOperations * sizeof(pulSamples[0]));
+    if (pulSamples == NULL)
+    {
+        fprintf(stderr, "no memory for %u samples\n", ulOperations);
+        return EXIT_FAILURE;
+    }
+
+    Pool_Init();
+    prvCalibrate();
+
+    printf("pool: %u x %u B messages, %u x %u B frames; %u operations per run, clock read %u ns taken off\n",
+           POOL_MESSAGE_BLOCKS, POOL_MESSAGE_BLOCK_SIZE, POOL_FRAME_BLOCKS, POOL_FRAME_BLOCK_SIZE, ulOperations,
+           ulClockNs);
+    printf("%-8s %-11s %9s %8s %9s %8s %8s\n", "heap", "workload", "ops", "failed", "mean ns", "p99 ns", "max ns");
+    for (ulAllocator = 0u; ulAllocator < (sizeof(axAllocators) / sizeof(axAllocators[0])); ulAllocator++)
+    {
+        for (ulWorkload = 0u; ulWorkload < BENCH_NUM_WORKLOADS; ulWorkload++)
+        {
+            prvRun(&axAllocators[ulAllocator], (Bench_WorkloadType)ulWorkload, ulOperations, &xResult);
+            printf("%-8s %-11s %9u %8u %9.1f %8u %8u\n", axAllocators[ulAllocator].pcName, apcWorkloads[ulWorkload],
+                   xResult.ulOperations, xResult.ulFailed, xResult.dMeanNs, xResult.ulP99Ns, xResult.ulMaxNs);
+        }
+    }
+
+    free(pulSamples);
+    return EXIT_SUCCESS;
+}
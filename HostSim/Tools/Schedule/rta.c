@@ -0,0 +1,474 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Response-time analysis
+ *
+ * File Name: rta.c
+ *
+ * Description: Reads the UART0 byte stream on stdin, like telemetry_dump,
+ *              from the host build or from the board, and checks the task
+ *              set of TaskSet.h against its deadlines with the measured
+ *              execution times instead of the guesses of the SimSo model.
+ *
+ *              The WCET of every task is the high-water mark of the last
+ *              runtime record. The time each task holds the seat table mutex
+ *              is taken from the kernel trace: the cycles it runs between its
+ *              take and its give, so preemption while holding it is left out.
+ *              A task whose hold the trace did not show, or every task when
+ *              there is no trace, is taken to hold it for its whole WCET.
+ *
+ *              Fixed-priority response-time analysis then iterates
+ *                R = C + B + sum over hp(i) of ceil(R / T(j)) * C(j)
+ *              for every task, where hp(i) holds the tasks of higher and of
+ *              equal priority, since the kernel time-slices those, and B is
+ *              the longest critical section of a lower priority task while
+ *              any task at or above the task's priority uses the mutex: the
+ *              kernel's priority inheritance bounds the blocking to one such
+ *              section. A sporadic task is analysed at its minimum
+ *              inter-arrival time. Interrupts are charged to the task they
+ *              preempt, so the measured WCETs already carry the interrupt
+ *              load seen during the capture.
+ *
+ *              The report goes to stdout. When a file name is given, the task
+ *              set with the measured WCETs is written there as a SimSo model
+ *              in the format of SimSo/RTOS_Project.xml.
+ *
+ *                ./build/seat_heater_sim | ./build/rta
+ *                ./build/rta RTOS_Project.xml 16000000 40 < capture
+ *
+ *              Arguments: the SimSo file to write, the core clock the cycle
+ *              timestamps count (configCPU_CLOCK_HZ), and the cost of one
+ *              context switch in cycles, charged twice per job.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "telemetry_decoder.h"
+#include "TaskSet.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define RTA_DEFAULT_CLOCK_HZ        16000000.0
+#define RTA_NUM_TAGS                256         /* Task tags fit the trace record's object byte */
+#define RTA_NO_TASK                 (-1)
+#define RTA_MAX_ITERATIONS          1000
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* A row of the task set in TaskSet.h */
+typedef struct
+{
+    uint32 ulTag;
+    const char *pcName;             /* SimSo task name */
+    uint32 ulPriority;              /* FreeRTOS priority, higher runs first */
+    uint32 ulPeriodMs;              /* Period, or minimum inter-arrival time */
+    uint32 ulDeadlineMs;            /* 0: best effort, analysed against its period */
+    boolean bSporadic;
+    boolean bUsesMutex;             /* Takes the seat table mutex */
+} Rta_TaskType;
+
+typedef struct
+{
+    double dWcetUs;
+    uint32 ulMisses;
+    double dCriticalUs;             /* Longest seat table mutex hold */
+    boolean bCriticalSeen;          /* Else the task's WCET stands in for it */
+    double dBlockingUs;
+    double dResponseUs;             /* < 0 if the iteration passed the deadline */
+} Rta_ResultType;
+
+typedef struct
+{
+    double dCyclesPerUs;
+    int iRunning;                   /* Task tag on the CPU */
+    uint32 ulRunningSince;
+    boolean bHolding[RTA_NUM_TAGS];
+    uint32 ulHeldCycles[RTA_NUM_TAGS];
+    double dMaxHoldUs[RTA_NUM_TAGS];
+    uint32 ulSections[RTA_NUM_TAGS];
+    uint32 ulDropped;
+    boolean bTraceSeen;
+    uint16 usNextSequence;
+    uint64 ullTraceRecords;
+    boolean bRuntimeSeen;
+    Telemetry_RuntimeType xRuntime;
+} Rta_StateType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* The task set main.c creates */
+static const Rta_TaskType axTasks[] =
+{
+#define APP_TASK(tag, name, priority, period, deadline, sporadic, mutex) \
+    { tag, name, priority, period, deadline, sporadic, mutex },
+    APP_TASKS
+#undef APP_TASK
+};
+
+#define RTA_NUM_TASKS               (sizeof(axTasks) / sizeof(axTasks[0]))
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Cycles the holder ran since it was last switched in */
+static void prvChargeHolder(Rta_StateType *pxState, uint32 ulCycles)
+{
+    if ((pxState->iRunning != RTA_NO_TASK) && pxState->bHolding[pxState->iRunning])
+    {
+        pxState->ulHeldCycles[pxState->iRunning] += ulCycles - pxState->ulRunningSince;
+    }
+    pxState->ulRunningSince = ulCycles;
+}
+
+/* After a gap a hold in progress cannot be measured */
+static void prvForget(Rta_StateType *pxState)
+{
+    memset(pxState->bHolding, 0, sizeof(pxState->bHolding));
+    pxState->iRunning = RTA_NO_TASK;
+}
+
+static void prvRecord(Rta_StateType *pxState, const Trace_RecordType *pxRecord)
+{
+    double dHoldUs;
+    int iTag;
+
+    pxState->ullTraceRecords++;
+    switch (pxRecord->Event)
+    {
+    case TRACE_EVENT_TASK_SWITCHED_IN:
+        prvChargeHolder(pxState, pxRecord->Cycles);
+        pxState->iRunning = (int)pxRecord->Object;
+        break;
+    case TRACE_EVENT_QUEUE_RECEIVE:
+        if ((pxRecord->Object == SEAT_TABLE_MUTEX_NUMBER) && (pxState->iRunning != RTA_NO_TASK))
+        {
+            prvChargeHolder(pxState, pxRecord->Cycles);
+            pxState->bHolding[pxState->iRunning] = TRUE;
+            pxState->ulHeldCycles[pxState->iRunning] = 0u;
+        }
+        break;
+    case TRACE_EVENT_QUEUE_SEND:
+        iTag = pxState->iRunning;
+        if ((pxRecord->Object == SEAT_TABLE_MUTEX_NUMBER) && (iTag != RTA_NO_TASK) && pxState->bHolding[iTag])
+        {
+            prvChargeHolder(pxState, pxRecord->Cycles);
+            pxState->bHolding[iTag] = FALSE;
+            dHoldUs = (double)pxState->ulHeldCycles[iTag] / pxState->dCyclesPerUs;
+            if (dHoldUs > pxState->dMaxHoldUs[iTag])
+            {
+                pxState->dMaxHoldUs[iTag] = dHoldUs;
+            }
+            pxState->ulSections[iTag]++;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void prvTrace(Rta_StateType *pxState, const TelemetryDecoder_RecordType *pxRecord)
+{
+    const Telemetry_TraceType *pxTrace = &pxRecord->u.xTrace;
+    uint32 ulRecord;
+
+    if ((pxState->bTraceSeen && (pxRecord->usSequence != pxState->usNextSequence)) ||
+        (pxTrace->Dropped != pxState->ulDropped))
+    {
+        prvForget(pxState);
+    }
+    pxState->bTraceSeen = TRUE;
+    pxState->usNextSequence = (uint16)(pxRecord->usSequence + 1u);
+    pxState->ulDropped = pxTrace->Dropped;
+    for (ulRecord = 0; ulRecord < pxTrace->NumberOfRecords; ulRecord++)
+    {
+        prvRecord(pxState, &pxTrace->Records[ulRecord]);
+    }
+}
+
+static double prvPeriodUs(const Rta_TaskType *pxTask)
+{
+    return (double)pxTask->ulPeriodMs * 1000.0;
+}
+
+static double prvDeadlineUs(const Rta_TaskType *pxTask)
+{
+    return (double)((pxTask->ulDeadlineMs != 0u) ? pxTask->ulDeadlineMs : pxTask->ulPeriodMs) * 1000.0;
+}
+
+static void prvBlocking(const Rta_ResultType *pxResults, uint32 ulTask, double *pdBlockingUs)
+{
+    uint32 ulPriority = axTasks[ulTask].ulPriority;
+    boolean bContended = FALSE;
+    uint32 ulOther;
+
+    *pdBlockingUs = 0.0;
+    for (ulOther = 0; ulOther < RTA_NUM_TASKS; ulOther++)
+    {
+        if (axTasks[ulOther].bUsesMutex && (axTasks[ulOther].ulPriority >= ulPriority))
+        {
+            bContended = TRUE;
+        }
+    }
+    if (!bContended)
+    {
+        return;
+    }
+    for (ulOther = 0; ulOther < RTA_NUM_TASKS; ulOther++)
+    {
+        if (axTasks[ulOther].bUsesMutex && (axTasks[ulOther].ulPriority < ulPriority) &&
+            (pxResults[ulOther].dCriticalUs > *pdBlockingUs))
+        {
+            *pdBlockingUs = pxResults[ulOther].dCriticalUs;
+        }
+    }
+}
+
+static double prvResponse(const Rta_ResultType *pxResults, uint32 ulTask, double dSwitchUs)
+{
+    double dDeadlineUs = prvDeadlineUs(&axTasks[ulTask]);
+    double dResponseUs = pxResults[ulTask].dWcetUs + (2.0 * dSwitchUs) + pxResults[ulTask].dBlockingUs;
+    double dNextUs;
+    uint32 ulIteration;
+    uint32 ulOther;
+
+    for (ulIteration = 0; ulIteration < RTA_MAX_ITERATIONS; ulIteration++)
+    {
+        dNextUs = pxResults[ulTask].dWcetUs + (2.0 * dSwitchUs) + pxResults[ulTask].dBlockingUs;
+        for (ulOther = 0; ulOther < RTA_NUM_TASKS; ulOther++)
+        {
+            if ((ulOther != ulTask) && (axTasks[ulOther].ulPriority >= axTasks[ulTask].ulPriority))
+            {
+                dNextUs += ceil(dResponseUs / prvPeriodUs(&axTasks[ulOther]))
+                         * (pxResults[ulOther].dWcetUs + (2.0 * dSwitchUs));
+            }
+        }
+        if (dNextUs > dDeadlineUs)
+        {
+            return -1.0;
+        }
+        if (dNextUs <= dResponseUs)
+        {
+            return dNextUs;
+        }
+        dResponseUs = dNextUs;
+    }
+    return -1.0;
+}
+
+static uint64 prvGcd(uint64 ullA, uint64 ullB)
+{
+    uint64 ullRest;
+
+    while (ullB != 0u)
+    {
+        ullRest = ullA % ullB;
+        ullA = ullB;
+        ullB = ullRest;
+    }
+    return ullA;
+}
+
+/* Same layout as SimSo/RTOS_Project.xml, one hyperperiod long, every task
+ * released at the critical instant */
+static boolean prvWriteModel(const char *pcFile, const Rta_ResultType *pxResults, double dClockHz,
+                             uint32 ulSwitchCycles)
+{
+    FILE *pxFile = fopen(pcFile, "w");
+    uint64 ullCyclesPerMs = (uint64)(dClockHz / 1000.0);
+    uint64 ullHyperperiodMs = 1u;
+    uint32 ulTask;
+
+    if (pxFile == NULL)
+    {
+        return FALSE;
+    }
+    for (ulTask = 0; ulTask < RTA_NUM_TASKS; ulTask++)
+    {
+        ullHyperperiodMs = (ullHyperperiodMs / prvGcd(ullHyperperiodMs, axTasks[ulTask].ulPeriodMs))
+                         * axTasks[ulTask].ulPeriodMs;
+    }
+    fprintf(pxFile, "<?xml version=\"1.0\" ?>\n");
+    fprintf(pxFile, "<simulation cycles_per_ms=\"%llu\" duration=\"%llu\" etm=\"wcet\">\n",
+            ullCyclesPerMs, ullHyperperiodMs * ullCyclesPerMs);
+    fprintf(pxFile, "\t<sched class=\"simso.schedulers.FP\" overhead=\"0\" overhead_activate=\"0\" "
+                    "overhead_terminate=\"0\"/>\n");
+    fprintf(pxFile, "\t<caches memory_access_time=\"100\"/>\n");
+    fprintf(pxFile, "\t<processors>\n");
+    fprintf(pxFile, "\t\t<processor cl_overhead=\"0\" cs_overhead=\"%u\" id=\"1\" name=\"CPU 1\" speed=\"1.0\"/>\n",
+            ulSwitchCycles);
+    fprintf(pxFile, "\t</processors>\n");
+    fprintf(pxFile, "\t<tasks>\n");
+    fprintf(pxFile, "\t\t<field name=\"priority\" type=\"int\"/>\n");
+    for (ulTask = 0; ulTask < RTA_NUM_TASKS; ulTask++)
+    {
+        fprintf(pxFile, "\t\t<task ACET=\"0.0\" WCET=\"%.3f\" abort_on_miss=\"no\" activationDate=\"0.0\" "
+                        "base_cpi=\"1.0\" deadline=\"%.1f\" et_stddev=\"0.0\" id=\"%u\" instructions=\"0\" "
+                        "list_activation_dates=\"\" mix=\"0.5\" name=\"%s\" period=\"%.1f\" "
+                        "preemption_cost=\"0\" priority=\"%u\" task_type=\"Periodic\"/>\n",
+                pxResults[ulTask].dWcetUs / 1000.0, prvDeadlineUs(&axTasks[ulTask]) / 1000.0,
+                axTasks[ulTask].ulTag, axTasks[ulTask].pcName, prvPeriodUs(&axTasks[ulTask]) / 1000.0,
+                axTasks[ulTask].ulPriority);
+    }
+    fprintf(pxFile, "\t</tasks>\n");
+    fprintf(pxFile, "</simulation>\n");
+    return (fclose(pxFile) == 0) ? TRUE : FALSE;
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    static TelemetryDecoder_Type xDecoder;
+    static Rta_StateType xState;
+    Rta_ResultType axResults[RTA_NUM_TASKS];
+    TelemetryDecoder_RecordType xRecord;
+    TelemetryDecoder_StatsType xStats;
+    const Rta_TaskType *pxTask;
+    Rta_ResultType *pxResult;
+    const char *pcModel = NULL;
+    double dClockHz = RTA_DEFAULT_CLOCK_HZ;
+    double dSwitchUs;
+    double dUtilisation = 0.0;
+    uint32 ulSwitchCycles = 0u;
+    uint32 ulTask;
+    boolean bSchedulable = TRUE;
+    int iByte;
+
+    if (argc >= 2)
+    {
+        pcModel = argv[1];
+    }
+    if (argc >= 3)
+    {
+        dClockHz = atof(argv[2]);
+    }
+    if (argc >= 4)
+    {
+        ulSwitchCycles = (uint32)strtoul(argv[3], NULL, 10);
+    }
+    if (dClockHz <= 0.0)
+    {
+        fprintf(stderr, "usage: %s [simso.xml [clock_hz [switch_cycles]]] < capture\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    xState.dCyclesPerUs = dClockHz / 1e6;
+    xState.iRunning = RTA_NO_TASK;
+    dSwitchUs = (double)ulSwitchCycles / xState.dCyclesPerUs;
+
+    TelemetryDecoder_Init(&xDecoder);
+    while ((iByte = getchar()) != EOF)
+    {
+        if (TelemetryDecoder_PushByte(&xDecoder, (uint8)iByte, &xRecord) != TELEMETRY_DECODER_RECORD)
+        {
+            continue;
+        }
+        if (xRecord.ucType == TELEMETRY_RECORD_TRACE)
+        {
+            prvTrace(&xState, &xRecord);
+        }
+        else if (xRecord.ucType == TELEMETRY_RECORD_RUNTIME)
+        {
+            /* High-water marks, the last record holds the largest */
+            xState.xRuntime = xRecord.u.xRuntime;
+            xState.bRuntimeSeen = TRUE;
+        }
+    }
+    TelemetryDecoder_GetStats(&xDecoder, &xStats);
+    if (!xState.bRuntimeSeen)
+    {
+        fprintf(stderr, "%s: no runtime record in the capture, it needs to run for at least one report period\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (ulTask = 0; ulTask < RTA_NUM_TASKS; ulTask++)
+    {
+        pxTask = &axTasks[ulTask];
+        pxResult = &axResults[ulTask];
+        pxResult->dWcetUs = 0.0;
+        pxResult->ulMisses = 0u;
+        if (pxTask->ulTag <= xState.xRuntime.NumberOfTasks)
+        {
+            pxResult->dWcetUs = (double)xState.xRuntime.TaskWcet[pxTask->ulTag - 1u];
+            pxResult->ulMisses = xState.xRuntime.DeadlineMisses[pxTask->ulTag - 1u];
+        }
+        pxResult->bCriticalSeen = (xState.ulSections[pxTask->ulTag] != 0u) ? TRUE : FALSE;
+        if (!pxTask->bUsesMutex)
+        {
+            pxResult->dCriticalUs = 0.0;
+            pxResult->bCriticalSeen = TRUE;
+        }
+        else if (pxResult->bCriticalSeen)
+        {
+            pxResult->dCriticalUs = xState.dMaxHoldUs[pxTask->ulTag];
+        }
+        else
+        {
+            pxResult->dCriticalUs = pxResult->dWcetUs;
+        }
+        dUtilisation += (pxResult->dWcetUs + (2.0 * dSwitchUs)) / prvPeriodUs(pxTask);
+    }
+    for (ulTask = 0; ulTask < RTA_NUM_TASKS; ulTask++)
+    {
+        prvBlocking(axResults, ulTask, &axResults[ulTask].dBlockingUs);
+    }
+    for (ulTask = 0; ulTask < RTA_NUM_TASKS; ulTask++)
+    {
+        axResults[ulTask].dResponseUs = prvResponse(axResults, ulTask, dSwitchUs);
+    }
+
+    printf("capture: %llu telemetry records, %llu trace events, %u dropped by the firmware, %llu lost; "
+           "clock %.0f Hz, context switch %u cycles\n",
+           xStats.ullRecords, xState.ullTraceRecords, xState.ulDropped, xStats.ullLostRecords, dClockHz,
+           ulSwitchCycles);
+    printf("%-16s %4s %8s %9s %5s %9s %12s %9s %9s %10s %10s\n",
+           "task", "prio", "T (ms)", "D (ms)", "tag", "WCET (us)", "mutex (us)", "B (us)", "R (us)",
+           "slack (us)", "misses");
+    for (ulTask = 0; ulTask < RTA_NUM_TASKS; ulTask++)
+    {
+        pxTask = &axTasks[ulTask];
+        pxResult = &axResults[ulTask];
+        printf("%-16s %4u %7u%s %9.0f %5u %9.1f %11.1f%s %9.1f",
+               pxTask->pcName, pxTask->ulPriority, pxTask->ulPeriodMs, pxTask->bSporadic ? "*" : " ",
+               prvDeadlineUs(pxTask) / 1000.0, pxTask->ulTag, pxResult->dWcetUs, pxResult->dCriticalUs,
+               pxResult->bCriticalSeen ? " " : "?", pxResult->dBlockingUs);
+        if (pxResult->dResponseUs < 0.0)
+        {
+            printf(" %9s %10s", "-", "MISS");
+            if (pxTask->ulDeadlineMs != 0u)
+            {
+                bSchedulable = FALSE;
+            }
+        }
+        else
+        {
+            printf(" %9.1f %10.1f", pxResult->dResponseUs, prvDeadlineUs(pxTask) - pxResult->dResponseUs);
+        }
+        printf(" %10u%s\n", pxResult->ulMisses, (pxTask->ulDeadlineMs == 0u) ? "  best effort" : "");
+    }
+    printf("* minimum inter-arrival time of a sporadic task\n");
+    printf("? no hold in the trace, the task's WCET stands in for it\n");
+    printf("utilisation %.3f %%, task set %s\n", 100.0 * dUtilisation,
+           bSchedulable ? "schedulable" : "NOT schedulable");
+
+    if ((pcModel != NULL) && !prvWriteModel(pcModel, axResults, dClockHz, ulSwitchCycles))
+    {
+        fprintf(stderr, "%s: cannot write %s\n", argv[0], pcModel);
+        return EXIT_FAILURE;
+    }
+    return bSchedulable ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,310 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Telemetry decoder
+ *
+ * File Name: telemetry_decoder.c
+ *
+ * Description: Host side decoder for the binary telemetry records. The CRC
+ *              is checked with the same driverlib Crc16 the firmware uses.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "telemetry_decoder.h"
+#include "driverlib/sw_crc.h"
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint16 prvGet16(const uint8 *pucData)
+{
+    return (uint16)(pucData[0] | (pucData[1] << 8));
+}
+
+static uint32 prvGet32(const uint8 *pucData)
+{
+    return (uint32)pucData[0] | ((uint32)pucData[1] << 8) |
+           ((uint32)pucData[2] << 16) | ((uint32)pucData[3] << 24);
+}
+
+static boolean prvUnpackSeatState(const uint8 *pucBody, uint32 ulLength,
+                                  Telemetry_SeatStateType *pxState)
+{
+    uint32 ulSeat;
+
+    if ((ulLength < 1u) || (pucBody[0] > TELEMETRY_MAX_SEATS) ||
+        (ulLength != (TELEMETRY_SEAT_STATE_SIZE(pucBody[0]) - TELEMETRY_HEADER_SIZE)))
+    {
+        return FALSE;
+    }
+    pxState->NumberOfSeats = *pucBody++;
+    for (ulSeat = 0; ulSeat < pxState->NumberOfSeats; ulSeat++)
+    {
+        pxState->Seats[ulSeat].Temperature = *pucBody++;
+        pxState->Seats[ulSeat].HeaterState = *pucBody++;
+        pxState->Seats[ulSeat].DesiredTemperature = *pucBody++;
+    }
+    pxState->Faults = *pucBody;
+    return TRUE;
+}
+
+static boolean prvUnpackRuntime(const uint8 *pucBody, uint32 ulLength,
+                                Telemetry_RuntimeType *pxRuntime)
+{
+    const uint8 *pucTask;
+    uint32 ulTask;
+
+    if ((ulLength < 4u) || (pucBody[3] > TELEMETRY_MAX_TASKS) ||
+        (ulLength != (TELEMETRY_RUNTIME_SIZE(pucBody[3]) - TELEMETRY_HEADER_SIZE)))
+    {
+        return FALSE;
+    }
+    pxRuntime->CpuLoad = pucBody[0];
+    pxRuntime->MaskedMax = prvGet16(&pucBody[1]);
+    pxRuntime->NumberOfTasks = pucBody[3];
+    for (ulTask = 0; ulTask < pxRuntime->NumberOfTasks; ulTask++)
+    {
+        pucTask = &pucBody[4u + (ulTask * TELEMETRY_TASK_SIZE)];
+        pxRuntime->TaskTime[ulTask] = prvGet32(&pucTask[0]);
+        pxRuntime->TaskWcet[ulTask] = prvGet16(&pucTask[4]);
+        pxRuntime->DeadlineMisses[ulTask] = prvGet16(&pucTask[6]);
+    }
+    return TRUE;
+}
+
+static boolean prvUnpackTrace(const uint8 *pucBody, uint32 ulLength,
+                              Telemetry_TraceType *pxTrace)
+{
+    const uint8 *pucRecord;
+    uint32 ulRecord;
+
+    if ((ulLength < 5u) || (pucBody[4] > TELEMETRY_MAX_TRACE_RECORDS) ||
+        (ulLength != (TELEMETRY_TRACE_SIZE(pucBody[4]) - TELEMETRY_HEADER_SIZE)))
+    {
+        return FALSE;
+    }
+    pxTrace->Dropped = prvGet32(pucBody);
+    pxTrace->NumberOfRecords = pucBody[4];
+    for (ulRecord = 0; ulRecord < pxTrace->NumberOfRecords; ulRecord++)
+    {
+        pucRecord = &pucBody[5u + (ulRecord * TRACE_RECORD_SIZE)];
+        pxTrace->Records[ulRecord].Cycles = prvGet32(pucRecord);
+        pxTrace->Records[ulRecord].Event = pucRecord[4];
+        pxTrace->Records[ulRecord].Object = pucRecord[5];
+        pxTrace->Records[ulRecord].Data = prvGet16(&pucRecord[6]);
+    }
+    return TRUE;
+}
+
+/* Records carry only the arguments their message has, so the body is walked
+ * and has to end with the last one */
+static boolean prvUnpackLog(const uint8 *pucBody, uint32 ulLength,
+                            Telemetry_LogType *pxLog)
+{
+    Log_RecordType *pxRecord;
+    uint32 ulOffset = 5u;
+    uint32 ulRecord;
+    uint32 ulArg;
+
+    if ((ulLength < 5u) || (pucBody[4] > TELEMETRY_MAX_LOG_RECORDS))
+    {
+        return FALSE;
+    }
+    pxLog->Dropped = prvGet32(pucBody);
+    pxLog->NumberOfRecords = pucBody[4];
+    for (ulRecord = 0; ulRecord < pxLog->NumberOfRecords; ulRecord++)
+    {
+        pxRecord = &pxLog->Records[ulRecord];
+        if (((ulOffset + TELEMETRY_LOG_RECORD_SIZE(0)) > ulLength) ||
+            (pucBody[ulOffset + 7u] > LOG_MAX_ARGS) ||
+            ((ulOffset + TELEMETRY_LOG_RECORD_SIZE(pucBody[ulOffset + 7u])) > ulLength))
+        {
+            return FALSE;
+        }
+        pxRecord->Cycles = prvGet32(&pucBody[ulOffset]);
+        pxRecord->Message = prvGet16(&pucBody[ulOffset + 4u]);
+        pxRecord->Producer = pucBody[ulOffset + 6u];
+        pxRecord->NumberOfArgs = pucBody[ulOffset + 7u];
+        for (ulArg = 0; ulArg < LOG_MAX_ARGS; ulArg++)
+        {
+            pxRecord->Args[ulArg] = (ulArg < pxRecord->NumberOfArgs) ?
+                                    prvGet32(&pucBody[ulOffset + 8u + (ulArg * 4u)]) : 0u;
+        }
+        ulOffset += TELEMETRY_LOG_RECORD_SIZE(pxRecord->NumberOfArgs);
+    }
+    return (ulOffset == ulLength) ? TRUE : FALSE;
+}
+
+static TelemetryDecoder_StatusType prvDecodeFrame(TelemetryDecoder_Type *pxDecoder,
+                                                  TelemetryDecoder_RecordType *pxRecord)
+{
+    uint8 aucPayload[TELEMETRY_MAX_FRAME_SIZE];
+    uint32 ulLength;
+    uint32 ulTimestamp;
+    uint8 ucType;
+    boolean bValid;
+
+    if (pxDecoder->bOverflow ||
+        !TelemetryDecoder_CobsDecode(pxDecoder->aucFrame, pxDecoder->ulLength, aucPayload, &ulLength) ||
+        (ulLength < (TELEMETRY_HEADER_SIZE + TELEMETRY_CRC_SIZE)))
+    {
+        return TELEMETRY_DECODER_FRAME_ERROR;
+    }
+
+    ulLength -= TELEMETRY_CRC_SIZE;
+    if (Crc16(0, aucPayload, ulLength) != prvGet16(&aucPayload[ulLength]))
+    {
+        return TELEMETRY_DECODER_CRC_ERROR;
+    }
+    if (aucPayload[0] != TELEMETRY_VERSION)
+    {
+        return TELEMETRY_DECODER_VERSION_ERROR;
+    }
+
+    ucType = aucPayload[1];
+    pxRecord->ucType = ucType;
+    pxRecord->usSequence = prvGet16(&aucPayload[2]);
+    ulTimestamp = prvGet32(&aucPayload[4]);
+    switch (ucType)
+    {
+    case TELEMETRY_RECORD_SEAT_STATE:
+        pxRecord->u.xSeatState.Timestamp = ulTimestamp;
+        bValid = prvUnpackSeatState(&aucPayload[TELEMETRY_HEADER_SIZE],
+                                    ulLength - TELEMETRY_HEADER_SIZE, &pxRecord->u.xSeatState);
+        break;
+    case TELEMETRY_RECORD_RUNTIME:
+        pxRecord->u.xRuntime.Timestamp = ulTimestamp;
+        bValid = prvUnpackRuntime(&aucPayload[TELEMETRY_HEADER_SIZE],
+                                  ulLength - TELEMETRY_HEADER_SIZE, &pxRecord->u.xRuntime);
+        break;
+    case TELEMETRY_RECORD_TRACE:
+        pxRecord->u.xTrace.Timestamp = ulTimestamp;
+        bValid = prvUnpackTrace(&aucPayload[TELEMETRY_HEADER_SIZE],
+                                ulLength - TELEMETRY_HEADER_SIZE, &pxRecord->u.xTrace);
+        break;
+    case TELEMETRY_RECORD_LOG:
+        pxRecord->u.xLog.Timestamp = ulTimestamp;
+        bValid = prvUnpackLog(&aucPayload[TELEMETRY_HEADER_SIZE],
+                              ulLength - TELEMETRY_HEADER_SIZE, &pxRecord->u.xLog);
+        break;
+    default:
+        bValid = FALSE;
+        break;
+    }
+    if (!bValid)
+    {
+        return TELEMETRY_DECODER_FRAME_ERROR;
+    }
+
+    /* A jump in the sequence number counts the records lost in between */
+    if (pxDecoder->abSeen[ucType])
+    {
+        pxDecoder->xStats.ullLostRecords +=
+            (uint16)(pxRecord->usSequence - pxDecoder->ausNextSequence[ucType]);
+    }
+    pxDecoder->abSeen[ucType] = TRUE;
+    pxDecoder->ausNextSequence[ucType] = (uint16)(pxRecord->usSequence + 1u);
+    return TELEMETRY_DECODER_RECORD;
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+void TelemetryDecoder_Init(TelemetryDecoder_Type *pxDecoder)
+{
+    memset(pxDecoder, 0, sizeof(*pxDecoder));
+}
+
+boolean TelemetryDecoder_CobsDecode(const uint8 *pucInput, uint32 ulLength,
+                                    uint8 *pucOutput, uint32 *pulDecoded)
+{
+    uint32 ulRead = 0;
+    uint32 ulWrite = 0;
+    uint32 ulCount;
+    uint8 ucCode;
+
+    while (ulRead < ulLength)
+    {
+        ucCode = pucInput[ulRead++];
+        if (ucCode == 0u)
+        {
+            return FALSE;
+        }
+        for (ulCount = 1; ulCount < ucCode; ulCount++)
+        {
+            if ((ulRead >= ulLength) || (pucInput[ulRead] == 0u))
+            {
+                return FALSE;
+            }
+            pucOutput[ulWrite++] = pucInput[ulRead++];
+        }
+
+        /* Every block but a full one and the last stands for a zero byte */
+        if ((ucCode != 0xFFu) && (ulRead < ulLength))
+        {
+            pucOutput[ulWrite++] = 0u;
+        }
+    }
+    *pulDecoded = ulWrite;
+    return TRUE;
+}
+
+TelemetryDecoder_StatusType TelemetryDecoder_PushByte(TelemetryDecoder_Type *pxDecoder,
+                                                      uint8 ucByte,
+                                                      TelemetryDecoder_RecordType *pxRecord)
+{
+    TelemetryDecoder_StatusType eStatus;
+
+    pxDecoder->xStats.ullBytes++;
+    if (ucByte != 0u)
+    {
+        if (pxDecoder->ulLength < sizeof(pxDecoder->aucFrame))
+        {
+            pxDecoder->aucFrame[pxDecoder->ulLength++] = ucByte;
+        }
+        else
+        {
+            pxDecoder->bOverflow = TRUE;
+        }
+        return TELEMETRY_DECODER_PENDING;
+    }
+
+    /* Back to back delimiters are idle fill, not empty frames */
+    if (pxDecoder->ulLength == 0u)
+    {
+        return TELEMETRY_DECODER_PENDING;
+    }
+
+    eStatus = prvDecodeFrame(pxDecoder, pxRecord);
+    pxDecoder->ulLength = 0;
+    pxDecoder->bOverflow = FALSE;
+
+    switch (eStatus)
+    {
+    case TELEMETRY_DECODER_RECORD:
+        pxDecoder->xStats.ullRecords++;
+        break;
+    case TELEMETRY_DECODER_CRC_ERROR:
+        pxDecoder->xStats.ullCrcErrors++;
+        break;
+    case TELEMETRY_DECODER_VERSION_ERROR:
+        pxDecoder->xStats.ullVersionErrors++;
+        break;
+    default:
+        pxDecoder->xStats.ullFrameErrors++;
+        break;
+    }
+    return eStatus;
+}
+
+void TelemetryDecoder_GetStats(const TelemetryDecoder_Type *pxDecoder,
+                               TelemetryDecoder_StatsType *pxStats)
+{
+    *pxStats = pxDecoder->xStats;
+}
@@ -0,0 +1,94 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Telemetry decoder
+ *
+ * File Name: telemetry_decoder.h
+ *
+ * Description: Host side decoder for the binary telemetry records of
+ *              Services/Telemetry. Bytes are pushed one at a time, as they
+ *              come off the serial line, and every zero delimiter closes a
+ *              frame that is COBS decoded, CRC checked and unpacked.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef TELEMETRY_DECODER_H_
+#define TELEMETRY_DECODER_H_
+
+#include "std_types.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Record types are small integers, one sequence tracker each */
+#define TELEMETRY_DECODER_NUM_TYPES     (TELEMETRY_RECORD_LOG + 1)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum
+{
+    TELEMETRY_DECODER_PENDING,          /* Frame not complete yet */
+    TELEMETRY_DECODER_RECORD,           /* A record was decoded */
+    TELEMETRY_DECODER_FRAME_ERROR,      /* Bad COBS, overlong frame, bad type or size */
+    TELEMETRY_DECODER_CRC_ERROR,
+    TELEMETRY_DECODER_VERSION_ERROR     /* Sent by a firmware this decoder does not know */
+} TelemetryDecoder_StatusType;
+
+typedef struct
+{
+    uint8 ucType;                       /* TELEMETRY_RECORD_* */
+    uint16 usSequence;
+    union
+    {
+        Telemetry_SeatStateType xSeatState;
+        Telemetry_RuntimeType xRuntime;
+        Telemetry_TraceType xTrace;
+        Telemetry_LogType xLog;
+    } u;
+} TelemetryDecoder_RecordType;
+
+typedef struct
+{
+    uint64 ullBytes;
+    uint64 ullRecords;
+    uint64 ullFrameErrors;
+    uint64 ullCrcErrors;
+    uint64 ullVersionErrors;
+    uint64 ullLostRecords;              /* Sum of the sequence number gaps */
+} TelemetryDecoder_StatsType;
+
+typedef struct
+{
+    uint8 aucFrame[TELEMETRY_MAX_FRAME_SIZE];
+    uint32 ulLength;
+    boolean bOverflow;
+    boolean abSeen[TELEMETRY_DECODER_NUM_TYPES];
+    uint16 ausNextSequence[TELEMETRY_DECODER_NUM_TYPES];
+    TelemetryDecoder_StatsType xStats;
+} TelemetryDecoder_Type;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+extern void TelemetryDecoder_Init(TelemetryDecoder_Type *pxDecoder);
+
+/* Feed one received byte, pxRecord is filled when TELEMETRY_DECODER_RECORD
+ * is returned */
+extern TelemetryDecoder_StatusType TelemetryDecoder_PushByte(TelemetryDecoder_Type *pxDecoder,
+                                                             uint8 ucByte,
+                                                             TelemetryDecoder_RecordType *pxRecord);
+
+/* Decode one COBS block without its delimiter, FALSE if it is malformed */
+extern boolean TelemetryDecoder_CobsDecode(const uint8 *pucInput, uint32 ulLength,
+                                           uint8 *pucOutput, uint32 *pulDecoded);
+
+extern void TelemetryDecoder_GetStats(const TelemetryDecoder_Type *pxDecoder,
+                                      TelemetryDecoder_StatsType *pxStats);
+
+#endif /* TELEMETRY_DECODER_H_ */
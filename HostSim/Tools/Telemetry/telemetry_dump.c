@@ -0,0 +1,154 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Telemetry decoder
+ *
+ * File Name: telemetry_dump.c
+ *
+ * Description: Reads the UART0 byte stream on stdin, from the host build or
+ *              a serial port, and prints one text line per telemetry record.
+ *              A summary of the decoder statistics goes to stderr at the end.
+ *              Log records are expanded with the formats of log_messages.h,
+ *              which the firmware never sends.
+ *
+ *                ./build/seat_heater_sim | ./build/telemetry_dump
+ *                ./build/telemetry_dump < /dev/ttyACM0
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "telemetry_decoder.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const char *const apcLogFormat[LOG_NUM_MESSAGES] =
+{
+#define LOG_MESSAGE(identifier, level, arguments, format) format,
+    LOG_MESSAGES
+#undef LOG_MESSAGE
+};
+
+static const char *const apcLogLevel[LOG_NUM_MESSAGES] =
+{
+#define LOG_MESSAGE(identifier, level, arguments, format) ((level) == LOG_LEVEL_ERROR) ? "error" : "info",
+    LOG_MESSAGES
+#undef LOG_MESSAGE
+};
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvPrintRecord(const TelemetryDecoder_RecordType *pxRecord)
+{
+    static const char *const apcHeater[] = { "OFF", "LOW", "MED", "HIGH" };
+    static const char *const apcSeat[] = { "driver", "passenger" };
+    uint32 ulIndex;
+
+    if (pxRecord->ucType == TELEMETRY_RECORD_SEAT_STATE)
+    {
+        const Telemetry_SeatStateType *pxState = &pxRecord->u.xSeatState;
+
+        printf("seat    #%-5u tick %-8u", pxRecord->usSequence, pxState->Timestamp);
+        for (ulIndex = 0; ulIndex < pxState->NumberOfSeats; ulIndex++)
+        {
+            if (ulIndex < 2u)
+            {
+                printf(" | %s", apcSeat[ulIndex]);
+            }
+            else
+            {
+                printf(" | seat %u", ulIndex);
+            }
+            printf(" %3u C, desired %3u C, heater %s",
+                   pxState->Seats[ulIndex].Temperature, pxState->Seats[ulIndex].DesiredTemperature,
+                   (pxState->Seats[ulIndex].HeaterState < 4u) ? apcHeater[pxState->Seats[ulIndex].HeaterState] : "?");
+        }
+        printf(" | faults 0x%02x\n", pxState->Faults);
+    }
+    else if (pxRecord->ucType == TELEMETRY_RECORD_TRACE)
+    {
+        const Telemetry_TraceType *pxTrace = &pxRecord->u.xTrace;
+
+        /* The events themselves are for trace_export */
+        printf("trace   #%-5u tick %-8u | %u kernel events, %u dropped since boot\n",
+               pxRecord->usSequence, pxTrace->Timestamp, pxTrace->NumberOfRecords, pxTrace->Dropped);
+    }
+    else if (pxRecord->ucType == TELEMETRY_RECORD_LOG)
+    {
+        const Telemetry_LogType *pxLog = &pxRecord->u.xLog;
+        const Log_RecordType *pxEntry;
+
+        for (ulIndex = 0; ulIndex < pxLog->NumberOfRecords; ulIndex++)
+        {
+            pxEntry = &pxLog->Records[ulIndex];
+            printf("log     #%-5u tick %-8u | cycle %-10u producer %u | ",
+                   pxRecord->usSequence, pxLog->Timestamp, pxEntry->Cycles, pxEntry->Producer);
+            if (pxEntry->Message < LOG_NUM_MESSAGES)
+            {
+                printf("%-5s ", apcLogLevel[pxEntry->Message]);
+                printf(apcLogFormat[pxEntry->Message], pxEntry->Args[0], pxEntry->Args[1], pxEntry->Args[2]);
+            }
+            else
+            {
+                printf("message %u not known to this decoder", pxEntry->Message);
+            }
+            printf("\n");
+        }
+        if (pxLog->Dropped != 0u)
+        {
+            printf("log     #%-5u tick %-8u | %u records dropped since boot\n",
+                   pxRecord->usSequence, pxLog->Timestamp, pxLog->Dropped);
+        }
+    }
+    else
+    {
+        const Telemetry_RuntimeType *pxRuntime = &pxRecord->u.xRuntime;
+
+        printf("runtime #%-5u tick %-8u | CPU %3u%% | masked max %u us | task time (ms)",
+               pxRecord->usSequence, pxRuntime->Timestamp, pxRuntime->CpuLoad, pxRuntime->MaskedMax);
+        for (ulIndex = 0; ulIndex < pxRuntime->NumberOfTasks; ulIndex++)
+        {
+            printf(" %u.%u", pxRuntime->TaskTime[ulIndex] / 10u, pxRuntime->TaskTime[ulIndex] % 10u);
+        }
+        printf(" | WCET (us) / misses");
+        for (ulIndex = 0; ulIndex < pxRuntime->NumberOfTasks; ulIndex++)
+        {
+            printf(" %u/%u", pxRuntime->TaskWcet[ulIndex], pxRuntime->DeadlineMisses[ulIndex]);
+        }
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+int main(void)
+{
+    static TelemetryDecoder_Type xDecoder;
+    TelemetryDecoder_RecordType xRecord;
+    TelemetryDecoder_StatsType xStats;
+    int iByte;
+
+    TelemetryDecoder_Init(&xDecoder);
+    while ((iByte = getchar()) != EOF)
+    {
+        if (TelemetryDecoder_PushByte(&xDecoder, (uint8)iByte, &xRecord) == TELEMETRY_DECODER_RECORD)
+        {
+            prvPrintRecord(&xRecord);
+        }
+    }
+
+    TelemetryDecoder_GetStats(&xDecoder, &xStats);
+    fprintf(stderr, "telemetry: %llu bytes, %llu records, %llu lost, %llu frame errors, "
+                    "%llu CRC errors, %llu version errors\n",
+            xStats.ullBytes, xStats.ullRecords, xStats.ullLostRecords, xStats.ullFrameErrors,
+            xStats.ullCrcErrors, xStats.ullVersionErrors);
+    return ((xStats.ullCrcErrors + xStats.ullFrameErrors + xStats.ullVersionErrors) == 0u) ? 0 : 1;
+}
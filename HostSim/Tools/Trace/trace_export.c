@@ -0,0 +1,360 @@
+ /******************************************************************************
+ *
+ * Module: HostSim - Trace export
+ *
+ * File Name: trace_export.c
+ *
+ * Description: Reads the UART0 byte stream on stdin, like telemetry_dump, and
+ *              writes the kernel trace records it carries as Chrome trace
+ *              event JSON on stdout, which ui.perfetto.dev and
+ *              chrome://tracing open directly.
+ *
+ *              Every task tag gets a track with one slice per stretch on the
+ *              CPU, every interrupt vector a track with one slice per handler
+ *              run. Ready, delay, queue, semaphore and notification events
+ *              are instants on the track of whoever caused them; a ready
+ *              event sits on the track of the task made ready. Records the
+ *              firmware dropped and trace frames lost on the line show as
+ *              global instants, after which the running task is unknown
+ *              until the next switch.
+ *
+ *                ./build/seat_heater_sim | ./build/trace_export > trace.json
+ *                ./build/trace_export 16000000 1=Acquisition 2=Control < capture > trace.json
+ *
+ *              The first argument is the core clock the cycle timestamps
+ *              count (configCPU_CLOCK_HZ), then optional tag=name pairs.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "telemetry_decoder.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define EXPORT_DEFAULT_CLOCK_HZ     16000000.0
+#define EXPORT_NUM_TAGS             256         /* Task tags fit the record's object byte */
+#define EXPORT_NUM_VECTORS          256
+#define EXPORT_ISR_TID_BASE         1000        /* Interrupt tracks follow the task tracks */
+#define EXPORT_MAX_NESTING          8
+#define EXPORT_NO_TASK              (-1)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 ulVector;
+    double dStartUs;
+} Export_IsrType;
+
+typedef struct
+{
+    double dCyclesPerUs;
+    uint64 ullBase;                 /* Cycle counter wraps seen so far, in cycles */
+    uint32 ulLastCycles;
+    boolean bStarted;
+    double dNowUs;
+    int iRunning;                   /* Task tag on the CPU */
+    double dRunningSinceUs;
+    Export_IsrType axIsr[EXPORT_MAX_NESTING];
+    uint32 ulIsrDepth;
+    uint32 ulDropped;
+    boolean bTraceSeen;
+    uint16 usNextSequence;
+    boolean abTaskNamed[EXPORT_NUM_TAGS];
+    boolean abVectorNamed[EXPORT_NUM_VECTORS];
+    const char *apcTaskNames[EXPORT_NUM_TAGS];
+    boolean bFirstEvent;
+    uint64 ullEvents;
+} Export_StateType;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static void prvBeginEvent(Export_StateType *pxState)
+{
+    printf(pxState->bFirstEvent ? "\n    " : ",\n    ");
+    pxState->bFirstEvent = FALSE;
+    pxState->ullEvents++;
+}
+
+/* Names given on the command line are used as they are, quotes aside */
+static void prvPrintName(const char *pcName)
+{
+    for (; *pcName != '\0'; pcName++)
+    {
+        if ((*pcName != '"') && (*pcName != '\\'))
+        {
+            putchar(*pcName);
+        }
+    }
+}
+
+static void prvNameTask(Export_StateType *pxState, uint32 ulTag)
+{
+    if (pxState->abTaskNamed[ulTag])
+    {
+        return;
+    }
+    pxState->abTaskNamed[ulTag] = TRUE;
+    prvBeginEvent(pxState);
+    printf("{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"", ulTag);
+    if (pxState->apcTaskNames[ulTag] != NULL)
+    {
+        prvPrintName(pxState->apcTaskNames[ulTag]);
+    }
+    else if (ulTag == 0u)
+    {
+        printf("idle");
+    }
+    else
+    {
+        printf("task %u", ulTag);
+    }
+    printf("\"}}");
+    prvBeginEvent(pxState);
+    printf("{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":%u}}",
+           ulTag, ulTag);
+}
+
+static void prvNameVector(Export_StateType *pxState, uint32 ulVector)
+{
+    if (pxState->abVectorNamed[ulVector])
+    {
+        return;
+    }
+    pxState->abVectorNamed[ulVector] = TRUE;
+    prvBeginEvent(pxState);
+    printf("{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"IRQ vector %u\"}}",
+           EXPORT_ISR_TID_BASE + ulVector, ulVector);
+}
+
+static void prvSlice(Export_StateType *pxState, uint32 ulTid, const char *pcName, double dStartUs)
+{
+    prvBeginEvent(pxState);
+    printf("{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"name\":\"%s\",\"ts\":%.3f,\"dur\":%.3f}",
+           ulTid, pcName, dStartUs, pxState->dNowUs - dStartUs);
+}
+
+static void prvInstant(Export_StateType *pxState, uint32 ulTid, const char *pcName,
+                       const Trace_RecordType *pxRecord)
+{
+    prvBeginEvent(pxState);
+    printf("{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"name\":\"%s\",\"ts\":%.3f,"
+           "\"args\":{\"object\":%u,\"data\":%u}}",
+           ulTid, pcName, pxState->dNowUs, pxRecord->Object, pxRecord->Data);
+}
+
+static void prvGlobalInstant(Export_StateType *pxState, const char *pcName, uint32 ulCount)
+{
+    prvBeginEvent(pxState);
+    printf("{\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"name\":\"%s\",\"ts\":%.3f,\"args\":{\"count\":%u}}",
+           pcName, pxState->dNowUs, ulCount);
+}
+
+/* After a gap nothing is known about who ran in between */
+static void prvForget(Export_StateType *pxState)
+{
+    pxState->iRunning = EXPORT_NO_TASK;
+    pxState->ulIsrDepth = 0;
+}
+
+/* Track the event happened on: the innermost handler, else the running task */
+static boolean prvContextTid(const Export_StateType *pxState, uint32 *pulTid)
+{
+    if (pxState->ulIsrDepth != 0u)
+    {
+        *pulTid = EXPORT_ISR_TID_BASE + pxState->axIsr[pxState->ulIsrDepth - 1u].ulVector;
+        return TRUE;
+    }
+    if (pxState->iRunning != EXPORT_NO_TASK)
+    {
+        *pulTid = (uint32)pxState->iRunning;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static void prvSwitchedIn(Export_StateType *pxState, uint32 ulTag)
+{
+    if (pxState->iRunning != EXPORT_NO_TASK)
+    {
+        prvSlice(pxState, (uint32)pxState->iRunning, "running", pxState->dRunningSinceUs);
+    }
+    prvNameTask(pxState, ulTag);
+    pxState->iRunning = (int)ulTag;
+    pxState->dRunningSinceUs = pxState->dNowUs;
+}
+
+static void prvIsrExit(Export_StateType *pxState, uint32 ulVector)
+{
+    Export_IsrType *pxIsr;
+
+    if (pxState->ulIsrDepth == 0u)
+    {
+        return;
+    }
+    pxIsr = &pxState->axIsr[--pxState->ulIsrDepth];
+    if (pxIsr->ulVector == ulVector)
+    {
+        prvSlice(pxState, EXPORT_ISR_TID_BASE + ulVector, "handler", pxIsr->dStartUs);
+    }
+    else
+    {
+        /* Unbalanced after lost records, start over with the next entry */
+        pxState->ulIsrDepth = 0;
+    }
+}
+
+static void prvRecord(Export_StateType *pxState, const Trace_RecordType *pxRecord)
+{
+    static const char *const apcNames[TRACE_NUM_EVENTS] =
+    {
+        "?", "switched in", "ready", "delay", "suspend", "resume", "queue send / give",
+        "queue send failed", "queue receive / take", "queue receive failed", "blocked on queue",
+        "notify", "notify from ISR", "notify wait", "blocked on notify", "ISR enter", "ISR exit",
+    };
+    uint32 ulTid;
+
+    /* The ring is filled with interrupts masked, so timestamps only go
+     * forward; a smaller one means the 32-bit counter wrapped */
+    if (pxState->bStarted && (pxRecord->Cycles < pxState->ulLastCycles))
+    {
+        pxState->ullBase += 1ull << 32;
+    }
+    pxState->bStarted = TRUE;
+    pxState->ulLastCycles = pxRecord->Cycles;
+    pxState->dNowUs = (double)(pxState->ullBase + pxRecord->Cycles) / pxState->dCyclesPerUs;
+
+    switch (pxRecord->Event)
+    {
+    case TRACE_EVENT_TASK_SWITCHED_IN:
+        prvSwitchedIn(pxState, pxRecord->Object);
+        break;
+    case TRACE_EVENT_ISR_ENTER:
+        prvNameVector(pxState, pxRecord->Object);
+        if (pxState->ulIsrDepth < EXPORT_MAX_NESTING)
+        {
+            pxState->axIsr[pxState->ulIsrDepth].ulVector = pxRecord->Object;
+            pxState->axIsr[pxState->ulIsrDepth].dStartUs = pxState->dNowUs;
+            pxState->ulIsrDepth++;
+        }
+        break;
+    case TRACE_EVENT_ISR_EXIT:
+        prvIsrExit(pxState, pxRecord->Object);
+        break;
+    case TRACE_EVENT_TASK_READY:
+        prvNameTask(pxState, pxRecord->Object);
+        prvInstant(pxState, pxRecord->Object, apcNames[pxRecord->Event], pxRecord);
+        break;
+    default:
+        if ((pxRecord->Event < TRACE_NUM_EVENTS) && prvContextTid(pxState, &ulTid))
+        {
+            prvInstant(pxState, ulTid, apcNames[pxRecord->Event], pxRecord);
+        }
+        break;
+    }
+}
+
+static void prvTrace(Export_StateType *pxState, const TelemetryDecoder_RecordType *pxRecord)
+{
+    const Telemetry_TraceType *pxTrace = &pxRecord->u.xTrace;
+    uint32 ulRecord;
+
+    if (pxState->bTraceSeen && (pxRecord->usSequence != pxState->usNextSequence))
+    {
+        prvGlobalInstant(pxState, "trace frames lost", (uint16)(pxRecord->usSequence - pxState->usNextSequence));
+        prvForget(pxState);
+    }
+    pxState->bTraceSeen = TRUE;
+    pxState->usNextSequence = (uint16)(pxRecord->usSequence + 1u);
+
+    /* The count covers drops before the first record of this frame */
+    if (pxTrace->Dropped != pxState->ulDropped)
+    {
+        prvGlobalInstant(pxState, "trace records dropped", pxTrace->Dropped - pxState->ulDropped);
+        pxState->ulDropped = pxTrace->Dropped;
+        prvForget(pxState);
+    }
+    for (ulRecord = 0; ulRecord < pxTrace->NumberOfRecords; ulRecord++)
+    {
+        prvRecord(pxState, &pxTrace->Records[ulRecord]);
+    }
+}
+
+/*******************************************************************************
+ *                      Public Functions Definitions                           *
+ *******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    static TelemetryDecoder_Type xDecoder;
+    static Export_StateType xState;
+    TelemetryDecoder_RecordType xRecord;
+    TelemetryDecoder_StatsType xStats;
+    double dClockHz = EXPORT_DEFAULT_CLOCK_HZ;
+    char *pcEnd;
+    int iArg;
+    int iByte;
+    unsigned long ulTag;
+
+    if (argc >= 2)
+    {
+        dClockHz = atof(argv[1]);
+    }
+    if (dClockHz <= 0.0)
+    {
+        fprintf(stderr, "usage: %s [clock_hz [tag=name ...]] < capture > trace.json\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (iArg = 2; iArg < argc; iArg++)
+    {
+        ulTag = strtoul(argv[iArg], &pcEnd, 10);
+        if ((*pcEnd != '=') || (ulTag >= EXPORT_NUM_TAGS))
+        {
+            fprintf(stderr, "%s: expected tag=name, got '%s'\n", argv[0], argv[iArg]);
+            return EXIT_FAILURE;
+        }
+        xState.apcTaskNames[ulTag] = pcEnd + 1;
+    }
+    xState.dCyclesPerUs = dClockHz / 1e6;
+    xState.iRunning = EXPORT_NO_TASK;
+    xState.bFirstEvent = TRUE;
+
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    prvBeginEvent(&xState);
+    printf("{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"seat heater firmware\"}}");
+
+    TelemetryDecoder_Init(&xDecoder);
+    while ((iByte = getchar()) != EOF)
+    {
+        if ((TelemetryDecoder_PushByte(&xDecoder, (uint8)iByte, &xRecord) == TELEMETRY_DECODER_RECORD) &&
+            (xRecord.ucType == TELEMETRY_RECORD_TRACE))
+        {
+            prvTrace(&xState, &xRecord);
+        }
+    }
+
+    /* The task still on the CPU gets its slice up to the last event */
+    if (xState.iRunning != EXPORT_NO_TASK)
+    {
+        prvSlice(&xState, (uint32)xState.iRunning, "running", xState.dRunningSinceUs);
+    }
+    printf("\n]}\n");
+
+    TelemetryDecoder_GetStats(&xDecoder, &xStats);
+    fprintf(stderr, "trace: %llu telemetry records, %llu trace events written, last at %.3f s, "
+                    "%u records dropped by the firmware, %llu frame errors, %llu CRC errors\n",
+            xStats.ullRecords, xState.ullEvents, xState.dNowUs / 1e6, xState.ulDropped,
+            xStats.ullFrameErrors, xStats.ullCrcErrors);
+    return ((xStats.ullCrcErrors + xStats.ullFrameErrors + xStats.ullVersionErrors) == 0u) ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+# -----------------------------------------------------------------------------
+# Configure time generation of the two files that let the firmware sources
+# build unchanged on the host:
+#
+#   tm4c123gh6pm_registers.h  the MCAL register header with every
+#                             (*((volatile uint32 *)0xADDR)) access rewritten
+#                             to go through the register file
+#   sim_vectors.c             the peripheral part of the startup file's vector
+#                             table, for the simulated NVIC to dispatch from
+# -----------------------------------------------------------------------------
+
+# Only rewrite the output when the content changed, so a re-configure does not
+# rebuild the whole firmware.
+function(hostsim_write_if_changed path content)
+    if(EXISTS "${path}")
+        file(READ "${path}" old_content)
+        if(old_content STREQUAL content)
+            return()
+        endif()
+    endif()
+    file(WRITE "${path}" "${content}")
+endfunction()
+
+function(hostsim_generate_registers input output)
+    file(READ "${input}" text)
+    string(REGEX REPLACE
+        "\\(\\*\\(\\(volatile uint32 \\*\\)(0x[0-9A-Fa-f]+)\\)\\)"
+        "(*SimReg_Map(\\1u))"
+        text "${text}")
+    string(REPLACE
+        "#include \"std_types.h\""
+        "#include \"std_types.h\"\n#include \"sim_registers.h\""
+        text "${text}")
+    set(header "/* Generated from ${input} - do not edit */\n")
+    hostsim_write_if_changed("${output}" "${header}${text}")
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${input}")
+endfunction()
+
+function(hostsim_generate_vectors input output)
+    file(READ "${input}" text)
+    string(REGEX MATCH "g_pfnVectors\\[\\]\\)\\(void\\) =[^{]*{([^}]*)}" table "${text}")
+    if(NOT table)
+        message(FATAL_ERROR "No g_pfnVectors table found in ${input}")
+    endif()
+    set(table "${CMAKE_MATCH_1}")
+    string(REGEX REPLACE "//[^\n]*" "" table "${table}")
+    string(REGEX REPLACE "[ \t\r\n]" "" table "${table}")
+    string(REPLACE "," ";" entries "${table}")
+
+    set(declarations "")
+    set(initialisers "")
+    set(index 0)
+    foreach(entry IN LISTS entries)
+        # The core exception vectors (0-15) belong to the FreeRTOS port
+        if(index GREATER_EQUAL 16 AND entry MATCHES "^[A-Za-z_][A-Za-z0-9_]*$"
+           AND NOT entry STREQUAL "IntDefaultHandler")
+            string(APPEND declarations "extern void ${entry}(void);\n")
+            string(APPEND initialisers "    [${index}] = ${entry},\n")
+        endif()
+        if(NOT entry STREQUAL "")
+            math(EXPR index "${index} + 1")
+        endif()
+    endforeach()
+
+    set(content "/* Generated from ${input} - do not edit */\n\n")
+    string(APPEND content "#include \"sim_nvic.h\"\n\n")
+    string(APPEND content "${declarations}\n")
+    string(APPEND content "void (* const g_pfnSimVectors[${index}])(void) =\n{\n${initialisers}};\n\n")
+    string(APPEND content "const uint32 g_ulSimVectorCount = ${index}u;\n")
+    hostsim_write_if_changed("${output}" "${content}")
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${input}")
+endfunction()
@@ -0,0 +1,38 @@
+/*
+ * -------------------------------------------------------------------------
+ * FreeRTOS Kernel Configuration File - Linux host simulation
+ * -------------------------------------------------------------------------
+ * Pulls in the target configuration unchanged so the host build schedules
+ * the same tasks with the same tick, priorities and trace hooks, then
+ * overrides only what has to differ on a 64-bit Linux process.
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef HOSTSIM_FREERTOS_CONFIG_H
+#define HOSTSIM_FREERTOS_CONFIG_H
+
+#include "../../Project Work Space/WS/First RTOS Project/FreeRTOSConfig.h"
+
+/******************************************************************************/
+/* Host overrides. ************************************************************/
+/******************************************************************************/
+
+/* The simulation idle hook parks the host thread until the next signal
+ * instead of spinning a host core at 100%. */
+#undef  configUSE_IDLE_HOOK
+#define configUSE_IDLE_HOOK                   1
+
+/* Lets the port account idle time for the CPU load report. */
+#define INCLUDE_xTaskGetIdleTaskHandle        1
+
+/* Sleep mode stops the core clock, and CYCCNT with it, as on the target. */
+extern void SimDwt_SetSleeping(boolean bSleep);
+#define configPRE_SLEEP_PROCESSING( x )       SimDwt_SetSleeping(TRUE)
+#define configPOST_SLEEP_PROCESSING( x )      SimDwt_SetSleeping(FALSE)
+
+/* Report the failing assertion instead of spinning with interrupts off. */
+extern void vAssertCalled(const char *pcFile, unsigned long ulLine);
+#undef  configASSERT
+#define configASSERT( x ) if( ( x ) == 0 ) { vAssertCalled( __FILE__, __LINE__ ); }
+
+#endif /* HOSTSIM_FREERTOS_CONFIG_H */
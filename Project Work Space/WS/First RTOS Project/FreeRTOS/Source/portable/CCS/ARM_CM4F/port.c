@@ -34,6 +34,13 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
+#if ( configUSE_MPU_STACK_GUARD == 1 )
+    #include <stdbool.h>
+    #include "inc/hw_ints.h"
+    #include "driverlib/interrupt.h"
+    #include "driverlib/mpu.h"
+#endif
+
 #ifndef __TI_VFP_SUPPORT__
     #error This port can only be used when the project options are configured to enable hardware floating point support.
 #endif
@@ -88,6 +95,41 @@
  * calculations. */
 #define portMISSED_COUNTS_FACTOR              ( 94UL )
 
+/* Wide Timer 1A is the wake source of the GPTM tickless idle.  It counts the
+ * system clock, as the SysTick does, so one count is one SysTick decrement. */
+#define portSYSCTL_RCGCWTIMER_REG             ( *( ( volatile uint32_t * ) 0x400FE65C ) )
+#define portSYSCTL_PRWTIMER_REG               ( *( ( volatile uint32_t * ) 0x400FEA5C ) )
+#define portWAKE_TIMER_CFG_REG                ( *( ( volatile uint32_t * ) 0x40037000 ) )
+#define portWAKE_TIMER_TAMR_REG               ( *( ( volatile uint32_t * ) 0x40037004 ) )
+#define portWAKE_TIMER_CTL_REG                ( *( ( volatile uint32_t * ) 0x4003700C ) )
+#define portWAKE_TIMER_IMR_REG                ( *( ( volatile uint32_t * ) 0x40037018 ) )
+#define portWAKE_TIMER_RIS_REG                ( *( ( volatile uint32_t * ) 0x4003701C ) )
+#define portWAKE_TIMER_ICR_REG                ( *( ( volatile uint32_t * ) 0x40037024 ) )
+#define portWAKE_TIMER_TAILR_REG              ( *( ( volatile uint32_t * ) 0x40037028 ) )
+#define portWAKE_TIMER_TAPR_REG               ( *( ( volatile uint32_t * ) 0x40037038 ) )
+#define portWAKE_TIMER_TAV_REG                ( *( ( volatile uint32_t * ) 0x40037050 ) )
+#define portWAKE_TIMER_PRI_REG                ( *( ( volatile uint8_t * ) 0xE000E460 ) )
+#define portNVIC_EN3_REG                      ( *( ( volatile uint32_t * ) 0xE000E10C ) )
+#define portNVIC_DIS3_REG                     ( *( ( volatile uint32_t * ) 0xE000E18C ) )
+#define portNVIC_UNPEND3_REG                  ( *( ( volatile uint32_t * ) 0xE000E28C ) )
+#define portWAKE_TIMER_CLOCK_BIT              ( 1UL << 1UL )  /* WTIMER1 in RCGCWTIMER */
+#define portWAKE_TIMER_NVIC_BIT               ( 1UL << 0UL )  /* Interrupt 96 in EN3 */
+#define portWAKE_TIMER_CFG_32_BIT             ( 0x04UL )
+#define portWAKE_TIMER_TAMR_PERIODIC          ( 0x02UL )
+#define portWAKE_TIMER_ENABLE_BIT             ( 1UL << 0UL )
+#define portWAKE_TIMER_TIMEOUT_BIT            ( 1UL << 0UL )
+
+/* Counts lost while neither the SysTick nor the wake timer runs, as
+ * portMISSED_COUNTS_FACTOR is for the SysTick only tickless idle. */
+#define portWAKE_TIMER_MISSED_COUNTS          ( portMISSED_COUNTS_FACTOR )
+
+/* MemManage fault status (the low byte of the CFSR) and address.  A fault on
+ * exception entry or lazy FPU stacking records no address. */
+#define portNVIC_MMFSR_REG                    ( *( ( volatile uint8_t * ) 0xE000ED28 ) )
+#define portNVIC_MMFAR_REG                    ( *( ( volatile uint32_t * ) 0xE000ED34 ) )
+#define portMMFSR_MMARVALID_BIT               ( 0x80UL )
+#define portMMFSR_STACKING_BITS               ( 0x30UL )  /* MLSPERR, MSTKERR */
+
 /* For strict compliance with the Cortex-M spec the task start address should
  * have bit-0 clear, as it is loaded into the PC on exit from an ISR. */
 #define portSTART_ADDRESS_MASK                ( ( StackType_t ) 0xfffffffeUL )
@@ -104,6 +146,27 @@
     #define portNVIC_SYSTICK_CLK_BIT_CONFIG    ( 0 )
 #endif
 
+/* Called around the outermost critical section with interrupts masked, so
+ * the application can time how long they stay masked. */
+#ifndef traceCRITICAL_ENTERED
+    #define traceCRITICAL_ENTERED()
+#endif
+#ifndef traceCRITICAL_EXITING
+    #define traceCRITICAL_EXITING()
+#endif
+
+/* Called with interrupts masked when the wake timer starts timing a tickless
+ * sleep, and after the wake-up, before the interrupt that woke the core runs,
+ * with the core clock cycles the wake timer measured.  The core clock stops in
+ * Sleep mode, so the application can put that time back into anything timed
+ * on the core clock. */
+#ifndef traceSLEEP_ENTERED
+    #define traceSLEEP_ENTERED()
+#endif
+#ifndef traceSLEEP_ENDED
+    #define traceSLEEP_ENDED( ulCycles )
+#endif
+
 /*
  * Setup the timer to generate the tick interrupts.  The implementation in this
  * file is weak to allow application writers to change the timer used to
@@ -131,6 +194,20 @@ extern void vPortEnableVFP( void );
  */
 static void prvTaskExitError( void );
 
+/*
+ * Size, attributes and enable of the stack guard region, and the MPU itself.
+ */
+#if ( configUSE_MPU_STACK_GUARD == 1 )
+    static void prvSetupStackGuard( void );
+
+/*
+ * Called from the MemManage handler with the task whose guard was hit.  The
+ * scheduler cannot be relied on any more, the hook is not expected to return.
+ */
+    extern void vApplicationStackGuardHook( TaskHandle_t xTask,
+                                            char * pcTaskName );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* Required to allow portasm.asm access the configMAX_SYSCALL_INTERRUPT_PRIORITY
@@ -164,6 +241,16 @@ static UBaseType_t uxCriticalNesting = 0xaaaaaaaa;
     static uint32_t ulStoppedTimerCompensation = 0;
 #endif /* configUSE_TICKLESS_IDLE */
 
+/*
+ * GPTM tickless idle: the tick period in wake timer counts, the longest sleep,
+ * which the 32-bit wake timer allows to be minutes long, and the statistics.
+ */
+#if ( configUSE_TICKLESS_IDLE == 2 )
+    static uint32_t ulTimerCountsForOneTick = 0;
+    static TickType_t xMaximumPossibleSuppressedTicks = 0;
+    static PortTicklessStats_t xTicklessStats;
+#endif /* configUSE_TICKLESS_IDLE */
+
 /*
  * Used by the portASSERT_IF_INTERRUPT_PRIORITY_INVALID() macro to ensure
  * FreeRTOS API functions are not called from interrupts that have been assigned
@@ -305,6 +392,12 @@ BaseType_t xPortStartScheduler( void )
      * here already. */
     vPortSetupTimerInterrupt();
 
+    #if ( configUSE_MPU_STACK_GUARD == 1 )
+    {
+        prvSetupStackGuard();
+    }
+    #endif
+
     /* Initialise the critical nesting count ready for the first task. */
     uxCriticalNesting = 0;
 
@@ -322,6 +415,53 @@ BaseType_t xPortStartScheduler( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_MPU_STACK_GUARD == 1 )
+
+    static void prvSetupStackGuard( void )
+    {
+        /* traceTASK_SWITCHED_IN() in vTaskStartScheduler() has already
+         * written the first task's guard base, which also selected the
+         * region. */
+        MPURegionSet( portSTACK_GUARD_REGION, portMPU_RBAR_REG & portMPU_RBAR_ADDR_MASK,
+                      MPU_RGN_SIZE_32B | MPU_RGN_PERM_NOEXEC | MPU_RGN_PERM_PRV_NO_USR_NO | MPU_RGN_ENABLE );
+
+        /* Tasks run privileged, everything outside the guard keeps the
+         * default memory map. */
+        MPUEnable( MPU_CONFIG_PRIV_DEFAULT );
+
+        /* A guard hit raises MemManage rather than escalating to HardFault. */
+        IntEnable( FAULT_MPU );
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortMemManageHandler( void )
+    {
+        uint32_t ulStatus = portNVIC_MMFSR_REG;
+        uint32_t ulAddress = portNVIC_MMFAR_REG;
+        uint32_t ulGuard = portMPU_RBAR_REG & portMPU_RBAR_ADDR_MASK;
+        TaskHandle_t xTask;
+
+        /* The guard is the only region, but the default map still faults, for
+         * example, on execution from peripheral space.  A push from PendSV
+         * while it saves the outgoing task is attributed to that task, which
+         * is still the current one. */
+        if( ( ( ulStatus & portMMFSR_STACKING_BITS ) != 0 ) ||
+            ( ( ( ulStatus & portMMFSR_MMARVALID_BIT ) != 0 ) && ( ( ulAddress - ulGuard ) < portSTACK_GUARD_SIZE ) ) )
+        {
+            xTask = xTaskGetCurrentTaskHandle();
+            vApplicationStackGuardHook( xTask, pcTaskGetName( xTask ) );
+        }
+
+        portDISABLE_INTERRUPTS();
+
+        for( ; ; )
+        {
+        }
+    }
+
+#endif /* configUSE_MPU_STACK_GUARD */
+/*-----------------------------------------------------------*/
+
 void vPortEndScheduler( void )
 {
     /* Not implemented in ports where there is nothing to return to.
@@ -343,6 +483,7 @@ void vPortEnterCritical( void )
     if( uxCriticalNesting == 1 )
     {
         configASSERT( ( portNVIC_INT_CTRL_REG & portVECTACTIVE_MASK ) == 0 );
+        traceCRITICAL_ENTERED();
     }
 }
 /*-----------------------------------------------------------*/
@@ -354,6 +495,7 @@ void vPortExitCritical( void )
 
     if( uxCriticalNesting == 0 )
     {
+        traceCRITICAL_EXITING();
         portENABLE_INTERRUPTS();
     }
 }
@@ -601,6 +743,194 @@ void xPortSysTickHandler( void )
 #endif /* configUSE_TICKLESS_IDLE */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TICKLESS_IDLE == 2 )
+
+    /* Tickless idle with Wide Timer 1A as the wake source.  The SysTick is
+     * stopped for the whole sleep and the wake timer, set to end the sleep on
+     * the tick the kernel expects to be needed next, measures how long the
+     * core actually slept when another interrupt woke it earlier.  The wake
+     * timer runs periodic, so it keeps counting past its time-out until the
+     * SysTick is running again, and it is only enabled in the NVIC for the
+     * WFI itself: its interrupt wakes the core but is never taken. */
+    void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+    {
+        uint32_t ulSysTickDecrementsLeft, ulCarriedTicks, ulWakeCounts, ulElapsed, ulRestarted;
+        uint32_t ulCompleteTickPeriods, ulNextTickCounts, ulBin, ulSlept;
+        int32_t lError;
+        TickType_t xModifiableIdleTime;
+
+        if( xExpectedIdleTime > xMaximumPossibleSuppressedTicks )
+        {
+            xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
+        }
+
+        /* Interrupts that end the sleep must still wake the core, so PRIMASK
+         * is used rather than the BASEPRI critical section. */
+        __asm( "	cpsid i");
+        __asm( "	dsb");
+        __asm( "	isb");
+
+        if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+        {
+            xTicklessStats.ulAborted++;
+            __asm( "	cpsie i");
+            return;
+        }
+
+        /* Stop the SysTick and see how far into the current tick it got.  A
+         * pending SysTick means that tick has ended already and the next one
+         * is under way. */
+        portNVIC_SYSTICK_CTRL_REG = ( portNVIC_SYSTICK_CLK_BIT_CONFIG | portNVIC_SYSTICK_INT_BIT );
+        ulSysTickDecrementsLeft = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+
+        if( ulSysTickDecrementsLeft == 0 )
+        {
+            ulSysTickDecrementsLeft = ulTimerCountsForOneTick;
+        }
+
+        ulCarriedTicks = 0;
+
+        if( ( portNVIC_INT_CTRL_REG & portNVIC_PEND_SYSTICK_SET_BIT ) != 0 )
+        {
+            portNVIC_INT_CTRL_REG = portNVIC_PEND_SYSTICK_CLEAR_BIT;
+            ulCarriedTicks = 1;
+        }
+
+        /* The expected idle time is always at least two ticks. */
+        ulWakeCounts = ulSysTickDecrementsLeft + ( ulTimerCountsForOneTick * ( xExpectedIdleTime - 1UL - ulCarriedTicks ) );
+
+        if( ulWakeCounts > portWAKE_TIMER_MISSED_COUNTS )
+        {
+            ulWakeCounts -= portWAKE_TIMER_MISSED_COUNTS;
+        }
+
+        portWAKE_TIMER_CTL_REG = 0UL;
+        portWAKE_TIMER_ICR_REG = portWAKE_TIMER_TIMEOUT_BIT;
+        portWAKE_TIMER_TAILR_REG = ulWakeCounts - 1UL;
+        portWAKE_TIMER_CTL_REG = portWAKE_TIMER_ENABLE_BIT;
+        portNVIC_EN3_REG = portWAKE_TIMER_NVIC_BIT;
+        traceSLEEP_ENTERED();
+
+        xModifiableIdleTime = xExpectedIdleTime;
+        configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+
+        if( xModifiableIdleTime > 0 )
+        {
+            __asm( "	dsb");
+            __asm( "	wfi");
+            __asm( "	isb");
+        }
+
+        configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+        /* Time asleep up to the wake-up, for the application's clock. */
+        ulSlept = ( ulWakeCounts - 1UL ) - portWAKE_TIMER_TAV_REG;
+
+        if( ( portWAKE_TIMER_RIS_REG & portWAKE_TIMER_TIMEOUT_BIT ) != 0 )
+        {
+            ulSlept += ulWakeCounts;
+        }
+
+        traceSLEEP_ENDED( ulSlept * ( configCPU_CLOCK_HZ / configSYSTICK_CLOCK_HZ ) );
+
+        /* Let the interrupt that woke the core run, unless it was the wake
+         * timer, which is taken out of the NVIC first. */
+        portNVIC_DIS3_REG = portWAKE_TIMER_NVIC_BIT;
+        __asm( "	cpsie i");
+        __asm( "	dsb");
+        __asm( "	isb");
+        __asm( "	cpsid i");
+        __asm( "	dsb");
+        __asm( "	isb");
+
+        /* Time asleep, the interrupt included, rounded down to whole ticks.
+         * The missed counts go back in for the gaps in the measurement. */
+        if( ( portWAKE_TIMER_RIS_REG & portWAKE_TIMER_TIMEOUT_BIT ) != 0 )
+        {
+            xTicklessStats.ulTimerWakeups++;
+            ulElapsed = ulWakeCounts + ( ( ulWakeCounts - 1UL ) - portWAKE_TIMER_TAV_REG );
+        }
+        else
+        {
+            xTicklessStats.ulEarlyWakeups++;
+            ulElapsed = ( ulWakeCounts - 1UL ) - portWAKE_TIMER_TAV_REG;
+        }
+
+        ulElapsed += portWAKE_TIMER_MISSED_COUNTS;
+
+        if( ulElapsed >= ulSysTickDecrementsLeft )
+        {
+            ulCompleteTickPeriods = ulCarriedTicks + 1UL + ( ( ulElapsed - ulSysTickDecrementsLeft ) / ulTimerCountsForOneTick );
+            ulNextTickCounts = ulTimerCountsForOneTick - ( ( ulElapsed - ulSysTickDecrementsLeft ) % ulTimerCountsForOneTick );
+        }
+        else
+        {
+            ulCompleteTickPeriods = ulCarriedTicks;
+            ulNextTickCounts = ulSysTickDecrementsLeft - ulElapsed;
+        }
+
+        /* The kernel cannot be stepped past the tick it expects to need, any
+         * overshoot lands in the next tick period instead. */
+        if( ulCompleteTickPeriods > xExpectedIdleTime )
+        {
+            ulCompleteTickPeriods = xExpectedIdleTime;
+            ulNextTickCounts = 1UL;
+        }
+
+        /* Restart the SysTick from what is left of the current tick period,
+         * then put the standard reload value back for the periods after. */
+        portNVIC_SYSTICK_LOAD_REG = ulNextTickCounts - 1UL;
+        portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;
+        portNVIC_SYSTICK_CTRL_REG = portNVIC_SYSTICK_CLK_BIT_CONFIG | portNVIC_SYSTICK_INT_BIT | portNVIC_SYSTICK_ENABLE_BIT;
+        portNVIC_SYSTICK_LOAD_REG = ulTimerCountsForOneTick - 1UL;
+
+        /* The wake timer has been counting all along: its count now, against
+         * the time the kernel was given, is the compensation error. */
+        ulRestarted = ( ulWakeCounts - 1UL ) - portWAKE_TIMER_TAV_REG;
+
+        if( ( portWAKE_TIMER_RIS_REG & portWAKE_TIMER_TIMEOUT_BIT ) != 0 )
+        {
+            ulRestarted += ulWakeCounts;
+        }
+
+        portWAKE_TIMER_CTL_REG = 0UL;
+        portWAKE_TIMER_ICR_REG = portWAKE_TIMER_TIMEOUT_BIT;
+        portNVIC_UNPEND3_REG = portWAKE_TIMER_NVIC_BIT;
+
+        lError = ( int32_t ) ( ulElapsed - ulRestarted );
+        xTicklessStats.lCompensationError += lError;
+
+        if( ( uint32_t ) ( ( lError < 0 ) ? -lError : lError ) > xTicklessStats.ulMaxCompensationError )
+        {
+            xTicklessStats.ulMaxCompensationError = ( uint32_t ) ( ( lError < 0 ) ? -lError : lError );
+        }
+
+        /* Residency histogram: 0, 1, 2-3, 4-7 ... tick periods */
+        for( ulBin = 0; ( ulBin < ( portTICKLESS_RESIDENCY_BINS - 1UL ) ) && ( ( ulCompleteTickPeriods >> ulBin ) != 0UL ); ulBin++ )
+        {
+        }
+
+        xTicklessStats.aulResidency[ ulBin ]++;
+        xTicklessStats.ulSleeps++;
+        xTicklessStats.ulTicksSuppressed += ulCompleteTickPeriods;
+        xTicklessStats.ullSleepCounts += ulElapsed;
+
+        vTaskStepTick( ulCompleteTickPeriods );
+
+        __asm( "	cpsie i");
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortGetTicklessStats( PortTicklessStats_t * pxStats )
+    {
+        __asm( "	cpsid i");
+        *pxStats = xTicklessStats;
+        __asm( "	cpsie i");
+    }
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
 /*
  * Setup the systick timer to generate the tick interrupts at the required
  * frequency.
@@ -617,6 +947,28 @@ void vPortSetupTimerInterrupt( void )
     }
     #endif /* configUSE_TICKLESS_IDLE */
 
+    #if ( configUSE_TICKLESS_IDLE == 2 )
+    {
+        /* 32-bit periodic down counter without prescaler, interrupt on the
+         * time-out.  Enabled in the NVIC only while the core sleeps. */
+        ulTimerCountsForOneTick = ( configSYSTICK_CLOCK_HZ / configTICK_RATE_HZ );
+        xMaximumPossibleSuppressedTicks = ( 0xffffffffUL / 2UL ) / ulTimerCountsForOneTick;
+        portSYSCTL_RCGCWTIMER_REG |= portWAKE_TIMER_CLOCK_BIT;
+
+        while( ( portSYSCTL_PRWTIMER_REG & portWAKE_TIMER_CLOCK_BIT ) == 0 )
+        {
+        }
+
+        portWAKE_TIMER_CTL_REG = 0UL;
+        portWAKE_TIMER_CFG_REG = portWAKE_TIMER_CFG_32_BIT;
+        portWAKE_TIMER_TAMR_REG = portWAKE_TIMER_TAMR_PERIODIC;
+        portWAKE_TIMER_TAPR_REG = 0UL;
+        portWAKE_TIMER_ICR_REG = portWAKE_TIMER_TIMEOUT_BIT;
+        portWAKE_TIMER_IMR_REG = portWAKE_TIMER_TIMEOUT_BIT;
+        portWAKE_TIMER_PRI_REG = ( uint8_t ) configKERNEL_INTERRUPT_PRIORITY;
+    }
+    #endif /* configUSE_TICKLESS_IDLE */
+
     /* Stop and clear the SysTick. */
     portNVIC_SYSTICK_CTRL_REG = 0UL;
     portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;
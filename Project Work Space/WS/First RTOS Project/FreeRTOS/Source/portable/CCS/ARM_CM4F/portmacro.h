@@ -139,6 +139,62 @@
         #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vPortSuppressTicksAndSleep( xExpectedIdleTime )
     #endif
 
+/* Statistics of the GPTM tickless idle (configUSE_TICKLESS_IDLE == 2).  Times
+ * are in system clock counts, configCPU_CLOCK_HZ per second. */
+    #define portTICKLESS_RESIDENCY_BINS    ( 8UL )
+
+    typedef struct xPORT_TICKLESS_STATS
+    {
+        uint32_t ulSleeps;                                      /* Sleeps entered. */
+        uint32_t ulAborted;                                     /* Sleeps abandoned, a task was ready. */
+        uint32_t ulTimerWakeups;                                /* Woken by the wake timer. */
+        uint32_t ulEarlyWakeups;                                /* Woken by another interrupt. */
+        uint32_t ulTicksSuppressed;                             /* Tick interrupts that did not happen. */
+        uint64_t ullSleepCounts;                                /* Time asleep. */
+        int32_t lCompensationError;                             /* Sum of kernel time minus wake timer time. */
+        uint32_t ulMaxCompensationError;                        /* Largest error of one sleep, either sign. */
+        uint32_t aulResidency[ portTICKLESS_RESIDENCY_BINS ];   /* Sleeps of 0, 1, 2-3, 4-7 ... tick periods. */
+    } PortTicklessStats_t;
+
+    extern void vPortGetTicklessStats( PortTicklessStats_t * pxStats );
+
+/*-----------------------------------------------------------*/
+
+/* MPU stack guard (configUSE_MPU_STACK_GUARD == 1).  While a task runs, the
+ * first 32-byte aligned block inside its stack is a no-access MPU region, so
+ * an overflow faults at the push that reaches it instead of corrupting the
+ * memory below.  The region's size and attributes are set once when the
+ * scheduler starts; a switch only moves its base, one register write made
+ * from traceTASK_SWITCHED_IN(), where the kernel knows the task's stack.  The
+ * exception return that ends the switch makes the new base take effect.
+ *
+ * The guard only catches a stack that grows into it: a frame that allocates
+ * more than 32 bytes at once can move the stack pointer past it, and its
+ * first store then lands below the guard unnoticed.  Functions with large
+ * locals need their stacks sized with that margin. */
+    #ifndef configUSE_MPU_STACK_GUARD
+        #define configUSE_MPU_STACK_GUARD    0
+    #endif
+
+    #define portSTACK_GUARD_REGION           ( 7UL )
+    #define portSTACK_GUARD_SIZE             ( 32UL )
+    #define portMPU_RBAR_REG                 ( *( ( volatile uint32_t * ) 0xE000ED9C ) )
+    #define portMPU_RBAR_ADDR_MASK           ( ~( portSTACK_GUARD_SIZE - 1UL ) )
+    #define portMPU_RBAR_VALID_BIT           ( 1UL << 4UL )
+    #define portSTACK_GUARD_BASE( pxStack )  ( ( ( uint32_t ) ( pxStack ) + portSTACK_GUARD_SIZE - 1UL ) & portMPU_RBAR_ADDR_MASK )
+
+    #if ( configUSE_MPU_STACK_GUARD == 1 )
+        #define portSTACK_GUARD_SWITCHED_IN( pxStack ) \
+    portMPU_RBAR_REG = ( portSTACK_GUARD_BASE( pxStack ) | portMPU_RBAR_VALID_BIT | portSTACK_GUARD_REGION )
+    #else
+        #define portSTACK_GUARD_SWITCHED_IN( pxStack )
+    #endif
+
+/* MemManage fault handler, a guard hit calls vApplicationStackGuardHook() */
+    #if ( configUSE_MPU_STACK_GUARD == 1 )
+        extern void vPortMemManageHandler( void );
+    #endif
+
 /*-----------------------------------------------------------*/
 
 /* Task function macros as described on the FreeRTOS.org WEB site.  These are
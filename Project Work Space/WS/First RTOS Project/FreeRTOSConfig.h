@@ -33,7 +33,7 @@
 #define configTICK_RATE_HZ                    ((TickType_t)100)
 
 /* Size of the stack allocated to the Idle task. 128 Words = 512 Bytes */
-#define configMINIMAL_STACK_SIZE              (8)
+#define configMINIMAL_STACK_SIZE              (128)
 
 /* configMAX_PRIORITIES Sets the number of available task priorities.  Tasks can
  * be assigned priorities of 0 to (configMAX_PRIORITIES - 1).  Zero is the lowest
@@ -49,15 +49,24 @@
  * TickType_t is defined to be an unsigned 32-bit type. */
 #define configUSE_16_BIT_TICKS                0
 
+/* configUSE_TICKLESS_IDLE 2 stops the tick while the Idle task runs and sleeps
+ * on WFI until Wide Timer 1A, set to the next tick any task waits for, or
+ * another interrupt wakes the core (port.c, vPortSuppressTicksAndSleep).
+ * Sleeps shorter than configEXPECTED_IDLE_TIME_BEFORE_SLEEP ticks keep the
+ * tick running. */
+#define configUSE_TICKLESS_IDLE               2
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2
+
 /******************************************************************************/
 /* Memory allocation related definitions. *************************************/
 /******************************************************************************/
 
-/* Sets the total size of the FreeRTOS heap, in bytes, when heap_1.c, heap_2.c
- * or heap_4.c are included in the build. This value is defaulted to 4096 bytes but
- * it must be tailored to each application. Note the heap will appear in the .bss
- * section. */
-#define configTOTAL_HEAP_SIZE                 ((size_t)(8192))
+/* Every task and mutex is created with the *Static APIs from storage in
+ * main.c, the idle task's through vApplicationGetIdleTaskMemory(). With
+ * dynamic allocation off no FreeRTOS heap is linked: heap_1.c is excluded
+ * from the build and RAM use is fixed by the linker. */
+#define configSUPPORT_STATIC_ALLOCATION       1
+#define configSUPPORT_DYNAMIC_ALLOCATION      0
 
 /* Set the following configUSE_* constants to 1 to include the named feature in
  * the build, or 0 to exclude the named feature from the build. */
@@ -97,6 +106,10 @@ to exclude the API function. */
  * the build, or 0 to exclude the named feature from the build. */
 #define configUSE_APPLICATION_TASK_TAG         1
 
+/* Notification slots per task: index 0 for the application, index 1 for
+ * the UART0 frame completion (UART0_FRAME_NOTIFY_INDEX) */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES  2
+
 /******************************************************************************/
 /* ARM Cortex-M Specific Definitions. *****************************************/
 /******************************************************************************/
@@ -129,28 +142,187 @@ PRIORITY THAN THIS! (higher priorities are lower numeric values. */
 /* Normal assert() semantics without relying on the provision of an assert.h header file. */
 #define configASSERT( x ) if( ( x ) == 0 ) { taskDISABLE_INTERRUPTS(); for( ;; ); }
 
+/* Stack overflows are caught by the MPU rather than by the kernel's checks,
+ * which cost every switch a comparison or a scan of the outgoing stack. The
+ * port keeps a no-access region at the bottom of the running task's stack
+ * (portmacro.h); the push that reaches it raises MemManage and
+ * vApplicationStackGuardHook() gets the task. The guard takes 8 to 15 words
+ * of every stack, and nothing may read the bottom of the running task's own
+ * stack, as uxTaskGetStackHighWaterMark() would. */
+#define configCHECK_FOR_STACK_OVERFLOW        0
+#define configUSE_MPU_STACK_GUARD             1
+
 /******************************************************************************/
 /* RTOS Runtime Measurements. *************************************************/
 /******************************************************************************/
 
 #include "std_types.h"
+#include "Services/RunTimeStats/runtime_stats.h"
+
+/* Application tasks, tagged 1 .. NUMBER_OF_TASKS; the idle task keeps tag 0 */
+#define NUMBER_OF_TASKS 8U
+
+/* The hooks expand inside tasks.c. A task switched out while it is no longer
+ * in its ready list has blocked or suspended itself, which ends its
+ * activation; a preempted task stays in the ready list. A task declared with
+ * RunTimeStats_SetTiming() ends its job only at its release point, see
+ * traceTASK_DELAY_UNTIL, traceTASK_NOTIFY_WAIT_BLOCK and traceTASK_NOTIFY_WAIT. */
+#define traceTASK_SWITCHED_IN()                                                         \
+    do                                                                                  \
+    {                                                                                   \
+        portSTACK_GUARD_SWITCHED_IN(pxCurrentTCB->pxStack);                             \
+        RunTimeStats_TaskSwitchedIn((uint32)(pxCurrentTCB->pxTaskTag));                 \
+        Trace_Record(TRACE_EVENT_TASK_SWITCHED_IN, TRACE_TAG(pxCurrentTCB),             \
+                     (uint16)pxCurrentTCB->uxPriority);                                 \
+    } while (0)
+
+#define traceTASK_SWITCHED_OUT()                                                        \
+    RunTimeStats_TaskSwitchedOut((uint32)(pxCurrentTCB->pxTaskTag),                     \
+        (listIS_CONTAINED_WITHIN(&(pxReadyTasksLists[pxCurrentTCB->uxPriority]),         \
+                                 &(pxCurrentTCB->xStateListItem)) == pdFALSE) ? TRUE : FALSE)
+
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB)                                           \
+    do                                                                                  \
+    {                                                                                   \
+        RunTimeStats_TaskReleased((uint32)((pxTCB)->pxTaskTag));                        \
+        Trace_Record(TRACE_EVENT_TASK_READY, TRACE_TAG(pxTCB), 0);                      \
+    } while (0)
+
+/* Port hooks, not kernel ones: the outermost taskENTER_CRITICAL() has just
+ * masked interrupts and the matching taskEXIT_CRITICAL() is about to unmask
+ * them */
+#define traceCRITICAL_ENTERED()     RunTimeStats_CriticalEntered()
+#define traceCRITICAL_EXITING()     RunTimeStats_CriticalExiting()
+
+/* Port hooks as well: CYCCNT stops while the core sleeps in tickless idle,
+ * the wake timer measures how long that was */
+#define traceSLEEP_ENTERED()        RunTimeStats_SleepEntered()
+#define traceSLEEP_ENDED(ulCycles)  RunTimeStats_SleepEnded((uint32)(ulCycles))
+
+/******************************************************************************/
+/* Kernel Event Trace. ********************************************************/
+/******************************************************************************/
 
-#define NUMBER_OF_TASKS 10U
-extern uint32 ullTasksOutTime[NUMBER_OF_TASKS + 1];
-extern uint32 ullTasksInTime[NUMBER_OF_TASKS + 1];
-extern uint32 ullTasksTotalTime[NUMBER_OF_TASKS + 1];
-
-#define traceTASK_SWITCHED_IN()                                    \
-do{                                                                \
-    uint32 taskInTag = (uint32)(pxCurrentTCB->pxTaskTag);          \
-    ullTasksInTime[taskInTag] = GPTM_WTimer0Read();                \
-}while(0);
-
-#define traceTASK_SWITCHED_OUT()                                                                 \
-do{                                                                                              \
-    uint32 taskOutTag = (uint32)(pxCurrentTCB->pxTaskTag);                                       \
-    ullTasksOutTime[taskOutTag] = GPTM_WTimer0Read();                                            \
-    ullTasksTotalTime[taskOutTag] += ullTasksOutTime[taskOutTag] - ullTasksInTime[taskOutTag];   \
-}while(0);
+#include "Services/Trace/trace.h"
+
+/* Queues and semaphores are told apart by the number vQueueSetQueueNumber()
+ * gives them */
+#define configUSE_TRACE_FACILITY               1
+
+#define TRACE_TAG(pxTCB)        ((uint8)(uint32)((pxTCB)->pxTaskTag))
+#define TRACE_QUEUE(pxQueue)    ((uint8)(pxQueue)->uxQueueNumber)
+
+/* A semaphore give is a send and a take a receive; the data is the count
+ * before the call. The hooks expand inside queue.c, where a mutex is a queue
+ * whose uxQueueType is queueQUEUE_IS_MUTEX. Takes, blocks and gives of a
+ * numbered object also feed its contention statistics. */
+#define TRACE_IS_MUTEX(pxQueue) (((pxQueue)->uxQueueType == queueQUEUE_IS_MUTEX) ? TRUE : FALSE)
+
+/* pxCurrentTCB is private to tasks.c; the FromISR getter only raises the
+ * interrupt mask, so it adds no critical section of its own */
+#define TRACE_RUNNING_TAG()     ((uint32)xTaskGetApplicationTaskTagFromISR(NULL))
+
+#define traceQUEUE_SEND(pxQueue)                                                        \
+    do                                                                                  \
+    {                                                                                   \
+        RunTimeStats_ObjectGiven(TRACE_QUEUE(pxQueue), TRACE_IS_MUTEX(pxQueue));        \
+        Trace_Record(TRACE_EVENT_QUEUE_SEND, TRACE_QUEUE(pxQueue),                      \
+                     (uint16)(pxQueue)->uxMessagesWaiting);                             \
+    } while (0)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       traceQUEUE_SEND(pxQueue)
+#define traceQUEUE_SEND_FAILED(pxQueue)                                                 \
+    Trace_Record(TRACE_EVENT_QUEUE_SEND_FAILED, TRACE_QUEUE(pxQueue), (uint16)(pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_RECEIVE(pxQueue)                                                     \
+    do                                                                                  \
+    {                                                                                   \
+        RunTimeStats_ObjectTaken(TRACE_RUNNING_TAG(), TRACE_QUEUE(pxQueue),              \
+                                 TRACE_IS_MUTEX(pxQueue));                              \
+        Trace_Record(TRACE_EVENT_QUEUE_RECEIVE, TRACE_QUEUE(pxQueue),                   \
+                     (uint16)(pxQueue)->uxMessagesWaiting);                             \
+    } while (0)
+/* No task takes anything from an ISR, the running one least of all */
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)                                            \
+    Trace_Record(TRACE_EVENT_QUEUE_RECEIVE, TRACE_QUEUE(pxQueue), (uint16)(pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)                                              \
+    do                                                                                  \
+    {                                                                                   \
+        RunTimeStats_ObjectTakeFailed(TRACE_RUNNING_TAG(), TRACE_QUEUE(pxQueue));       \
+        Trace_Record(TRACE_EVENT_QUEUE_RECEIVE_FAILED, TRACE_QUEUE(pxQueue),            \
+                     (uint16)(pxQueue)->uxMessagesWaiting);                             \
+    } while (0)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)                                         \
+    do                                                                                  \
+    {                                                                                   \
+        RunTimeStats_ObjectBlocked(TRACE_RUNNING_TAG(), TRACE_QUEUE(pxQueue));          \
+        Trace_Record(TRACE_EVENT_QUEUE_BLOCK, TRACE_QUEUE(pxQueue), 0);                 \
+    } while (0)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)                                            \
+    Trace_Record(TRACE_EVENT_QUEUE_BLOCK, TRACE_QUEUE(pxQueue), 1)
+
+/* Expands in tasks.c while the waiter that raised the holder is running */
+#define traceTASK_PRIORITY_INHERIT(pxTCBOfMutexHolder, uxInheritedPriority)            \
+    RunTimeStats_PriorityInherited((uint32)(pxCurrentTCB->pxTaskTag))
+
+/* Registered names label the contention statistics as well as the debugger's
+ * object view; register an object after numbering it */
+#define configQUEUE_REGISTRY_SIZE               4
+#define traceQUEUE_REGISTRY_ADD(xQueue, pcQueueName)                                    \
+    RunTimeStats_ObjectNamed(TRACE_QUEUE(xQueue), (pcQueueName))
+
+/* A periodic task's job ends where it waits for its next period, and a
+ * sporadic task's where it waits on notification index 0 for its next event;
+ * the UART frame wait on index 1 is part of the job. A wait that finds its
+ * release already due does not block: the job then ends when the wait
+ * returns, in traceTASK_NOTIFY_WAIT or, for xTaskDelayUntil(), which has no
+ * hook there, in the task itself. */
+#define traceTASK_DELAY_UNTIL(xTimeToWake)                                              \
+    do                                                                                  \
+    {                                                                                   \
+        RunTimeStats_TaskCompleted((uint32)(pxCurrentTCB->pxTaskTag));                  \
+        Trace_Record(TRACE_EVENT_TASK_DELAY, TRACE_TAG(pxCurrentTCB),                   \
+                     (uint16)(xTimeToWake));                                            \
+    } while (0)
+#define traceTASK_DELAY()                                                               \
+    Trace_Record(TRACE_EVENT_TASK_DELAY, TRACE_TAG(pxCurrentTCB), (uint16)(xTickCount + xTicksToDelay))
+#define traceTASK_SUSPEND(pxTCB)                                                        \
+    Trace_Record(TRACE_EVENT_TASK_SUSPEND, TRACE_TAG(pxTCB), 0)
+#define traceTASK_RESUME(pxTCB)                                                         \
+    Trace_Record(TRACE_EVENT_TASK_RESUME, TRACE_TAG(pxTCB), 0)
+#define traceTASK_RESUME_FROM_ISR(pxTCB)                                                \
+    Trace_Record(TRACE_EVENT_TASK_RESUME, TRACE_TAG(pxTCB), 1)
+
+/* The notify hooks expand where the notified task is pxTCB */
+#define traceTASK_NOTIFY(uxIndexToNotify)                                               \
+    Trace_Record(TRACE_EVENT_TASK_NOTIFY, TRACE_TAG(pxTCB), (uint16)(uxIndexToNotify))
+#define traceTASK_NOTIFY_FROM_ISR(uxIndexToNotify)                                      \
+    Trace_Record(TRACE_EVENT_TASK_NOTIFY_FROM_ISR, TRACE_TAG(pxTCB), (uint16)(uxIndexToNotify))
+#define traceTASK_NOTIFY_GIVE_FROM_ISR(uxIndexToNotify) traceTASK_NOTIFY_FROM_ISR(uxIndexToNotify)
+#define traceTASK_NOTIFY_WAIT(uxIndexToWait)                                            \
+    do                                                                                  \
+    {                                                                                   \
+        RunTimeStats_TaskNotifyReturned((uint32)(pxCurrentTCB->pxTaskTag),              \
+                                        (uint32)(uxIndexToWait));                       \
+        Trace_Record(TRACE_EVENT_TASK_NOTIFY_WAIT, TRACE_TAG(pxCurrentTCB),             \
+                     (uint16)(uxIndexToWait));                                          \
+    } while (0)
+#define traceTASK_NOTIFY_TAKE(uxIndexToWait)    traceTASK_NOTIFY_WAIT(uxIndexToWait)
+#define traceTASK_NOTIFY_WAIT_BLOCK(uxIndexToWait)                                      \
+    do                                                                                  \
+    {                                                                                   \
+        if ((uxIndexToWait) == tskDEFAULT_INDEX_TO_NOTIFY)                              \
+        {                                                                               \
+            RunTimeStats_TaskCompleted((uint32)(pxCurrentTCB->pxTaskTag));              \
+        }                                                                               \
+        Trace_Record(TRACE_EVENT_TASK_NOTIFY_BLOCK, TRACE_TAG(pxCurrentTCB),            \
+                     (uint16)(uxIndexToWait));                                          \
+    } while (0)
+#define traceTASK_NOTIFY_TAKE_BLOCK(uxIndexToWait) traceTASK_NOTIFY_WAIT_BLOCK(uxIndexToWait)
+
+/* Not kernel hooks: the application's interrupt handlers call these first
+ * and last with their vector number (INT_* of inc/hw_ints.h) */
+#define traceISR_ENTER(ulVector)                                                        \
+    Trace_Record(TRACE_EVENT_ISR_ENTER, (uint8)(ulVector), 0)
+#define traceISR_EXIT(ulVector)                                                         \
+    Trace_Record(TRACE_EVENT_ISR_EXIT, (uint8)(ulVector), 0)
 
 #endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,270 @@
+ /******************************************************************************
+ *
+ * Module: Heater
+ *
+ * File Name: heater.c
+ *
+ * Description: Source file for the seat heater power stage on PWM0
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heater.h"
+#include "../../inc/hw_memmap.h"
+#include "../../inc/hw_ints.h"
+#include "../../driverlib/gpio.h"
+#include "../../driverlib/interrupt.h"
+#include "../../driverlib/pin_map.h"
+#include "../../driverlib/pwm.h"
+#include "../../driverlib/sysctl.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define HEATER_MAX_PERIOD           65536u  /* 16-bit generator counter */
+
+/* PWM clock: the system clock / 64, so at 16 MHz a 16-bit generator period
+ * reaches down to 4 Hz. The divider and its SysCtlPWMClockSet() setting. */
+#define HEATER_PWM_DIVIDER          64u
+#define HEATER_PWM_DIVIDER_CONFIG   SYSCTL_PWMDIV_64
+#define HEATER_NO_SEAT              0xFF
+
+#if HEATER_NUM_SEATS > HEATER_MAX_SEATS
+#error "HEATER_NUM_SEATS exceeds the PWM0 generators"
+#endif
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 uGenerator;              /* PWM_GEN_x */
+    uint32 uOutput;                 /* PWM_OUT_x */
+    uint32 uOutputBit;              /* PWM_OUT_x_BIT */
+    uint32 uIntBit;                 /* PWM_INT_GEN_x */
+    uint32 uInterrupt;              /* INT_PWM0_x */
+    uint32 uPeriod;                 /* PWM clocks */
+    uint16 uRampStep;               /* Duty added per period while ramping */
+    volatile uint16 uTarget;
+    volatile uint16 uDuty;
+} Heater_SeatType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static Heater_SeatType Heater_Seats[] =
+{
+    { PWM_GEN_0, PWM_OUT_0, PWM_OUT_0_BIT, PWM_INT_GEN_0, INT_PWM0_0 },    /* Driver, PB6 */
+    { PWM_GEN_1, PWM_OUT_2, PWM_OUT_2_BIT, PWM_INT_GEN_1, INT_PWM0_1 },    /* Passenger, PB4 */
+};
+
+/* A missing row would share generator 0 rather than fail to compile */
+typedef char Heater_SeatsRowsCheck[((sizeof(Heater_Seats) / sizeof(Heater_Seats[0])) == HEATER_NUM_SEATS) ? 1 : -1];
+
+/* Seat on each generator, filled in by Heater_Init */
+static uint8 Heater_GeneratorSeat[HEATER_MAX_SEATS] =
+{
+    HEATER_NO_SEAT, HEATER_NO_SEAT, HEATER_NO_SEAT, HEATER_NO_SEAT
+};
+
+static Heater_StatsType Heater_Stats;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* Interrupts masked: the compare value and the enable bit are only latched at
+ * the next reload of the generator */
+static void Heater_Apply(Heater_SeatType *pSeat, uint16 uDuty)
+{
+    uint32 uWidth;
+
+    pSeat->uDuty = uDuty;
+    if (uDuty == 0)
+    {
+        /* A compare value equal to the load value would hold the pin high */
+        PWMOutputState(PWM0_BASE, pSeat->uOutputBit, false);
+        return;
+    }
+
+    /* The compare value must stay inside the period: at least one clock high
+     * and one clock low */
+    uWidth = (pSeat->uPeriod * uDuty) / HEATER_DUTY_MAX;
+    if (uWidth > (pSeat->uPeriod - 2))
+    {
+        uWidth = pSeat->uPeriod - 2;
+    }
+    if (uWidth == 0)
+    {
+        uWidth = 1;
+    }
+    PWMPulseWidthSet(PWM0_BASE, pSeat->uOutput, uWidth);
+    PWMOutputState(PWM0_BASE, pSeat->uOutputBit, true);
+    Heater_Stats.CompareUpdates++;
+}
+
+static void Heater_Ramp(uint32 uGenerator)
+{
+    uint8 uSeat = Heater_GeneratorSeat[uGenerator];
+    Heater_SeatType *pSeat;
+
+    PWMGenIntClear(PWM0_BASE, PWM_GEN_0 + (uGenerator * (PWM_GEN_1 - PWM_GEN_0)), PWM_INT_CNT_LOAD);
+    if (uSeat == HEATER_NO_SEAT)
+    {
+        return;
+    }
+    pSeat = &Heater_Seats[uSeat];
+    Heater_Stats.RampInterrupts++;
+
+    if ((pSeat->uTarget > pSeat->uDuty) && ((pSeat->uTarget - pSeat->uDuty) > pSeat->uRampStep))
+    {
+        Heater_Apply(pSeat, pSeat->uDuty + pSeat->uRampStep);
+    }
+    else
+    {
+        Heater_Apply(pSeat, pSeat->uTarget);
+        PWMIntDisable(PWM0_BASE, pSeat->uIntBit);
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Heater_Init(const Heater_ConfigType *pConfig)
+{
+    Heater_SeatType *pSeat;
+    uint32 uPwmClock;
+    uint32 uFrequency;
+    uint32 uStep;
+    uint8 uSeat;
+
+    SysCtlPWMClockSet(HEATER_PWM_DIVIDER_CONFIG);
+    uPwmClock = SysCtlClockGet() / HEATER_PWM_DIVIDER;
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_PWM0);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_PWM0));
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOB);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_GPIOB));
+
+    GPIOPinConfigure(GPIO_PB6_M0PWM0);
+    GPIOPinConfigure(GPIO_PB4_M0PWM2);
+    GPIOPinTypePWM(GPIO_PORTB_BASE, GPIO_PIN_6 | GPIO_PIN_4);
+
+    /* Outputs start off and are switched at the reload, like the compare */
+    PWMOutputState(PWM0_BASE, PWM_OUT_0_BIT | PWM_OUT_2_BIT, false);
+    PWMOutputUpdateMode(PWM0_BASE, PWM_OUT_0_BIT | PWM_OUT_2_BIT, PWM_OUTPUT_MODE_SYNC_LOCAL);
+
+    for (uSeat = 0; uSeat < HEATER_NUM_SEATS; uSeat++)
+    {
+        pSeat = &Heater_Seats[uSeat];
+        uFrequency = (pConfig[uSeat].FrequencyHz != 0) ? pConfig[uSeat].FrequencyHz
+                                                       : HEATER_DEFAULT_FREQUENCY_HZ;
+        pSeat->uPeriod = uPwmClock / uFrequency;
+        if (pSeat->uPeriod > HEATER_MAX_PERIOD)
+        {
+            pSeat->uPeriod = HEATER_MAX_PERIOD;
+        }
+
+        /* One step per PWM period, so the whole ramp takes SoftStartMs */
+        uStep = HEATER_DUTY_MAX;
+        if (pConfig[uSeat].SoftStartMs != 0)
+        {
+            uStep = (HEATER_DUTY_MAX * 1000) / (pConfig[uSeat].SoftStartMs * uFrequency);
+            if (uStep == 0)
+            {
+                uStep = 1;
+            }
+        }
+        pSeat->uRampStep = (uint16)uStep;
+        pSeat->uTarget = 0;
+        pSeat->uDuty = 0;
+        Heater_GeneratorSeat[(pSeat->uGenerator - PWM_GEN_0) / (PWM_GEN_1 - PWM_GEN_0)] = uSeat;
+
+        /* Down count, load and compare updates wait for the counter to reload */
+        PWMGenConfigure(PWM0_BASE, pSeat->uGenerator, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_SYNC |
+                        PWM_GEN_MODE_GEN_SYNC_LOCAL | PWM_GEN_MODE_DBG_STOP);
+        PWMGenPeriodSet(PWM0_BASE, pSeat->uGenerator, pSeat->uPeriod);
+        PWMGenIntTrigEnable(PWM0_BASE, pSeat->uGenerator, PWM_INT_CNT_LOAD);
+        PWMGenEnable(PWM0_BASE, pSeat->uGenerator);
+
+        IntPrioritySet(pSeat->uInterrupt, HEATER_INTERRUPT_PRIORITY);
+        IntEnable(pSeat->uInterrupt);
+    }
+}
+
+void Heater_SetDuty(uint8 uSeat, uint16 uDuty)
+{
+    Heater_SeatType *pSeat = &Heater_Seats[uSeat];
+
+    if (uDuty > HEATER_DUTY_MAX)
+    {
+        uDuty = HEATER_DUTY_MAX;
+    }
+
+    taskENTER_CRITICAL();
+    if (uDuty != pSeat->uTarget)
+    {
+        Heater_Stats.DutyRequests++;
+        pSeat->uTarget = uDuty;
+        if ((uDuty <= pSeat->uDuty) || (pSeat->uRampStep >= HEATER_DUTY_MAX))
+        {
+            PWMIntDisable(PWM0_BASE, pSeat->uIntBit);
+            Heater_Apply(pSeat, uDuty);
+        }
+        else
+        {
+            /* The first step comes with the next reload */
+            PWMGenIntClear(PWM0_BASE, pSeat->uGenerator, PWM_INT_CNT_LOAD);
+            PWMIntEnable(PWM0_BASE, pSeat->uIntBit);
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+uint16 Heater_GetDuty(uint8 uSeat)
+{
+    return Heater_Seats[uSeat].uDuty;
+}
+
+void Heater_GetStats(Heater_StatsType *pStats)
+{
+    taskENTER_CRITICAL();
+    *pStats = Heater_Stats;
+    taskEXIT_CRITICAL();
+}
+
+void Heater_Generator0Handler(void)
+{
+    traceISR_ENTER(INT_PWM0_0);
+    Heater_Ramp(0);
+    traceISR_EXIT(INT_PWM0_0);
+}
+
+void Heater_Generator1Handler(void)
+{
+    traceISR_ENTER(INT_PWM0_1);
+    Heater_Ramp(1);
+    traceISR_EXIT(INT_PWM0_1);
+}
+
+void Heater_Generator2Handler(void)
+{
+    traceISR_ENTER(INT_PWM0_2);
+    Heater_Ramp(2);
+    traceISR_EXIT(INT_PWM0_2);
+}
+
+void Heater_Generator3Handler(void)
+{
+    traceISR_ENTER(INT_PWM0_3);
+    Heater_Ramp(3);
+    traceISR_EXIT(INT_PWM0_3);
+}
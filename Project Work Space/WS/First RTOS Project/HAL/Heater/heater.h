@@ -0,0 +1,90 @@
+ /******************************************************************************
+ *
+ * Module: Heater
+ *
+ * File Name: heater.h
+ *
+ * Description: Header file for the seat heater power stage. Every seat has its
+ *              own PWM generator of the PWM0 module, so each runs at its own
+ *              frequency, and seat n is row n of Heater_Seats in heater.c:
+ *
+ *                driver      M0PWM0 on PB6, generator 0
+ *                passenger   M0PWM2 on PB4, generator 1
+ *
+ *              Generators 2 and 3 are free for two more seats.
+ *
+ *              Duty cycles are in per mille. Compare values and the output
+ *              enable are written in locally synchronized mode, so a new duty
+ *              only takes effect when the generator counter reloads and no
+ *              period is ever cut short or stretched.
+ *
+ *              A rise in duty is ramped over the seat's soft-start time to
+ *              limit the inrush into a cold heater element. The ramp is
+ *              stepped from the generator load interrupt, which is enabled
+ *              only while a ramp runs. A fall in duty is applied at once.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef HEATER_H_
+#define HEATER_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define HEATER_NUM_SEATS            2
+#define HEATER_MAX_SEATS            4       /* PWM0 generators */
+
+#define HEATER_DUTY_MAX             1000    /* Per mille */
+
+#define HEATER_DEFAULT_FREQUENCY_HZ 100
+#define HEATER_DEFAULT_SOFT_START_MS 500
+
+/* Below configMAX_SYSCALL_INTERRUPT_PRIORITY, in the upper three bits. The
+ * ramp interrupt makes no FreeRTOS calls. */
+#define HEATER_INTERRUPT_PRIORITY   (6 << 5)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 FrequencyHz;             /* PWM frequency, 4 Hz .. PWM clock / 100 (2500 Hz at 16 MHz) */
+    uint32 SoftStartMs;             /* Time a ramp from 0 to full power takes, 0 steps at once */
+} Heater_ConfigType;
+
+typedef struct
+{
+    uint32 DutyRequests;            /* Heater_SetDuty calls that changed the target */
+    uint32 CompareUpdates;          /* Compare values written, ramp steps included */
+    uint32 RampInterrupts;          /* Generator load interrupts taken */
+} Heater_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Configures PWM0 and the output pins, one configuration per seat, and starts
+ * every generator with its output off. Call before the scheduler starts. */
+void Heater_Init(const Heater_ConfigType *pConfig);
+
+/* Target duty of a seat, 0 .. HEATER_DUTY_MAX. Task context only. */
+void Heater_SetDuty(uint8 uSeat, uint16 uDuty);
+
+/* Duty the output runs at now, behind the target while a ramp is running */
+uint16 Heater_GetDuty(uint8 uSeat);
+
+void Heater_GetStats(Heater_StatsType *pStats);
+
+/* PWM0 generator interrupts, each steps the ramp of the seat on it */
+void Heater_Generator0Handler(void);
+void Heater_Generator1Handler(void);
+void Heater_Generator2Handler(void);
+void Heater_Generator3Handler(void);
+
+#endif /* HEATER_H_ */
@@ -1,57 +1,231 @@
 #include "lm35.h"
+#include "FreeRTOS.h"
 #include <stdint.h>
+#include <stdbool.h>
 #include "uart0.h"
 #include "../../inc/hw_memmap.h"
+#include "../../inc/hw_adc.h"
+#include "../../inc/hw_ints.h"
 #include "../../driverlib/adc.h"
 #include "../../driverlib/gpio.h"
+#include "../../driverlib/interrupt.h"
+#include "../../driverlib/udma.h"
 #include "../../MCAL/GPIO/gpio.h"
+#include "../../MCAL/GPTM/GPTM.h"
+#include "../../MCAL/DMA/dma.h"
 #include "../../driverlib/pin_map.h"
 #include "../../driverlib/sysctl.h"
 
-void DriverSensor_Init(void){
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
-    GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_3);
+#define LM35_BUFFER_SAMPLES     (LM35_SEQUENCES_PER_BUFFER * LM35_NUM_CHANNELS)
+
+/* Every seat is one step of a single sequencer 0 sequence, and one uDMA
+ * burst of the arbitration size, a power of two, moves one whole sequence */
+#if LM35_NUM_CHANNELS == 1
+#define LM35_DMA_ARB            UDMA_ARB_1
+#elif LM35_NUM_CHANNELS == 2
+#define LM35_DMA_ARB            UDMA_ARB_2
+#elif LM35_NUM_CHANNELS == 4
+#define LM35_DMA_ARB            UDMA_ARB_4
+#elif LM35_NUM_CHANNELS == 8
+#define LM35_DMA_ARB            UDMA_ARB_8
+#else
+#error "LM35_NUM_CHANNELS must be 1, 2, 4 or 8: one uDMA burst per sequence, at most 8 sequencer 0 steps"
+#endif
+
+typedef struct
+{
+    uint32_t ui32Channel;       /* ADC_CTL_CHx */
+    uint32_t ui32Periph;        /* SYSCTL_PERIPH_GPIOx of the pin */
+    uint32_t ui32Port;
+    uint8_t ui8Pin;
+} LM35_ChannelType;
+
+/* One row per seat, in seat order, which is also the order of the sequencer
+ * steps and of the samples in a sequence */
+static const LM35_ChannelType LM35_Channels[] =
+{
+    { ADC_CTL_CH0, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_3 },     /* Driver, AIN0 */
+    { ADC_CTL_CH1, SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE, GPIO_PIN_2 },     /* Passenger, AIN1 */
+};
+
+/* A missing row would read AIN0 again rather than fail to compile */
+typedef char LM35_ChannelsRowsCheck[((sizeof(LM35_Channels) / sizeof(LM35_Channels[0])) == LM35_NUM_CHANNELS) ? 1 : -1];
+
+/* Ping-pong halves: the uDMA fills one through the primary control structure
+ * and the other through the alternate one */
+static uint16_t LM35_Samples[2][LM35_BUFFER_SAMPLES];
+
+/* Newest reading per channel, the mean of every sequence of the newest
+ * buffer. Written only by the ADC interrupt, which counts LM35_BufferCount
+ * up after each update so readers can tell a copy that straddled one. */
+static volatile uint16_t LM35_Latest[LM35_NUM_CHANNELS];
+
+static volatile uint32_t LM35_BufferCount = 0;
 
+/* Half the uDMA completes next, the two always finish in turn */
+static uint32_t LM35_NextHalf = UDMA_PRI_SELECT;
 
+static void LM35_ArmHalf(uint32_t ui32Half)
+{
+    uDMAChannelTransferSet(UDMA_CHANNEL_ADC0 | ui32Half, UDMA_MODE_PINGPONG,
+                           (void *)(ADC0_BASE + ADC_O_SSFIFO0),
+                           LM35_Samples[(ui32Half == UDMA_PRI_SELECT) ? 0 : 1],
+                           LM35_BUFFER_SAMPLES);
 }
-uint8_t GetDriverSensorReading(){
 
-    uint32_t pui32ADC0Value[1];
+/* Steps of a sequence, one per channel, the last one ends the sequence */
+static void LM35_ConfigureSteps(uint32_t ui32Sequencer)
+{
+    uint32_t ui32Step;
 
-    ADCSequenceConfigure(ADC0_BASE, 3, ADC_TRIGGER_PROCESSOR, 0);
-    ADCSequenceStepConfigure(ADC0_BASE, 3, 0, ADC_CTL_CH0 | ADC_CTL_IE |
-                             ADC_CTL_END);
-    ADCSequenceEnable(ADC0_BASE, 3);
-    ADCIntClear(ADC0_BASE, 3);
+    for (ui32Step = 0; ui32Step < LM35_NUM_CHANNELS; ui32Step++)
+    {
+        ADCSequenceStepConfigure(ADC0_BASE, ui32Sequencer, ui32Step, LM35_Channels[ui32Step].ui32Channel |
+                                 ((ui32Step == (LM35_NUM_CHANNELS - 1)) ? (ADC_CTL_IE | ADC_CTL_END) : 0));
+    }
+}
+
+/* The first buffer takes LM35_SEQUENCES_PER_BUFFER sample periods to fill, so
+ * every seat is read once by software before the engine starts. Otherwise
+ * the acquisition task would see zero and report a sensor error at boot.
+ * This runs the engine's own sequencer 0 sequence, steps already set. */
+static void LM35_PrimeLatest(void)
+{
+    uint32_t pui32ADC0Value[LM35_NUM_CHANNELS];
+    uint32_t ui32Channel;
+
+    ADCSequenceConfigure(ADC0_BASE, 0, ADC_TRIGGER_PROCESSOR, 0);
+    ADCSequenceEnable(ADC0_BASE, 0);
+    ADCIntClear(ADC0_BASE, 0);
+
+    ADCProcessorTrigger(ADC0_BASE, 0);
+    while(!ADCIntStatus(ADC0_BASE, 0, false));  // Wait for conversion to be completed.
+    ADCIntClear(ADC0_BASE, 0);
+    ADCSequenceDataGet(ADC0_BASE, 0, pui32ADC0Value);
+    ADCSequenceDisable(ADC0_BASE, 0);
 
-    ADCProcessorTrigger(ADC0_BASE, 3);
-    while(!ADCIntStatus(ADC0_BASE, 3, FALSE));  // Wait for conversion to be completed.
-    ADCIntClear(ADC0_BASE, 3);
-    ADCSequenceDataGet(ADC0_BASE, 3, pui32ADC0Value);
-    return (uint8_t)pui32ADC0Value[0];
+    for (ui32Channel = 0; ui32Channel < LM35_NUM_CHANNELS; ui32Channel++)
+    {
+        LM35_Latest[ui32Channel] = (uint16_t)pui32ADC0Value[ui32Channel];
+    }
 }
 
-void PassengerSensor_Init(void){
+void LM35_Init(void){
+
+    uint32_t ui32Channel;
+
     SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
-    GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_2);
+    for (ui32Channel = 0; ui32Channel < LM35_NUM_CHANNELS; ui32Channel++)
+    {
+        SysCtlPeripheralEnable(LM35_Channels[ui32Channel].ui32Periph);
+        GPIOPinTypeADC(LM35_Channels[ui32Channel].ui32Port, LM35_Channels[ui32Channel].ui8Pin);
+    }
+}
 
+void LM35_GetReadings(uint8_t *pui8Readings){
 
+    uint32_t ui32Count;
+    uint32_t ui32Channel;
+
+    /* Copied again if a buffer completed meanwhile, so every reading comes
+     * from the same completed buffer. The interrupt runs once per buffer,
+     * LM35_SAMPLE_RATE_HZ / LM35_SEQUENCES_PER_BUFFER times a second, one
+     * retry is the most this ever takes. */
+    do
+    {
+        ui32Count = LM35_BufferCount;
+        for (ui32Channel = 0; ui32Channel < LM35_NUM_CHANNELS; ui32Channel++)
+        {
+            pui8Readings[ui32Channel] = (uint8_t)LM35_Latest[ui32Channel];
+        }
+    } while (ui32Count != LM35_BufferCount);
 }
-uint8_t GetPassengerSensorReading(){
 
-    uint32_t pui32ADC0Value[1];
+void LM35_StartAcquisition(void){
+
+    DMA_Init();
+
+    /* One sequence converts every seat, the uDMA request comes with the last step */
+    ADCSequenceDisable(ADC0_BASE, 0);
+    ADCHardwareOversampleConfigure(ADC0_BASE, LM35_OVERSAMPLE_FACTOR);
+    LM35_ConfigureSteps(0);
+    LM35_PrimeLatest();
+
+    /* The steps stay, only the trigger changes */
+    ADCSequenceConfigure(ADC0_BASE, 0, ADC_TRIGGER_TIMER, 0);
+
+    /* Each request moves one sequence, 16 bits per sample out of the FIFO */
+    uDMAChannelAssign(UDMA_CH14_ADC0_0);
+    uDMAChannelAttributeDisable(UDMA_CHANNEL_ADC0, UDMA_ATTR_ALTSELECT |
+                                UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    uDMAChannelAttributeEnable(UDMA_CHANNEL_ADC0, UDMA_ATTR_USEBURST);
+    uDMAChannelControlSet(UDMA_CHANNEL_ADC0 | UDMA_PRI_SELECT, UDMA_SIZE_16 |
+                          UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | LM35_DMA_ARB);
+    uDMAChannelControlSet(UDMA_CHANNEL_ADC0 | UDMA_ALT_SELECT, UDMA_SIZE_16 |
+                          UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | LM35_DMA_ARB);
+    LM35_ArmHalf(UDMA_PRI_SELECT);
+    LM35_ArmHalf(UDMA_ALT_SELECT);
+    uDMAChannelEnable(UDMA_CHANNEL_ADC0);
+
+    ADCSequenceEnable(ADC0_BASE, 0);
+    ADCSequenceDMAEnable(ADC0_BASE, 0);
+    ADCIntClearEx(ADC0_BASE, ADC_INT_DMA_SS0);
+    ADCIntEnableEx(ADC0_BASE, ADC_INT_DMA_SS0);
+    IntPrioritySet(INT_ADC0SS0, LM35_ADC_INTERRUPT_PRIORITY);
+    IntEnable(INT_ADC0SS0);
+
+    GPTM_Timer0ADCTriggerInit(SysCtlClockGet() / LM35_SAMPLE_RATE_HZ);
+}
+
+uint32_t LM35_GetBufferCount(void){
+
+    return LM35_BufferCount;
+}
+
+void LM35_ADC0Seq0Handler(void){
+
+    uint16_t *pui16Buffer;
+    uint32_t ui32Half;
+    uint32_t ui32Channel;
+    uint32_t ui32Sample;
+    uint32_t pui32Sum[LM35_NUM_CHANNELS];
+
+    traceISR_ENTER(INT_ADC0SS0);
+    ADCIntClearEx(ADC0_BASE, ADC_INT_DMA_SS0);
+
+    /* Normally one half is done; both are if this interrupt was held off for
+     * a whole buffer, and then they are handed over oldest first */
+    while (uDMAChannelModeGet(UDMA_CHANNEL_ADC0 | LM35_NextHalf) == UDMA_MODE_STOP)
+    {
+        ui32Half = LM35_NextHalf;
+        pui16Buffer = LM35_Samples[(ui32Half == UDMA_PRI_SELECT) ? 0 : 1];
+        for (ui32Channel = 0; ui32Channel < LM35_NUM_CHANNELS; ui32Channel++)
+        {
+            pui32Sum[ui32Channel] = 0;
+        }
+        /* Samples are in sequence order, one per channel in turn */
+        for (ui32Sample = 0; ui32Sample < LM35_BUFFER_SAMPLES; ui32Sample += LM35_NUM_CHANNELS)
+        {
+            for (ui32Channel = 0; ui32Channel < LM35_NUM_CHANNELS; ui32Channel++)
+            {
+                pui32Sum[ui32Channel] += pui16Buffer[ui32Sample + ui32Channel];
+            }
+        }
+        for (ui32Channel = 0; ui32Channel < LM35_NUM_CHANNELS; ui32Channel++)
+        {
+            LM35_Latest[ui32Channel] = (uint16_t)((pui32Sum[ui32Channel] + (LM35_SEQUENCES_PER_BUFFER / 2)) /
+                                                  LM35_SEQUENCES_PER_BUFFER);
+        }
+        LM35_BufferCount++;
 
-    ADCSequenceConfigure(ADC0_BASE, 3, ADC_TRIGGER_PROCESSOR, 0);
-    ADCSequenceStepConfigure(ADC0_BASE, 3, 0, ADC_CTL_CH1 | ADC_CTL_IE |
-                             ADC_CTL_END);
-    ADCSequenceEnable(ADC0_BASE, 3);
-    ADCIntClear(ADC0_BASE, 3);
+        LM35_ArmHalf(ui32Half);
+        LM35_NextHalf = (ui32Half == UDMA_PRI_SELECT) ? UDMA_ALT_SELECT : UDMA_PRI_SELECT;
+    }
 
-    ADCProcessorTrigger(ADC0_BASE, 3);
-    while(!ADCIntStatus(ADC0_BASE, 3, FALSE));  // Wait for conversion to be completed.
-    ADCIntClear(ADC0_BASE, 3);
-    ADCSequenceDataGet(ADC0_BASE, 3, pui32ADC0Value);
-    return (uint8_t)pui32ADC0Value[0];
+    /* With both halves stopped the channel disabled itself */
+    if (!uDMAChannelIsEnabled(UDMA_CHANNEL_ADC0))
+    {
+        uDMAChannelEnable(UDMA_CHANNEL_ADC0);
+    }
+    traceISR_EXIT(INT_ADC0SS0);
 }
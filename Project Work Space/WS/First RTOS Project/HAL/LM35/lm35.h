@@ -1,18 +1,40 @@
 
-
 #ifndef HAL_LM35_LM35_H_
 #define HAL_LM35_LM35_H_
 
 #include <stdint.h>
 
-#define DriverSensor_MAX_VALUE   4096
-#define PassengerSensor_MAX_VALUE   4096
+#define LM35_MAX_VALUE   4096
+
+/* Background acquisition: Timer0A triggers ADC0 sequencer 0 at LM35_SAMPLE_RATE_HZ,
+ * each trigger converts every seat channel with hardware averaging and the uDMA
+ * moves the results into one half of a ping-pong buffer while the other half
+ * is published to the readers. The engine is the only user of ADC0: readers
+ * get the mean of the buffer's LM35_SEQUENCES_PER_BUFFER sequences, so each
+ * reading averages LM35_OVERSAMPLE_FACTOR * LM35_SEQUENCES_PER_BUFFER
+ * conversions. */
+#define LM35_SAMPLE_RATE_HZ         100
+#define LM35_OVERSAMPLE_FACTOR      16
+#define LM35_SEQUENCES_PER_BUFFER   8
+#define LM35_NUM_CHANNELS           2   /* One per seat, rows of LM35_Channels in lm35.c: 1, 2, 4 or 8 */
+
+/* Below configMAX_SYSCALL_INTERRUPT_PRIORITY, in the upper three bits */
+#define LM35_ADC_INTERRUPT_PRIORITY (6 << 5)
+
+/* Powers ADC0 and puts every channel's pin in analog mode */
+void LM35_Init(void);
+
+/* Newest reading of every channel, all from the same completed buffer, into
+ * pui8Readings[LM35_NUM_CHANNELS]; channel n is seat n */
+void LM35_GetReadings(uint8_t *pui8Readings);
 
-void DriverSensor_Init(void);
-uint8_t GetDriverSensorReading(void);
+/* Starts the timer, ADC and uDMA engine, call after LM35_Init */
+void LM35_StartAcquisition(void);
 
-void PassengerSensor_Init(void);
-uint8_t GetPassengerSensorReading(void);
+/* Number of ping-pong buffers filled since the engine was started */
+uint32_t LM35_GetBufferCount(void);
 
+/* ADC0 sequencer 0 interrupt, signalled by the uDMA when a buffer is full */
+void LM35_ADC0Seq0Handler(void);
 
 #endif /* HAL_LM35_LM35_H_*/
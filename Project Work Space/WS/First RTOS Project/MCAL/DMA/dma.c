@@ -0,0 +1,41 @@
+ /******************************************************************************
+ *
+ * Module: DMA
+ *
+ * File Name: dma.c
+ *
+ * Description: Source file for the TM4C123GH6PM uDMA controller setup shared
+ *              by the drivers that stream data through it
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "dma.h"
+#include "../../driverlib/sysctl.h"
+#include "../../driverlib/udma.h"
+
+/* Primary and alternate control structures of all 32 channels. The controller
+ * requires the table to be aligned on its own size (1024 bytes). */
+#if defined(ccs)
+#pragma DATA_ALIGN(DMA_ControlTable, 1024)
+static tDMAControlTable DMA_ControlTable[64];
+#else
+static tDMAControlTable DMA_ControlTable[64] __attribute__((aligned(1024)));
+#endif
+
+static boolean DMA_Initialized = FALSE;
+
+void DMA_Init(void)
+{
+    if (DMA_Initialized == FALSE)
+    {
+        SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+        while (!SysCtlPeripheralReady(SYSCTL_PERIPH_UDMA));
+        uDMAEnable();
+        uDMAControlBaseSet(DMA_ControlTable);
+        DMA_Initialized = TRUE;
+    }
+}
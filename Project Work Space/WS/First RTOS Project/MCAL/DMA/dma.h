@@ -0,0 +1,23 @@
+ /******************************************************************************
+ *
+ * Module: DMA
+ *
+ * File Name: dma.h
+ *
+ * Description: Header file for the TM4C123GH6PM uDMA controller setup shared
+ *              by the drivers that stream data through it
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef DMA_H_
+#define DMA_H_
+
+#include "std_types.h"
+
+/* Enables the uDMA controller and hands it the channel control table. Safe to
+ * call from every driver that uses a channel, only the first call does work. */
+void DMA_Init(void);
+
+#endif /* DMA_H_ */
@@ -0,0 +1,263 @@
+ /******************************************************************************
+ *
+ * Module: GPIO Debounce
+ *
+ * File Name: gpio_debounce.c
+ *
+ * Description: Source file for the debounce and gesture layer of the TivaC
+ *              built-in buttons SW1 (PF4) and SW2 (PF0)
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "gpio_debounce.h"
+#include "gpio.h"
+#include "GPTM.h"
+#include "tm4c123gh6pm_registers.h"
+#include "../../inc/hw_ints.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define GPIO_DEBOUNCE_TICKS(ms)     ((uint32)(ms) * GPIO_DEBOUNCE_TICKS_PER_MS)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum
+{
+    GPIO_DEBOUNCE_IDLE,                 /* Released, falling edge armed */
+    GPIO_DEBOUNCE_PRESS_SETTLING,       /* Pin masked until the settle time-out */
+    GPIO_DEBOUNCE_PRESSED,              /* Held, rising edge armed */
+    GPIO_DEBOUNCE_RELEASE_SETTLING,     /* Pin masked until the settle time-out */
+    GPIO_DEBOUNCE_WAIT_SECOND           /* Released, double click window running */
+} GPIO_DebounceStateType;
+
+typedef struct
+{
+    uint32 uPin;                        /* Port F pin mask */
+    void (*pfnTimerStart)(uint32 ulTicks);
+    GPIO_DebounceStateType eState;
+    boolean bSecondPress;               /* Current press may complete a double click */
+    boolean bLongReported;
+} GPIO_DebounceButtonType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static GPIO_DebounceButtonType GPIO_Buttons[GPIO_NUM_BUTTONS] =
+{
+    { (1<<4), GPTM_Timer1OneShotStart, GPIO_DEBOUNCE_IDLE, FALSE, FALSE },  /* SW1 */
+    { (1<<0), GPTM_Timer2OneShotStart, GPIO_DEBOUNCE_IDLE, FALSE, FALSE },  /* SW2 */
+};
+
+static GPIO_GestureCallbackType GPIO_GestureCallback = NULL_PTR;
+static GPIO_DebounceStatsType GPIO_DebounceStats;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static boolean GPIO_ButtonPressed(const GPIO_DebounceButtonType *pButton)
+{
+    /* The buttons pull the pin low while pressed */
+    return ((GPIO_PORTF_DATA_REG & pButton->uPin) == 0) ? TRUE : FALSE;
+}
+
+static void GPIO_Report(uint8 uButton, GPIO_GestureType eGesture)
+{
+    GPIO_DebounceStats.Gestures[eGesture]++;
+    if (GPIO_GestureCallback != NULL_PTR)
+    {
+        GPIO_GestureCallback(uButton, eGesture);
+    }
+}
+
+static void GPIO_OnEdge(uint8 uButton);
+
+/* Unmask the pin for the edge that leaves the level just sampled. A change
+ * that came before the flag was cleared is handled here as if it was seen. */
+static void GPIO_ArmEdge(uint8 uButton, boolean bPressed)
+{
+    GPIO_DebounceButtonType *pButton = &GPIO_Buttons[uButton];
+
+    if (bPressed)
+    {
+        GPIO_PORTF_IEV_REG |= pButton->uPin;        /* Rising edge: release */
+    }
+    else
+    {
+        GPIO_PORTF_IEV_REG &= ~pButton->uPin;       /* Falling edge: press */
+    }
+    GPIO_PORTF_ICR_REG = pButton->uPin;
+    GPIO_PORTF_IM_REG |= pButton->uPin;
+
+    if (GPIO_ButtonPressed(pButton) != bPressed)
+    {
+        GPIO_OnEdge(uButton);
+    }
+}
+
+/* First edge of a bounce: mask the pin and look again after the settle time */
+static void GPIO_OnEdge(uint8 uButton)
+{
+    GPIO_DebounceButtonType *pButton = &GPIO_Buttons[uButton];
+
+    GPIO_PORTF_IM_REG &= ~pButton->uPin;
+    GPIO_PORTF_ICR_REG = pButton->uPin;
+
+    switch (pButton->eState)
+    {
+    case GPIO_DEBOUNCE_IDLE:
+        pButton->bSecondPress = FALSE;
+        pButton->eState = GPIO_DEBOUNCE_PRESS_SETTLING;
+        break;
+    case GPIO_DEBOUNCE_WAIT_SECOND:
+        /* Restarting the timer ends the double click window */
+        pButton->bSecondPress = TRUE;
+        pButton->eState = GPIO_DEBOUNCE_PRESS_SETTLING;
+        break;
+    case GPIO_DEBOUNCE_PRESSED:
+        /* Restarting the timer ends the long press wait */
+        pButton->eState = GPIO_DEBOUNCE_RELEASE_SETTLING;
+        break;
+    default:
+        return;                         /* Settling, the pin is already masked */
+    }
+    pButton->pfnTimerStart(GPIO_DEBOUNCE_TICKS(GPIO_DEBOUNCE_SETTLE_MS));
+}
+
+static void GPIO_OnTimeout(uint8 uButton)
+{
+    GPIO_DebounceButtonType *pButton = &GPIO_Buttons[uButton];
+    boolean bPressed = GPIO_ButtonPressed(pButton);
+
+    GPIO_DebounceStats.TimerInterrupts++;
+    switch (pButton->eState)
+    {
+    case GPIO_DEBOUNCE_PRESS_SETTLING:
+        if (bPressed)
+        {
+            GPIO_DebounceStats.Presses++;
+            pButton->bLongReported = FALSE;
+            pButton->eState = GPIO_DEBOUNCE_PRESSED;
+            if (pButton->bSecondPress == FALSE)
+            {
+                pButton->pfnTimerStart(GPIO_DEBOUNCE_TICKS(GPIO_DEBOUNCE_LONG_PRESS_MS - GPIO_DEBOUNCE_SETTLE_MS));
+            }
+        }
+        else
+        {
+            /* Too short to be a press. It still ends a pending click. */
+            GPIO_DebounceStats.Glitches++;
+            if (pButton->bSecondPress)
+            {
+                GPIO_Report(uButton, GPIO_GESTURE_SHORT_PRESS);
+            }
+            pButton->eState = GPIO_DEBOUNCE_IDLE;
+        }
+        GPIO_ArmEdge(uButton, bPressed);
+        break;
+
+    case GPIO_DEBOUNCE_PRESSED:
+        /* Long press time-out, the release is reported as nothing */
+        pButton->bLongReported = TRUE;
+        GPIO_Report(uButton, GPIO_GESTURE_LONG_PRESS);
+        break;
+
+    case GPIO_DEBOUNCE_RELEASE_SETTLING:
+        if (bPressed)
+        {
+            /* Bounced back down, still held */
+            pButton->eState = GPIO_DEBOUNCE_PRESSED;
+            if ((pButton->bSecondPress == FALSE) && (pButton->bLongReported == FALSE))
+            {
+                pButton->pfnTimerStart(GPIO_DEBOUNCE_TICKS(GPIO_DEBOUNCE_LONG_PRESS_MS - GPIO_DEBOUNCE_SETTLE_MS));
+            }
+        }
+        else if (pButton->bLongReported)
+        {
+            pButton->eState = GPIO_DEBOUNCE_IDLE;
+        }
+        else if (pButton->bSecondPress)
+        {
+            GPIO_Report(uButton, GPIO_GESTURE_DOUBLE_CLICK);
+            pButton->eState = GPIO_DEBOUNCE_IDLE;
+        }
+        else
+        {
+            pButton->eState = GPIO_DEBOUNCE_WAIT_SECOND;
+            pButton->pfnTimerStart(GPIO_DEBOUNCE_TICKS(GPIO_DEBOUNCE_DOUBLE_CLICK_MS));
+        }
+        GPIO_ArmEdge(uButton, bPressed);
+        break;
+
+    case GPIO_DEBOUNCE_WAIT_SECOND:
+        GPIO_Report(uButton, GPIO_GESTURE_SHORT_PRESS);
+        pButton->eState = GPIO_DEBOUNCE_IDLE;
+        break;
+
+    default:
+        break;                          /* Stale time-out */
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void GPIO_DebounceInit(GPIO_GestureCallbackType pfnCallback)
+{
+    GPIO_GestureCallback = pfnCallback;
+    GPTM_Timer1OneShotInit();
+    GPTM_Timer2OneShotInit();
+    GPIO_SW1EdgeTriggeredInterruptInit();
+    GPIO_SW2EdgeTriggeredInterruptInit();
+}
+
+void GPIO_DebounceGetStats(GPIO_DebounceStatsType *pStats)
+{
+    *pStats = GPIO_DebounceStats;
+}
+
+void GPIO_DebouncePortFHandler(void)
+{
+    uint32 uStatus = GPIO_PORTF_MIS_REG;
+    uint8 uButton;
+
+    traceISR_ENTER(INT_GPIOF);
+    GPIO_DebounceStats.EdgeInterrupts++;
+    for (uButton = 0; uButton < GPIO_NUM_BUTTONS; uButton++)
+    {
+        if (uStatus & GPIO_Buttons[uButton].uPin)
+        {
+            GPIO_OnEdge(uButton);
+        }
+    }
+    traceISR_EXIT(INT_GPIOF);
+}
+
+void GPIO_DebounceSW1TimerHandler(void)
+{
+    traceISR_ENTER(INT_TIMER1A);
+    if (GPTM_Timer1ClearTimeout())
+    {
+        GPIO_OnTimeout(GPIO_BUTTON_SW1);
+    }
+    traceISR_EXIT(INT_TIMER1A);
+}
+
+void GPIO_DebounceSW2TimerHandler(void)
+{
+    traceISR_ENTER(INT_TIMER2A);
+    if (GPTM_Timer2ClearTimeout())
+    {
+        GPIO_OnTimeout(GPIO_BUTTON_SW2);
+    }
+    traceISR_EXIT(INT_TIMER2A);
+}
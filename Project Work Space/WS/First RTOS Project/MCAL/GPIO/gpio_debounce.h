@@ -0,0 +1,89 @@
+ /******************************************************************************
+ *
+ * Module: GPIO Debounce
+ *
+ * File Name: gpio_debounce.h
+ *
+ * Description: Header file for the debounce and gesture layer of the TivaC
+ *              built-in buttons SW1 (PF4) and SW2 (PF0).
+ *
+ *              The first edge of a button masks its pin interrupt and starts
+ *              the button's one-shot timer (Timer1A for SW1, Timer2A for
+ *              SW2). The pin is re-sampled when the settle time is over, so
+ *              the contact bounce never reaches the application. While the
+ *              button is held the pin waits for the opposite edge, and the
+ *              same timer measures the long press and double click windows:
+ *
+ *                short press   released, no second press within the window
+ *                long press    held past the long press time, reported
+ *                              while still held
+ *                double click  second press within the window
+ *
+ *              Gestures are handed to a callback from interrupt context, at
+ *              GPIO_PORTF_INTERRUPT_PRIORITY, so FreeRTOS FromISR calls may
+ *              be used there.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef GPIO_DEBOUNCE_H_
+#define GPIO_DEBOUNCE_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define GPIO_BUTTON_SW1                 0
+#define GPIO_BUTTON_SW2                 1
+#define GPIO_NUM_BUTTONS                2
+
+/* Times in ms, counted by the GPTM from the 16 MHz system clock */
+#define GPIO_DEBOUNCE_SETTLE_MS         20
+#define GPIO_DEBOUNCE_LONG_PRESS_MS     1000
+#define GPIO_DEBOUNCE_DOUBLE_CLICK_MS   300
+#define GPIO_DEBOUNCE_TICKS_PER_MS      16000
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum
+{
+    GPIO_GESTURE_SHORT_PRESS,
+    GPIO_GESTURE_LONG_PRESS,
+    GPIO_GESTURE_DOUBLE_CLICK,
+    GPIO_NUM_GESTURES
+} GPIO_GestureType;
+
+/* Called from the Port F or the timer interrupt */
+typedef void (*GPIO_GestureCallbackType)(uint8 uButton, GPIO_GestureType eGesture);
+
+typedef struct
+{
+    uint32 EdgeInterrupts;              /* Port F interrupts taken */
+    uint32 TimerInterrupts;             /* Settle and window time-outs */
+    uint32 Presses;                     /* Presses that outlasted the settle time */
+    uint32 Glitches;                    /* Edges gone again before the settle time */
+    uint32 Gestures[GPIO_NUM_GESTURES]; /* Callbacks made, per gesture */
+} GPIO_DebounceStatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Configures the SW1 and SW2 edge interrupts and their one-shot timers. The
+ * callback receives every gesture, GPIO_BUTTON_SW1 or GPIO_BUTTON_SW2. */
+void GPIO_DebounceInit(GPIO_GestureCallbackType pfnCallback);
+
+/* Counters only grow and each is read in one access */
+void GPIO_DebounceGetStats(GPIO_DebounceStatsType *pStats);
+
+/* GPIO Port F, Timer1A and Timer2A interrupts */
+void GPIO_DebouncePortFHandler(void);
+void GPIO_DebounceSW1TimerHandler(void);
+void GPIO_DebounceSW2TimerHandler(void);
+
+#endif /* GPIO_DEBOUNCE_H_ */
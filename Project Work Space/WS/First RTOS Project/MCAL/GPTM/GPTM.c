@@ -12,19 +12,85 @@
 #include "GPTM.h"
 #include "tm4c123gh6pm_registers.h"
 
-void GPTM_WTimer0Init(void)
+void GPTM_Timer0ADCTriggerInit(uint32 ulPeriodTicks)
 {
-    /* Configure one shot down 32bit timer with tick time = 0.1msec */
-    SYSCTL_RCGCWTIMER_REG |= (1<<0);  /* Enable clock WTimer0 in run mode */
-    WTIMER0_CTL_REG = 0;              /* Disable WTimer0 output */
-    WTIMER0_CFG_REG = 0x04;           /* Select 32-bit configuration option */
-    WTIMER0_TAMR_REG = 0x01;          /* Select one-shot down counter mode of WTimer0A */
-    WTIMER0_TAPR_REG = 1600 -1;       /* Set the prescaler for WTimer0A */
-    WTIMER0_CTL_REG |= (0x01);        /* Enable WTimer0A module */
+    /* Configure periodic down 32bit timer that starts the ADC on each time-out */
+    SYSCTL_RCGCTIMER_REG |= (1<<0);   /* Enable clock Timer0 in run mode */
+    TIMER0_CTL_REG = 0;               /* Disable Timer0 output */
+    TIMER0_CFG_REG = 0x00;            /* Select 32-bit configuration option */
+    TIMER0_TAMR_REG = 0x02;           /* Select periodic down counter mode of Timer0A */
+    TIMER0_TAILR_REG = ulPeriodTicks - 1;
+    TIMER0_IMR_REG = 0;               /* No CPU interrupt, the time-out only triggers the ADC */
+    TIMER0_CTL_REG |= (1<<5);         /* TAOTE: Timer0A time-out is an ADC trigger */
+    TIMER0_CTL_REG |= (0x01);         /* Enable Timer0A module */
 }
 
-uint32 GPTM_WTimer0Read(void)
+void GPTM_Timer1OneShotInit(void)
 {
-    return (uint32) (0xFFFFFFFFUL - WTIMER0_TAR_REG);
+    /* Configure one shot down 32bit timer clocked by the system clock, started per use */
+    SYSCTL_RCGCTIMER_REG |= (1<<1);   /* Enable clock Timer1 in run mode */
+    TIMER1_CTL_REG = 0;               /* Disable Timer1 output */
+    TIMER1_CFG_REG = 0x00;            /* Select 32-bit configuration option */
+    TIMER1_TAMR_REG = 0x01;           /* Select one-shot down counter mode of Timer1A */
+    TIMER1_ICR_REG = 0x01;            /* Clear Timer1A time-out flag */
+    TIMER1_IMR_REG = 0x01;            /* Enable Timer1A time-out interrupt */
+    /* Set Timer1A priority by set Bit number 13, 14 and 15 */
+    NVIC_PRI5_REG = (NVIC_PRI5_REG & GPTM_TIMER1A_PRIORITY_MASK) | (GPTM_ONE_SHOT_INTERRUPT_PRIORITY<<GPTM_TIMER1A_PRIORITY_BITS_POS);
+    NVIC_EN0_REG |= (1<<21);          /* Enable NVIC Interrupt for Timer1A by set bit number 21 in EN0 Register */
 }
 
+void GPTM_Timer1OneShotStart(uint32 ulTicks)
+{
+    TIMER1_CTL_REG &= ~(0x01);        /* Stop Timer1A, a running count is dropped */
+    TIMER1_ICR_REG = 0x01;            /* and so is a time-out not served yet */
+    TIMER1_TAILR_REG = ulTicks - 1;
+    TIMER1_CTL_REG |= (0x01);         /* Enable Timer1A, it stops by itself at the time-out */
+}
+
+void GPTM_Timer1OneShotStop(void)
+{
+    TIMER1_CTL_REG &= ~(0x01);        /* Disable Timer1A */
+    TIMER1_ICR_REG = 0x01;            /* Drop a time-out that was not served yet */
+}
+
+boolean GPTM_Timer1ClearTimeout(void)
+{
+    boolean bTimeout = (TIMER1_MIS_REG & 0x01) ? TRUE : FALSE;
+    TIMER1_ICR_REG = 0x01;            /* Clear Timer1A time-out flag */
+    return bTimeout;
+}
+
+void GPTM_Timer2OneShotInit(void)
+{
+    /* Configure one shot down 32bit timer clocked by the system clock, started per use */
+    SYSCTL_RCGCTIMER_REG |= (1<<2);   /* Enable clock Timer2 in run mode */
+    TIMER2_CTL_REG = 0;               /* Disable Timer2 output */
+    TIMER2_CFG_REG = 0x00;            /* Select 32-bit configuration option */
+    TIMER2_TAMR_REG = 0x01;           /* Select one-shot down counter mode of Timer2A */
+    TIMER2_ICR_REG = 0x01;            /* Clear Timer2A time-out flag */
+    TIMER2_IMR_REG = 0x01;            /* Enable Timer2A time-out interrupt */
+    /* Set Timer2A priority by set Bit number 29, 30 and 31 */
+    NVIC_PRI5_REG = (NVIC_PRI5_REG & GPTM_TIMER2A_PRIORITY_MASK) | (GPTM_ONE_SHOT_INTERRUPT_PRIORITY<<GPTM_TIMER2A_PRIORITY_BITS_POS);
+    NVIC_EN0_REG |= (1<<23);          /* Enable NVIC Interrupt for Timer2A by set bit number 23 in EN0 Register */
+}
+
+void GPTM_Timer2OneShotStart(uint32 ulTicks)
+{
+    TIMER2_CTL_REG &= ~(0x01);        /* Stop Timer2A, a running count is dropped */
+    TIMER2_ICR_REG = 0x01;            /* and so is a time-out not served yet */
+    TIMER2_TAILR_REG = ulTicks - 1;
+    TIMER2_CTL_REG |= (0x01);         /* Enable Timer2A, it stops by itself at the time-out */
+}
+
+void GPTM_Timer2OneShotStop(void)
+{
+    TIMER2_CTL_REG &= ~(0x01);        /* Disable Timer2A */
+    TIMER2_ICR_REG = 0x01;            /* Drop a time-out that was not served yet */
+}
+
+boolean GPTM_Timer2ClearTimeout(void)
+{
+    boolean bTimeout = (TIMER2_MIS_REG & 0x01) ? TRUE : FALSE;
+    TIMER2_ICR_REG = 0x01;            /* Clear Timer2A time-out flag */
+    return bTimeout;
+}
@@ -15,8 +15,29 @@
 
 #include "std_types.h"
 
-void GPTM_WTimer0Init(void);
-uint32 GPTM_WTimer0Read(void);
+/* Timer1A (IRQ 21) and Timer2A (IRQ 23) share NVIC_PRI5 */
+#define GPTM_TIMER1A_PRIORITY_MASK       0xFFFF1FFF
+#define GPTM_TIMER1A_PRIORITY_BITS_POS   13
+#define GPTM_TIMER2A_PRIORITY_MASK       0x1FFFFFFF
+#define GPTM_TIMER2A_PRIORITY_BITS_POS   29
+/* Same level as GPIO Port F, FreeRTOS FromISR calls are allowed */
+#define GPTM_ONE_SHOT_INTERRUPT_PRIORITY 5
+
+/* Periodic Timer0A that raises an ADC trigger every ulPeriodTicks system clocks */
+void GPTM_Timer0ADCTriggerInit(uint32 ulPeriodTicks);
+
+/* One-shot Timer1A and Timer2A, interrupt on time-out. Start counts ulTicks
+ * system clocks from now, restarting a timer that is already running.
+ * ClearTimeout returns FALSE for an interrupt left pending by a restart. */
+void GPTM_Timer1OneShotInit(void);
+void GPTM_Timer1OneShotStart(uint32 ulTicks);
+void GPTM_Timer1OneShotStop(void);
+boolean GPTM_Timer1ClearTimeout(void);
+
+void GPTM_Timer2OneShotInit(void);
+void GPTM_Timer2OneShotStart(uint32 ulTicks);
+void GPTM_Timer2OneShotStop(void);
+boolean GPTM_Timer2ClearTimeout(void);
 
 
 #endif /* GPTM_H_ */
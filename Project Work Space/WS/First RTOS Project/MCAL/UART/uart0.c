@@ -4,14 +4,65 @@
  *
  * File Name: uart0.c
  *
- * Description: Source file for the TM4C123GH6PM UART0 driver
+ * Description: Source file for the TM4C123GH6PM UART0 driver. Transmission is
+ *              interrupt driven: the send functions only copy into a ring
+ *              buffer and return, the UART0 interrupt moves the bytes into
+ *              the hardware FIFO as it drains. Whole frames can instead be
+ *              handed to uDMA channel 9, which feeds the FIFO straight from
+ *              the caller's buffer and raises a single interrupt at the end.
+ *              Frames sent while the channel is busy wait in a short queue of
+ *              descriptors, the end-of-transfer interrupt starts the next one.
  *
  * Author: Edges for Training Team
  *
  *******************************************************************************/
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "uart0.h"
+#include "dma.h"
 #include "tm4c123gh6pm_registers.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "../../inc/hw_memmap.h"
+#include "../../inc/hw_uart.h"
+#include "../../driverlib/udma.h"
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum
+{
+    UART0_FRAME_IDLE,
+    UART0_FRAME_PENDING,    /* Waits for the bytes queued ahead of it */
+    UART0_FRAME_ACTIVE      /* The uDMA is feeding the FIFO */
+} UART0_FrameStateType;
+
+typedef struct
+{
+    const uint8 *pBuffer;
+    uint32 uLength;
+    uint32 uStart;          /* Ring position the frame goes out at */
+    TaskHandle_t xOwner;
+} UART0_QueuedFrameType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static uint8 UART0_TxBuffer[UART0_TX_BUFFER_SIZE];
+static volatile uint32 UART0_TxHead = 0;          /* Next free entry, moved by the senders */
+static volatile uint32 UART0_TxTail = 0;          /* Next byte to transmit, moved by the ISR */
+static volatile uint32 UART0_TxDroppedBytes = 0;
+
+static volatile UART0_FrameStateType UART0_FrameState = UART0_FRAME_IDLE;
+static uint32 UART0_FrameStart = 0;               /* Ring position the first frame goes out at */
+
+/* Frames in the order they were sent, the first one is pending or active */
+static UART0_QueuedFrameType UART0_FrameQueue[UART0_FRAME_QUEUE_LENGTH];
+static volatile uint32 UART0_FrameFirst = 0;
+static volatile uint32 UART0_FrameCount = 0;
 
 /*******************************************************************************
  *                         Private Functions Definitions                       *
@@ -31,11 +82,102 @@ static void GPIO_SetupUART0Pins(void)
     GPIO_PORTA_DEN_REG   |= 0x03;         /* Enable Digital I/O on PA0 & PA1 */
 }
 
+/* Called from the ISR and, with the interrupt masked, from the senders */
+static void UART0_FillTxFifo(void)
+{
+    /* While a frame is pending only the bytes queued ahead of it are sent,
+     * while it is active the uDMA owns the FIFO */
+    while((UART0_FrameState != UART0_FRAME_ACTIVE) && !(UART0_FR_REG & UART_FR_TXFF_MASK) &&
+          (UART0_TxTail != UART0_TxHead) &&
+          !((UART0_FrameState == UART0_FRAME_PENDING) && (UART0_TxTail == UART0_FrameStart)))
+    {
+        UART0_DR_REG = UART0_TxBuffer[UART0_TxTail];
+        UART0_TxTail = (UART0_TxTail + 1) & (UART0_TX_BUFFER_SIZE - 1);
+    }
+
+    if ((UART0_FrameState == UART0_FRAME_PENDING) && (UART0_TxTail == UART0_FrameStart))
+    {
+        UART0_FrameState = UART0_FRAME_ACTIVE;
+        uDMAChannelEnable(UDMA_CHANNEL_UART0TX);
+        UART0_DMACTL_REG |= UART_DMACTL_TXDMAE_MASK;
+    }
+}
+
+/* Called from the ISR and, with the interrupt masked, from the senders, with
+ * the frame at the front of the queue */
+static void UART0_StartFrame(void)
+{
+    const UART0_QueuedFrameType *pFrame = &UART0_FrameQueue[UART0_FrameFirst];
+
+    UART0_FrameStart = pFrame->uStart;
+    uDMAChannelTransferSet(UDMA_CHANNEL_UART0TX | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+                           (void *)pFrame->pBuffer, (void *)(UART0_BASE + UART_O_DR),
+                           pFrame->uLength);
+    UART0_FrameState = UART0_FRAME_PENDING;
+}
+
+static uint32 UART0_FormatInteger(sint64 sNumber, uint8 *pText)
+{
+    uint8 uDigits[20];
+    sint8 uCounter = 0;
+    uint32 uLength = 0;
+
+    /* Send the negative sign in case of negative numbers */
+    if (sNumber < 0)
+    {
+        pText[uLength++] = '-';
+        sNumber *= -1;
+    }
+
+    /* Convert the number to an array of characters */
+    do
+    {
+        uDigits[uCounter++] = sNumber % 10 + '0'; /* Convert each digit to its corresponding ASCI character */
+        sNumber /= 10; /* Remove the already converted digit */
+    }
+    while (sNumber != 0);
+
+    /* Copy the array of characters in a reverse order as the digits were converted from right to left */
+    for( uCounter--; uCounter>= 0; uCounter--)
+    {
+        pText[uLength++] = uDigits[uCounter];
+    }
+    return uLength;
+}
+
+static void UART0_Enqueue(const uint8 *pData, uint32 uLength)
+{
+    uint32 uCounter;
+
+    /* Several tasks print, and the UART0 interrupt is below the syscall priority */
+    taskENTER_CRITICAL();
+    /* All or nothing: the head of a frame without its delimiter would also
+     * corrupt the frame after it */
+    if (uLength <= ((UART0_TxTail - UART0_TxHead - 1) & (UART0_TX_BUFFER_SIZE - 1)))
+    {
+        for (uCounter = 0; uCounter < uLength; uCounter++)
+        {
+            UART0_TxBuffer[UART0_TxHead] = pData[uCounter];
+            UART0_TxHead = (UART0_TxHead + 1) & (UART0_TX_BUFFER_SIZE - 1);
+        }
+    }
+    else
+    {
+        UART0_TxDroppedBytes += uLength;
+    }
+
+    /* The TX interrupt comes when the FIFO drains through its trigger level, so
+     * an idle transmitter has to be started here. Filling the FIFO up also
+     * guarantees that transition while the buffer still holds data. */
+    UART0_FillTxFifo();
+    taskEXIT_CRITICAL();
+}
+
 /*******************************************************************************
  *                         Public Functions Definitions                        *
  *******************************************************************************/
 
-void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1 stop bit and 9600BPS */
+void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1 stop bit and 115200BPS */
 {
     /* Setup UART0 pins PA0 --> U0RX & PA1 --> U0TX */
     GPIO_SetupUART0Pins();
@@ -47,20 +189,40 @@ void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1
 
     UART0_CC_REG  = 0;                    /* Use System Clock*/
     
-    /* To Configure UART0 with Baud Rate 9600 */
-    UART0_IBRD_REG = 104;
-    UART0_FBRD_REG = 11;
+    /* To Configure UART0 with Baud Rate 115200: 16 MHz / (16 * 115200) = 8.6806,
+     * the fraction in 64ths rounded. The kernel trace streams on this line
+     * too, 9600 baud carried only about 100 trace records a second. */
+    UART0_IBRD_REG = 8;
+    UART0_FBRD_REG = 44;
     
     /* UART Line Control Register Settings
      * BRK = 0 Normal Use
      * PEN = 0 Disable Parity
      * EPS = 0 No affect as the parity is disabled
      * STP2 = 0 1-stop bit at end of the frame
-     * FEN = 0 FIFOs are disabled
+     * FEN = 1 FIFOs are enabled
      * WLEN = 0x3 8-bits data frame
      * SPS = 0 no stick parity
      */
-    UART0_LCRH_REG = (UART_DATA_8BITS << UART_LCRH_WLEN_BITS_POS);
+    UART0_LCRH_REG = (UART_DATA_8BITS << UART_LCRH_WLEN_BITS_POS) | UART_LCRH_FEN_MASK;
+
+    /* Interrupt when the transmit FIFO drains to 2 bytes, time to refill it */
+    UART0_IFLS_REG = UART_IFLS_TXIFLSEL_1_8;
+    UART0_ICR_REG  = UART_ICR_TXIC_MASK;
+    UART0_IM_REG   = UART_IM_TXIM_MASK;
+    /* Set UART0 priority as 6 by set Bit number 13, 14 and 15 with value 6 */
+    NVIC_PRI1_REG = (NVIC_PRI1_REG & UART0_PRIORITY_MASK) | (UART0_INTERRUPT_PRIORITY<<UART0_PRIORITY_BITS_POS);
+    NVIC_EN0_REG         |= 0x00000020;   /* Enable NVIC Interrupt for UART0 by set bit number 5 in EN0 Register */
+
+    /* uDMA channel 9: byte wide from memory into DR, 8 bytes per burst request,
+     * which the UART raises once the FIFO drained to its 1/8 trigger level */
+    DMA_Init();
+    uDMAChannelAssign(UDMA_CH9_UART0TX);
+    uDMAChannelAttributeDisable(UDMA_CHANNEL_UART0TX, UDMA_ATTR_ALTSELECT |
+                                UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    uDMAChannelAttributeEnable(UDMA_CHANNEL_UART0TX, UDMA_ATTR_USEBURST);
+    uDMAChannelControlSet(UDMA_CHANNEL_UART0TX | UDMA_PRI_SELECT, UDMA_SIZE_8 |
+                          UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_8);
     
     /* UART Control Register Settings
      * RXE = 1 Enable UART Receive
@@ -73,8 +235,7 @@ void UART0_Init(void) /* UART0 configuration: 1 start, 8 bits data, No Parity, 1
        
 void UART0_SendByte(uint8 data)
 {
-    while(!(UART0_FR_REG & UART_FR_TXFE_MASK)); /* Wait until the transmit FIFO is empty */
-    UART0_DR_REG = data; /* Send the byte */
+    UART0_Enqueue(&data, 1); /* Queue the byte, the UART0 interrupt sends it */
 }
 
 uint8 UART0_ReceiveByte(void)
@@ -86,38 +247,98 @@ uint8 UART0_ReceiveByte(void)
 void UART0_SendString(const uint8 *pData)
 {
     uint32 uCounter =0;
-	/* Transmit the whole string */
+	/* Find the length, then queue the whole string at once */
     while(pData[uCounter] != '\0')
     {
-        UART0_SendByte(pData[uCounter]); /* Send the byte */
         uCounter++; /* increment the counter to the next byte */
     }
+    UART0_Enqueue(pData, uCounter);
 }
 
 void UART0_SendInteger(sint64 sNumber)
 {
+    uint8 uText[21];
 
-    uint8 uDigits[20];
-    sint8 uCounter = 0;
+    UART0_Enqueue(uText, UART0_FormatInteger(sNumber, uText));
+}
 
-    /* Send the negative sign in case of negative numbers */
-    if (sNumber < 0)
+void UART0_SendFrame(const UART0_FrameType *pFrame)
+{
+    UART0_QueuedFrameType *pQueued;
+    boolean bQueued = FALSE;
+
+    /* One uDMA transfer sends at most UART0_DMA_MAX_FRAME items */
+    configASSERT(pFrame->uLength <= UART0_DMA_MAX_FRAME);
+    if ((pFrame->uLength == 0) || (pFrame->uLength > UART0_DMA_MAX_FRAME))
     {
-        UART0_SendByte('-');
-        sNumber *= -1;
+        /* Nothing sent; an oversized frame counts as dropped */
+        taskENTER_CRITICAL();
+        UART0_TxDroppedBytes += pFrame->uLength;
+        taskEXIT_CRITICAL();
+        xTaskNotifyGiveIndexed(xTaskGetCurrentTaskHandle(), UART0_FRAME_NOTIFY_INDEX);
+        return;
     }
 
-    /* Convert the number to an array of characters */
-    do
+    taskENTER_CRITICAL();
+    if (UART0_FrameCount < UART0_FRAME_QUEUE_LENGTH)
     {
-        uDigits[uCounter++] = sNumber % 10 + '0'; /* Convert each digit to its corresponding ASCI character */
-        sNumber /= 10; /* Remove the already converted digit */
+        pQueued = &UART0_FrameQueue[(UART0_FrameFirst + UART0_FrameCount) % UART0_FRAME_QUEUE_LENGTH];
+        pQueued->pBuffer = pFrame->pBuffer;
+        pQueued->uLength = pFrame->uLength;
+        pQueued->uStart = UART0_TxHead;
+        pQueued->xOwner = xTaskGetCurrentTaskHandle();
+        UART0_FrameCount++;
+        if (UART0_FrameCount == 1)
+        {
+            UART0_StartFrame();
+            UART0_FillTxFifo(); /* Starts the uDMA at once if nothing is queued ahead */
+        }
+        bQueued = TRUE;
     }
-    while (sNumber != 0);
+    taskEXIT_CRITICAL();
 
-    /* Send the array of characters in a reverse order as the digits were converted from right to left */
-    for( uCounter--; uCounter>= 0; uCounter--)
+    if (bQueued == FALSE)
     {
-        UART0_SendByte(uDigits[uCounter]);
+        /* More senders than descriptors: copy the whole frame into the
+         * transmit buffer or drop it, the caller's buffer is free either way */
+        UART0_Enqueue(pFrame->pBuffer, pFrame->uLength);
+        xTaskNotifyGiveIndexed(xTaskGetCurrentTaskHandle(), UART0_FRAME_NOTIFY_INDEX);
     }
 }
+
+boolean UART0_WaitFrame(uint32 uTicksToWait)
+{
+    return (ulTaskNotifyTakeIndexed(UART0_FRAME_NOTIFY_INDEX, pdTRUE, (TickType_t)uTicksToWait) != 0)
+           ? TRUE : FALSE;
+}
+
+uint32 UART0_GetDroppedBytes(void)
+{
+    return UART0_TxDroppedBytes;
+}
+
+void UART0_Handler(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    UART0_ICR_REG = UART_ICR_TXIC_MASK; /* Clear the transmit interrupt flag */
+
+    /* The uDMA signals the end of a transfer on this vector without a UART
+     * status bit; a finished basic transfer disables its channel */
+    if ((UART0_FrameState == UART0_FRAME_ACTIVE) && !uDMAChannelIsEnabled(UDMA_CHANNEL_UART0TX))
+    {
+        UART0_DMACTL_REG &= ~UART_DMACTL_TXDMAE_MASK;
+        UART0_FrameState = UART0_FRAME_IDLE;
+        vTaskNotifyGiveIndexedFromISR(UART0_FrameQueue[UART0_FrameFirst].xOwner, UART0_FRAME_NOTIFY_INDEX,
+                                      &xHigherPriorityTaskWoken);
+        UART0_FrameFirst = (UART0_FrameFirst + 1) % UART0_FRAME_QUEUE_LENGTH;
+        UART0_FrameCount--;
+        if (UART0_FrameCount != 0)
+        {
+            UART0_StartFrame(); /* Goes out after the bytes queued ahead of it */
+        }
+    }
+
+    UART0_FillTxFifo();
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
@@ -27,7 +27,43 @@
 #define UART_CTL_TXE_MASK        0x00000100
 #define UART_CTL_RXE_MASK        0x00000200
 #define UART_FR_TXFE_MASK        0x00000080
+#define UART_FR_TXFF_MASK        0x00000020
 #define UART_FR_RXFE_MASK        0x00000010
+#define UART_LCRH_FEN_MASK       0x00000010
+#define UART_IFLS_TXIFLSEL_1_8   0x0            /* TX interrupt at <= 2 of 16 entries */
+#define UART_IM_TXIM_MASK        0x00000020
+#define UART_ICR_TXIC_MASK       0x00000020
+#define UART_DMACTL_TXDMAE_MASK  0x00000002
+
+/* Software transmit buffer in front of the 16-byte hardware FIFO, a power of two */
+#define UART0_TX_BUFFER_SIZE     512
+
+/* UART0 is IRQ 5, priority field in bits 13-15 of PRI1. Kept below
+ * configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY so critical sections mask it */
+#define UART0_PRIORITY_MASK      0xFFFF1FFF
+#define UART0_PRIORITY_BITS_POS  13
+#define UART0_INTERRUPT_PRIORITY 6
+
+/* Largest frame one uDMA transfer carries */
+#define UART0_DMA_MAX_FRAME      1024
+
+/* Frames waiting for the uDMA channel, one for each task that sends frames */
+#define UART0_FRAME_QUEUE_LENGTH 4
+
+/* Task notification slot that signals a sent frame, index 0 stays free for the application */
+#define UART0_FRAME_NOTIFY_INDEX 1
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* A caller-owned transmit frame, uLength bytes of uSize are to be sent */
+typedef struct
+{
+    uint8 *pBuffer;
+    uint32 uSize;
+    uint32 uLength;
+} UART0_FrameType;
 
 /*******************************************************************************
  *                            Functions Prototypes                             *
@@ -43,4 +79,22 @@ extern void UART0_SendString(const uint8 *pData);
 
 extern void UART0_SendInteger(sint64 sNumber);
 
+/* Sends the frame by uDMA straight from its buffer, after anything already
+ * queued. The buffer must stay untouched until UART0_WaitFrame() returns TRUE.
+ * Task context only: completion is notified to the calling task. Only with
+ * all UART0_FRAME_QUEUE_LENGTH descriptors taken is the frame copied into
+ * the transmit buffer, whole or not at all. An empty frame completes at once.
+ * A frame longer than UART0_DMA_MAX_FRAME fails configASSERT(); without the
+ * assert it completes at once, unsent, and its bytes count as dropped. */
+extern void UART0_SendFrame(const UART0_FrameType *pFrame);
+
+extern boolean UART0_WaitFrame(uint32 uTicksToWait);
+
+/* Bytes discarded because the transmit buffer was full, whole writes at a
+ * time, or in oversized frames */
+extern uint32 UART0_GetDroppedBytes(void);
+
+/* UART0 interrupt: refills the hardware FIFO from the transmit buffer */
+extern void UART0_Handler(void);
+
 #endif
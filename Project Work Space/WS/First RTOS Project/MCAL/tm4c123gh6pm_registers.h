@@ -133,6 +133,7 @@ GPIO registers (PORTF)
 #define GPIO_PORTF_IEV_REG        (*((volatile uint32 *)0x4002540C))
 #define GPIO_PORTF_IM_REG         (*((volatile uint32 *)0x40025410))
 #define GPIO_PORTF_RIS_REG        (*((volatile uint32 *)0x40025414))
+#define GPIO_PORTF_MIS_REG        (*((volatile uint32 *)0x40025418))
 #define GPIO_PORTF_ICR_REG        (*((volatile uint32 *)0x4002541C))
 
 /*****************************************************************************
@@ -142,6 +143,13 @@ Systick Timer Registers
 #define SYSTICK_RELOAD_REG        (*((volatile uint32 *)0xE000E014))
 #define SYSTICK_CURRENT_REG       (*((volatile uint32 *)0xE000E018))
 
+/*****************************************************************************
+Debug Registers (DWT cycle counter)
+*****************************************************************************/
+#define DEBUG_DEMCR_REG           (*((volatile uint32 *)0xE000EDFC))
+#define DWT_CTRL_REG              (*((volatile uint32 *)0xE0001000))
+#define DWT_CYCCNT_REG            (*((volatile uint32 *)0xE0001004))
+
 /*****************************************************************************
 NVIC Registers
 *****************************************************************************/
@@ -438,6 +446,60 @@ Flash Registers
 #define FLASH_FMPPE2_REG          (*((volatile uint32 *)0x400FE408))
 #define FLASH_FMPPE3_REG          (*((volatile uint32 *)0x400FE40C))
 
+/*****************************************************************************
+Timer Registers (TIMER0)
+*****************************************************************************/
+#define TIMER0_CFG_REG            (*((volatile uint32 *)0x40030000))
+#define TIMER0_TAMR_REG           (*((volatile uint32 *)0x40030004))
+#define TIMER0_TBMR_REG           (*((volatile uint32 *)0x40030008))
+#define TIMER0_CTL_REG            (*((volatile uint32 *)0x4003000C))
+#define TIMER0_IMR_REG            (*((volatile uint32 *)0x40030018))
+#define TIMER0_RIS_REG            (*((volatile uint32 *)0x4003001C))
+#define TIMER0_MIS_REG            (*((volatile uint32 *)0x40030020))
+#define TIMER0_ICR_REG            (*((volatile uint32 *)0x40030024))
+#define TIMER0_TAILR_REG          (*((volatile uint32 *)0x40030028))
+#define TIMER0_TBILR_REG          (*((volatile uint32 *)0x4003002C))
+#define TIMER0_TAPR_REG           (*((volatile uint32 *)0x40030038))
+#define TIMER0_TBPR_REG           (*((volatile uint32 *)0x4003003C))
+#define TIMER0_TAR_REG            (*((volatile uint32 *)0x40030048))
+#define TIMER0_TBR_REG            (*((volatile uint32 *)0x4003004C))
+
+/*****************************************************************************
+Timer Registers (TIMER1)
+*****************************************************************************/
+#define TIMER1_CFG_REG            (*((volatile uint32 *)0x40031000))
+#define TIMER1_TAMR_REG           (*((volatile uint32 *)0x40031004))
+#define TIMER1_TBMR_REG           (*((volatile uint32 *)0x40031008))
+#define TIMER1_CTL_REG            (*((volatile uint32 *)0x4003100C))
+#define TIMER1_IMR_REG            (*((volatile uint32 *)0x40031018))
+#define TIMER1_RIS_REG            (*((volatile uint32 *)0x4003101C))
+#define TIMER1_MIS_REG            (*((volatile uint32 *)0x40031020))
+#define TIMER1_ICR_REG            (*((volatile uint32 *)0x40031024))
+#define TIMER1_TAILR_REG          (*((volatile uint32 *)0x40031028))
+#define TIMER1_TBILR_REG          (*((volatile uint32 *)0x4003102C))
+#define TIMER1_TAPR_REG           (*((volatile uint32 *)0x40031038))
+#define TIMER1_TBPR_REG           (*((volatile uint32 *)0x4003103C))
+#define TIMER1_TAR_REG            (*((volatile uint32 *)0x40031048))
+#define TIMER1_TBR_REG            (*((volatile uint32 *)0x4003104C))
+
+/*****************************************************************************
+Timer Registers (TIMER2)
+*****************************************************************************/
+#define TIMER2_CFG_REG            (*((volatile uint32 *)0x40032000))
+#define TIMER2_TAMR_REG           (*((volatile uint32 *)0x40032004))
+#define TIMER2_TBMR_REG           (*((volatile uint32 *)0x40032008))
+#define TIMER2_CTL_REG            (*((volatile uint32 *)0x4003200C))
+#define TIMER2_IMR_REG            (*((volatile uint32 *)0x40032018))
+#define TIMER2_RIS_REG            (*((volatile uint32 *)0x4003201C))
+#define TIMER2_MIS_REG            (*((volatile uint32 *)0x40032020))
+#define TIMER2_ICR_REG            (*((volatile uint32 *)0x40032024))
+#define TIMER2_TAILR_REG          (*((volatile uint32 *)0x40032028))
+#define TIMER2_TBILR_REG          (*((volatile uint32 *)0x4003202C))
+#define TIMER2_TAPR_REG           (*((volatile uint32 *)0x40032038))
+#define TIMER2_TBPR_REG           (*((volatile uint32 *)0x4003203C))
+#define TIMER2_TAR_REG            (*((volatile uint32 *)0x40032048))
+#define TIMER2_TBR_REG            (*((volatile uint32 *)0x4003204C))
+
 /*****************************************************************************
 Timer Registers (WTIMER0)
 *****************************************************************************/
@@ -0,0 +1,80 @@
+ /******************************************************************************
+ *
+ * Module: PI Controller
+ *
+ * File Name: pi_controller.c
+ *
+ * Description: Source file for the fixed-point PI controller
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "pi_controller.h"
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void PI_Init(PI_ControllerType *pController, const PI_ConfigType *pConfig)
+{
+    pController->Kp = pConfig->Kp;
+    /* The sample period is folded into the integral gain once, here */
+    pController->KiTs = (sint32)(((sint64)pConfig->Ki * pConfig->SamplePeriodMs) / 1000);
+    pController->OutputMin = (sint64)pConfig->OutputMin << PI_Q;
+    pController->OutputMax = (sint64)pConfig->OutputMax << PI_Q;
+    pController->SaturatedUpdates = 0;
+    PI_Reset(pController);
+}
+
+void PI_Reset(PI_ControllerType *pController)
+{
+    pController->Integral = 0;
+    if ((sint64)pController->Integral < pController->OutputMin)
+    {
+        pController->Integral = (sint32)pController->OutputMin;
+    }
+}
+
+sint32 PI_Update(PI_ControllerType *pController, sint32 sError)
+{
+    sint64 sIntegral = pController->Integral + ((sint64)pController->KiTs * sError);
+    sint64 sOutput;
+
+    if (sIntegral > pController->OutputMax)
+    {
+        sIntegral = pController->OutputMax;
+    }
+    else if (sIntegral < pController->OutputMin)
+    {
+        sIntegral = pController->OutputMin;
+    }
+
+    sOutput = ((sint64)pController->Kp * sError) + sIntegral;
+    if (sOutput > pController->OutputMax)
+    {
+        sOutput = pController->OutputMax;
+        pController->SaturatedUpdates++;
+        /* Only integrate errors that pull the output back into range */
+        if (sError < 0)
+        {
+            pController->Integral = (sint32)sIntegral;
+        }
+    }
+    else if (sOutput < pController->OutputMin)
+    {
+        sOutput = pController->OutputMin;
+        pController->SaturatedUpdates++;
+        if (sError > 0)
+        {
+            pController->Integral = (sint32)sIntegral;
+        }
+    }
+    else
+    {
+        pController->Integral = (sint32)sIntegral;
+    }
+
+    /* Rounded to the nearest output unit */
+    return (sint32)((sOutput + (1L << (PI_Q - 1))) >> PI_Q);
+}
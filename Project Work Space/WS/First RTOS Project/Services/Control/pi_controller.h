@@ -0,0 +1,71 @@
+ /******************************************************************************
+ *
+ * Module: PI Controller
+ *
+ * File Name: pi_controller.h
+ *
+ * Description: Header file for a fixed-point PI controller. Gains are Q15
+ *              numbers (PI_GAIN), the integrator is kept in Q15 output units
+ *              and every product goes through 64 bits, so no FPU context is
+ *              needed in the tasks that run it.
+ *
+ *              Anti-windup is conditional integration: while the output sits
+ *              at a limit, errors that would push it further out are not
+ *              integrated, and the integrator itself never leaves the output
+ *              range. A long cold start therefore does not store up heat that
+ *              later overshoots the setpoint.
+ *
+ *              This header has no target dependencies so host tools share it.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef PI_CONTROLLER_H_
+#define PI_CONTROLLER_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define PI_Q                    15
+#define PI_GAIN(gain)           ((sint32)((gain) * (1L << PI_Q)))
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    sint32 Kp;                  /* Output units per unit of error, PI_GAIN() */
+    sint32 Ki;                  /* Output units per unit of error and second, PI_GAIN() */
+    uint32 SamplePeriodMs;      /* Time between PI_Update calls */
+    sint32 OutputMin;
+    sint32 OutputMax;
+} PI_ConfigType;
+
+typedef struct
+{
+    sint32 Kp;                  /* Q15 */
+    sint32 KiTs;                /* Ki * sample period, Q15 */
+    sint64 OutputMin;           /* Q15 */
+    sint64 OutputMax;           /* Q15 */
+    sint32 Integral;            /* Q15 output units */
+    uint32 SaturatedUpdates;    /* Updates whose output was clamped */
+} PI_ControllerType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+void PI_Init(PI_ControllerType *pController, const PI_ConfigType *pConfig);
+
+/* Empties the integrator, e.g. when the loop is opened */
+void PI_Reset(PI_ControllerType *pController);
+
+/* One sample: returns the output for error = setpoint - measurement */
+sint32 PI_Update(PI_ControllerType *pController, sint32 sError);
+
+#endif /* PI_CONTROLLER_H_ */
@@ -0,0 +1,298 @@
+ /******************************************************************************
+ *
+ * Module: EventLog
+ *
+ * File Name: event_log.c
+ *
+ * Description: Source file for the event journal kept in the on-chip EEPROM
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_log.h"
+#include "../../inc/hw_ints.h"
+#include "../../driverlib/eeprom.h"
+#include "../../driverlib/interrupt.h"
+#include "../../driverlib/sw_crc.h"
+#include "../../driverlib/sysctl.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define EVENT_LOG_ERASED_WORD       0xFFFFFFFFu
+#define EVENT_LOG_CRC_SHIFT         16
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static boolean EventLog_Available = FALSE;
+static uint32 EventLog_NumSlots = 0;
+
+/* Slot the writer programs next and sequence number of the next record */
+static uint32 EventLog_NextSlot = 0;
+static uint32 EventLog_NextSequence = 0;
+
+/* Records waiting for the EEPROM, the oldest is the one being written */
+static EventLog_RecordType EventLog_Queue[EVENT_LOG_QUEUE_SIZE];
+static uint32 EventLog_QueueTail = 0;
+static uint32 EventLog_QueueCount = 0;
+
+/* Record being programmed and the word the EEPROM is working on */
+static uint32 EventLog_WriteWords[EVENT_LOG_RECORD_WORDS];
+static uint32 EventLog_WriteWord = 0;
+static boolean EventLog_Writing = FALSE;
+
+static EventLog_RecordType EventLog_Index[EVENT_LOG_NUM_TYPES][EVENT_LOG_NUM_SOURCES];
+static boolean EventLog_IndexValid[EVENT_LOG_NUM_TYPES][EVENT_LOG_NUM_SOURCES];
+
+static EventLog_StatsType EventLog_Stats;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint16 EventLog_Crc(const uint32 *pWords)
+{
+    uint32 uWords[EVENT_LOG_RECORD_WORDS];
+    uint32 uWord;
+
+    for (uWord = 0; uWord < EVENT_LOG_RECORD_WORDS; uWord++)
+    {
+        uWords[uWord] = pWords[uWord];
+    }
+    uWords[1] &= ~(0xFFFFu << EVENT_LOG_CRC_SHIFT);
+    return Crc16(0, (const uint8_t *)uWords, EVENT_LOG_RECORD_SIZE);
+}
+
+static void EventLog_Encode(const EventLog_RecordType *pRecord, uint32 *pWords)
+{
+    pWords[0] = pRecord->Sequence;
+    pWords[1] = (uint32)pRecord->Type | ((uint32)pRecord->Source << 8);
+    pWords[2] = pRecord->Value;
+    pWords[3] = pRecord->Timestamp;
+    pWords[1] |= (uint32)EventLog_Crc(pWords) << EVENT_LOG_CRC_SHIFT;
+}
+
+static boolean EventLog_Decode(const uint32 *pWords, EventLog_RecordType *pRecord)
+{
+    if ((pWords[1] >> EVENT_LOG_CRC_SHIFT) != EventLog_Crc(pWords))
+    {
+        return FALSE;
+    }
+    pRecord->Sequence = pWords[0];
+    pRecord->Type = (uint8)pWords[1];
+    pRecord->Source = (uint8)(pWords[1] >> 8);
+    pRecord->Value = pWords[2];
+    pRecord->Timestamp = pWords[3];
+    return ((pRecord->Type < EVENT_LOG_NUM_TYPES) && (pRecord->Source < EVENT_LOG_NUM_SOURCES))
+           ? TRUE : FALSE;
+}
+
+static void EventLog_UpdateIndex(const EventLog_RecordType *pRecord)
+{
+    EventLog_Index[pRecord->Type][pRecord->Source] = *pRecord;
+    EventLog_IndexValid[pRecord->Type][pRecord->Source] = TRUE;
+}
+
+/* Reads every slot once: the newest valid record marks the end of the log */
+static void EventLog_Scan(void)
+{
+    uint32 uWords[EVENT_LOG_RECORD_WORDS];
+    EventLog_RecordType xRecord;
+    uint32 uSlot;
+    uint32 uLastSlot = 0;
+    uint32 uLastSequence = 0;
+    boolean bFound = FALSE;
+
+    for (uSlot = 0; uSlot < EventLog_NumSlots; uSlot++)
+    {
+        EEPROMRead(uWords, uSlot * EVENT_LOG_RECORD_SIZE, EVENT_LOG_RECORD_SIZE);
+        if ((uWords[0] == EVENT_LOG_ERASED_WORD) && (uWords[1] == EVENT_LOG_ERASED_WORD) &&
+            (uWords[2] == EVENT_LOG_ERASED_WORD) && (uWords[3] == EVENT_LOG_ERASED_WORD))
+        {
+            continue;
+        }
+        if (EventLog_Decode(uWords, &xRecord) == FALSE)
+        {
+            EventLog_Stats.RecordsCorrupt++;
+            continue;
+        }
+        EventLog_Stats.RecordsRecovered++;
+
+        if ((bFound == FALSE) || (xRecord.Sequence > uLastSequence))
+        {
+            uLastSequence = xRecord.Sequence;
+            uLastSlot = uSlot;
+            bFound = TRUE;
+        }
+        if ((EventLog_IndexValid[xRecord.Type][xRecord.Source] == FALSE) ||
+            (xRecord.Sequence > EventLog_Index[xRecord.Type][xRecord.Source].Sequence))
+        {
+            EventLog_UpdateIndex(&xRecord);
+        }
+    }
+
+    if (bFound)
+    {
+        EventLog_NextSlot = (uLastSlot + 1) % EventLog_NumSlots;
+        EventLog_NextSequence = uLastSequence + 1;
+    }
+}
+
+/* Interrupts masked: starts programming the oldest queued record */
+static void EventLog_StartRecord(void)
+{
+    EventLog_Encode(&EventLog_Queue[EventLog_QueueTail], EventLog_WriteWords);
+    EventLog_WriteWord = 0;
+    EventLog_Writing = TRUE;
+    EEPROMProgramNonBlocking(EventLog_WriteWords[0], EventLog_NextSlot * EVENT_LOG_RECORD_SIZE);
+}
+
+/* Program done: next word of the record, or the next record */
+static void EventLog_ProgramDone(void)
+{
+    EEPROMIntClear(EEPROM_INT_PROGRAM);
+    if (EventLog_Writing == FALSE)
+    {
+        return;
+    }
+
+    EventLog_WriteWord++;
+    if (EventLog_WriteWord < EVENT_LOG_RECORD_WORDS)
+    {
+        EEPROMProgramNonBlocking(EventLog_WriteWords[EventLog_WriteWord],
+                                 (EventLog_NextSlot * EVENT_LOG_RECORD_SIZE) + (EventLog_WriteWord * 4));
+        return;
+    }
+
+    EventLog_Stats.RecordsWritten++;
+    EventLog_NextSlot = (EventLog_NextSlot + 1) % EventLog_NumSlots;
+    EventLog_QueueTail = (EventLog_QueueTail + 1) % EVENT_LOG_QUEUE_SIZE;
+    EventLog_QueueCount--;
+    EventLog_Writing = FALSE;
+    if (EventLog_QueueCount > 0)
+    {
+        EventLog_StartRecord();
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void EventLog_Init(void)
+{
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_EEPROM0));
+
+    /* An interrupted program or erase is recovered here, the log is left
+     * alone if the EEPROM reports it could not be */
+    if (EEPROMInit() != EEPROM_INIT_OK)
+    {
+        return;
+    }
+    EventLog_NumSlots = EEPROMSizeGet() / EVENT_LOG_RECORD_SIZE;
+    EventLog_Scan();
+
+    EEPROMIntClear(EEPROM_INT_PROGRAM);
+    EEPROMIntEnable(EEPROM_INT_PROGRAM);
+    IntPrioritySet(INT_FLASH, EVENT_LOG_INTERRUPT_PRIORITY);
+    IntEnable(INT_FLASH);
+    EventLog_Available = TRUE;
+}
+
+boolean EventLog_Append(uint8 uType, uint8 uSource, uint32 uValue)
+{
+    return EventLog_AppendAt(uType, uSource, uValue, xTaskGetTickCount());
+}
+
+boolean EventLog_AppendAt(uint8 uType, uint8 uSource, uint32 uValue, uint32 uTimestamp)
+{
+    EventLog_RecordType *pRecord = NULL_PTR;
+    uint32 uEntry;
+    uint32 uPosition;
+    boolean bQueued = TRUE;
+
+    taskENTER_CRITICAL();
+    /* A selection still waiting in the queue is overwritten, the one being
+     * programmed is left alone */
+    if (uType == EVENT_LOG_SELECTION)
+    {
+        for (uPosition = (EventLog_Writing ? 1 : 0); uPosition < EventLog_QueueCount; uPosition++)
+        {
+            uEntry = (EventLog_QueueTail + uPosition) % EVENT_LOG_QUEUE_SIZE;
+            if ((EventLog_Queue[uEntry].Type == uType) && (EventLog_Queue[uEntry].Source == uSource))
+            {
+                pRecord = &EventLog_Queue[uEntry];
+                EventLog_Stats.RecordsCoalesced++;
+                break;
+            }
+        }
+    }
+
+    if (pRecord == NULL_PTR)
+    {
+        if ((EventLog_Available == FALSE) || (EventLog_QueueCount == EVENT_LOG_QUEUE_SIZE))
+        {
+            EventLog_Stats.RecordsDropped++;
+            bQueued = FALSE;
+        }
+        else
+        {
+            pRecord = &EventLog_Queue[(EventLog_QueueTail + EventLog_QueueCount) % EVENT_LOG_QUEUE_SIZE];
+            pRecord->Sequence = EventLog_NextSequence++;
+            pRecord->Type = uType;
+            pRecord->Source = uSource;
+            EventLog_QueueCount++;
+        }
+    }
+
+    if (pRecord != NULL_PTR)
+    {
+        pRecord->Value = uValue;
+        pRecord->Timestamp = uTimestamp;
+        EventLog_UpdateIndex(pRecord);
+        if (EventLog_Writing == FALSE)
+        {
+            EventLog_StartRecord();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return bQueued;
+}
+
+boolean EventLog_GetLatest(uint8 uType, uint8 uSource, EventLog_RecordType *pRecord)
+{
+    boolean bValid = FALSE;
+
+    if ((uType < EVENT_LOG_NUM_TYPES) && (uSource < EVENT_LOG_NUM_SOURCES))
+    {
+        taskENTER_CRITICAL();
+        bValid = EventLog_IndexValid[uType][uSource];
+        *pRecord = EventLog_Index[uType][uSource];
+        taskEXIT_CRITICAL();
+    }
+    return bValid;
+}
+
+void EventLog_GetStats(EventLog_StatsType *pStats)
+{
+    taskENTER_CRITICAL();
+    *pStats = EventLog_Stats;
+    taskEXIT_CRITICAL();
+}
+
+void EventLog_Handler(void)
+{
+    traceISR_ENTER(INT_FLASH);
+    EventLog_ProgramDone();
+    traceISR_EXIT(INT_FLASH);
+}
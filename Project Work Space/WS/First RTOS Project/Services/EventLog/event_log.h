@@ -0,0 +1,101 @@
+ /******************************************************************************
+ *
+ * Module: EventLog
+ *
+ * File Name: event_log.h
+ *
+ * Description: Header file for the event journal kept in the on-chip EEPROM.
+ *              The whole EEPROM is one circular log of fixed size records,
+ *              appended in order so every word wears at the same rate:
+ *
+ *                word 0  sequence number, grows by one per record
+ *                word 1  type (bits 7:0), source (bits 15:8), CRC-16 (31:16)
+ *                word 2  value
+ *                word 3  RTOS tick count of the event
+ *
+ *              The CRC (driverlib Crc16) covers the record with its own field
+ *              zeroed, so a record torn by a reset is skipped at boot. The
+ *              boot scan finds the newest record to append after and keeps
+ *              the latest record of every type and source in RAM.
+ *
+ *              Tasks only queue records. The queue is written one word at a
+ *              time with EEPROMProgramNonBlocking, each word started from the
+ *              EEPROM program-done interrupt, so no task waits on the EEPROM.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef EVENT_LOG_H_
+#define EVENT_LOG_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Record types */
+#define EVENT_LOG_SELECTION         0       /* Heating level chosen, latest wins */
+#define EVENT_LOG_SENSOR_ERROR      1       /* Value is the error code */
+#define EVENT_LOG_NUM_TYPES         2
+
+/* Record sources are seat numbers */
+#define EVENT_LOG_NUM_SOURCES       8
+
+#define EVENT_LOG_RECORD_WORDS      4
+#define EVENT_LOG_RECORD_SIZE       (EVENT_LOG_RECORD_WORDS * 4)
+
+/* Records waiting for the EEPROM. A selection replaces a queued one of the
+ * same source, so only bursts of errors can fill it. */
+#define EVENT_LOG_QUEUE_SIZE        8
+
+/* Below configMAX_SYSCALL_INTERRUPT_PRIORITY, in the upper three bits */
+#define EVENT_LOG_INTERRUPT_PRIORITY (6 << 5)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 Sequence;
+    uint8 Type;
+    uint8 Source;
+    uint32 Value;
+    uint32 Timestamp;
+} EventLog_RecordType;
+
+typedef struct
+{
+    uint32 RecordsRecovered;        /* Valid records found by the boot scan */
+    uint32 RecordsCorrupt;          /* Written slots that failed the CRC */
+    uint32 RecordsWritten;
+    uint32 RecordsCoalesced;        /* Selections replaced while still queued */
+    uint32 RecordsDropped;          /* Queue full or EEPROM unusable */
+} EventLog_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Powers the EEPROM, scans the log and enables the program-done interrupt.
+ * Blocking, call before the scheduler starts. */
+void EventLog_Init(void);
+
+/* Queue a record for the EEPROM and make it the latest of its type and
+ * source. Returns FALSE if it had to be dropped. Task context only. */
+boolean EventLog_Append(uint8 uType, uint8 uSource, uint32 uValue);
+
+/* As EventLog_Append, stamped with the tick the event happened at */
+boolean EventLog_AppendAt(uint8 uType, uint8 uSource, uint32 uValue, uint32 uTimestamp);
+
+/* Latest record of a type and source, FALSE if there never was one */
+boolean EventLog_GetLatest(uint8 uType, uint8 uSource, EventLog_RecordType *pRecord);
+
+void EventLog_GetStats(EventLog_StatsType *pStats);
+
+/* Flash and EEPROM controller interrupt */
+void EventLog_Handler(void);
+
+#endif /* EVENT_LOG_H_ */
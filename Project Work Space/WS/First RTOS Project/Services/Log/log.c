@@ -0,0 +1,177 @@
+ /******************************************************************************
+ *
+ * Module: Log
+ *
+ * File Name: log.c
+ *
+ * Description: Source file for the deferred logger. Each ring is indexed
+ *              and accessed like the trace ring, see trace.c; having a single
+ *              writer, it needs no interrupt masking around a write.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "log.h"
+#include "../../MCAL/tm4c123gh6pm_registers.h"
+
+#if (LOG_RING_RECORDS & (LOG_RING_RECORDS - 1)) != 0
+#error "LOG_RING_RECORDS must be a power of two"
+#endif
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    Log_RecordType Records[LOG_RING_RECORDS];
+    volatile uint32 Head;               /* Written by the producer only */
+    volatile uint32 Tail;               /* Written by Log_Read() only */
+    uint32 Written;                     /* Producer's counters */
+    uint32 Dropped;
+    uint32 MaxUsed;
+} Log_RingType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* The level and argument count of every message; its format stays on the host */
+static const uint8 Log_MessageLevel[LOG_NUM_MESSAGES] =
+{
+#define LOG_MESSAGE(identifier, level, arguments, format) level,
+    LOG_MESSAGES
+#undef LOG_MESSAGE
+};
+
+static const uint8 Log_MessageArgs[LOG_NUM_MESSAGES] =
+{
+#define LOG_MESSAGE(identifier, level, arguments, format) arguments,
+    LOG_MESSAGES
+#undef LOG_MESSAGE
+};
+
+static Log_RingType Log_Rings[LOG_NUM_LEVELS][LOG_NUM_PRODUCERS];
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Log_Init(void)
+{
+    uint32 uLevel;
+    uint32 uProducer;
+    Log_RingType *pRing;
+
+    for (uLevel = 0; uLevel < LOG_NUM_LEVELS; uLevel++)
+    {
+        for (uProducer = 0; uProducer < LOG_NUM_PRODUCERS; uProducer++)
+        {
+            pRing = &Log_Rings[uLevel][uProducer];
+            pRing->Head = 0;
+            pRing->Tail = 0;
+            pRing->Written = 0;
+            pRing->Dropped = 0;
+            pRing->MaxUsed = 0;
+        }
+    }
+}
+
+void Log_Write(uint8 uProducer, Log_MessageType eMessage, uint32 uArg0, uint32 uArg1, uint32 uArg2)
+{
+    Log_RingType *pRing;
+    volatile Log_RecordType *pRecord;
+    uint32 uHead;
+    uint32 uUsed;
+
+    configASSERT((uProducer < LOG_NUM_PRODUCERS) && ((uint32)eMessage < LOG_NUM_MESSAGES));
+    pRing = &Log_Rings[Log_MessageLevel[eMessage]][uProducer];
+    uHead = pRing->Head;
+    uUsed = uHead - pRing->Tail;
+    if (uUsed >= LOG_RING_RECORDS)
+    {
+        pRing->Dropped++;
+        return;
+    }
+
+    pRecord = &pRing->Records[uHead & (LOG_RING_RECORDS - 1)];
+    pRecord->Cycles = DWT_CYCCNT_REG;
+    pRecord->Message = (uint16)eMessage;
+    pRecord->Producer = uProducer;
+    pRecord->NumberOfArgs = Log_MessageArgs[eMessage];
+    pRecord->Args[0] = uArg0;
+    pRecord->Args[1] = uArg1;
+    pRecord->Args[2] = uArg2;
+    /* Published once complete, the reader never sees a half written record */
+    pRing->Head = uHead + 1;
+
+    pRing->Written++;
+    if (uUsed >= pRing->MaxUsed)
+    {
+        pRing->MaxUsed = uUsed + 1;
+    }
+}
+
+uint32 Log_Read(Log_RecordType *pRecords, uint32 uMaxRecords)
+{
+    Log_RingType *pRing;
+    const volatile Log_RecordType *pRecord;
+    uint32 uCount = 0;
+    uint32 uLevel;
+    uint32 uProducer;
+    uint32 uTail;
+    uint32 uArg;
+
+    for (uLevel = 0; uLevel < LOG_NUM_LEVELS; uLevel++)
+    {
+        for (uProducer = 0; uProducer < LOG_NUM_PRODUCERS; uProducer++)
+        {
+            pRing = &Log_Rings[uLevel][uProducer];
+            uTail = pRing->Tail;
+            while ((uTail != pRing->Head) && (uCount < uMaxRecords))
+            {
+                pRecord = &pRing->Records[uTail & (LOG_RING_RECORDS - 1)];
+                pRecords[uCount].Cycles = pRecord->Cycles;
+                pRecords[uCount].Message = pRecord->Message;
+                pRecords[uCount].Producer = pRecord->Producer;
+                pRecords[uCount].NumberOfArgs = pRecord->NumberOfArgs;
+                for (uArg = 0; uArg < LOG_MAX_ARGS; uArg++)
+                {
+                    pRecords[uCount].Args[uArg] = pRecord->Args[uArg];
+                }
+                uCount++;
+                uTail++;
+            }
+            /* The slots are handed back to the writer only once they are copied */
+            pRing->Tail = uTail;
+        }
+    }
+    return uCount;
+}
+
+/* Each counter is read in one access; the totals may be a few records apart */
+void Log_GetStats(Log_StatsType *pStats)
+{
+    uint32 uLevel;
+    uint32 uProducer;
+    const Log_RingType *pRing;
+
+    pStats->Written = 0;
+    pStats->Dropped = 0;
+    pStats->MaxUsed = 0;
+    for (uLevel = 0; uLevel < LOG_NUM_LEVELS; uLevel++)
+    {
+        for (uProducer = 0; uProducer < LOG_NUM_PRODUCERS; uProducer++)
+        {
+            pRing = &Log_Rings[uLevel][uProducer];
+            pStats->Written += pRing->Written;
+            pStats->Dropped += pRing->Dropped;
+            if (pRing->MaxUsed > pStats->MaxUsed)
+            {
+                pStats->MaxUsed = pRing->MaxUsed;
+            }
+        }
+    }
+}
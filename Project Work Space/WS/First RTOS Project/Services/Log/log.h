@@ -0,0 +1,85 @@
+ /******************************************************************************
+ *
+ * Module: Log
+ *
+ * File Name: log.h
+ *
+ * Description: Header file for the deferred logger. Producers, tasks or
+ *              ISRs, write a message number (log_messages.h) and its integer
+ *              arguments into a RAM ring and carry on; the logger task drains
+ *              the rings into TELEMETRY_RECORD_LOG frames on UART0 and the
+ *              host expands the messages.
+ *
+ *              Every producer owns one ring per level, so a ring has a single
+ *              writer and a single reader and needs no lock and no interrupt
+ *              masking: the writer moves the head only after the record is in
+ *              place, the reader moves the tail only after it copied it. A
+ *              producer number is used by one context only, never by a task
+ *              and an ISR both.
+ *
+ *              Error rings are drained before info rings, so errors go out
+ *              first and a burst of info messages cannot hold them back. A
+ *              full ring drops the new record and counts it, it never blocks.
+ *
+ *              This header has no target dependencies so host tools share it.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include "std_types.h"
+#include "Services/Log/log_messages.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* One per LOG_PRODUCER_* of main.c */
+#define LOG_NUM_PRODUCERS               5
+
+/* Records per ring between two drains, a power of two */
+#define LOG_RING_RECORDS                8
+
+#define LOG_MAX_ARGS                    3
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 Cycles;                      /* DWT cycle counter when it was written */
+    uint16 Message;                     /* Log_MessageType */
+    uint8 Producer;
+    uint8 NumberOfArgs;
+    uint32 Args[LOG_MAX_ARGS];
+} Log_RecordType;
+
+typedef struct
+{
+    uint32 Written;
+    uint32 Dropped;                     /* Ring full when the message was written */
+    uint32 MaxUsed;                     /* Most records waiting at once in one ring */
+} Log_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Timestamps come from the DWT cycle counter RunTimeStats_Init() starts */
+void Log_Init(void);
+
+/* Any context at or below configMAX_SYSCALL_INTERRUPT_PRIORITY. Arguments
+ * past the message's count are ignored. */
+void Log_Write(uint8 uProducer, Log_MessageType eMessage, uint32 uArg0, uint32 uArg1, uint32 uArg2);
+
+/* Moves up to uMaxRecords of the waiting records out of the rings, errors
+ * first, and returns how many. One reader only. */
+uint32 Log_Read(Log_RecordType *pRecords, uint32 uMaxRecords);
+
+void Log_GetStats(Log_StatsType *pStats);
+
+#endif /* LOG_H_ */
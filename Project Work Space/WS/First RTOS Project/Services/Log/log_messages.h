@@ -0,0 +1,62 @@
+ /******************************************************************************
+ *
+ * Module: Log
+ *
+ * File Name: log_messages.h
+ *
+ * Description: The application's log messages. Each entry names a message,
+ *              its level, how many arguments it carries and its format:
+ *
+ *                LOG_MESSAGE(identifier, level, arguments, format)
+ *
+ *              The firmware expands the list into the message numbers and the
+ *              level and argument tables of log.c, the format strings are
+ *              dropped by the preprocessor and never reach the image or the
+ *              link. The host decoder expands the same list into its format
+ *              table, so a message is added here and nowhere else.
+ *
+ *              Arguments are uint32; every conversion in a format takes one.
+ *              Entries are only ever appended, the number of a message is its
+ *              position in the list.
+ *
+ *              This header has no target dependencies so host tools share it.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef LOG_MESSAGES_H_
+#define LOG_MESSAGES_H_
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Levels, drained in this order */
+#define LOG_LEVEL_ERROR                 0
+#define LOG_LEVEL_INFO                  1
+#define LOG_NUM_LEVELS                  2
+
+#define LOG_MESSAGES                                                                                    \
+    LOG_MESSAGE(LOG_SENSOR_FAILED, LOG_LEVEL_ERROR, 2, "seat %u sensor failed, reading %u C")           \
+    LOG_MESSAGE(LOG_SENSOR_RECOVERED, LOG_LEVEL_INFO, 2, "seat %u sensor recovered, reading %u C")      \
+    LOG_MESSAGE(LOG_SEAT_TABLE_TIMEOUT, LOG_LEVEL_ERROR, 1, "seat table busy for %u ms, sample skipped") \
+    LOG_MESSAGE(LOG_HEATER_LEVEL, LOG_LEVEL_INFO, 3, "seat %u heater level %u, duty %u")                \
+    LOG_MESSAGE(LOG_GESTURE, LOG_LEVEL_INFO, 2, "button %u gesture %u")                                 \
+    LOG_MESSAGE(LOG_SELECTION, LOG_LEVEL_INFO, 2, "seat %u set to %u C")                                \
+    LOG_MESSAGE(LOG_PRESS_IGNORED, LOG_LEVEL_INFO, 1, "seat %u press ignored, sensor failed")           \
+    LOG_MESSAGE(LOG_SENSOR_ERROR_HANDLED, LOG_LEVEL_ERROR, 2, "seat %u heater off, error 0x%x journaled")
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum
+{
+#define LOG_MESSAGE(identifier, level, arguments, format) identifier,
+    LOG_MESSAGES
+#undef LOG_MESSAGE
+    LOG_NUM_MESSAGES
+} Log_MessageType;
+
+#endif /* LOG_MESSAGES_H_ */
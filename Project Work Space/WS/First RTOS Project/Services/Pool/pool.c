@@ -0,0 +1,256 @@
+ /******************************************************************************
+ *
+ * Module: Pool
+ *
+ * File Name: pool.c
+ *
+ * Description: Source file for the fixed-block pool allocator. A class's
+ *              free list is threaded through a table of block numbers, not
+ *              through the blocks, so what a user leaves in a block can never
+ *              corrupt it. The list head holds the first free block number in
+ *              its low half and a tag in its high half; every swap increments
+ *              the tag, so a head that was taken and put back while an
+ *              allocation read it no longer compares equal and the swap fails
+ *              instead of handing out a block twice.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "pool.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define POOL_INDEX_MASK                 0x0000FFFFu
+#define POOL_TAG_ONE                    0x00010000u
+#define POOL_LIST_END                   0xFFFFu
+
+#define POOL_CLASS(identifier, size, blocks) || (((size) % 8) != 0) || ((blocks) == 0) || ((blocks) >= POOL_LIST_END)
+#if 0 POOL_CLASSES
+#error "Pool block sizes must be multiples of 8 and a class needs 1 to 0xFFFE blocks"
+#endif
+#undef POOL_CLASS
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint8 *Start;                       /* First block */
+    uint8 *End;                         /* Past the last block */
+    volatile uint16 *Next;              /* Next free block of each block */
+    uint32 BlockSize;
+    uint32 Blocks;
+    volatile uint32 Head;               /* Tag and first free block */
+    volatile uint32 Used;
+    volatile uint32 MaxUsed;
+    volatile uint32 Allocated;
+    volatile uint32 Failed;
+} Pool_ClassDataType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static const uint32 Pool_BlockSize[POOL_NUM_CLASSES] =
+{
+#define POOL_CLASS(identifier, size, blocks) size,
+    POOL_CLASSES
+#undef POOL_CLASS
+};
+
+static const uint32 Pool_Blocks[POOL_NUM_CLASSES] =
+{
+#define POOL_CLASS(identifier, size, blocks) blocks,
+    POOL_CLASSES
+#undef POOL_CLASS
+};
+
+/* The blocks of every class back to back, 8-byte aligned */
+#define POOL_CLASS(identifier, size, blocks) + ((size) * (blocks))
+static uint64 Pool_Storage[(0 POOL_CLASSES) / 8];
+#undef POOL_CLASS
+
+#define POOL_CLASS(identifier, size, blocks) + (blocks)
+static volatile uint16 Pool_Next[0 POOL_CLASSES];
+#undef POOL_CLASS
+
+static Pool_ClassDataType Pool_Classes[POOL_NUM_CLASSES];
+
+/*******************************************************************************
+ *                      Private Functions Definitions                          *
+ *******************************************************************************/
+
+#if defined(__TI_ARM__)
+/* Any exception taken between the LDREX and the STREX clears the exclusive
+ * monitor, so the store fails and the caller reads the word again */
+static boolean Pool_CompareAndSwap(volatile uint32 *pWord, uint32 uExpected, uint32 uDesired)
+{
+    if ((uint32)__ldrex((void *)pWord) != uExpected)
+    {
+        return FALSE;
+    }
+    return (__strex(uDesired, (void *)pWord) == 0) ? TRUE : FALSE;
+}
+#else
+/* GCC, both for the target and for the host tools */
+static boolean Pool_CompareAndSwap(volatile uint32 *pWord, uint32 uExpected, uint32 uDesired)
+{
+    return __atomic_compare_exchange_n(pWord, &uExpected, uDesired, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+           ? TRUE : FALSE;
+}
+#endif
+
+static uint32 Pool_AtomicAdd(volatile uint32 *pWord, uint32 uValue)
+{
+    uint32 uOld;
+
+    do
+    {
+        uOld = *pWord;
+    }
+    while (!Pool_CompareAndSwap(pWord, uOld, uOld + uValue));
+    return uOld + uValue;
+}
+
+static void Pool_AtomicMax(volatile uint32 *pWord, uint32 uValue)
+{
+    uint32 uOld;
+
+    do
+    {
+        uOld = *pWord;
+        if (uValue <= uOld)
+        {
+            return;
+        }
+    }
+    while (!Pool_CompareAndSwap(pWord, uOld, uValue));
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Pool_Init(void)
+{
+    Pool_ClassDataType *pPool;
+    uint8 *pStart = (uint8 *)Pool_Storage;
+    volatile uint16 *pNext = Pool_Next;
+    uint32 uClass;
+    uint32 uBlock;
+
+    for (uClass = 0; uClass < POOL_NUM_CLASSES; uClass++)
+    {
+        pPool = &Pool_Classes[uClass];
+        pPool->BlockSize = Pool_BlockSize[uClass];
+        pPool->Blocks = Pool_Blocks[uClass];
+        pPool->Start = pStart;
+        pPool->End = pStart + (pPool->BlockSize * pPool->Blocks);
+        pPool->Next = pNext;
+        for (uBlock = 0; uBlock < pPool->Blocks - 1; uBlock++)
+        {
+            pPool->Next[uBlock] = (uint16)(uBlock + 1);
+        }
+        pPool->Next[pPool->Blocks - 1] = POOL_LIST_END;
+        pPool->Head = 0;
+        pPool->Used = 0;
+        pPool->MaxUsed = 0;
+        pPool->Allocated = 0;
+        pPool->Failed = 0;
+
+        pStart = pPool->End;
+        pNext += pPool->Blocks;
+    }
+}
+
+void *Pool_Alloc(uint32 uSize)
+{
+    Pool_ClassDataType *pPool;
+    uint32 uClass = 0;
+    uint32 uHead;
+    uint32 uBlock;
+
+    while ((uClass < POOL_NUM_CLASSES) && (uSize > Pool_BlockSize[uClass]))
+    {
+        uClass++;
+    }
+    if (uClass == POOL_NUM_CLASSES)
+    {
+        return NULL_PTR;
+    }
+
+    pPool = &Pool_Classes[uClass];
+    do
+    {
+        uHead = pPool->Head;
+        uBlock = uHead & POOL_INDEX_MASK;
+        if (uBlock == POOL_LIST_END)
+        {
+            Pool_AtomicAdd(&pPool->Failed, 1);
+            return NULL_PTR;
+        }
+        /* The next block is read before the swap; if the first one was
+         * taken meanwhile, the tag moved on and the swap fails */
+    }
+    while (!Pool_CompareAndSwap(&pPool->Head, uHead,
+                                ((uHead + POOL_TAG_ONE) & ~POOL_INDEX_MASK) | pPool->Next[uBlock]));
+
+    Pool_AtomicAdd(&pPool->Allocated, 1);
+    Pool_AtomicMax(&pPool->MaxUsed, Pool_AtomicAdd(&pPool->Used, 1));
+    return pPool->Start + (uBlock * pPool->BlockSize);
+}
+
+boolean Pool_Free(void *pBlock)
+{
+    Pool_ClassDataType *pPool;
+    uint8 *pByte = (uint8 *)pBlock;
+    uint32 uClass = 0;
+    uint32 uOffset;
+    uint32 uHead;
+    uint32 uBlock;
+
+    while ((uClass < POOL_NUM_CLASSES)
+           && ((pByte < Pool_Classes[uClass].Start) || (pByte >= Pool_Classes[uClass].End)))
+    {
+        uClass++;
+    }
+    if (uClass == POOL_NUM_CLASSES)
+    {
+        return FALSE;
+    }
+
+    pPool = &Pool_Classes[uClass];
+    uOffset = (uint32)(pByte - pPool->Start);
+    if ((uOffset % pPool->BlockSize) != 0)
+    {
+        return FALSE;
+    }
+    uBlock = uOffset / pPool->BlockSize;
+
+    /* Counted out before it is back on the list, so Used never passes Blocks */
+    Pool_AtomicAdd(&pPool->Used, (uint32)-1);
+    do
+    {
+        uHead = pPool->Head;
+        /* The block is off every list, nobody else writes its link */
+        pPool->Next[uBlock] = (uint16)(uHead & POOL_INDEX_MASK);
+    }
+    while (!Pool_CompareAndSwap(&pPool->Head, uHead, ((uHead + POOL_TAG_ONE) & ~POOL_INDEX_MASK) | uBlock));
+    return TRUE;
+}
+
+void Pool_GetStats(Pool_ClassType eClass, Pool_StatsType *pStats)
+{
+    const Pool_ClassDataType *pPool = &Pool_Classes[eClass];
+
+    pStats->BlockSize = pPool->BlockSize;
+    pStats->Blocks = pPool->Blocks;
+    pStats->Used = pPool->Used;
+    pStats->MaxUsed = pPool->MaxUsed;
+    pStats->Allocated = pPool->Allocated;
+    pStats->Failed = pPool->Failed;
+}
@@ -0,0 +1,95 @@
+ /******************************************************************************
+ *
+ * Module: Pool
+ *
+ * File Name: pool.h
+ *
+ * Description: Header file for the fixed-block pool allocator. Memory is
+ *              handed out in blocks of a few size classes, each class a
+ *              static array of equal blocks, so buffers can be taken and
+ *              given back at run time while all of their RAM is still placed
+ *              and counted by the linker.
+ *
+ *              A request is served by the smallest class whose blocks fit it,
+ *              a block goes back to the class it came from. Neither searches
+ *              a heap nor merges free space: both take the same few steps
+ *              whatever was allocated before, and there is no fragmentation.
+ *
+ *              The free blocks of a class form a list whose head is swapped
+ *              in one compare-and-swap, so allocation and release take no
+ *              lock and mask no interrupt and are safe from tasks and ISRs
+ *              alike. A swap that was interrupted by another allocation or
+ *              release of the same class is retried.
+ *
+ *              This header has no target dependencies so host tools share it.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Short messages from tasks and interrupts */
+#define POOL_MESSAGE_BLOCK_SIZE         32
+#define POOL_MESSAGE_BLOCKS             4
+
+/* Telemetry frames, from the moment they are packed until UART0 sent them */
+#define POOL_FRAME_BLOCK_SIZE           160
+#define POOL_FRAME_BLOCKS               3
+
+/* Size classes, smallest first: POOL_CLASS(identifier, block size in bytes,
+ * blocks). Block sizes are multiples of 8 and a class has fewer than 0xFFFF
+ * blocks. */
+#define POOL_CLASSES                                                                    \
+    POOL_CLASS(POOL_CLASS_MESSAGE, POOL_MESSAGE_BLOCK_SIZE, POOL_MESSAGE_BLOCKS)        \
+    POOL_CLASS(POOL_CLASS_FRAME, POOL_FRAME_BLOCK_SIZE, POOL_FRAME_BLOCKS)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum
+{
+#define POOL_CLASS(identifier, size, blocks) identifier,
+    POOL_CLASSES
+#undef POOL_CLASS
+    POOL_NUM_CLASSES
+} Pool_ClassType;
+
+typedef struct
+{
+    uint32 BlockSize;
+    uint32 Blocks;
+    uint32 Used;                        /* Blocks allocated now */
+    uint32 MaxUsed;                     /* High-water mark of Used */
+    uint32 Allocated;                   /* Successful allocations */
+    uint32 Failed;                      /* Allocations that found the class empty */
+} Pool_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Before the first allocation, with nothing else using the pools */
+void Pool_Init(void);
+
+/* Any context. A block of the smallest class that fits uSize bytes, or
+ * NULL_PTR when that class has none left; a larger class is not used
+ * instead, so one class running short cannot starve the others. */
+void *Pool_Alloc(uint32 uSize);
+
+/* Any context. Returns FALSE, and does nothing, for a pointer that is not
+ * the start of a pool block. A block must not be released twice. */
+boolean Pool_Free(void *pBlock);
+
+/* Each counter is read in one access, they may be an allocation apart */
+void Pool_GetStats(Pool_ClassType eClass, Pool_StatsType *pStats);
+
+#endif /* POOL_H_ */
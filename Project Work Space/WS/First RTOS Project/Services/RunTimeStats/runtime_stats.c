@@ -0,0 +1,661 @@
+ /******************************************************************************
+ *
+ * Module: Run-Time Statistics
+ *
+ * File Name: runtime_stats.c
+ *
+ * Description: Source file for the run-time statistics engine on the DWT
+ *              cycle counter. The core clock stops in Sleep mode and CYCCNT
+ *              with it, so every time is taken on CYCCNT plus the cycles the
+ *              port reported slept since boot.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "runtime_stats.h"
+#include "../../MCAL/tm4c123gh6pm_registers.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define RUNTIME_STATS_DEMCR_TRCENA      (1UL << 24)     /* Enables the DWT and ITM */
+#define RUNTIME_STATS_DWT_CYCCNTENA     (1UL << 0)
+
+#define RUNTIME_STATS_IDLE_TAG          0
+#define RUNTIME_STATS_SLOT_CYCLES       ((configCPU_CLOCK_HZ / 1000) * RUNTIME_STATS_SLOT_MS)
+#define RUNTIME_STATS_CYCLES_PER_MS     (configCPU_CLOCK_HZ / 1000)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 uSwitchedIn;             /* Time when the task last got the CPU */
+    uint32 uReleased;               /* Time when the activation started */
+    uint32 uExecution;              /* Cycles run in the current activation */
+    uint32 uDeadline;               /* Cycles, 0 for none */
+    boolean bActive;
+    boolean bJobs;                  /* Completes at its release point only */
+    boolean bWaited;                /* Job ended at the release point, the wait has not returned yet */
+    uint32 uWaitObject;             /* Object it is blocked on, 0 for none */
+    uint32 uWaitStart;              /* Time when it blocked on it */
+} RunTimeStats_ActivationType;
+
+/* Idle cycles per slot of the load window, uSlot is the one being filled and
+ * started at uSlotStart */
+typedef struct
+{
+    uint32 uIdle[RUNTIME_STATS_WINDOW_SLOTS];
+    uint32 uSlot;
+    uint32 uSlotStart;
+    uint32 uSlotsDone;              /* Complete slots in the window */
+} RunTimeStats_WindowType;
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static RunTimeStats_TaskType RunTimeStats_Tasks[RUNTIME_STATS_MAX_TASKS];
+static RunTimeStats_ActivationType RunTimeStats_Activations[RUNTIME_STATS_MAX_TASKS];
+static RunTimeStats_WindowType RunTimeStats_Window;
+static RunTimeStats_ObjectType RunTimeStats_Objects[RUNTIME_STATS_MAX_OBJECTS];
+
+/* Time when each mutex was taken, valid while it is held */
+static uint32 RunTimeStats_HeldSince[RUNTIME_STATS_MAX_OBJECTS];
+
+/* Tags below this one have been seen, the snapshots copy no further */
+static uint32 RunTimeStats_TagsUsed = RUNTIME_STATS_IDLE_TAG + 1;
+
+/* Odd while a hook updates the statistics. The hooks cannot preempt each
+ * other, so a reader that sees the same even value before and after its copy
+ * has copied a consistent state. */
+static volatile uint32 RunTimeStats_Sequence = 0;
+
+/* The snapshot last published is RunTimeStats_Snapshots[RunTimeStats_Published] */
+static RunTimeStats_SnapshotType RunTimeStats_Snapshots[2];
+static volatile uint32 RunTimeStats_Published = 0;
+
+/* Cycles CYCCNT missed while the core slept, and CYCCNT when the current
+ * sleep was entered */
+static uint32 RunTimeStats_Slept = 0;
+static uint32 RunTimeStats_SleepStart;
+
+static uint32 RunTimeStats_MaskedStart;
+static volatile uint32 RunTimeStats_MaskedMax = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+/* CYCCNT with the sleeps put back in. A sleep is only entered and reported
+ * from the idle task with interrupts masked, so no reader sees the two apart. */
+static uint32 RunTimeStats_Now(void)
+{
+    return DWT_CYCCNT_REG + RunTimeStats_Slept;
+}
+
+static uint32 RunTimeStats_Bucket(uint32 uCycles)
+{
+    uint32 uBucket = 0;
+
+    uCycles >>= (RUNTIME_STATS_HISTOGRAM_SHIFT + 1);
+    while ((uCycles != 0) && (uBucket < (RUNTIME_STATS_BUCKETS - 1)))
+    {
+        uCycles >>= 1;
+        uBucket++;
+    }
+    return uBucket;
+}
+
+/* Moves the window on to the slot uNow falls in, clearing the slots it enters */
+static void RunTimeStats_Advance(RunTimeStats_WindowType *pWindow, uint32 uNow)
+{
+    while ((uint32)(uNow - pWindow->uSlotStart) >= RUNTIME_STATS_SLOT_CYCLES)
+    {
+        pWindow->uSlotStart += RUNTIME_STATS_SLOT_CYCLES;
+        pWindow->uSlot = (pWindow->uSlot + 1) % RUNTIME_STATS_WINDOW_SLOTS;
+        pWindow->uIdle[pWindow->uSlot] = 0;
+        if (pWindow->uSlotsDone < (RUNTIME_STATS_WINDOW_SLOTS - 1))
+        {
+            pWindow->uSlotsDone++;
+        }
+    }
+}
+
+/* Charges an idle stretch that ended at uNow to the slots it covered, newest
+ * first. A tickless sleep can span several slots. */
+static void RunTimeStats_AddIdle(RunTimeStats_WindowType *pWindow, uint32 uIdle, uint32 uNow)
+{
+    uint32 uSpan = uNow - pWindow->uSlotStart;
+    uint32 uSlot = pWindow->uSlot;
+    uint32 uPart;
+    uint32 uCount;
+
+    for (uCount = 0; (uIdle != 0) && (uCount < RUNTIME_STATS_WINDOW_SLOTS); uCount++)
+    {
+        uPart = (uIdle < uSpan) ? uIdle : uSpan;
+        pWindow->uIdle[uSlot] += uPart;
+        uIdle -= uPart;
+        uSlot = (uSlot + RUNTIME_STATS_WINDOW_SLOTS - 1) % RUNTIME_STATS_WINDOW_SLOTS;
+        uSpan = RUNTIME_STATS_SLOT_CYCLES;
+    }
+}
+
+/* Load of a private copy of the window, brought up to uNow */
+static uint32 RunTimeStats_WindowLoad(RunTimeStats_WindowType *pWindow, uint32 uNow)
+{
+    uint32 uElapsed;
+    uint32 uIdle = 0;
+    uint32 uSlot;
+
+    RunTimeStats_Advance(pWindow, uNow);
+    uElapsed = (pWindow->uSlotsDone * RUNTIME_STATS_SLOT_CYCLES) + (uNow - pWindow->uSlotStart);
+    for (uSlot = 0; uSlot <= pWindow->uSlotsDone; uSlot++)
+    {
+        uIdle += pWindow->uIdle[(pWindow->uSlot + RUNTIME_STATS_WINDOW_SLOTS - uSlot) % RUNTIME_STATS_WINDOW_SLOTS];
+    }
+    if ((uElapsed == 0) || (uIdle >= uElapsed))
+    {
+        return 0;
+    }
+    /* In 64 bits: the window is up to 32 million cycles */
+    return (uint32)(((uint64)(uElapsed - uIdle) * 1000) / uElapsed);
+}
+
+/* Word by word through a volatile pointer, so the compiler keeps the copy
+ * between the two reads of the sequence */
+static void RunTimeStats_CopyWords(uint32 *pDestination, const volatile uint32 *pSource, uint32 uBytes)
+{
+    uint32 uWord;
+
+    for (uWord = 0; uWord < (uBytes / sizeof(uint32)); uWord++)
+    {
+        pDestination[uWord] = pSource[uWord];
+    }
+}
+
+/* Copies uBytes of the statistics without masking interrupts, again if a
+ * hook ran in between. The hooks run for a few hundred cycles per context
+ * switch, so a copy of this size is rarely taken twice. */
+static void RunTimeStats_Read(void *pDestination, const void *pSource, uint32 uBytes)
+{
+    uint32 uSequence;
+
+    do
+    {
+        uSequence = RunTimeStats_Sequence;
+        RunTimeStats_CopyWords((uint32 *)pDestination, (const volatile uint32 *)pSource, uBytes);
+    }
+    while (((uSequence & 1) != 0) || (uSequence != RunTimeStats_Sequence));
+}
+
+static void RunTimeStats_Complete(RunTimeStats_TaskType *pTask, RunTimeStats_ActivationType *pActivation,
+                                  uint32 uNow)
+{
+    uint32 uResponse = uNow - pActivation->uReleased;
+
+    if ((pTask->Activations == 0) || (pActivation->uExecution < pTask->ExecutionMin))
+    {
+        pTask->ExecutionMin = pActivation->uExecution;
+    }
+    if (pActivation->uExecution > pTask->ExecutionMax)
+    {
+        pTask->ExecutionMax = pActivation->uExecution;
+    }
+    pTask->ExecutionTotal += pActivation->uExecution;
+
+    if ((pTask->Activations == 0) || (uResponse < pTask->ResponseMin))
+    {
+        pTask->ResponseMin = uResponse;
+    }
+    if (uResponse > pTask->ResponseMax)
+    {
+        pTask->ResponseMax = uResponse;
+    }
+    pTask->ResponseHistogram[RunTimeStats_Bucket(uResponse)]++;
+    if ((pActivation->uDeadline != 0) && (uResponse > pActivation->uDeadline))
+    {
+        pTask->DeadlineMisses++;
+    }
+    pTask->Activations++;
+    pActivation->bActive = FALSE;
+}
+
+/* An activation starts when the task is made ready. A task first scheduled
+ * without a release of its own, e.g. tagged after it was created, starts
+ * one when it gets the CPU. */
+static void RunTimeStats_Start(RunTimeStats_ActivationType *pActivation, uint32 uNow)
+{
+    if (!pActivation->bActive)
+    {
+        pActivation->bActive = TRUE;
+        pActivation->uReleased = uNow;
+        pActivation->uExecution = 0;
+    }
+}
+
+/* Ends the running task's job at uNow; the cycles since it was switched in
+ * belong to the job */
+static void RunTimeStats_EndJob(uint32 uTag, RunTimeStats_ActivationType *pActivation, uint32 uNow)
+{
+    pActivation->uExecution += uNow - pActivation->uSwitchedIn;
+    RunTimeStats_Tasks[uTag].RunTime += uNow - pActivation->uSwitchedIn;
+    pActivation->uSwitchedIn = uNow;
+    RunTimeStats_Complete(&RunTimeStats_Tasks[uTag], pActivation, uNow);
+}
+
+/* Ends the task's wait on uObject, if it had one; the wait counts as
+ * contention whether the take succeeded or not */
+static void RunTimeStats_EndWait(RunTimeStats_ActivationType *pActivation, RunTimeStats_ObjectType *pObject,
+                                 uint32 uObject, uint32 uNow)
+{
+    uint32 uWait;
+
+    if (pActivation->uWaitObject != uObject)
+    {
+        return;
+    }
+    uWait = uNow - pActivation->uWaitStart;
+    pObject->Contended++;
+    pObject->WaitTotal += uWait;
+    if (uWait > pObject->WaitMax)
+    {
+        pObject->WaitMax = uWait;
+    }
+    pActivation->uWaitObject = 0;
+}
+
+static void RunTimeStats_Use(uint32 uTag)
+{
+    if (uTag >= RunTimeStats_TagsUsed)
+    {
+        RunTimeStats_TagsUsed = uTag + 1;
+    }
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void RunTimeStats_Init(void)
+{
+    DEBUG_DEMCR_REG |= RUNTIME_STATS_DEMCR_TRCENA;
+    DWT_CYCCNT_REG = 0;
+    DWT_CTRL_REG |= RUNTIME_STATS_DWT_CYCCNTENA;
+    RunTimeStats_Window.uSlotStart = 0;
+}
+
+void RunTimeStats_SetTiming(uint32 uTag, uint32 uPeriodMs, uint32 uDeadlineMs)
+{
+    if ((uTag == RUNTIME_STATS_IDLE_TAG) || (uTag >= RUNTIME_STATS_MAX_TASKS))
+    {
+        return;
+    }
+    RunTimeStats_Sequence++;
+    RunTimeStats_Use(uTag);
+    RunTimeStats_Tasks[uTag].PeriodMs = uPeriodMs;
+    RunTimeStats_Tasks[uTag].DeadlineMs = uDeadlineMs;
+    RunTimeStats_Activations[uTag].uDeadline = uDeadlineMs * RUNTIME_STATS_CYCLES_PER_MS;
+    RunTimeStats_Activations[uTag].bJobs = TRUE;
+    RunTimeStats_Sequence++;
+}
+
+uint32 RunTimeStats_GetCycles(void)
+{
+    return RunTimeStats_Now();
+}
+
+void RunTimeStats_SleepEntered(void)
+{
+    RunTimeStats_SleepStart = DWT_CYCCNT_REG;
+}
+
+void RunTimeStats_SleepEnded(uint32 uCycles)
+{
+    uint32 uCounted = DWT_CYCCNT_REG - RunTimeStats_SleepStart;
+
+    /* Whatever CYCCNT did count of the sleep, if it kept running, is not
+     * added twice */
+    if (uCycles > uCounted)
+    {
+        RunTimeStats_Sequence++;
+        RunTimeStats_Slept += uCycles - uCounted;
+        RunTimeStats_Sequence++;
+    }
+}
+
+boolean RunTimeStats_GetTask(uint32 uTag, RunTimeStats_TaskType *pStats)
+{
+    if (uTag >= RUNTIME_STATS_MAX_TASKS)
+    {
+        return FALSE;
+    }
+    RunTimeStats_Read(pStats, &RunTimeStats_Tasks[uTag], sizeof(RunTimeStats_TaskType));
+    return TRUE;
+}
+
+boolean RunTimeStats_GetObject(uint32 uObject, RunTimeStats_ObjectType *pStats)
+{
+    if (uObject >= RUNTIME_STATS_MAX_OBJECTS)
+    {
+        return FALSE;
+    }
+    RunTimeStats_Read(pStats, &RunTimeStats_Objects[uObject], sizeof(RunTimeStats_ObjectType));
+    return TRUE;
+}
+
+uint32 RunTimeStats_GetCpuLoad(void)
+{
+    RunTimeStats_WindowType xWindow;
+
+    /* Called from a task, so the idle task is not in the middle of a stretch */
+    RunTimeStats_Read(&xWindow, &RunTimeStats_Window, sizeof(xWindow));
+    return RunTimeStats_WindowLoad(&xWindow, RunTimeStats_Now());
+}
+
+uint32 RunTimeStats_GetMaskedMax(void)
+{
+    return RunTimeStats_MaskedMax;
+}
+
+const RunTimeStats_SnapshotType *RunTimeStats_TakeSnapshot(void)
+{
+    RunTimeStats_SnapshotType *pSnapshot = &RunTimeStats_Snapshots[RunTimeStats_Published ^ 1];
+    RunTimeStats_WindowType xWindow;
+    uint32 uSequence;
+
+    /* One pass copies the tasks and the window from the same state */
+    do
+    {
+        uSequence = RunTimeStats_Sequence;
+        pSnapshot->NumberOfTags = RunTimeStats_TagsUsed;
+        RunTimeStats_CopyWords((uint32 *)pSnapshot->Tasks, (const volatile uint32 *)RunTimeStats_Tasks,
+                               pSnapshot->NumberOfTags * sizeof(RunTimeStats_TaskType));
+        RunTimeStats_CopyWords((uint32 *)pSnapshot->Objects, (const volatile uint32 *)RunTimeStats_Objects,
+                               sizeof(RunTimeStats_Objects));
+        RunTimeStats_CopyWords((uint32 *)&xWindow, (const volatile uint32 *)&RunTimeStats_Window,
+                               sizeof(xWindow));
+        pSnapshot->Cycles = RunTimeStats_Now();
+    }
+    while (((uSequence & 1) != 0) || (uSequence != RunTimeStats_Sequence));
+
+    pSnapshot->CpuLoad = RunTimeStats_WindowLoad(&xWindow, pSnapshot->Cycles);
+    pSnapshot->MaskedMax = RunTimeStats_MaskedMax;
+    RunTimeStats_Published ^= 1;
+    return pSnapshot;
+}
+
+const RunTimeStats_SnapshotType *RunTimeStats_GetSnapshot(void)
+{
+    return &RunTimeStats_Snapshots[RunTimeStats_Published];
+}
+
+void RunTimeStats_TaskReleased(uint32 uTag)
+{
+    if ((uTag == RUNTIME_STATS_IDLE_TAG) || (uTag >= RUNTIME_STATS_MAX_TASKS))
+    {
+        return;
+    }
+    RunTimeStats_Sequence++;
+    RunTimeStats_Start(&RunTimeStats_Activations[uTag], RunTimeStats_Now());
+    RunTimeStats_Sequence++;
+}
+
+void RunTimeStats_TaskSwitchedIn(uint32 uTag)
+{
+    uint32 uNow = RunTimeStats_Now();
+
+    if (uTag >= RUNTIME_STATS_MAX_TASKS)
+    {
+        return;
+    }
+    RunTimeStats_Sequence++;
+    RunTimeStats_Use(uTag);
+    if (uTag != RUNTIME_STATS_IDLE_TAG)
+    {
+        RunTimeStats_Start(&RunTimeStats_Activations[uTag], uNow);
+    }
+    RunTimeStats_Activations[uTag].uSwitchedIn = uNow;
+    RunTimeStats_Sequence++;
+}
+
+void RunTimeStats_TaskSwitchedOut(uint32 uTag, boolean bBlocked)
+{
+    uint32 uNow = RunTimeStats_Now();
+    uint32 uRun;
+    RunTimeStats_ActivationType *pActivation;
+
+    if (uTag >= RUNTIME_STATS_MAX_TASKS)
+    {
+        return;
+    }
+    RunTimeStats_Sequence++;
+    pActivation = &RunTimeStats_Activations[uTag];
+    uRun = uNow - pActivation->uSwitchedIn;
+    RunTimeStats_Tasks[uTag].RunTime += uRun;
+
+    if (uTag == RUNTIME_STATS_IDLE_TAG)
+    {
+        RunTimeStats_Advance(&RunTimeStats_Window, uNow);
+        RunTimeStats_AddIdle(&RunTimeStats_Window, uRun, uNow);
+    }
+    else
+    {
+        pActivation->uExecution += uRun;
+        if (bBlocked && pActivation->bActive && !pActivation->bJobs)
+        {
+            RunTimeStats_Complete(&RunTimeStats_Tasks[uTag], pActivation, uNow);
+        }
+    }
+    RunTimeStats_Sequence++;
+}
+
+void RunTimeStats_TaskCompleted(uint32 uTag)
+{
+    RunTimeStats_ActivationType *pActivation;
+    UBaseType_t uMask;
+
+    if ((uTag == RUNTIME_STATS_IDLE_TAG) || (uTag >= RUNTIME_STATS_MAX_TASKS))
+    {
+        return;
+    }
+    /* vTaskDelayUntil() calls this with only the scheduler suspended; masking
+     * keeps it one update to a reader like the other hooks */
+    uMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    RunTimeStats_Sequence++;
+    pActivation = &RunTimeStats_Activations[uTag];
+    if (pActivation->bJobs)
+    {
+        if (pActivation->bActive)
+        {
+            RunTimeStats_EndJob(uTag, pActivation, RunTimeStats_Now());
+        }
+        pActivation->bWaited = TRUE;
+    }
+    RunTimeStats_Sequence++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uMask);
+}
+
+void RunTimeStats_TaskResumed(uint32 uTag, uint32 uLateCycles)
+{
+    uint32 uNow;
+    RunTimeStats_ActivationType *pActivation;
+    UBaseType_t uMask;
+
+    if ((uTag == RUNTIME_STATS_IDLE_TAG) || (uTag >= RUNTIME_STATS_MAX_TASKS))
+    {
+        return;
+    }
+    uMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    RunTimeStats_Sequence++;
+    pActivation = &RunTimeStats_Activations[uTag];
+    if (pActivation->bJobs)
+    {
+        if (pActivation->bWaited)
+        {
+            /* It blocked, the release that woke it started the next job */
+            pActivation->bWaited = FALSE;
+        }
+        else if (pActivation->bActive)
+        {
+            /* An overrun: the next release was due before the task got to
+             * its release point, so no hook ended the job. It ends here and
+             * the next one, released uLateCycles ago, starts. */
+            uNow = RunTimeStats_Now();
+            RunTimeStats_EndJob(uTag, pActivation, uNow);
+            RunTimeStats_Start(pActivation, uNow - uLateCycles);
+        }
+    }
+    RunTimeStats_Sequence++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uMask);
+}
+
+void RunTimeStats_TaskNotifyReturned(uint32 uTag, uint32 uIndex)
+{
+    /* Filtered here rather than in the hook, where the test on the index
+     * upsets the array bounds analysis of the kernel's notify functions */
+    if (uIndex == tskDEFAULT_INDEX_TO_NOTIFY)
+    {
+        RunTimeStats_TaskResumed(uTag, 0);
+    }
+}
+
+/* The object hooks run from tasks with the scheduler suspended or inside a
+ * kernel critical section, and gives also from ISRs; masking keeps each one
+ * update to a reader like the other hooks */
+void RunTimeStats_ObjectBlocked(uint32 uTag, uint32 uObject)
+{
+    RunTimeStats_ActivationType *pActivation;
+    UBaseType_t uMask;
+
+    if ((uTag >= RUNTIME_STATS_MAX_TASKS) || (uObject == 0) || (uObject >= RUNTIME_STATS_MAX_OBJECTS))
+    {
+        return;
+    }
+    uMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    RunTimeStats_Sequence++;
+    /* A take blocks again when another task got the object first; the wait
+     * runs from the first time */
+    pActivation = &RunTimeStats_Activations[uTag];
+    if (pActivation->uWaitObject != uObject)
+    {
+        pActivation->uWaitObject = uObject;
+        pActivation->uWaitStart = RunTimeStats_Now();
+    }
+    RunTimeStats_Sequence++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uMask);
+}
+
+void RunTimeStats_ObjectTaken(uint32 uTag, uint32 uObject, boolean bMutex)
+{
+    uint32 uNow;
+    RunTimeStats_ObjectType *pObject;
+    UBaseType_t uMask;
+
+    if ((uTag >= RUNTIME_STATS_MAX_TASKS) || (uObject == 0) || (uObject >= RUNTIME_STATS_MAX_OBJECTS))
+    {
+        return;
+    }
+    uMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    RunTimeStats_Sequence++;
+    uNow = RunTimeStats_Now();
+    pObject = &RunTimeStats_Objects[uObject];
+    pObject->Takes++;
+    RunTimeStats_EndWait(&RunTimeStats_Activations[uTag], pObject, uObject, uNow);
+    if (bMutex)
+    {
+        RunTimeStats_HeldSince[uObject] = uNow;
+    }
+    RunTimeStats_Sequence++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uMask);
+}
+
+void RunTimeStats_ObjectTakeFailed(uint32 uTag, uint32 uObject)
+{
+    RunTimeStats_ObjectType *pObject;
+    UBaseType_t uMask;
+
+    if ((uTag >= RUNTIME_STATS_MAX_TASKS) || (uObject == 0) || (uObject >= RUNTIME_STATS_MAX_OBJECTS))
+    {
+        return;
+    }
+    uMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    RunTimeStats_Sequence++;
+    pObject = &RunTimeStats_Objects[uObject];
+    pObject->Failed++;
+    RunTimeStats_EndWait(&RunTimeStats_Activations[uTag], pObject, uObject, RunTimeStats_Now());
+    RunTimeStats_Sequence++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uMask);
+}
+
+void RunTimeStats_ObjectGiven(uint32 uObject, boolean bMutex)
+{
+    uint32 uHeld;
+    UBaseType_t uMask;
+
+    if (!bMutex || (uObject == 0) || (uObject >= RUNTIME_STATS_MAX_OBJECTS))
+    {
+        return;
+    }
+    uMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    RunTimeStats_Sequence++;
+    uHeld = RunTimeStats_Now() - RunTimeStats_HeldSince[uObject];
+    if (uHeld > RunTimeStats_Objects[uObject].HoldMax)
+    {
+        RunTimeStats_Objects[uObject].HoldMax = uHeld;
+    }
+    RunTimeStats_Sequence++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uMask);
+}
+
+void RunTimeStats_PriorityInherited(uint32 uTag)
+{
+    uint32 uObject;
+    UBaseType_t uMask;
+
+    if (uTag >= RUNTIME_STATS_MAX_TASKS)
+    {
+        return;
+    }
+    uMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    RunTimeStats_Sequence++;
+    /* The kernel raises the holder right after the waiter blocked */
+    uObject = RunTimeStats_Activations[uTag].uWaitObject;
+    if (uObject != 0)
+    {
+        RunTimeStats_Objects[uObject].Inheritances++;
+    }
+    RunTimeStats_Sequence++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uMask);
+}
+
+void RunTimeStats_ObjectNamed(uint32 uObject, const char *pName)
+{
+    if ((uObject == 0) || (uObject >= RUNTIME_STATS_MAX_OBJECTS))
+    {
+        return;
+    }
+    RunTimeStats_Sequence++;
+    RunTimeStats_Objects[uObject].Name = pName;
+    RunTimeStats_Sequence++;
+}
+
+void RunTimeStats_CriticalEntered(void)
+{
+    RunTimeStats_MaskedStart = DWT_CYCCNT_REG;
+}
+
+void RunTimeStats_CriticalExiting(void)
+{
+    uint32 uMasked = DWT_CYCCNT_REG - RunTimeStats_MaskedStart;
+
+    if (uMasked > RunTimeStats_MaskedMax)
+    {
+        RunTimeStats_MaskedMax = uMasked;
+    }
+}
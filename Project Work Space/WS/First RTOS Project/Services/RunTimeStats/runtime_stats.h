@@ -0,0 +1,209 @@
+ /******************************************************************************
+ *
+ * Module: Run-Time Statistics
+ *
+ * File Name: runtime_stats.h
+ *
+ * Description: Header file for the run-time statistics engine. Every context
+ *              switch is timed with the Cortex-M4 DWT cycle counter (CYCCNT)
+ *              from the kernel trace hooks in FreeRTOSConfig.h, so times are
+ *              in CPU cycles and do not depend on a peripheral timer. CYCCNT
+ *              stops with the core clock in Sleep mode; the port reports the
+ *              length of every tickless sleep as measured by its wake timer,
+ *              and the engine adds what CYCCNT missed to all of its times.
+ *
+ *              Tasks are told apart by their application tag, the idle task
+ *              keeps tag 0. An activation of a task runs from the moment it
+ *              becomes ready until it blocks again; per task the engine keeps
+ *              the execution time of each activation (min, max, mean), its
+ *              response time (min, max and a log2 histogram) and the total
+ *              time it ran. Interrupts are charged to the task they preempt.
+ *
+ *              A task declared with RunTimeStats_SetTiming() is timed per
+ *              job instead: a job is released when the task is made ready
+ *              and completes only when the task waits at its release point,
+ *              xTaskDelayUntil() for a periodic task or a wait on
+ *              notification index 0 for a sporadic one. Blocking on a mutex
+ *              or a UART frame in between stays part of the job. A task
+ *              that reaches its release point after its next release does
+ *              not block there; that job ends and the next one starts when
+ *              the wait returns, so overrunning jobs are not merged. A job
+ *              whose response time exceeds the task's deadline is counted
+ *              as a miss, and the largest execution time of any job is the
+ *              task's measured WCET.
+ *
+ *              CPU load is the share of the last RUNTIME_STATS_WINDOW_SLOTS
+ *              slots of RUNTIME_STATS_SLOT_MS not spent in the idle task,
+ *              tickless sleep included, so it follows load changes within
+ *              a couple of seconds.
+ *
+ *              The getters never mask interrupts. The hooks bump a sequence
+ *              count around every update and a getter copies again when the
+ *              count moved, so a task reads a consistent state however long
+ *              its copy takes. RunTimeStats_TakeSnapshot() copies every task
+ *              at once into one of two buffers and publishes it, leaving the
+ *              previous snapshot intact for anyone still reading it;
+ *              reports are formatted and sent from the snapshot.
+ *
+ *              The port calls the critical section hooks around the
+ *              outermost taskENTER_CRITICAL() / taskEXIT_CRITICAL() pair,
+ *              and the longest stretch with interrupts masked that way is
+ *              kept. Masking inside ISRs and the context switch is not
+ *              counted.
+ *
+ *              Queues, semaphores and mutexes are profiled by the number
+ *              vQueueSetQueueNumber() gives them, and named by
+ *              vQueueAddToRegistry(); number 0 is not profiled. Per object
+ *              the engine counts the takes, the takes that had to block and
+ *              the ones that gave up, the time spent blocked and, for a
+ *              mutex, the time from take to give and how often a waiter
+ *              raised the holder's priority.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef RUNTIME_STATS_H_
+#define RUNTIME_STATS_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define RUNTIME_STATS_MAX_TASKS         16      /* Tags 0 .. 15, 0 is the idle task */
+
+/* Response time buckets: bucket 0 holds everything below
+ * 2^(RUNTIME_STATS_HISTOGRAM_SHIFT + 1) cycles (128 us at 16 MHz), bucket n
+ * the times from 2^(SHIFT + n) up to twice that, the last one everything
+ * longer (above 2 s) */
+#define RUNTIME_STATS_BUCKETS           16
+#define RUNTIME_STATS_HISTOGRAM_SHIFT   10
+
+#define RUNTIME_STATS_MAX_OBJECTS       8       /* Queue numbers 1 .. 7 */
+
+#define RUNTIME_STATS_WINDOW_SLOTS      8
+#define RUNTIME_STATS_SLOT_MS           250
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* All times in CPU cycles */
+typedef struct
+{
+    uint64 RunTime;                 /* Every cycle the task ran */
+    uint32 Activations;             /* Completed activations or jobs */
+    uint32 ExecutionMin;
+    uint32 ExecutionMax;            /* WCET high-water mark */
+    uint64 ExecutionTotal;          /* Of the completed activations, for the mean */
+    uint32 ResponseMin;
+    uint32 ResponseMax;
+    uint32 ResponseHistogram[RUNTIME_STATS_BUCKETS];
+    uint32 PeriodMs;                /* As declared, 0 for a sporadic task */
+    uint32 DeadlineMs;              /* As declared, 0 if the task has none */
+    uint32 DeadlineMisses;          /* Jobs that completed after their deadline */
+} RunTimeStats_TaskType;
+
+/* A receive is a take and a send a give; times in CPU cycles */
+typedef struct
+{
+    const char *Name;               /* As registered, NULL if it is not */
+    uint32 Takes;
+    uint32 Contended;               /* Takes that blocked first */
+    uint32 Failed;                  /* Takes that gave up, at once or after blocking */
+    uint32 WaitMax;
+    uint64 WaitTotal;               /* Of the contended takes, for the mean */
+    uint32 HoldMax;                 /* Mutexes only, preemption included */
+    uint32 Inheritances;            /* A waiter raised the mutex holder's priority */
+} RunTimeStats_ObjectType;
+
+typedef struct
+{
+    uint32 Cycles;                  /* RunTimeStats_GetCycles() when it was taken */
+    uint32 CpuLoad;                 /* Per mille, as RunTimeStats_GetCpuLoad() */
+    uint32 MaskedMax;               /* As RunTimeStats_GetMaskedMax() */
+    uint32 NumberOfTags;            /* Tasks[] holds tags 0 .. NumberOfTags - 1 */
+    RunTimeStats_TaskType Tasks[RUNTIME_STATS_MAX_TASKS];
+    RunTimeStats_ObjectType Objects[RUNTIME_STATS_MAX_OBJECTS];
+} RunTimeStats_SnapshotType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Starts the DWT cycle counter, call before the scheduler starts */
+void RunTimeStats_Init(void);
+
+/* Cycles since the counter was started, sleeps included; wraps every 2^32
+ * cycles (268 s at 16 MHz) */
+uint32 RunTimeStats_GetCycles(void);
+
+/* Declares the task with tag uTag as periodic with uPeriodMs, or sporadic
+ * with 0, and relative deadline uDeadlineMs. Call before the scheduler starts. */
+void RunTimeStats_SetTiming(uint32 uTag, uint32 uPeriodMs, uint32 uDeadlineMs);
+
+/* Copy of the statistics of the task with tag uTag, FALSE for a tag out of range */
+boolean RunTimeStats_GetTask(uint32 uTag, RunTimeStats_TaskType *pStats);
+
+/* Copy of the statistics of the kernel object numbered uObject, FALSE for
+ * a number out of range */
+boolean RunTimeStats_GetObject(uint32 uObject, RunTimeStats_ObjectType *pStats);
+
+/* CPU load over the sliding window, in per mille */
+uint32 RunTimeStats_GetCpuLoad(void);
+
+/* Longest task level critical section since boot, in cycles */
+uint32 RunTimeStats_GetMaskedMax(void);
+
+/* Copies the statistics of every task seen so far and publishes them as the
+ * current snapshot. One task takes snapshots; the pointer stays valid until
+ * its next call. */
+const RunTimeStats_SnapshotType *RunTimeStats_TakeSnapshot(void);
+
+/* The snapshot last published, all zero before the first one */
+const RunTimeStats_SnapshotType *RunTimeStats_GetSnapshot(void);
+
+/* Kernel trace hooks, called by the scheduler with interrupts masked.
+ * Released: a task was moved to a ready list. SwitchedOut: bBlocked is TRUE
+ * when the task left the ready lists, which ends its activation. */
+void RunTimeStats_TaskReleased(uint32 uTag);
+void RunTimeStats_TaskSwitchedIn(uint32 uTag);
+void RunTimeStats_TaskSwitchedOut(uint32 uTag, boolean bBlocked);
+
+/* Kernel trace hooks. Completed: the running task blocks at its release
+ * point. Resumed: its wait at the release point returned, whether it blocked
+ * or not; without blocking it overran, and its next job was released
+ * uLateCycles ago. xTaskDelayUntil() has no hook on the path that does not
+ * block, so a periodic task calls Resumed itself after every call. */
+void RunTimeStats_TaskCompleted(uint32 uTag);
+void RunTimeStats_TaskResumed(uint32 uTag, uint32 uLateCycles);
+
+/* Kernel trace hook: a notification wait on uIndex returned; a wait on index
+ * 0 is a release point, see RunTimeStats_TaskResumed() */
+void RunTimeStats_TaskNotifyReturned(uint32 uTag, uint32 uIndex);
+
+/* Kernel trace hooks for the queue numbered uObject. Blocked: the task tagged
+ * uTag waits for it. Taken / TakeFailed: the task's take ended. Given: a
+ * give from any context. PriorityInherited: the task tagged uTag, waiting,
+ * raised the holder of the mutex it waits for. Named: it was registered. */
+void RunTimeStats_ObjectBlocked(uint32 uTag, uint32 uObject);
+void RunTimeStats_ObjectTaken(uint32 uTag, uint32 uObject, boolean bMutex);
+void RunTimeStats_ObjectTakeFailed(uint32 uTag, uint32 uObject);
+void RunTimeStats_ObjectGiven(uint32 uObject, boolean bMutex);
+void RunTimeStats_PriorityInherited(uint32 uTag);
+void RunTimeStats_ObjectNamed(uint32 uObject, const char *pName);
+
+/* Port hooks, called from the idle task with interrupts masked: the wake
+ * timer was just started for a tickless sleep, and the core woke up uCycles
+ * core clock cycles later by that timer, before any interrupt ran */
+void RunTimeStats_SleepEntered(void);
+void RunTimeStats_SleepEnded(uint32 uCycles);
+
+/* Port hooks: interrupts were just masked by the outermost critical section,
+ * and are about to be unmasked again */
+void RunTimeStats_CriticalEntered(void);
+void RunTimeStats_CriticalExiting(void);
+
+#endif /* RUNTIME_STATS_H_ */
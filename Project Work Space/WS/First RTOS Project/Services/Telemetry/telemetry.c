@@ -0,0 +1,214 @@
+ /******************************************************************************
+ *
+ * Module: Telemetry
+ *
+ * File Name: telemetry.c
+ *
+ * Description: Source file for the binary telemetry records. Builds the
+ *              payload, appends the CRC-16 and COBS frames the result.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include <stdint.h>
+#include "telemetry.h"
+#include "driverlib/sw_crc.h"
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+/* Each record type is built by one task only, so no locking is needed */
+static uint16 Telemetry_SeatStateSequence = 0;
+static uint16 Telemetry_RuntimeSequence = 0;
+static uint16 Telemetry_TraceSequence = 0;
+static uint16 Telemetry_LogSequence = 0;
+
+/*******************************************************************************
+ *                         Private Functions Definitions                       *
+ *******************************************************************************/
+
+static uint32 Telemetry_PutHeader(uint8 *pPayload, uint8 uType, uint16 uSequence, uint32 uTimestamp)
+{
+    pPayload[0] = TELEMETRY_VERSION;
+    pPayload[1] = uType;
+    pPayload[2] = (uint8)uSequence;
+    pPayload[3] = (uint8)(uSequence >> 8);
+    pPayload[4] = (uint8)uTimestamp;
+    pPayload[5] = (uint8)(uTimestamp >> 8);
+    pPayload[6] = (uint8)(uTimestamp >> 16);
+    pPayload[7] = (uint8)(uTimestamp >> 24);
+    return TELEMETRY_HEADER_SIZE;
+}
+
+static uint32 Telemetry_Put16(uint8 *pPayload, uint16 uValue)
+{
+    pPayload[0] = (uint8)uValue;
+    pPayload[1] = (uint8)(uValue >> 8);
+    return 2;
+}
+
+static uint32 Telemetry_Put32(uint8 *pPayload, uint32 uValue)
+{
+    pPayload[0] = (uint8)uValue;
+    pPayload[1] = (uint8)(uValue >> 8);
+    pPayload[2] = (uint8)(uValue >> 16);
+    pPayload[3] = (uint8)(uValue >> 24);
+    return 4;
+}
+
+/* Append the CRC, encode and terminate the frame */
+static uint32 Telemetry_Frame(uint8 *pPayload, uint32 uLength, uint8 *pFrame)
+{
+    uint16 uCrc = Crc16(0, pPayload, uLength);
+    uint32 uFrameLength;
+
+    pPayload[uLength++] = (uint8)uCrc;
+    pPayload[uLength++] = (uint8)(uCrc >> 8);
+    uFrameLength = Telemetry_CobsEncode(pPayload, uLength, pFrame);
+    pFrame[uFrameLength++] = 0;
+    return uFrameLength;
+}
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+uint32 Telemetry_CobsEncode(const uint8 *pInput, uint32 uLength, uint8 *pOutput)
+{
+    uint32 uRead = 0;
+    uint32 uWrite = 1;
+    uint32 uCode = 0;       /* Position of the pending code byte */
+    uint8 uRun = 1;
+
+    /* Each code byte gives the distance to the next zero, 0xFF means 254
+     * data bytes follow without an implied zero */
+    while (uRead < uLength)
+    {
+        if (pInput[uRead] == 0)
+        {
+            pOutput[uCode] = uRun;
+            uCode = uWrite++;
+            uRun = 1;
+        }
+        else
+        {
+            pOutput[uWrite++] = pInput[uRead];
+            uRun++;
+            if (uRun == 0xFF)
+            {
+                pOutput[uCode] = uRun;
+                uCode = uWrite++;
+                uRun = 1;
+            }
+        }
+        uRead++;
+    }
+    pOutput[uCode] = uRun;
+    return uWrite;
+}
+
+uint32 Telemetry_PackSeatState(const Telemetry_SeatStateType *pState, uint8 *pFrame)
+{
+    uint8 uPayload[TELEMETRY_SEAT_STATE_SIZE(TELEMETRY_MAX_SEATS) + TELEMETRY_CRC_SIZE];
+    uint32 uLength;
+    uint32 uSeat;
+    uint8 uSeats = (pState->NumberOfSeats > TELEMETRY_MAX_SEATS) ? TELEMETRY_MAX_SEATS
+                                                                 : pState->NumberOfSeats;
+
+    uLength = Telemetry_PutHeader(uPayload, TELEMETRY_RECORD_SEAT_STATE,
+                                  Telemetry_SeatStateSequence++, pState->Timestamp);
+    uPayload[uLength++] = uSeats;
+    for (uSeat = 0; uSeat < uSeats; uSeat++)
+    {
+        uPayload[uLength++] = pState->Seats[uSeat].Temperature;
+        uPayload[uLength++] = pState->Seats[uSeat].HeaterState;
+        uPayload[uLength++] = pState->Seats[uSeat].DesiredTemperature;
+    }
+    uPayload[uLength++] = pState->Faults;
+
+    return Telemetry_Frame(uPayload, uLength, pFrame);
+}
+
+uint32 Telemetry_PackRuntime(const Telemetry_RuntimeType *pRuntime, uint8 *pFrame)
+{
+    uint8 uPayload[TELEMETRY_MAX_PAYLOAD_SIZE + TELEMETRY_CRC_SIZE];
+    uint32 uLength;
+    uint32 uTask;
+    uint8 uTasks = (pRuntime->NumberOfTasks > TELEMETRY_MAX_TASKS) ? TELEMETRY_MAX_TASKS
+                                                                    : pRuntime->NumberOfTasks;
+
+    uLength = Telemetry_PutHeader(uPayload, TELEMETRY_RECORD_RUNTIME,
+                                  Telemetry_RuntimeSequence++, pRuntime->Timestamp);
+    uPayload[uLength++] = pRuntime->CpuLoad;
+    uLength += Telemetry_Put16(&uPayload[uLength], pRuntime->MaskedMax);
+    uPayload[uLength++] = uTasks;
+    for (uTask = 0; uTask < uTasks; uTask++)
+    {
+        uLength += Telemetry_Put32(&uPayload[uLength], pRuntime->TaskTime[uTask]);
+        uLength += Telemetry_Put16(&uPayload[uLength], pRuntime->TaskWcet[uTask]);
+        uLength += Telemetry_Put16(&uPayload[uLength], pRuntime->DeadlineMisses[uTask]);
+    }
+
+    return Telemetry_Frame(uPayload, uLength, pFrame);
+}
+
+uint32 Telemetry_PackTrace(const Telemetry_TraceType *pTrace, uint8 *pFrame)
+{
+    uint8 uPayload[TELEMETRY_MAX_PAYLOAD_SIZE + TELEMETRY_CRC_SIZE];
+    const Trace_RecordType *pRecord;
+    uint32 uLength;
+    uint32 uRecord;
+    uint8 uRecords = (pTrace->NumberOfRecords > TELEMETRY_MAX_TRACE_RECORDS) ? TELEMETRY_MAX_TRACE_RECORDS
+                                                                              : pTrace->NumberOfRecords;
+
+    uLength = Telemetry_PutHeader(uPayload, TELEMETRY_RECORD_TRACE,
+                                  Telemetry_TraceSequence++, pTrace->Timestamp);
+    uLength += Telemetry_Put32(&uPayload[uLength], pTrace->Dropped);
+    uPayload[uLength++] = uRecords;
+    for (uRecord = 0; uRecord < uRecords; uRecord++)
+    {
+        pRecord = &pTrace->Records[uRecord];
+        uLength += Telemetry_Put32(&uPayload[uLength], pRecord->Cycles);
+        uPayload[uLength++] = pRecord->Event;
+        uPayload[uLength++] = pRecord->Object;
+        uPayload[uLength++] = (uint8)pRecord->Data;
+        uPayload[uLength++] = (uint8)(pRecord->Data >> 8);
+    }
+
+    return Telemetry_Frame(uPayload, uLength, pFrame);
+}
+
+uint32 Telemetry_PackLog(const Telemetry_LogType *pLog, uint8 *pFrame)
+{
+    uint8 uPayload[TELEMETRY_MAX_PAYLOAD_SIZE + TELEMETRY_CRC_SIZE];
+    const Log_RecordType *pRecord;
+    uint32 uLength;
+    uint32 uRecord;
+    uint32 uArg;
+    uint8 uArgs;
+    uint8 uRecords = (pLog->NumberOfRecords > TELEMETRY_MAX_LOG_RECORDS) ? TELEMETRY_MAX_LOG_RECORDS
+                                                                          : pLog->NumberOfRecords;
+
+    uLength = Telemetry_PutHeader(uPayload, TELEMETRY_RECORD_LOG,
+                                  Telemetry_LogSequence++, pLog->Timestamp);
+    uLength += Telemetry_Put32(&uPayload[uLength], pLog->Dropped);
+    uPayload[uLength++] = uRecords;
+    for (uRecord = 0; uRecord < uRecords; uRecord++)
+    {
+        /* Only the arguments the message has go on the wire */
+        pRecord = &pLog->Records[uRecord];
+        uArgs = (pRecord->NumberOfArgs > LOG_MAX_ARGS) ? LOG_MAX_ARGS : pRecord->NumberOfArgs;
+        uLength += Telemetry_Put32(&uPayload[uLength], pRecord->Cycles);
+        uLength += Telemetry_Put16(&uPayload[uLength], pRecord->Message);
+        uPayload[uLength++] = pRecord->Producer;
+        uPayload[uLength++] = uArgs;
+        for (uArg = 0; uArg < uArgs; uArg++)
+        {
+            uLength += Telemetry_Put32(&uPayload[uLength], pRecord->Args[uArg]);
+        }
+    }
+
+    return Telemetry_Frame(uPayload, uLength, pFrame);
+}
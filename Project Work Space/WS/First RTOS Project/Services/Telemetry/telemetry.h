@@ -0,0 +1,173 @@
+ /******************************************************************************
+ *
+ * Module: Telemetry
+ *
+ * File Name: telemetry.h
+ *
+ * Description: Header file for the binary telemetry records sent over UART0.
+ *              Every record is a little-endian payload followed by its CRC-16
+ *              (driverlib Crc16), COBS encoded and terminated by a zero byte,
+ *              so a receiver can resynchronise on any zero it sees.
+ *
+ *              Payload layout, version 4:
+ *                0  uint8   version (TELEMETRY_VERSION)
+ *                1  uint8   record type
+ *                2  uint16  sequence number, per record type so a gap
+ *                           shows a lost record
+ *                4  uint32  RTOS tick count when the record was built
+ *                8  ...     record body
+ *
+ *              TELEMETRY_RECORD_SEAT_STATE body:
+ *                   uint8   number of seats N
+ *                   uint8   N times temperature, heater state, desired
+ *                           temperature
+ *                   uint8   sensor fault flags, bit n for seat n
+ *
+ *              TELEMETRY_RECORD_RUNTIME body:
+ *                   uint8   CPU load in percent
+ *                   uint16  longest stretch with interrupts masked by a
+ *                           critical section, us, saturated
+ *                   uint8   number of tasks N
+ *                   8 bytes N times, task tag 1 first:
+ *                     uint32  accumulated run time, 0.1 ms units
+ *                     uint16  WCET high-water mark in us, saturated
+ *                     uint16  deadline misses, saturated
+ *
+ *              TELEMETRY_RECORD_TRACE body:
+ *                   uint32  trace records dropped since boot
+ *                   uint8   number of trace records N
+ *                   8 bytes N times a kernel trace record (Services/Trace),
+ *                           oldest first
+ *
+ *              TELEMETRY_RECORD_LOG body:
+ *                   uint32  log records dropped since boot
+ *                   uint8   number of log records N
+ *                   N times a deferred log record (Services/Log), errors
+ *                   first:
+ *                     uint32  DWT cycle counter when it was written
+ *                     uint16  message number, see log_messages.h
+ *                     uint8   producer
+ *                     uint8   number of arguments A
+ *                     uint32  A times an argument
+ *
+ *              This header has no target dependencies so host tools share it.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "std_types.h"
+#include "Services/Trace/trace.h"
+#include "Services/Log/log.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+#define TELEMETRY_VERSION               4
+
+#define TELEMETRY_RECORD_SEAT_STATE     1
+#define TELEMETRY_RECORD_RUNTIME        2
+#define TELEMETRY_RECORD_TRACE          3
+#define TELEMETRY_RECORD_LOG            4
+
+#define TELEMETRY_MAX_SEATS             8       /* Bits of the fault flags */
+#define TELEMETRY_MAX_TASKS             16
+#define TELEMETRY_MAX_TRACE_RECORDS     16
+#define TELEMETRY_MAX_LOG_RECORDS       6
+
+#define TELEMETRY_FAULT_SEAT(seat)      (1 << (seat))
+
+#define TELEMETRY_HEADER_SIZE           8
+#define TELEMETRY_CRC_SIZE              2
+#define TELEMETRY_SEAT_SIZE             3
+#define TELEMETRY_SEAT_STATE_SIZE(seats) (TELEMETRY_HEADER_SIZE + 1 + ((seats) * TELEMETRY_SEAT_SIZE) + 1)
+#define TELEMETRY_TASK_SIZE             8
+#define TELEMETRY_RUNTIME_SIZE(tasks)   (TELEMETRY_HEADER_SIZE + 4 + ((tasks) * TELEMETRY_TASK_SIZE))
+#define TELEMETRY_TRACE_SIZE(records)   (TELEMETRY_HEADER_SIZE + 5 + ((records) * TRACE_RECORD_SIZE))
+#define TELEMETRY_LOG_RECORD_SIZE(args) (8 + ((args) * 4))
+/* A log record's size depends on its arguments, this is the most it takes */
+#define TELEMETRY_LOG_MAX_SIZE(records) (TELEMETRY_HEADER_SIZE + 5 + ((records) * TELEMETRY_LOG_RECORD_SIZE(LOG_MAX_ARGS)))
+#define TELEMETRY_MAX_PAYLOAD_SIZE      TELEMETRY_TRACE_SIZE(TELEMETRY_MAX_TRACE_RECORDS)
+
+#if TELEMETRY_SEAT_STATE_SIZE(TELEMETRY_MAX_SEATS) > TELEMETRY_MAX_PAYLOAD_SIZE
+#error "TELEMETRY_MAX_PAYLOAD_SIZE does not fit a seat state record"
+#endif
+#if TELEMETRY_RUNTIME_SIZE(TELEMETRY_MAX_TASKS) > TELEMETRY_MAX_PAYLOAD_SIZE
+#error "TELEMETRY_MAX_PAYLOAD_SIZE does not fit a runtime record"
+#endif
+#if TELEMETRY_LOG_MAX_SIZE(TELEMETRY_MAX_LOG_RECORDS) > TELEMETRY_MAX_PAYLOAD_SIZE
+#error "TELEMETRY_MAX_PAYLOAD_SIZE does not fit a log record"
+#endif
+
+/* COBS adds one byte per started 254 bytes, then the zero delimiter */
+#define TELEMETRY_MAX_FRAME_SIZE        (TELEMETRY_MAX_PAYLOAD_SIZE + TELEMETRY_CRC_SIZE + \
+                                         ((TELEMETRY_MAX_PAYLOAD_SIZE + TELEMETRY_CRC_SIZE) / 254) + 2)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint8 Temperature;
+    uint8 HeaterState;
+    uint8 DesiredTemperature;
+} Telemetry_SeatType;
+
+typedef struct
+{
+    uint32 Timestamp;
+    uint8 NumberOfSeats;
+    Telemetry_SeatType Seats[TELEMETRY_MAX_SEATS];
+    uint8 Faults;
+} Telemetry_SeatStateType;
+
+typedef struct
+{
+    uint32 Timestamp;
+    uint8 CpuLoad;
+    uint16 MaskedMax;                               /* us */
+    uint8 NumberOfTasks;
+    uint32 TaskTime[TELEMETRY_MAX_TASKS];
+    uint16 TaskWcet[TELEMETRY_MAX_TASKS];           /* us */
+    uint16 DeadlineMisses[TELEMETRY_MAX_TASKS];
+} Telemetry_RuntimeType;
+
+typedef struct
+{
+    uint32 Timestamp;
+    uint32 Dropped;
+    uint8 NumberOfRecords;
+    Trace_RecordType Records[TELEMETRY_MAX_TRACE_RECORDS];
+} Telemetry_TraceType;
+
+typedef struct
+{
+    uint32 Timestamp;
+    uint32 Dropped;
+    uint8 NumberOfRecords;
+    Log_RecordType Records[TELEMETRY_MAX_LOG_RECORDS];
+} Telemetry_LogType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Build the framed record into pFrame, TELEMETRY_MAX_FRAME_SIZE bytes, and
+ * return the number of bytes to send including the delimiter */
+uint32 Telemetry_PackSeatState(const Telemetry_SeatStateType *pState, uint8 *pFrame);
+
+uint32 Telemetry_PackRuntime(const Telemetry_RuntimeType *pRuntime, uint8 *pFrame);
+
+uint32 Telemetry_PackTrace(const Telemetry_TraceType *pTrace, uint8 *pFrame);
+
+uint32 Telemetry_PackLog(const Telemetry_LogType *pLog, uint8 *pFrame);
+
+/* COBS encode uLength bytes, no delimiter, and return the encoded length */
+uint32 Telemetry_CobsEncode(const uint8 *pInput, uint32 uLength, uint8 *pOutput);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,113 @@
+ /******************************************************************************
+ *
+ * Module: Trace
+ *
+ * File Name: trace.c
+ *
+ * Description: Source file for the kernel event trace recorder. The ring
+ *              indexes run freely and are masked on access, so a full ring
+ *              and an empty one are told apart without a spare slot. Records
+ *              are written and read through volatile pointers so the compiler
+ *              keeps them ahead of the index that publishes or releases them.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace.h"
+#include "../../MCAL/tm4c123gh6pm_registers.h"
+
+#if (TRACE_BUFFER_RECORDS & (TRACE_BUFFER_RECORDS - 1)) != 0
+#error "TRACE_BUFFER_RECORDS must be a power of two"
+#endif
+
+/*******************************************************************************
+ *                              Private Variables                              *
+ *******************************************************************************/
+
+static Trace_RecordType Trace_Buffer[TRACE_BUFFER_RECORDS];
+
+/* Written by Trace_Record() only, and by Trace_Read() only */
+static volatile uint32 Trace_Head = 0;
+static volatile uint32 Trace_Tail = 0;
+
+static Trace_StatsType Trace_Stats;
+
+/*******************************************************************************
+ *                         Public Functions Definitions                        *
+ *******************************************************************************/
+
+void Trace_Init(void)
+{
+    Trace_Head = 0;
+    Trace_Tail = 0;
+    Trace_Stats.Recorded = 0;
+    Trace_Stats.Dropped = 0;
+    Trace_Stats.MaxUsed = 0;
+}
+
+void Trace_Record(uint8 uEvent, uint8 uObject, uint16 uData)
+{
+    volatile Trace_RecordType *pRecord;
+    uint32 uHead;
+    uint32 uUsed;
+    UBaseType_t uMask;
+
+    /* The kernel calls the hooks from tasks, ISRs and PendSV alike; masking
+     * makes the slot claim and the head update one step for all of them */
+    uMask = portSET_INTERRUPT_MASK_FROM_ISR();
+    uHead = Trace_Head;
+    uUsed = uHead - Trace_Tail;
+    if (uUsed >= TRACE_BUFFER_RECORDS)
+    {
+        Trace_Stats.Dropped++;
+    }
+    else
+    {
+        pRecord = &Trace_Buffer[uHead & (TRACE_BUFFER_RECORDS - 1)];
+        pRecord->Cycles = DWT_CYCCNT_REG;
+        pRecord->Event = uEvent;
+        pRecord->Object = uObject;
+        pRecord->Data = uData;
+        Trace_Head = uHead + 1;
+        Trace_Stats.Recorded++;
+        if (uUsed >= Trace_Stats.MaxUsed)
+        {
+            Trace_Stats.MaxUsed = uUsed + 1;
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uMask);
+}
+
+uint32 Trace_Read(Trace_RecordType *pRecords, uint32 uMaxRecords)
+{
+    const volatile Trace_RecordType *pRecord;
+    uint32 uTail = Trace_Tail;
+    uint32 uCount = Trace_Head - uTail;
+    uint32 uRecord;
+
+    if (uCount > uMaxRecords)
+    {
+        uCount = uMaxRecords;
+    }
+    for (uRecord = 0; uRecord < uCount; uRecord++)
+    {
+        pRecord = &Trace_Buffer[(uTail + uRecord) & (TRACE_BUFFER_RECORDS - 1)];
+        pRecords[uRecord].Cycles = pRecord->Cycles;
+        pRecords[uRecord].Event = pRecord->Event;
+        pRecords[uRecord].Object = pRecord->Object;
+        pRecords[uRecord].Data = pRecord->Data;
+    }
+    /* The slots are handed back to the writer only once they are copied */
+    Trace_Tail = uTail + uCount;
+    return uCount;
+}
+
+void Trace_GetStats(Trace_StatsType *pStats)
+{
+    taskENTER_CRITICAL();
+    *pStats = Trace_Stats;
+    taskEXIT_CRITICAL();
+}
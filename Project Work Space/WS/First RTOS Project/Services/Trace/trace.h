@@ -0,0 +1,103 @@
+ /******************************************************************************
+ *
+ * Module: Trace
+ *
+ * File Name: trace.h
+ *
+ * Description: Header file for the kernel event trace recorder. The FreeRTOS
+ *              trace hook macros of FreeRTOSConfig.h and the traceISR_ENTER /
+ *              traceISR_EXIT calls of the interrupt handlers append fixed
+ *              size records to a RAM ring; a low priority task drains the
+ *              ring into TELEMETRY_RECORD_TRACE frames on UART0.
+ *
+ *              Record layout, 8 bytes, little-endian on the wire:
+ *                0  uint32  DWT cycle counter when the event happened
+ *                4  uint8   event (TRACE_EVENT_*)
+ *                5  uint8   object: task tag, queue number or vector number
+ *                6  uint16  event data, see the event list
+ *
+ *              Trace_Record() is straight-line code with interrupts masked up
+ *              to configMAX_SYSCALL_INTERRUPT_PRIORITY: no loop and no path
+ *              that depends on the ring's contents, about 50 cycles (3 us at
+ *              16 MHz) per event counted from its instructions. A full ring
+ *              drops the new record and counts it, it never blocks.
+ *
+ *              UART0_Handler is not traced: it runs several times for every
+ *              frame the trace goes out in, so tracing it would take about as
+ *              many records as each frame carries.
+ *
+ *              This header has no target dependencies so host tools share it.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Records held in RAM between two drains, a power of two */
+#define TRACE_BUFFER_RECORDS            256
+
+#define TRACE_RECORD_SIZE               8
+
+/* Events, the object and data each one carries */
+#define TRACE_EVENT_TASK_SWITCHED_IN    1       /* Task tag, priority */
+#define TRACE_EVENT_TASK_READY          2       /* Task tag */
+#define TRACE_EVENT_TASK_DELAY          3       /* Running task's tag, tick it wakes at (low 16 bits) */
+#define TRACE_EVENT_TASK_SUSPEND        4       /* Task tag */
+#define TRACE_EVENT_TASK_RESUME         5       /* Task tag, 1 from an ISR */
+#define TRACE_EVENT_QUEUE_SEND          6       /* Queue number, items before; a semaphore give */
+#define TRACE_EVENT_QUEUE_SEND_FAILED   7       /* Queue number, items */
+#define TRACE_EVENT_QUEUE_RECEIVE       8       /* Queue number, items before; a semaphore take */
+#define TRACE_EVENT_QUEUE_RECEIVE_FAILED 9      /* Queue number, items */
+#define TRACE_EVENT_QUEUE_BLOCK         10      /* Queue number, 0 on receive, 1 on send */
+#define TRACE_EVENT_TASK_NOTIFY         11      /* Notified task's tag, notification index */
+#define TRACE_EVENT_TASK_NOTIFY_FROM_ISR 12     /* Notified task's tag, notification index */
+#define TRACE_EVENT_TASK_NOTIFY_WAIT    13      /* Running task's tag, notification index */
+#define TRACE_EVENT_TASK_NOTIFY_BLOCK   14      /* Running task's tag, notification index */
+#define TRACE_EVENT_ISR_ENTER           15      /* Vector number */
+#define TRACE_EVENT_ISR_EXIT            16      /* Vector number */
+#define TRACE_NUM_EVENTS                17
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef struct
+{
+    uint32 Cycles;
+    uint8 Event;
+    uint8 Object;
+    uint16 Data;
+} Trace_RecordType;
+
+typedef struct
+{
+    uint32 Recorded;
+    uint32 Dropped;                 /* Ring full when the event happened */
+    uint32 MaxUsed;                 /* Most records waiting at once */
+} Trace_StatsType;
+
+/*******************************************************************************
+ *                            Functions Prototypes                             *
+ *******************************************************************************/
+
+/* Timestamps come from the DWT cycle counter RunTimeStats_Init() starts */
+void Trace_Init(void);
+
+/* Any context at or below configMAX_SYSCALL_INTERRUPT_PRIORITY */
+void Trace_Record(uint8 uEvent, uint8 uObject, uint16 uData);
+
+/* Moves up to uMaxRecords of the oldest records out of the ring and returns
+ * how many. One reader only. */
+uint32 Trace_Read(Trace_RecordType *pRecords, uint32 uMaxRecords);
+
+void Trace_GetStats(Trace_StatsType *pStats);
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,97 @@
+ /******************************************************************************
+ *
+ * Module: Application
+ *
+ * File Name: TaskSet.h
+ *
+ * Description: Tags, priorities, periods and deadlines of the application
+ *              tasks. main.c creates and declares the tasks from these
+ *              values and the HostSim response-time analysis reads the same
+ *              ones, so the analysis follows every change to the task set.
+ *
+ *              Deadlines are relative, as in the schedulability model in
+ *              SimSo/RTOS_Project.xml; a job that responds later is counted
+ *              as a deadline miss.
+ *
+ *              This header has no target dependencies so host tools share it.
+ *
+ * Author: Edges for Training Team
+ *
+ *******************************************************************************/
+
+#ifndef TASKSET_H_
+#define TASKSET_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                             Preprocessor Macros                             *
+ *******************************************************************************/
+
+/* Application task tags, 1 .. NUMBER_OF_TASKS; the idle task keeps tag 0 */
+#define SEAT_ACQUISITION_TASK_TAG               1
+#define SEAT_CONTROL_TASK_TAG                   2
+#define DISPLAY_SYSTEM_STATE_TASK_TAG           3
+#define INPUT_DISPATCHER_TASK_TAG               4
+#define SENSOR_ERROR_HOOK_TASK_TAG              5
+#define RUNTIME_MEASUREMENTS_TASK_TAG           6
+#define TRACE_STREAM_TASK_TAG                   7
+#define LOGGER_TASK_TAG                         8
+
+/* FreeRTOS priorities, higher runs first */
+#define SEAT_ACQUISITION_TASK_PRIORITY          3
+#define SEAT_CONTROL_TASK_PRIORITY              2
+#define DISPLAY_SYSTEM_STATE_TASK_PRIORITY      3
+#define INPUT_DISPATCHER_TASK_PRIORITY          4
+#define SENSOR_ERROR_HOOK_TASK_PRIORITY         5
+#define RUNTIME_MEASUREMENTS_TASK_PRIORITY      2
+#define TRACE_STREAM_TASK_PRIORITY              1   /* The trace goes out in the time nothing else needs */
+#define LOGGER_TASK_PRIORITY                    1   /* The producers never wait for it */
+
+/* Periods of the periodic tasks */
+#define GET_TEMP_TASK_PERIOD_MS                 500     /* Seat acquisition */
+#define SET_TEMP_TASK_PERIOD_MS                 150     /* Seat control, also the PI sample period */
+#define DISPLAY_SYSTEM_STATE_PERIOD_MS          1000
+#define RUNTIME_MEASUREMENTS_TASK_PERIOD_MS     2200
+#define TRACE_STREAM_PERIOD_MS                  100     /* The trace ring is drained this often */
+#define LOG_DRAIN_PERIOD_MS                     100     /* The log rings are drained this often */
+
+/* Minimum inter-arrival times of the sporadic tasks: the input dispatcher can
+ * be woken once per debounce settle time (GPIO_DEBOUNCE_SETTLE_MS), the
+ * sensor error hook once per acquisition period */
+#define INPUT_DISPATCHER_MIN_INTERARRIVAL_MS    20
+#define SENSOR_ERROR_HOOK_MIN_INTERARRIVAL_MS   GET_TEMP_TASK_PERIOD_MS
+
+/* Relative deadlines */
+#define GET_TEMP_TASK_DEADLINE_MS               100
+#define SET_TEMP_TASK_DEADLINE_MS               50
+#define DISPLAY_SYSTEM_STATE_DEADLINE_MS        50
+#define INPUT_DISPATCHER_DEADLINE_MS            50      /* From the button event */
+#define SENSOR_ERROR_HOOK_DEADLINE_MS           10000   /* From the failure report */
+#define RUNTIME_MEASUREMENTS_TASK_DEADLINE_MS   RUNTIME_MEASUREMENTS_TASK_PERIOD_MS     /* Implicit */
+
+/* Names the seat table mutex in the kernel trace and contention statistics */
+#define SEAT_TABLE_MUTEX_NUMBER                 1
+
+/* The task set: APP_TASK(tag, SimSo name, priority, period or minimum
+ * inter-arrival time in ms, deadline in ms or 0 for best effort, sporadic,
+ * takes the seat table mutex) */
+#define APP_TASKS                                                                                       \
+    APP_TASK(SEAT_ACQUISITION_TASK_TAG, "SeatAcquisition", SEAT_ACQUISITION_TASK_PRIORITY,              \
+             GET_TEMP_TASK_PERIOD_MS, GET_TEMP_TASK_DEADLINE_MS, FALSE, TRUE)                           \
+    APP_TASK(SEAT_CONTROL_TASK_TAG, "SeatControl", SEAT_CONTROL_TASK_PRIORITY,                          \
+             SET_TEMP_TASK_PERIOD_MS, SET_TEMP_TASK_DEADLINE_MS, FALSE, TRUE)                           \
+    APP_TASK(DISPLAY_SYSTEM_STATE_TASK_TAG, "Display", DISPLAY_SYSTEM_STATE_TASK_PRIORITY,              \
+             DISPLAY_SYSTEM_STATE_PERIOD_MS, DISPLAY_SYSTEM_STATE_DEADLINE_MS, FALSE, FALSE)            \
+    APP_TASK(INPUT_DISPATCHER_TASK_TAG, "InputDispatcher", INPUT_DISPATCHER_TASK_PRIORITY,              \
+             INPUT_DISPATCHER_MIN_INTERARRIVAL_MS, INPUT_DISPATCHER_DEADLINE_MS, TRUE, TRUE)            \
+    APP_TASK(SENSOR_ERROR_HOOK_TASK_TAG, "SensorErr", SENSOR_ERROR_HOOK_TASK_PRIORITY,                  \
+             SENSOR_ERROR_HOOK_MIN_INTERARRIVAL_MS, SENSOR_ERROR_HOOK_DEADLINE_MS, TRUE, TRUE)          \
+    APP_TASK(RUNTIME_MEASUREMENTS_TASK_TAG, "RTM", RUNTIME_MEASUREMENTS_TASK_PRIORITY,                  \
+             RUNTIME_MEASUREMENTS_TASK_PERIOD_MS, RUNTIME_MEASUREMENTS_TASK_DEADLINE_MS, FALSE, FALSE)  \
+    APP_TASK(TRACE_STREAM_TASK_TAG, "TraceStream", TRACE_STREAM_TASK_PRIORITY,                          \
+             TRACE_STREAM_PERIOD_MS, 0, FALSE, FALSE)                                                   \
+    APP_TASK(LOGGER_TASK_TAG, "Logger", LOGGER_TASK_PRIORITY,                                           \
+             LOG_DRAIN_PERIOD_MS, 0, FALSE, FALSE)
+
+#endif /* TASKSET_H_ */
@@ -16,11 +16,20 @@ typedef enum{
     Desired_OFF, Desired_LOW = 25, Desired_MED = 30, Desired_HIGH = 35
 }DesiredTemperatureType;
 
+/* Seats are numbered from 0. Adding one means a row in the seat tables of
+ * main.c, lm35.c and heater.c, no new tasks. */
+#define NUM_SEATS       2
+#define SEAT_DRIVER     0
+#define SEAT_PASSENGER  1
+
+/* State of every seat, one array per field so a loop over the seats walks
+ * short contiguous arrays. Enumerations are kept in a byte each. */
 typedef struct{
-    uint8_t SeatTemperature;
-    HeaterIntensityType HeaterState;
-    DesiredTemperatureType DesiredTemperature;
-}SeatInfoType;
+    uint8_t SeatTemperature[NUM_SEATS];
+    uint8_t HeaterState[NUM_SEATS];         /* HeaterIntensityType */
+    uint8_t DesiredTemperature[NUM_SEATS];  /* DesiredTemperatureType */
+    uint8_t SensorFault[NUM_SEATS];         /* Reading outside the valid window */
+}SeatTableType;
 
 
 
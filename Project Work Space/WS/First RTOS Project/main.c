@@ -4,50 +4,122 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "TypeDef.h"
+#include "TaskSet.h"
 #include "semphr.h"
 #include <stdbool.h>
 #include "uart0.h"
-#include "GPTM.h"
 #include "HAL/LM35/lm35.h"
+#include "HAL/Heater/heater.h"
+#include "Services/Control/pi_controller.h"
 #include "driverlib/adc.h"
 #include "MCAL/GPIO/gpio.h"
+#include "MCAL/GPIO/gpio_debounce.h"
 #include "MCAL/tm4c123gh6pm_registers.h"
-#include "eeprom.h"
+#include "Services/EventLog/event_log.h"
+#include "Services/Telemetry/telemetry.h"
+#include "Services/RunTimeStats/runtime_stats.h"
+#include "Services/Trace/trace.h"
+#include "Services/Log/log.h"
+#include "Services/Pool/pool.h"
 
 
 /******************************************************************************/
 /* Definitions. ***************************************************************/
 /******************************************************************************/
-#define xGetTempMaxDelay pdMS_TO_TICKS(100); /* Get Temperature Tasks Timeout */
-#define xDriverInfoMaxDelay pdMS_TO_TICKS(50); /* Set Driver Seat Heater Task Timeout */
-#define xPassengerInfoMaxDelay xDriverInfoMaxDelay /* Set Passenger Seat Heater Task Timeout */
-#define xGetDriverInputMaxDelay pdMS_TO_TICKS(50); /* Driver Selection Input Tasks Timeout */
-#define xGetPassengerInputMaxDelay xGetDriverInputMaxDelay /* Passenger Selection Input Task Timeout */
-#define DRIVER_SENSOR_ERROR_ADDRESS 0x1111 /* Location in eeprom where the driver sensor error will be reported */
-#define PASSENGER_SENSOR_ERROR_ADDRESS 0x2222 /* Location in eeprom where the passenger sensor error will be reported */
-#define DRIVER_INPUT_ADDRESS 0x3333 /* Location in eeprom where the driver selection will be reported */
-#define PASSENGER_INPUT_ADDRESS 0x4444 /* Location in eeprom where the passenger selection will be reported */
-#define DRIVER_SENSOR_ERROR_CODE 0x1234 /* The code that will be reported in case of driver sensor failure */
-#define PASSENGER_SENSOR_ERROR_CODE 0x4321 /* The code that will be reported in case of passenger sensor failure */
-#define RUNTIME_MEASUREMENTS_TASK_PERIODICITY pdMS_TO_TICKS(2200) /* Period of Run-Time Measurement Task */
-#define GET_TEMP_TASK_PERIODICITY pdMS_TO_TICKS(500) /* Period for both Get Temp tasks */
-#define SET_TEMP_TASK_PERIODICITY pdMS_TO_TICKS(150) /* Period for both Set Temp tasks */
-#define DISPLAY_SYSTEM_STATE_PERIOD pdMS_TO_TICKS(1000) /* Period for Display System State Task */
+#define xSeatTableMaxDelay pdMS_TO_TICKS(50) /* Acquisition and control tasks' seat table timeout */
+#define INPUT_SOURCES GPIO_NUM_BUTTONS /* SW1 (PF4) selects for the driver, SW2 (PF0) for the passenger */
+#define INPUT_EVENT_ALL ((1 << INPUT_SOURCES) - 1) /* One notification bit per input source */
+#define INPUT_NO_LEVEL 0xFF /* No long press or double click pending */
+#define SENSOR_VALID_MIN 5 /* Readings outside this window are a sensor failure */
+#define SENSOR_VALID_MAX 40
+/* Periods, deadlines and priorities are in TaskSet.h */
+#define RUNTIME_MEASUREMENTS_TASK_PERIODICITY pdMS_TO_TICKS(RUNTIME_MEASUREMENTS_TASK_PERIOD_MS)
+#define GET_TEMP_TASK_PERIODICITY pdMS_TO_TICKS(GET_TEMP_TASK_PERIOD_MS)
+#define SET_TEMP_TASK_PERIODICITY pdMS_TO_TICKS(SET_TEMP_TASK_PERIOD_MS)
+#define DISPLAY_SYSTEM_STATE_PERIOD pdMS_TO_TICKS(DISPLAY_SYSTEM_STATE_PERIOD_MS)
+#define TRACE_STREAM_PERIOD pdMS_TO_TICKS(TRACE_STREAM_PERIOD_MS)
+#define LOG_DRAIN_PERIOD pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS)
+#define TASK_STACK_SIZE 128 /* Stack of every application task, in words */
+#define RUNTIME_CYCLES_PER_REPORT_UNIT (configCPU_CLOCK_HZ / 10000) /* Runtime record times are in 0.1 ms */
+#define RUNTIME_CYCLES_PER_US (configCPU_CLOCK_HZ / 1000000) /* Runtime record WCETs are in us */
+/* Log producers, each writes its own rings and from one context only */
+#define LOG_PRODUCER_ACQUISITION 0
+#define LOG_PRODUCER_CONTROL 1
+#define LOG_PRODUCER_GESTURE 2 /* Debounce interrupt context */
+#define LOG_PRODUCER_INPUT 3
+#define LOG_PRODUCER_SENSOR_ERROR 4
+#define LOG_PRODUCERS_USED 5
+
+/* Every seat needs a sensor channel, a heater and room in the reports */
+#if (LM35_NUM_CHANNELS != NUM_SEATS) || (HEATER_NUM_SEATS != NUM_SEATS)
+#error "The LM35 channel and heater tables need one row per seat"
+#endif
+#if (NUM_SEATS > EVENT_LOG_NUM_SOURCES) || (NUM_SEATS > TELEMETRY_MAX_SEATS)
+#error "NUM_SEATS exceeds the event log sources or the telemetry seat state"
+#endif
+#if (NUMBER_OF_TASKS >= RUNTIME_STATS_MAX_TASKS) || (NUMBER_OF_TASKS > TELEMETRY_MAX_TASKS)
+#error "NUMBER_OF_TASKS exceeds the run-time statistics tags or the telemetry runtime record"
+#endif
+/* The task set has one row per task, and the sporadic tasks' inter-arrival
+ * times are the ones their wake-ups allow */
+#define APP_TASK(tag, name, priority, period, deadline, sporadic, mutex) + 1
+#if (0 APP_TASKS) != NUMBER_OF_TASKS
+#error "APP_TASKS in TaskSet.h needs one row per task"
+#endif
+#undef APP_TASK
+#if (INPUT_DISPATCHER_MIN_INTERARRIVAL_MS != GPIO_DEBOUNCE_SETTLE_MS)
+#error "INPUT_DISPATCHER_MIN_INTERARRIVAL_MS does not match the debounce settle time"
+#endif
+#if SEAT_TABLE_MUTEX_NUMBER >= RUNTIME_STATS_MAX_OBJECTS
+#error "SEAT_TABLE_MUTEX_NUMBER is past the objects the run-time statistics profile"
+#endif
+/* A table that is one row short still compiles, its last row all zeros */
+#define TABLE_ROWS_CHECK(table, rows) \
+    typedef char table##_RowsCheck[((sizeof(table) / sizeof((table)[0])) == (rows)) ? 1 : -1]
+/* Log_Read() scans every ring on each drain, so none is left unused */
+#if LOG_PRODUCERS_USED != LOG_NUM_PRODUCERS
+#error "LOG_NUM_PRODUCERS must be the number of log producers"
+#endif
+#if TELEMETRY_MAX_FRAME_SIZE > POOL_FRAME_BLOCK_SIZE
+#error "POOL_FRAME_BLOCK_SIZE does not fit a telemetry frame"
+#endif
 /******************************************************************************/
 /* Global Variables. **********************************************************/
 /******************************************************************************/
-bool DRIVER_SENSOR_ERROR = pdFALSE;
-bool PASSENGER_SENSOR_ERROR = pdFALSE;
-uint32_t ERROR_CODE;
-TickType_t xLastWakeTime;
-uint32_t DriverSelection;
-uint32_t PassengerSelection;
-uint32 ullTasksOutTime[NUMBER_OF_TASKS + 1];
-uint32 ullTasksInTime[NUMBER_OF_TASKS + 1];
-uint32 ullTasksExecutionTime[NUMBER_OF_TASKS + 1];
-uint32 ullTasksTotalTime[NUMBER_OF_TASKS + 1];
-SeatInfoType DriverSeatInfo = { 10, Heater_OFF, Desired_HIGH };
-SeatInfoType PassengerSeatInfo = { 10, Heater_OFF, Desired_HIGH };
+/* Gestures latched by the debounce layer and not handled yet, per input
+ * source: short presses that step the level, the level set by a long press
+ * or double click before them, and the tick of the last gesture */
+volatile uint32 ulInputPresses[INPUT_SOURCES];
+volatile uint8 ucInputLevel[INPUT_SOURCES];
+volatile TickType_t xInputPressTime[INPUT_SOURCES];
+/* Seat each button selects for */
+static const uint8 ucInputSeat[] = { SEAT_DRIVER, SEAT_PASSENGER };
+TABLE_ROWS_CHECK(ucInputSeat, INPUT_SOURCES);
+/* Filled in by prvSetupHardware, every seat starts out the same */
+SeatTableType SeatTable;
+/* Copies of the seat table for readers that do not take the mutex. The
+ * writer holding the mutex fills the copy the version does not point at and
+ * then moves the version on, so a reader that preempts it still finds a
+ * complete copy and never waits for the writer. */
+static volatile SeatTableType xSeatTablePublished[2];
+static volatile uint32 ulSeatTableVersion = 0;
+/* Code journaled when a seat's sensor fails, per seat */
+static const uint32 ulSensorErrorCode[] = { 0x1234, 0x4321 };
+TABLE_ROWS_CHECK(ulSensorErrorCode, NUM_SEATS);
+/* PWM frequency and soft-start time of each seat's heater, filled in by
+ * prvSetupHardware */
+static Heater_ConfigType xHeaterConfig[NUM_SEATS];
+/* Seat temperature loops, degrees in and heater duty out. The integral time
+ * Kp / Ki of 5 s matches the seat's thermal time constant; Kp was picked with
+ * the HostSim pi_benchmark step responses. Every seat uses these gains. */
+static const PI_ConfigType xSeatControlConfig =
+{
+    PI_GAIN(150), PI_GAIN(30), SET_TEMP_TASK_PERIOD_MS, 0, HEATER_DUTY_MAX
+};
+static PI_ControllerType xSeatController[NUM_SEATS];
+/* Name and tag of the task that hit its stack guard, for the debugger */
+static volatile const char *pcStackOverflowTask = NULL;
+static volatile uint32 ulStackOverflowTag = 0;
 
 /******************************************************************************/
 /* Function Declarations. *****************************************************/
@@ -55,45 +127,79 @@ SeatInfoType PassengerSeatInfo = { 10, Heater_OFF, Desired_HIGH };
 /* The HW setup function */
 static void prvSetupHardware(void);
 
+/* Heating levels restored from the event log */
+static void prvRestoreSelections(void);
+
+/* Heater power from the seat's controller */
+static uint16 prvHeaterDuty(uint8 ucSeat);
+static HeaterIntensityType prvHeaterLevel(uint16 usDuty);
+
+/* Input dispatching */
+static DesiredTemperatureType prvNextLevel(DesiredTemperatureType xDesiredTemperature);
+static void prvApplyPresses(uint8 ucSource);
+static void prvInputGesture(uint8 ucSource, GPIO_GestureType eGesture);
+
+/* Runtime record fields */
+static uint16 prvSaturate16(uint32 ulValue);
+
+/* Release point of the periodic tasks */
+static void prvWaitForPeriod(TickType_t *pxLastWakeTime, TickType_t xPeriod);
+
+/* Stack overflow caught by the MPU guard of the port */
+void vApplicationStackGuardHook(TaskHandle_t xTask, char *pcTaskName);
+
+/* Seat table copies for lock-free readers */
+static void prvPublishSeatTable(void);
+void vSeatTableSnapshot(SeatTableType *pxSnapshot);
+
 /* FreeRTOS tasks */
-void vGetDriverSeatTemp(void *pvParameters);
-void vGetPassengerSeatTemp(void *pvParameters);
-void vSetDriverSeatHeaterState(void *pvParameters);
-void vSetPassengerSeatHeaterState(void *pvParameters);
+void vSeatAcquisitionTask(void *pvParameters);
+void vSeatControlTask(void *pvParameters);
 void vDisplaySystemState(void *pvParameters);
-void vGetDriverInput(void *pvParameters);
-void vGetPassengerInput(void *pvParameters);
-void vGPIOPortF_Handler(void);
+void vInputDispatcherTask(void *pvParameters);
 void vSensorErrorHook(void *pvParameters);
 void vRunTimeMeasurementsTask(void *pvParameters);
+void vTraceStreamTask(void *pvParameters);
+void vLoggerTask(void *pvParameters);
 
 
 /******************************************************************************/
 /* Semaphores and Task Handles. ***********************************************/
 /******************************************************************************/
 /* FreeRTOS Mutexes */
-xSemaphoreHandle xLM35GetTempMutex;
-xSemaphoreHandle xDriverInfoMutex;
-xSemaphoreHandle xPassengerInfoMutex;
-xSemaphoreHandle xErrorReportingMutex;
-
-/* FreeRTOS Semaphores */
-xSemaphoreHandle xDriverInputSemaphore;
-xSemaphoreHandle xDriverInputSemaphoreFromSteering;
-xSemaphoreHandle xPassengerInputSemaphore;
-xSemaphoreHandle xSensorErrorHookSemaphore;
+xSemaphoreHandle xSeatTableMutex;
 
 /* Used to hold the handle of tasks */
-TaskHandle_t xGetDriverSeatTempHandle;
-TaskHandle_t xGetPassengerSeatTempHandle;
-TaskHandle_t xSetDriverSeatHeaterStateHandle;
-TaskHandle_t xSetPassengerSeatHeaterStateHandle;
+TaskHandle_t xSeatAcquisitionHandle;
+TaskHandle_t xSeatControlHandle;
 TaskHandle_t xDisplaySystemStateHandle;
-TaskHandle_t xGetDriverInputHandle;
-TaskHandle_t xGetDriverInputFromSteeringHandle;
-TaskHandle_t xGetPassengerInputHandle;
+TaskHandle_t xInputDispatcherHandle;
 TaskHandle_t xSensorErrorHookHandle;
 TaskHandle_t xRunTimeMeasurementsHandle;
+TaskHandle_t xTraceStreamHandle;
+TaskHandle_t xLoggerHandle;
+
+/* Kernel objects are created from this storage, not from a FreeRTOS heap,
+ * so their RAM is placed and counted by the linker */
+static StaticSemaphore_t xSeatTableMutexBuffer;
+static StaticTask_t xSeatAcquisitionTCB;
+static StaticTask_t xSeatControlTCB;
+static StaticTask_t xDisplaySystemStateTCB;
+static StaticTask_t xInputDispatcherTCB;
+static StaticTask_t xSensorErrorHookTCB;
+static StaticTask_t xRunTimeMeasurementsTCB;
+static StaticTask_t xTraceStreamTCB;
+static StaticTask_t xLoggerTCB;
+static StaticTask_t xIdleTaskTCB;
+static StackType_t xSeatAcquisitionStack[TASK_STACK_SIZE];
+static StackType_t xSeatControlStack[TASK_STACK_SIZE];
+static StackType_t xDisplaySystemStateStack[TASK_STACK_SIZE];
+static StackType_t xInputDispatcherStack[TASK_STACK_SIZE];
+static StackType_t xSensorErrorHookStack[TASK_STACK_SIZE];
+static StackType_t xRunTimeMeasurementsStack[TASK_STACK_SIZE];
+static StackType_t xTraceStreamStack[TASK_STACK_SIZE];
+static StackType_t xLoggerStack[TASK_STACK_SIZE];
+static StackType_t xIdleTaskStack[configMINIMAL_STACK_SIZE];
 
 
 /******************************************************************************/
@@ -104,48 +210,53 @@ int main()
     /* Setup the hardware for use with the Tiva C board. */
     prvSetupHardware();
 
-    /* Create Tasks here and assign tags */
-    xTaskCreate(vGetDriverSeatTemp, "Get Driver Seat Temperature Task", 128, NULL, 3, &xGetDriverSeatTempHandle);
-    vTaskSetApplicationTaskTag( xGetDriverSeatTempHandle, ( TaskHookFunction_t ) 1 );
-
-    xTaskCreate(vGetPassengerSeatTemp, "Get Passenger Seat Temperature Task", 128, NULL, 3, &xGetPassengerSeatTempHandle);
-    vTaskSetApplicationTaskTag( xGetPassengerSeatTempHandle, ( TaskHookFunction_t ) 2 );
-
-    xTaskCreate(vSetDriverSeatHeaterState, "Set Driver Seat Heater State Task", 128, NULL, 2, &xSetDriverSeatHeaterStateHandle);
-    vTaskSetApplicationTaskTag( xSetDriverSeatHeaterStateHandle, ( TaskHookFunction_t ) 3 );
-
-    xTaskCreate(vSetPassengerSeatHeaterState, "Set Passenger Seat Heater State Task", 128, NULL, 2, &xSetPassengerSeatHeaterStateHandle);
-    vTaskSetApplicationTaskTag( xSetPassengerSeatHeaterStateHandle, ( TaskHookFunction_t ) 4 );
-
-    xTaskCreate(vDisplaySystemState, "Display System Information Task", 128, NULL, 3, &xDisplaySystemStateHandle);
-    vTaskSetApplicationTaskTag( xDisplaySystemStateHandle, ( TaskHookFunction_t ) 5 );
-
-    xTaskCreate(vGetDriverInput, "Get Driver Selection", 128, NULL, 4, &xGetDriverInputHandle);
-    vTaskSetApplicationTaskTag( xGetDriverInputHandle, ( TaskHookFunction_t ) 6 );
-
-    xTaskCreate(vGetDriverInput, "Get Driver Selection From Steering Wheel", 128, NULL, 4, &xGetDriverInputFromSteeringHandle);
-    vTaskSetApplicationTaskTag( xGetDriverInputFromSteeringHandle, ( TaskHookFunction_t ) 7 );
-
-    xTaskCreate(vGetPassengerInput, "Get Passenger Selection", 128, NULL, 4, &xGetPassengerInputHandle);
-    vTaskSetApplicationTaskTag( xGetPassengerInputHandle, ( TaskHookFunction_t ) 8 );
-
-    xTaskCreate(vSensorErrorHook, "Sensor Error Hook", 128, NULL, 5, &xSensorErrorHookHandle);
-    vTaskSetApplicationTaskTag( xSensorErrorHookHandle, ( TaskHookFunction_t ) 9 );
-
-    xTaskCreate(vRunTimeMeasurementsTask, "Run time", 128, NULL, 2, &xRunTimeMeasurementsHandle);
-    vTaskSetApplicationTaskTag( xRunTimeMeasurementsHandle, ( TaskHookFunction_t ) 10 );
+    /* Create Tasks here and assign tags, one task per role serves every seat */
+    xSeatAcquisitionHandle = xTaskCreateStatic(vSeatAcquisitionTask, "Seat Acquisition Task", TASK_STACK_SIZE, NULL, SEAT_ACQUISITION_TASK_PRIORITY,
+                                               xSeatAcquisitionStack, &xSeatAcquisitionTCB);
+    vTaskSetApplicationTaskTag( xSeatAcquisitionHandle, ( TaskHookFunction_t ) SEAT_ACQUISITION_TASK_TAG );
+    RunTimeStats_SetTiming(SEAT_ACQUISITION_TASK_TAG, GET_TEMP_TASK_PERIOD_MS, GET_TEMP_TASK_DEADLINE_MS);
+
+    xSeatControlHandle = xTaskCreateStatic(vSeatControlTask, "Seat Control Task", TASK_STACK_SIZE, NULL, SEAT_CONTROL_TASK_PRIORITY,
+                                           xSeatControlStack, &xSeatControlTCB);
+    vTaskSetApplicationTaskTag( xSeatControlHandle, ( TaskHookFunction_t ) SEAT_CONTROL_TASK_TAG );
+    RunTimeStats_SetTiming(SEAT_CONTROL_TASK_TAG, SET_TEMP_TASK_PERIOD_MS, SET_TEMP_TASK_DEADLINE_MS);
+
+    xDisplaySystemStateHandle = xTaskCreateStatic(vDisplaySystemState, "Display System Information Task", TASK_STACK_SIZE, NULL, DISPLAY_SYSTEM_STATE_TASK_PRIORITY,
+                                                  xDisplaySystemStateStack, &xDisplaySystemStateTCB);
+    vTaskSetApplicationTaskTag( xDisplaySystemStateHandle, ( TaskHookFunction_t ) DISPLAY_SYSTEM_STATE_TASK_TAG );
+    RunTimeStats_SetTiming(DISPLAY_SYSTEM_STATE_TASK_TAG, DISPLAY_SYSTEM_STATE_PERIOD_MS, DISPLAY_SYSTEM_STATE_DEADLINE_MS);
+
+    xInputDispatcherHandle = xTaskCreateStatic(vInputDispatcherTask, "Input Dispatcher", TASK_STACK_SIZE, NULL, INPUT_DISPATCHER_TASK_PRIORITY,
+                                               xInputDispatcherStack, &xInputDispatcherTCB);
+    vTaskSetApplicationTaskTag( xInputDispatcherHandle, ( TaskHookFunction_t ) INPUT_DISPATCHER_TASK_TAG );
+    RunTimeStats_SetTiming(INPUT_DISPATCHER_TASK_TAG, 0, INPUT_DISPATCHER_DEADLINE_MS);
+
+    xSensorErrorHookHandle = xTaskCreateStatic(vSensorErrorHook, "Sensor Error Hook", TASK_STACK_SIZE, NULL, SENSOR_ERROR_HOOK_TASK_PRIORITY,
+                                               xSensorErrorHookStack, &xSensorErrorHookTCB);
+    vTaskSetApplicationTaskTag( xSensorErrorHookHandle, ( TaskHookFunction_t ) SENSOR_ERROR_HOOK_TASK_TAG );
+    RunTimeStats_SetTiming(SENSOR_ERROR_HOOK_TASK_TAG, 0, SENSOR_ERROR_HOOK_DEADLINE_MS);
+
+    xRunTimeMeasurementsHandle = xTaskCreateStatic(vRunTimeMeasurementsTask, "Run time", TASK_STACK_SIZE, NULL, RUNTIME_MEASUREMENTS_TASK_PRIORITY,
+                                                   xRunTimeMeasurementsStack, &xRunTimeMeasurementsTCB);
+    vTaskSetApplicationTaskTag( xRunTimeMeasurementsHandle, ( TaskHookFunction_t ) RUNTIME_MEASUREMENTS_TASK_TAG );
+    RunTimeStats_SetTiming(RUNTIME_MEASUREMENTS_TASK_TAG, RUNTIME_MEASUREMENTS_TASK_PERIOD_MS, RUNTIME_MEASUREMENTS_TASK_DEADLINE_MS);
+
+    /* Lowest priority: the trace goes out in the time nothing else needs, with
+     * no period or deadline declared */
+    xTraceStreamHandle = xTaskCreateStatic(vTraceStreamTask, "Trace Stream", TASK_STACK_SIZE, NULL, TRACE_STREAM_TASK_PRIORITY,
+                                           xTraceStreamStack, &xTraceStreamTCB);
+    vTaskSetApplicationTaskTag( xTraceStreamHandle, ( TaskHookFunction_t ) TRACE_STREAM_TASK_TAG );
+
+    /* Lowest priority as well, the producers never wait for it */
+    xLoggerHandle = xTaskCreateStatic(vLoggerTask, "Logger", TASK_STACK_SIZE, NULL, LOGGER_TASK_PRIORITY,
+                                      xLoggerStack, &xLoggerTCB);
+    vTaskSetApplicationTaskTag( xLoggerHandle, ( TaskHookFunction_t ) LOGGER_TASK_TAG );
 
 
     /* Create a Mutexes and semaphores */
-    xLM35GetTempMutex = xSemaphoreCreateMutex();
-    xDriverInfoMutex = xSemaphoreCreateMutex();
-    xPassengerInfoMutex = xSemaphoreCreateMutex();
-    xErrorReportingMutex = xSemaphoreCreateMutex();
-
-    xDriverInputSemaphore = xSemaphoreCreateBinary();
-    xDriverInputSemaphoreFromSteering = xSemaphoreCreateBinary();
-    xPassengerInputSemaphore = xSemaphoreCreateBinary();
-    xSensorErrorHookSemaphore = xSemaphoreCreateBinary();
+    xSeatTableMutex = xSemaphoreCreateMutexStatic(&xSeatTableMutexBuffer);
+    vQueueSetQueueNumber(xSeatTableMutex, SEAT_TABLE_MUTEX_NUMBER);
+    vQueueAddToRegistry(xSeatTableMutex, "SeatTable");
 
     /* Now all the tasks have been started - start the scheduler.
 
@@ -156,461 +267,554 @@ int main()
      these demo application projects then ensure Supervisor mode is used here. */
     vTaskStartScheduler();
 
-    /* Should never reach here!  If you do then there was not enough heap
-     available for the idle task to be created. */
+    /* Should never reach here! The idle task is statically allocated, so
+     starting the scheduler cannot run out of memory. */
     for (;;)
         ;
 
 }
 
+/* Storage of the idle task, required with configSUPPORT_STATIC_ALLOCATION */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = xIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+/* MemManage handler (port.c): a task ran into the MPU guard at the bottom of
+ * its stack. What lies below the guard is intact, but the task's last push
+ * is lost and the kernel may be mid-switch, so nothing runs any more; the red
+ * LED shows the stop and the debugger finds the task in pcStackOverflowTask. */
+void vApplicationStackGuardHook(TaskHandle_t xTask, char *pcTaskName)
+{
+    pcStackOverflowTask = pcTaskName;
+    ulStackOverflowTag = (uint32)xTaskGetApplicationTaskTagFromISR(xTask);
+    GPIO_RedLedOn();
+    taskDISABLE_INTERRUPTS();
+    for (;;)
+        ;
+}
+
 static void prvSetupHardware(void)
 {
+    uint8 ucSeat;
+    uint8 ucSource;
+
+    /* Rows that are the same for every seat, so a new seat needs none */
+    for (ucSeat = 0; ucSeat < NUM_SEATS; ucSeat++)
+    {
+        SeatTable.SeatTemperature[ucSeat] = 10;
+        SeatTable.HeaterState[ucSeat] = Heater_OFF;
+        SeatTable.DesiredTemperature[ucSeat] = Desired_HIGH;
+        SeatTable.SensorFault[ucSeat] = pdFALSE;
+        xHeaterConfig[ucSeat].FrequencyHz = HEATER_DEFAULT_FREQUENCY_HZ;
+        xHeaterConfig[ucSeat].SoftStartMs = HEATER_DEFAULT_SOFT_START_MS;
+    }
+    for (ucSource = 0; ucSource < INPUT_SOURCES; ucSource++)
+    {
+        ucInputLevel[ucSource] = INPUT_NO_LEVEL;
+    }
+
     /* Place here any needed HW initialization such as GPIO, UART, etc.  */
     UART0_Init();
-    DriverSensor_Init();
-    PassengerSensor_Init();
+    LM35_Init();
+    LM35_StartAcquisition();
     GPIO_BuiltinButtonsLedsInit();
-    GPIO_SW1EdgeTriggeredInterruptInit();
-    GPIO_SW2EdgeTriggeredInterruptInit();
-    GPTM_WTimer0Init();
-    EEPROMInit();
+    GPIO_DebounceInit(prvInputGesture);
+    Heater_Init(xHeaterConfig);
+    for (ucSeat = 0; ucSeat < NUM_SEATS; ucSeat++)
+    {
+        PI_Init(&xSeatController[ucSeat], &xSeatControlConfig);
+    }
+    RunTimeStats_Init();
+    Trace_Init();
+    Log_Init();
+    Pool_Init();
+    EventLog_Init();
+    prvRestoreSelections();
+    prvPublishSeatTable();
+}
+
+static void prvRestoreSelections(void)
+{
+    EventLog_RecordType xRecord;
+    uint8 ucSeat;
+
+    for (ucSeat = 0; ucSeat < NUM_SEATS; ucSeat++)
+    {
+        if (EventLog_GetLatest(EVENT_LOG_SELECTION, ucSeat, &xRecord))
+        {
+            SeatTable.DesiredTemperature[ucSeat] = (uint8)xRecord.Value;
+        }
+    }
+}
+
+/* With the seat table mutex held, after the table was changed */
+static void prvPublishSeatTable(void)
+{
+    uint32 ulNext = ulSeatTableVersion + 1;
+
+    xSeatTablePublished[ulNext & 1] = SeatTable;
+    ulSeatTableVersion = ulNext;
+}
+
+/* Any context, no lock. A reader only copies again when a writer published
+ * while it was copying, which cannot happen to a reader that preempted the
+ * writer; a lower priority reader makes progress between the writers. */
+void vSeatTableSnapshot(SeatTableType *pxSnapshot)
+{
+    uint32 ulVersion;
+
+    do
+    {
+        ulVersion = ulSeatTableVersion;
+        *pxSnapshot = xSeatTablePublished[ulVersion & 1];
+    }
+    while (ulVersion != ulSeatTableVersion);
+}
+
+/* Each press moves one step along OFF, LOW, MED, HIGH and back to OFF */
+static DesiredTemperatureType prvNextLevel(DesiredTemperatureType xDesiredTemperature)
+{
+    switch (xDesiredTemperature)
+    {
+    case Desired_OFF:
+        return Desired_LOW;
+    case Desired_LOW:
+        return Desired_MED;
+    case Desired_MED:
+        return Desired_HIGH;
+    default:
+        return Desired_OFF;
+    }
+}
+
+/* vTaskDelayUntil() that also ends an overrunning job: a task that reaches
+ * it after its next release does not block, and no kernel hook sees that */
+static void prvWaitForPeriod(TickType_t *pxLastWakeTime, TickType_t xPeriod)
+{
+    uint32 ulLateCycles = 0;
+
+    if (xTaskDelayUntil(pxLastWakeTime, xPeriod) == pdFALSE)
+    {
+        /* *pxLastWakeTime is the release that is already past */
+        ulLateCycles = (uint32)(xTaskGetTickCount() - *pxLastWakeTime) * (configCPU_CLOCK_HZ / configTICK_RATE_HZ);
+    }
+    RunTimeStats_TaskResumed((uint32)xTaskGetApplicationTaskTag(NULL), ulLateCycles);
+}
+
+/* The runtime record's 16-bit fields stick at their maximum */
+static uint16 prvSaturate16(uint32 ulValue)
+{
+    return (ulValue > 0xFFFF) ? 0xFFFF : (uint16)ulValue;
 }
 
 void vRunTimeMeasurementsTask(void *pvParameters)
 {
+    UART0_FrameType xReport = { NULL_PTR, TELEMETRY_MAX_FRAME_SIZE, 0 };
+    Telemetry_RuntimeType xRuntime;
     TickType_t xLastWakeTime = xTaskGetTickCount();
     for (;;)
     {
-        uint8 ucCounter, ucCPU_Load;
-        uint32 ullTotalTasksTime = 0;
-        vTaskDelayUntil(&xLastWakeTime, RUNTIME_MEASUREMENTS_TASK_PERIODICITY);
+        const RunTimeStats_SnapshotType *pxStats;
+        const RunTimeStats_TaskType *pxTaskStats;
+        uint8 ucCounter;
+        prvWaitForPeriod(&xLastWakeTime, RUNTIME_MEASUREMENTS_TASK_PERIODICITY);
+
+        /* Every task at one instant and without masking interrupts; the
+         * record is built from the copy */
+        pxStats = RunTimeStats_TakeSnapshot();
+        xRuntime.Timestamp = xTaskGetTickCount();
+        xRuntime.NumberOfTasks = NUMBER_OF_TASKS;
         for(ucCounter = 1; ucCounter < NUMBER_OF_TASKS + 1; ucCounter++)
         {
-            ullTotalTasksTime += ullTasksTotalTime[ucCounter];
-            taskENTER_CRITICAL();
-            UART0_SendString("Task of tag ");
-            UART0_SendInteger(ucCounter);
-            UART0_SendString(" execution time is: ");
-            UART0_SendInteger(ullTasksExecutionTime[ucCounter] / 10);
-            UART0_SendString(" msec \r\n");
-            taskEXIT_CRITICAL();
+            pxTaskStats = &pxStats->Tasks[ucCounter];
+            xRuntime.TaskTime[ucCounter - 1] = (uint32)(pxTaskStats->RunTime / RUNTIME_CYCLES_PER_REPORT_UNIT);
+            xRuntime.TaskWcet[ucCounter - 1] = prvSaturate16(pxTaskStats->ExecutionMax / RUNTIME_CYCLES_PER_US);
+            xRuntime.DeadlineMisses[ucCounter - 1] = prvSaturate16(pxTaskStats->DeadlineMisses);
+        }
+        /* Over the last two seconds, not since boot */
+        xRuntime.CpuLoad = (uint8)((pxStats->CpuLoad + 5) / 10);
+        xRuntime.MaskedMax = prvSaturate16(pxStats->MaskedMax / RUNTIME_CYCLES_PER_US);
+
+        /* The whole report goes out by uDMA in one piece. Without a frame
+         * block the report is skipped, the totals are in the next one. */
+        xReport.pBuffer = (uint8 *)Pool_Alloc(TELEMETRY_MAX_FRAME_SIZE);
+        if (xReport.pBuffer != NULL_PTR)
+        {
+            xReport.uLength = Telemetry_PackRuntime(&xRuntime, xReport.pBuffer);
+            UART0_SendFrame(&xReport);
+            UART0_WaitFrame(portMAX_DELAY);
+            Pool_Free(xReport.pBuffer);
         }
-        ucCPU_Load = (ullTotalTasksTime * 100) /  GPTM_WTimer0Read();
-
-        taskENTER_CRITICAL();
-        UART0_SendString("CPU Load is ");
-        UART0_SendInteger(ucCPU_Load);
-        UART0_SendString("% \r\n");
-        taskEXIT_CRITICAL();
     }
 }
 
-void vGetDriverSeatTemp(void *pvParameters)
+void vTraceStreamTask(void *pvParameters)
 {
-    /* Tries to acquire the semaphore. */
-    TickType_t Timeout = xGetTempMaxDelay;
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-
+    static Telemetry_TraceType xTrace;
+    UART0_FrameType xFrame = { NULL_PTR, TELEMETRY_MAX_FRAME_SIZE, 0 };
+    Trace_StatsType xStats;
     for (;;)
     {
-        vTaskDelayUntil(&xLastWakeTime, GET_TEMP_TASK_PERIODICITY);
-        if (xSemaphoreTake(xLM35GetTempMutex, Timeout) == pdTRUE)
+        vTaskDelay(TRACE_STREAM_PERIOD);
+        /* Without a frame block the records wait in the ring for the next drain */
+        xFrame.pBuffer = (uint8 *)Pool_Alloc(TELEMETRY_MAX_FRAME_SIZE);
+        if (xFrame.pBuffer == NULL_PTR)
         {
-
-            DriverSeatInfo.SeatTemperature = GetDriverSensorReading();
-            if (DriverSeatInfo.SeatTemperature < 5
-                    || DriverSeatInfo.SeatTemperature > 40)
-            {
-                DRIVER_SENSOR_ERROR = pdTRUE;
-                xSemaphoreGive(xSensorErrorHookSemaphore);
-            }
-            else
+            continue;
+        }
+        /* Full frames while the ring holds them, then the rest. Sending a
+         * frame records events of its own, so draining until the ring is
+         * empty would keep the line busy with frames about themselves. */
+        do
+        {
+            xTrace.NumberOfRecords = (uint8)Trace_Read(xTrace.Records, TELEMETRY_MAX_TRACE_RECORDS);
+            if (xTrace.NumberOfRecords != 0)
             {
-                GPIO_RedLedOff();
-                vTaskResume(xSetDriverSeatHeaterStateHandle);
-                vTaskResume(xGetDriverInputHandle);
-                vTaskResume(xGetDriverInputFromSteeringHandle);
-                /* Release the peripheral */
-                xSemaphoreGive(xLM35GetTempMutex);
+                Trace_GetStats(&xStats);
+                xTrace.Timestamp = xTaskGetTickCount();
+                xTrace.Dropped = xStats.Dropped;
+                xFrame.uLength = Telemetry_PackTrace(&xTrace, xFrame.pBuffer);
+                UART0_SendFrame(&xFrame);
+                UART0_WaitFrame(portMAX_DELAY);
             }
         }
+        while (xTrace.NumberOfRecords == TELEMETRY_MAX_TRACE_RECORDS);
+        Pool_Free(xFrame.pBuffer);
     }
 }
-void vGetPassengerSeatTemp(void *pvParameters)
-{
-    /* Tries to acquire the semaphore. */
-    uint32 Timeout = xGetTempMaxDelay;
-    TickType_t xLastWakeTime = xTaskGetTickCount();
 
+void vLoggerTask(void *pvParameters)
+{
+    static Telemetry_LogType xLog;
+    UART0_FrameType xFrame = { NULL_PTR, TELEMETRY_MAX_FRAME_SIZE, 0 };
+    Log_StatsType xStats;
     for (;;)
     {
-        if (xSemaphoreTake(xLM35GetTempMutex, Timeout) == pdTRUE)
+        vTaskDelay(LOG_DRAIN_PERIOD);
+        /* Without a frame block the records wait in their rings */
+        xFrame.pBuffer = (uint8 *)Pool_Alloc(TELEMETRY_MAX_FRAME_SIZE);
+        if (xFrame.pBuffer == NULL_PTR)
         {
-
-            PassengerSeatInfo.SeatTemperature = GetPassengerSensorReading();
-
-            if (PassengerSeatInfo.SeatTemperature < 5
-                    || PassengerSeatInfo.SeatTemperature > 40)
-            {
-
-                PASSENGER_SENSOR_ERROR = pdTRUE;
-                xSemaphoreGive(xSensorErrorHookSemaphore);
-
-            }
-            else
+            continue;
+        }
+        /* Log_Read() hands out the error rings first, so errors lead the
+         * first frame of every drain */
+        do
+        {
+            xLog.NumberOfRecords = (uint8)Log_Read(xLog.Records, TELEMETRY_MAX_LOG_RECORDS);
+            if (xLog.NumberOfRecords != 0)
             {
-                GPIO_RedLedOff();
-                vTaskResume(xSetPassengerSeatHeaterStateHandle);
-                vTaskResume(xGetPassengerInputHandle);
-                /* Release the peripheral */
-                xSemaphoreGive(xLM35GetTempMutex);
+                Log_GetStats(&xStats);
+                xLog.Timestamp = xTaskGetTickCount();
+                xLog.Dropped = xStats.Dropped;
+                xFrame.uLength = Telemetry_PackLog(&xLog, xFrame.pBuffer);
+                UART0_SendFrame(&xFrame);
+                UART0_WaitFrame(portMAX_DELAY);
             }
-            vTaskDelayUntil(&xLastWakeTime, GET_TEMP_TASK_PERIODICITY);
         }
+        while (xLog.NumberOfRecords == TELEMETRY_MAX_LOG_RECORDS);
+        Pool_Free(xFrame.pBuffer);
     }
 }
 
-void vSetDriverSeatHeaterState(void *pvParameters)
+void vSeatAcquisitionTask(void *pvParameters)
 {
-
-    TickType_t Timeout = xDriverInfoMaxDelay;
     TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint32 ulNewFaults;
+    uint8 ucAnyFault;
+    uint8 ucReading[NUM_SEATS];
+    uint8 ucSeat;
+
     for (;;)
     {
-        vTaskDelayUntil(&xLastWakeTime, SET_TEMP_TASK_PERIODICITY);
-        if (xSemaphoreTake(xDriverInfoMutex, Timeout) == pdTRUE)
+        prvWaitForPeriod(&xLastWakeTime, GET_TEMP_TASK_PERIODICITY);
+        /* Every seat from one conversion pass, taken before the table is locked */
+        LM35_GetReadings(ucReading);
+        if (xSemaphoreTake(xSeatTableMutex, xSeatTableMaxDelay) == pdTRUE)
         {
-            sint8 xTemperatureDifference = (DriverSeatInfo.SeatTemperature
-                    - DriverSeatInfo.DesiredTemperature);
-            if (xTemperatureDifference >= 10)
-            {
-                DriverSeatInfo.HeaterState = Heater_HIGH;
-                GPIO_BlueLedOn();
-                GPIO_GreenLedOn();
-            }
-            else if (xTemperatureDifference < 10 && xTemperatureDifference >= 5)
+            ulNewFaults = 0;
+            ucAnyFault = pdFALSE;
+            for (ucSeat = 0; ucSeat < NUM_SEATS; ucSeat++)
             {
-                DriverSeatInfo.HeaterState = Heater_MED;
-                GPIO_BlueLedOn();
-                GPIO_GreenLedOff();
+                SeatTable.SeatTemperature[ucSeat] = ucReading[ucSeat];
+                if ((ucReading[ucSeat] < SENSOR_VALID_MIN) || (ucReading[ucSeat] > SENSOR_VALID_MAX))
+                {
+                    /* The hook handles a failure once, when it starts */
+                    if (!SeatTable.SensorFault[ucSeat])
+                    {
+                        ulNewFaults |= (1 << ucSeat);
+                        Log_Write(LOG_PRODUCER_ACQUISITION, LOG_SENSOR_FAILED, ucSeat, ucReading[ucSeat], 0);
+                    }
+                    SeatTable.SensorFault[ucSeat] = pdTRUE;
+                    ucAnyFault = pdTRUE;
+                }
+                else
+                {
+                    /* A recovered seat takes presses again, its heater
+                     * stays off until a level is selected */
+                    if (SeatTable.SensorFault[ucSeat])
+                    {
+                        Log_Write(LOG_PRODUCER_ACQUISITION, LOG_SENSOR_RECOVERED, ucSeat, ucReading[ucSeat], 0);
+                    }
+                    SeatTable.SensorFault[ucSeat] = pdFALSE;
+                }
             }
-            else if (xTemperatureDifference < 5 && xTemperatureDifference >= 2)
+            /* Released on every path, a failed sensor no longer blocks the others */
+            prvPublishSeatTable();
+            xSemaphoreGive(xSeatTableMutex);
+
+            if (ulNewFaults != 0)
             {
-                DriverSeatInfo.HeaterState = Heater_LOW;
-                GPIO_GreenLedOn();
-                GPIO_BlueLedOff();
+                xTaskNotify(xSensorErrorHookHandle, ulNewFaults, eSetBits);
             }
-            else
+            else if (!ucAnyFault)
             {
-                DriverSeatInfo.HeaterState = Heater_OFF;
+                GPIO_RedLedOff();
             }
-            xSemaphoreGive(xDriverInfoMutex);
         }
+        else
+        {
+            Log_Write(LOG_PRODUCER_ACQUISITION, LOG_SEAT_TABLE_TIMEOUT, xSeatTableMaxDelay * portTICK_PERIOD_MS, 0, 0);
+        }
+    }
+}
+
+/* One PI sample of a seat, with the seat table mutex held. A seat switched
+ * off or with a failed sensor opens its loop and starts the next heat-up
+ * from an empty integrator. */
+static uint16 prvHeaterDuty(uint8 ucSeat)
+{
+    if ((SeatTable.DesiredTemperature[ucSeat] == Desired_OFF) || SeatTable.SensorFault[ucSeat])
+    {
+        PI_Reset(&xSeatController[ucSeat]);
+        return 0;
+    }
+    /* Positive while the seat is colder than desired */
+    return (uint16)PI_Update(&xSeatController[ucSeat], (sint32)SeatTable.DesiredTemperature[ucSeat]
+                             - (sint32)SeatTable.SeatTemperature[ucSeat]);
+}
+
+/* Heater state reported by the display, the duty in thirds */
+static HeaterIntensityType prvHeaterLevel(uint16 usDuty)
+{
+    if (usDuty == 0)
+    {
+        return Heater_OFF;
+    }
+    if (usDuty < (HEATER_DUTY_MAX / 3))
+    {
+        return Heater_LOW;
     }
+    if (usDuty < ((2 * HEATER_DUTY_MAX) / 3))
+    {
+        return Heater_MED;
+    }
+    return Heater_HIGH;
 }
-void vSetPassengerSeatHeaterState(void *pvParameters)
+
+void vSeatControlTask(void *pvParameters)
 {
-    TickType_t Timeout = xDriverInfoMaxDelay;
     TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint16 usDuty[NUM_SEATS];
+    uint8 ucLevelChanged[NUM_SEATS];
+    uint8 ucLevel;
+    uint8 ucSeat;
+
     for (;;)
     {
-        vTaskDelayUntil(&xLastWakeTime, SET_TEMP_TASK_PERIODICITY);
-        if (xSemaphoreTake(xPassengerInfoMutex, Timeout) == pdTRUE)
+        prvWaitForPeriod(&xLastWakeTime, SET_TEMP_TASK_PERIODICITY);
+        if (xSemaphoreTake(xSeatTableMutex, xSeatTableMaxDelay) == pdTRUE)
         {
-
-            sint8 xTemperatureDifference = (PassengerSeatInfo.SeatTemperature)
-                    - (PassengerSeatInfo.DesiredTemperature);
-
-            if (xTemperatureDifference >= 10)
+            for (ucSeat = 0; ucSeat < NUM_SEATS; ucSeat++)
             {
-                PassengerSeatInfo.HeaterState = Heater_HIGH;
-                GPIO_BlueLedOn();
-                GPIO_GreenLedOn();
+                usDuty[ucSeat] = prvHeaterDuty(ucSeat);
+                ucLevel = prvHeaterLevel(usDuty[ucSeat]);
+                ucLevelChanged[ucSeat] = (ucLevel != SeatTable.HeaterState[ucSeat]);
+                SeatTable.HeaterState[ucSeat] = ucLevel;
             }
-            else if (xTemperatureDifference < 10 && xTemperatureDifference >= 5)
-            {
-                PassengerSeatInfo.HeaterState = Heater_MED;
-                GPIO_BlueLedOn();
-                GPIO_GreenLedOff();
-            }
-            else if (xTemperatureDifference < 5 && xTemperatureDifference >= 2)
-            {
-                PassengerSeatInfo.HeaterState = Heater_LOW;
-                GPIO_GreenLedOn();
-                GPIO_BlueLedOff();
-            }
-            else
+            prvPublishSeatTable();
+            xSemaphoreGive(xSeatTableMutex);
+
+            for (ucSeat = 0; ucSeat < NUM_SEATS; ucSeat++)
             {
-                PassengerSeatInfo.HeaterState = Heater_OFF;
+                Heater_SetDuty(ucSeat, usDuty[ucSeat]);
+                if (ucLevelChanged[ucSeat])
+                {
+                    Log_Write(LOG_PRODUCER_CONTROL, LOG_HEATER_LEVEL, ucSeat, prvHeaterLevel(usDuty[ucSeat]),
+                              usDuty[ucSeat]);
+                }
             }
-            xSemaphoreGive(xPassengerInfoMutex);
+        }
+        else
+        {
+            Log_Write(LOG_PRODUCER_CONTROL, LOG_SEAT_TABLE_TIMEOUT, xSeatTableMaxDelay * portTICK_PERIOD_MS, 0, 0);
         }
     }
 }
 
 void vDisplaySystemState(void *pvParameters)
 {
-
+    UART0_FrameType xDisplay = { NULL_PTR, TELEMETRY_MAX_FRAME_SIZE, 0 };
+    Telemetry_SeatStateType xState;
+    SeatTableType xSeats;
     TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint8 ucSeat;
     for (;;)
     {
-        vTaskDelayUntil(&xLastWakeTime ,DISPLAY_SYSTEM_STATE_PERIOD);
-        if (xSemaphoreTake(xDriverInfoMutex, portMAX_DELAY) == pdTRUE)
+        prvWaitForPeriod(&xLastWakeTime, DISPLAY_SYSTEM_STATE_PERIOD);
+        xState.Timestamp = xTaskGetTickCount();
+        xState.NumberOfSeats = NUM_SEATS;
+        xState.Faults = 0;
+        /* A published copy, the writers are never held up by the display */
+        vSeatTableSnapshot(&xSeats);
+        for (ucSeat = 0; ucSeat < NUM_SEATS; ucSeat++)
         {
-            UART0_SendString("*****Driver Seat*****\r\n");
-            UART0_SendString("Current Temperature: ");
-            UART0_SendInteger(DriverSeatInfo.SeatTemperature);
-
-            UART0_SendString("\r\nDesired Heating Level: ");
-            if (DriverSeatInfo.DesiredTemperature == Desired_OFF)
-            {
-                UART0_SendString("OFF\r\n");
-            }
-            else if (DriverSeatInfo.DesiredTemperature == Desired_LOW)
-            {
-                UART0_SendString("LOW\r\n");
-            }
-            else if (DriverSeatInfo.DesiredTemperature == Desired_MED)
-            {
-                UART0_SendString("MED\r\n");
-            }
-            else
-            {
-                UART0_SendString("HIGH\r\n");
-            }
-
-            UART0_SendString("Heater Intensity: ");
-            if (DriverSeatInfo.HeaterState == Heater_OFF)
-            {
-                UART0_SendString("OFF\r\n");
-            }
-            else if (DriverSeatInfo.HeaterState == Heater_LOW)
-            {
-                UART0_SendString("LOW\r\n");
-            }
-            else if (DriverSeatInfo.HeaterState == Heater_MED)
+            xState.Seats[ucSeat].Temperature = xSeats.SeatTemperature[ucSeat];
+            xState.Seats[ucSeat].HeaterState = xSeats.HeaterState[ucSeat];
+            xState.Seats[ucSeat].DesiredTemperature = xSeats.DesiredTemperature[ucSeat];
+            if (xSeats.SensorFault[ucSeat])
             {
-                UART0_SendString("MED\r\n");
+                xState.Faults |= TELEMETRY_FAULT_SEAT(ucSeat);
             }
-            else
-            {
-                UART0_SendString("HIGH\r\n");
-            }
-            xSemaphoreGive(xDriverInfoMutex);
         }
 
-        if (xSemaphoreTake(xDriverInfoMutex, portMAX_DELAY) == pdTRUE)
+        /* The block is ours until the frame is done; without one this
+         * second's state is not shown */
+        xDisplay.pBuffer = (uint8 *)Pool_Alloc(TELEMETRY_MAX_FRAME_SIZE);
+        if (xDisplay.pBuffer != NULL_PTR)
         {
-            UART0_SendString("*****Passenger Seat*****\r\n");
-            UART0_SendString("Current Temperature: ");
-            UART0_SendInteger(PassengerSeatInfo.SeatTemperature);
-
-            UART0_SendString("\r\nDesired Heating Level: ");
-            if (PassengerSeatInfo.DesiredTemperature == Desired_OFF)
-            {
-                UART0_SendString("OFF\r\n");
-            }
-            else if (PassengerSeatInfo.DesiredTemperature == Desired_LOW)
-            {
-                UART0_SendString("LOW\r\n");
-            }
-            else if (PassengerSeatInfo.DesiredTemperature == Desired_MED)
-            {
-                UART0_SendString("MED\r\n");
-            }
-            else
-            {
-                UART0_SendString("HIGH\r\n");
-            }
-
-            UART0_SendString("Heater Intensity: ");
-            if (PassengerSeatInfo.HeaterState == Heater_OFF)
-            {
-                UART0_SendString("OFF\r\n");
-            }
-            else if (PassengerSeatInfo.HeaterState == Heater_LOW)
-            {
-                UART0_SendString("LOW\r\n");
-            }
-            else if (PassengerSeatInfo.HeaterState == Heater_MED)
-            {
-                UART0_SendString("MED\r\n");
-            }
-            else
-            {
-                UART0_SendString("HIGH\r\n");
-            }
-            xSemaphoreGive(xPassengerInfoMutex);
+            xDisplay.uLength = Telemetry_PackSeatState(&xState, xDisplay.pBuffer);
+            UART0_SendFrame(&xDisplay);
+            UART0_WaitFrame(portMAX_DELAY);
+            Pool_Free(xDisplay.pBuffer);
         }
     }
 }
 
-void vGPIOPortF_Handler(void)
+/* Debounce interrupt context: short press steps the level, long press turns
+ * the seat off and double click goes straight to HIGH */
+static void prvInputGesture(uint8 ucSource, GPIO_GestureType eGesture)
 {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    if (GPIO_PORTF_RIS_REG & (1 << 4))
-    {
-        /* Synchronize with the red led task to toggle it each edge triggered interrupt */
-        xSemaphoreGiveFromISR(xDriverInputSemaphore, &xHigherPriorityTaskWoken);
-        /* Clear Trigger flag for PF4 (Interrupt Flag) */
-        GPIO_PORTF_ICR_REG |= (1 << 4);
-    }
-    else if (GPIO_PORTF_RIS_REG & (1 << 0))
+
+    if (eGesture == GPIO_GESTURE_SHORT_PRESS)
     {
-        /* Synchronize with the red led task to toggle it each edge triggered interrupt */
-        xSemaphoreGiveFromISR(xPassengerInputSemaphore,
-                              &xHigherPriorityTaskWoken);
-        /* Clear Trigger flag for PF0 (Interrupt Flag) */
-        GPIO_PORTF_ICR_REG |= (1 << 0);
+        ulInputPresses[ucSource]++;
     }
     else
     {
-        /* Synchronize with the red led task to toggle it each edge triggered interrupt */
-        xSemaphoreGiveFromISR(xDriverInputSemaphoreFromSteering,
-                              &xHigherPriorityTaskWoken);
-        /* Clear Trigger flag for PF4 (Interrupt Flag) */
-        GPIO_PORTF_ICR_REG |= (1 << 4);
+        /* Overrides the presses still pending before it */
+        ulInputPresses[ucSource] = 0;
+        ucInputLevel[ucSource] = (eGesture == GPIO_GESTURE_LONG_PRESS) ? Desired_OFF : Desired_HIGH;
     }
+    xInputPressTime[ucSource] = xTaskGetTickCountFromISR();
+    Log_Write(LOG_PRODUCER_GESTURE, LOG_GESTURE, ucSource, eGesture, 0);
+
+    xTaskNotifyFromISR(xInputDispatcherHandle, (1 << ucSource), eSetBits, &xHigherPriorityTaskWoken);
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
-void vGetDriverInput(void *pvParameters)
+void vInputDispatcherTask(void *pvParameters)
 {
+    uint32 ulEvents;
+    uint8 ucSource;
 
-    uint32 Timeout = xGetDriverInputMaxDelay
-    ;
-    static uint8 clicks = 0;
-    static uint8 i = 0;
     for (;;)
     {
-        /* Waits for synchronization with PF4 & PF0 edge triggered interrupt using the binary semaphore. */
-        /* This task will be blocked until both PF0 & PF4 edge triggered interrupt happened. */
-        /* This task does not need a delay call since it is waiting for edge triggered interrupt */
-        if ((xSemaphoreTake(xDriverInputSemaphore, Timeout) == pdTRUE)
-                || (xSemaphoreTake(xDriverInputSemaphoreFromSteering, Timeout)
-                        == pdTRUE))
+        /* No timeout: the task only runs when a button was pressed */
+        xTaskNotifyWait(0, INPUT_EVENT_ALL, &ulEvents, portMAX_DELAY);
+        for (ucSource = 0; ucSource < INPUT_SOURCES; ucSource++)
         {
-            if (xSemaphoreTake(xDriverInfoMutex, portMAX_DELAY) == pdTRUE)
+            if (ulEvents & (1 << ucSource))
             {
-                clicks = clicks % 4;
-                switch (clicks)
-                {
-                case 0:
-                    DriverSeatInfo.DesiredTemperature = Desired_OFF;
-                    break;
-                case 1:
-                    DriverSeatInfo.DesiredTemperature = Desired_LOW;
-                    break;
-                case 2:
-                    DriverSeatInfo.DesiredTemperature = Desired_MED;
-                    break;
-                case 3:
-                    DriverSeatInfo.DesiredTemperature = Desired_HIGH;
-                    break;
-                }
+                prvApplyPresses(ucSource);
             }
         }
-        clicks++;
-        DriverSelection = DriverSeatInfo.DesiredTemperature;
-        EEPROMProgram(&DriverSelection, DRIVER_INPUT_ADDRESS + i, 1);
-        i += 4;
     }
 }
 
-void vGetPassengerInput(void *pvParameters)
+static void prvApplyPresses(uint8 ucSource)
 {
+    uint8 ucSeat = ucInputSeat[ucSource];
+    uint8 ucSelection;
+    TickType_t xPressTime;
+    uint32 ulPresses;
+    uint8 ucLevel;
+
+    taskENTER_CRITICAL();
+    ulPresses = ulInputPresses[ucSource];
+    ulInputPresses[ucSource] = 0;
+    ucLevel = ucInputLevel[ucSource];
+    ucInputLevel[ucSource] = INPUT_NO_LEVEL;
+    xPressTime = xInputPressTime[ucSource];
+    taskEXIT_CRITICAL();
+
+    if ((ulPresses == 0) && (ucLevel == INPUT_NO_LEVEL))
+    {
+        return;
+    }
 
-    uint32 Timeout = xGetPassengerInputMaxDelay
-    ;
-    uint8 i = 0;
-    static uint8 clicks = 0;
-    for (;;)
+    if (xSemaphoreTake(xSeatTableMutex, portMAX_DELAY) == pdTRUE)
     {
-        /* Waits for synchronization with PF4 & PF0 edge triggered interrupt using the binary semaphore. */
-        /* This task will be blocked until both PF0 & PF4 edge triggered interrupt happened. */
-        /* This task does not need a delay call since it is waiting for edge triggered interrupt */
-        if ((xSemaphoreTake(xPassengerInputSemaphore, Timeout) == pdTRUE))
+        /* Presses for a seat whose sensor failed are ignored */
+        if (SeatTable.SensorFault[ucSeat])
         {
-            if (xSemaphoreTake(xPassengerInfoMutex, portMAX_DELAY) == pdTRUE)
-            {
-                clicks = clicks % 4;
-                switch (clicks)
-                {
-                case 0:
-                    PassengerSeatInfo.DesiredTemperature = Desired_OFF;
-                    break;
-                case 1:
-                    PassengerSeatInfo.DesiredTemperature = Desired_LOW;
-                    break;
-                case 2:
-                    PassengerSeatInfo.DesiredTemperature = Desired_MED;
-                    break;
-                case 3:
-                    PassengerSeatInfo.DesiredTemperature = Desired_HIGH;
-                    break;
-                }
-            }
+            xSemaphoreGive(xSeatTableMutex);
+            Log_Write(LOG_PRODUCER_INPUT, LOG_PRESS_IGNORED, ucSeat, 0, 0);
+            return;
+        }
+        if (ucLevel != INPUT_NO_LEVEL)
+        {
+            SeatTable.DesiredTemperature[ucSeat] = ucLevel;
+        }
+        while (ulPresses > 0)
+        {
+            SeatTable.DesiredTemperature[ucSeat] =
+                prvNextLevel((DesiredTemperatureType)SeatTable.DesiredTemperature[ucSeat]);
+            ulPresses--;
         }
-        clicks++;
-        PassengerSelection = PassengerSeatInfo.DesiredTemperature;
-        EEPROMProgram(&PassengerSelection, PASSENGER_INPUT_ADDRESS + i, 1);
-        i += 4;
+        ucSelection = SeatTable.DesiredTemperature[ucSeat];
+        prvPublishSeatTable();
+        xSemaphoreGive(xSeatTableMutex);
+
+        /* Journaled with the time of the press, not of its handling */
+        EventLog_AppendAt(EVENT_LOG_SELECTION, ucSeat, ucSelection, xPressTime);
+        Log_Write(LOG_PRODUCER_INPUT, LOG_SELECTION, ucSeat, ucSelection, 0);
     }
 }
 
 void vSensorErrorHook(void *pvParameters)
 {
-    static uint8 i = 0;
-    static uint8 j = 0;
+    uint32 ulFailedSeats;
+    uint8 ucSeat;
 
-    while ((xSemaphoreTake(xSensorErrorHookSemaphore, portMAX_DELAY) == pdTRUE))
+    /* Notified by the acquisition task, one bit per seat whose sensor failed */
+    while (xTaskNotifyWait(0, (1 << NUM_SEATS) - 1, &ulFailedSeats, portMAX_DELAY) == pdTRUE)
     {
-        xLastWakeTime = (TickType_t) (xTaskGetTickCount() * (TickType_t) 1000
-                / (TickType_t) configTICK_RATE_HZ);
-
         GPIO_RedLedOn();
         GPIO_GreenLedOff();
         GPIO_BlueLedOff();
 
-        if (DRIVER_SENSOR_ERROR == pdTRUE)
-        {
-            vTaskSuspend(xSetDriverSeatHeaterStateHandle);
-            vTaskSuspend(xGetDriverInputHandle);
-            vTaskSuspend(xGetDriverInputFromSteeringHandle);
-            DriverSeatInfo.DesiredTemperature = Desired_OFF;
-            DriverSeatInfo.HeaterState = Heater_OFF;
-            DRIVER_SENSOR_ERROR = pdFALSE;
-            if ((xSemaphoreTake(xErrorReportingMutex, portMAX_DELAY) == pdTRUE))
-            {
-                ERROR_CODE = DRIVER_SENSOR_ERROR_CODE;
-                EEPROMProgram(&ERROR_CODE, DRIVER_SENSOR_ERROR_ADDRESS + i, 1);
-                i += 4;
-                EEPROMProgram(&xLastWakeTime, DRIVER_SENSOR_ERROR_ADDRESS + i,
-                              1);
-                i += 4;
-            }
-
-        }
-
-        if (PASSENGER_SENSOR_ERROR == pdTRUE)
+        /* The event log stamps each record with the tick count */
+        for (ucSeat = 0; ucSeat < NUM_SEATS; ucSeat++)
         {
-            vTaskSuspend(xSetPassengerSeatHeaterStateHandle);
-            vTaskSuspend(xGetPassengerInputHandle);
-            PassengerSeatInfo.DesiredTemperature = Desired_OFF;
-            PassengerSeatInfo.HeaterState = Heater_OFF;
-            PASSENGER_SENSOR_ERROR = pdFALSE;
-            if ((xSemaphoreTake(xErrorReportingMutex, portMAX_DELAY) == pdTRUE))
+            if (ulFailedSeats & (1 << ucSeat))
             {
-                ERROR_CODE = PASSENGER_SENSOR_ERROR_CODE;
-                EEPROMProgram(&ERROR_CODE, PASSENGER_SENSOR_ERROR_ADDRESS + j,
-                              1);
-                j += 4;
-                EEPROMProgram(&xLastWakeTime,
-                PASSENGER_SENSOR_ERROR_ADDRESS + j,
-                              1);
-                j += 4;
+                if (xSemaphoreTake(xSeatTableMutex, portMAX_DELAY) == pdTRUE)
+                {
+                    SeatTable.DesiredTemperature[ucSeat] = Desired_OFF;
+                    SeatTable.HeaterState[ucSeat] = Heater_OFF;
+                    prvPublishSeatTable();
+                    xSemaphoreGive(xSeatTableMutex);
+                }
+                Heater_SetDuty(ucSeat, 0);
+                EventLog_Append(EVENT_LOG_SENSOR_ERROR, ucSeat, ulSensorErrorCode[ucSeat]);
+                Log_Write(LOG_PRODUCER_SENSOR_ERROR, LOG_SENSOR_ERROR_HANDLED, ucSeat, ulSensorErrorCode[ucSeat], 0);
             }
-
         }
     }
 }
@@ -23,6 +23,7 @@
 //*****************************************************************************
 
 #include <stdint.h>
+#include "FreeRTOSConfig.h"
 
 //*****************************************************************************
 //
@@ -36,7 +37,22 @@ static void IntDefaultHandler(void);
 extern void xPortPendSVHandler(void);
 extern void vPortSVCHandler(void);
 extern void xPortSysTickHandler(void);
-extern void vGPIOPortF_Handler(void);
+#if (configUSE_MPU_STACK_GUARD == 1)
+extern void vPortMemManageHandler(void);
+#define MEM_MANAGE_HANDLER vPortMemManageHandler
+#else
+#define MEM_MANAGE_HANDLER IntDefaultHandler
+#endif
+extern void GPIO_DebouncePortFHandler(void);
+extern void GPIO_DebounceSW1TimerHandler(void);
+extern void GPIO_DebounceSW2TimerHandler(void);
+extern void LM35_ADC0Seq0Handler(void);
+extern void UART0_Handler(void);
+extern void EventLog_Handler(void);
+extern void Heater_Generator0Handler(void);
+extern void Heater_Generator1Handler(void);
+extern void Heater_Generator2Handler(void);
+extern void Heater_Generator3Handler(void);
 //*****************************************************************************
 //
 // External declaration for the reset handler that is to be called when the
@@ -74,7 +90,7 @@ void (* const g_pfnVectors[])(void) =
     ResetISR,                               // The reset handler
     NmiSR,                                  // The NMI handler
     FaultISR,                               // The hard fault handler
-    IntDefaultHandler,                      // The MPU fault handler
+    MEM_MANAGE_HANDLER,                     // The MPU fault handler
     IntDefaultHandler,                      // The bus fault handler
     IntDefaultHandler,                      // The usage fault handler
     0,                                      // Reserved
@@ -91,32 +107,32 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // GPIO Port C
     IntDefaultHandler,                      // GPIO Port D
     IntDefaultHandler,                      // GPIO Port E
-    IntDefaultHandler,                      // UART0 Rx and Tx
+    UART0_Handler,                          // UART0 Rx and Tx
     IntDefaultHandler,                      // UART1 Rx and Tx
     IntDefaultHandler,                      // SSI0 Rx and Tx
     IntDefaultHandler,                      // I2C0 Master and Slave
     IntDefaultHandler,                      // PWM Fault
-    IntDefaultHandler,                      // PWM Generator 0
-    IntDefaultHandler,                      // PWM Generator 1
-    IntDefaultHandler,                      // PWM Generator 2
+    Heater_Generator0Handler,               // PWM Generator 0
+    Heater_Generator1Handler,               // PWM Generator 1
+    Heater_Generator2Handler,               // PWM Generator 2
     IntDefaultHandler,                      // Quadrature Encoder 0
-    IntDefaultHandler,                      // ADC Sequence 0
+    LM35_ADC0Seq0Handler,                   // ADC Sequence 0
     IntDefaultHandler,                      // ADC Sequence 1
     IntDefaultHandler,                      // ADC Sequence 2
     IntDefaultHandler,                      // ADC Sequence 3
     IntDefaultHandler,                      // Watchdog timer
     IntDefaultHandler,                      // Timer 0 subtimer A
     IntDefaultHandler,                      // Timer 0 subtimer B
-    IntDefaultHandler,                      // Timer 1 subtimer A
+    GPIO_DebounceSW1TimerHandler,           // Timer 1 subtimer A
     IntDefaultHandler,                      // Timer 1 subtimer B
-    IntDefaultHandler,                      // Timer 2 subtimer A
+    GPIO_DebounceSW2TimerHandler,           // Timer 2 subtimer A
     IntDefaultHandler,                      // Timer 2 subtimer B
     IntDefaultHandler,                      // Analog Comparator 0
     IntDefaultHandler,                      // Analog Comparator 1
     IntDefaultHandler,                      // Analog Comparator 2
     IntDefaultHandler,                      // System Control (PLL, OSC, BO)
-    IntDefaultHandler,                      // FLASH Control
-    vGPIOPortF_Handler,                      // GPIO Port F
+    EventLog_Handler,                       // FLASH Control
+    GPIO_DebouncePortFHandler,              // GPIO Port F
     IntDefaultHandler,                      // GPIO Port G
     IntDefaultHandler,                      // GPIO Port H
     IntDefaultHandler,                      // UART2 Rx and Tx
@@ -131,7 +147,7 @@ void (* const g_pfnVectors[])(void) =
     0,                                      // Reserved
     IntDefaultHandler,                      // Hibernate
     IntDefaultHandler,                      // USB0
-    IntDefaultHandler,                      // PWM Generator 3
+    Heater_Generator3Handler,               // PWM Generator 3
     IntDefaultHandler,                      // uDMA Software Transfer
     IntDefaultHandler,                      // uDMA Error
     IntDefaultHandler,                      // ADC1 Sequence 0